@@ -0,0 +1,1178 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// Times zetaml's public functions and writes the results as JSON.
+// usage: zmlbench [-o file] [-t milliseconds per repetition] [-r repetitions] [filter]
+// Only benchmarks whose group or function name contains filter are run. Each result has the median and fastest time per call,
+// GFLOP/s (where the function does a known number of floating-point operations) and the number of allocations zetaml makes per call.
+// Build zetaml with and without -DZML_USE_FLOATS=ON to compare float and double builds; "precision" in the output says which one was run.
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <zetaml.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include <time.h>
+#endif
+
+// *****						   TIMING AND SETUP								*****
+// ==============================================================================
+
+// monotonic time in seconds.
+static double now() {
+#ifdef _WIN32
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (double) count.QuadPart / (double) freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+#endif
+}
+
+// results are written here so that the compiler can't optimise the calls away.
+static volatile __zml_floating sink;
+
+// fixed-seed generator, so that every run works on the same data.
+static unsigned int seed = 12345;
+static __zml_floating randomValue() {
+	seed = seed * 1103515245u + 12345u;
+	return (__zml_floating) 0.5 + (__zml_floating) ((seed >> 8) & 0xffff) / (__zml_floating) 65536.0; // [0.5, 1.5), never 0
+}
+
+static void fillVector(zmlVector vec) {
+	for (unsigned int i = 0; i < vec.size; i++) {
+		vec.elements[i] = randomValue();
+	}
+}
+
+static void fillMatrix(zmlMatrix mat) {
+	for (unsigned int r = 0; r < mat.rows; r++) {
+		for (unsigned int c = 0; c < mat.cols; c++) {
+			mat.elements[r][c] = randomValue();
+		}
+	}
+}
+
+static void fillArray(__zml_floating *arr, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		arr[i] = randomValue();
+	}
+}
+
+// allocator that counts the allocations zetaml makes, passing them on to the default allocator.
+static size_t allocations = 0;
+static void *countingAlloc(void *context, size_t size, size_t alignment) {
+	(void) context;
+
+	allocations++;
+	return ZML_DEFAULT_ALLOCATOR.alloc(ZML_DEFAULT_ALLOCATOR.context, size, alignment);
+}
+static void countingFree(void *context, void *ptr) {
+	(void) context;
+	ZML_DEFAULT_ALLOCATOR.free(ZML_DEFAULT_ALLOCATOR.context, ptr);
+}
+static const zmlAllocator countingAllocator = { countingAlloc, countingFree, NULL };
+
+// *****							 BENCHMARKS									*****
+// ==============================================================================
+
+// the size being benchmarked (vector size, matrix rows and columns, point or object count, depending on the group).
+static unsigned int size;
+
+// ---- vectors ----
+
+static zmlVector va, vb, vdst;
+
+static void setupVectors() {
+	va = zmlAllocVector(size);
+	vb = zmlAllocVector(size);
+	vdst = zmlAllocVector(size);
+	fillVector(va);
+	fillVector(vb);
+}
+static void teardownVectors() {
+	zmlFreeVector(&va);
+	zmlFreeVector(&vb);
+	zmlFreeVector(&vdst);
+}
+
+static void benchDot(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = zmlDot(va, vb);
+}
+static void benchMagnitude(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = zmlMagnitude(va);
+}
+static void benchAddVecsInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlAddVecsInto(&vdst, va, vb);
+}
+static void benchAddVecs_r(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlVector r = zmlAddVecs_r(va, vb);
+		zmlFreeVector(&r);
+	}
+}
+static void benchDivideVecsInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlDivideVecsInto(&vdst, va, vb);
+}
+static void benchMultiplyVecScalarInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplyVecScalarInto(&vdst, va, (__zml_floating) 1.5);
+}
+static void benchNormalisedInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlNormalisedInto(&vdst, va);
+}
+static void benchVecEquals(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = zmlVecEquals(va, va);
+}
+static void benchVecGTScalar(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = zmlVecGTScalar(va, 0);
+}
+static void benchCopyVector(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlVector r = zmlCopyVector(&va);
+		zmlFreeVector(&r);
+	}
+}
+static void benchAppendVector(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlVector r = ZML_NULL_VECTOR;
+		for (unsigned int j = 0; j < size; j++) {
+			zmlAppendVector(&r, (__zml_floating) j);
+		}
+		zmlFreeVector(&r);
+	}
+}
+
+// ---- float and double arrays ----
+
+static float *fa, *fb, *fdst;
+static double *da, *db, *ddst;
+
+static void setupArrays() {
+	fa = malloc(size * sizeof(float));
+	fb = malloc(size * sizeof(float));
+	fdst = malloc(size * sizeof(float));
+	da = malloc(size * sizeof(double));
+	db = malloc(size * sizeof(double));
+	ddst = malloc(size * sizeof(double));
+	for (unsigned int i = 0; i < size; i++) {
+		da[i] = (double) randomValue();
+		db[i] = (double) randomValue();
+	}
+	zmlDoublesToFloats(fa, da, size);
+	zmlDoublesToFloats(fb, db, size);
+}
+static void teardownArrays() {
+	free(fa);
+	free(fb);
+	free(fdst);
+	free(da);
+	free(db);
+	free(ddst);
+}
+
+static void benchAddArraysf(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlAddArraysf(fdst, fa, fb, size);
+}
+static void benchAddArraysd(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlAddArraysd(ddst, da, db, size);
+}
+static void benchAxpyf(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlAxpyf(fdst, 0.5f, fa, size);
+}
+static void benchAxpyd(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlAxpyd(ddst, 0.5, da, size);
+}
+static void benchDotf(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = (__zml_floating) zmlDotf(fa, fb, size);
+}
+static void benchDotd(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = (__zml_floating) zmlDotd(da, db, size);
+}
+static void benchFloatsToDoubles(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlFloatsToDoubles(ddst, fa, size);
+}
+
+// ---- matrices ----
+
+static zmlMatrix ma, mb, mdst;
+
+static void setupMatrices() {
+	ma = zmlAllocMatrix(size, size);
+	mb = zmlAllocMatrix(size, size);
+	mdst = zmlAllocMatrix(size, size);
+	va = zmlAllocVector(size);
+	vdst = zmlAllocVector(size);
+	fillMatrix(ma);
+	fillMatrix(mb);
+	fillVector(va);
+}
+static void teardownMatrices() {
+	zmlFreeMatrix(&ma);
+	zmlFreeMatrix(&mb);
+	zmlFreeMatrix(&mdst);
+	zmlFreeVector(&va);
+	zmlFreeVector(&vdst);
+}
+
+static void benchMultiplyMatsInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplyMatsInto(&mdst, ma, mb);
+}
+static void benchMultiplyMats_r(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix r = zmlMultiplyMats_r(ma, mb);
+		zmlFreeMatrix(&r);
+	}
+}
+static void benchGemmTransposed(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlGemm(ZML_TRANSPOSE, ZML_TRANSPOSE, 1, ma, mb, 0, &mdst);
+}
+static void benchAddMatsInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlAddMatsInto(&mdst, ma, mb);
+}
+static void benchMultiplyMatScalarInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplyMatScalarInto(&mdst, ma, (__zml_floating) 1.5);
+}
+static void benchMultiplyVecMatInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplyVecMatInto(&vdst, va, ma);
+}
+static void benchTransposedInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlTransposedInto(&mdst, ma);
+}
+static void benchTranspose(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlTranspose(&ma);
+}
+static void benchCopyMatrix(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix r = zmlCopyMatrix(&ma);
+		zmlFreeMatrix(&r);
+	}
+}
+static void benchMatEquals(size_t iters) {
+	for (size_t i = 0; i < iters; i++) sink = zmlMatEquals(ma, ma);
+}
+static void benchInvertedInto(size_t iters) {
+	// keep the matrix well away from singular
+	for (unsigned int i = 0; i < size; i++) ma.elements[i][i] = (__zml_floating) size;
+	for (size_t i = 0; i < iters; i++) zmlInvertedInto(&mdst, ma);
+}
+static void benchDeterminant(size_t iters) {
+	for (unsigned int i = 0; i < size; i++) ma.elements[i][i] = (__zml_floating) size;
+	for (size_t i = 0; i < iters; i++) sink = zmlDeterminant(ma);
+}
+static void benchLUDecompose(size_t iters) {
+	unsigned int *pivots = (unsigned int *) malloc(size * sizeof(unsigned int));
+	for (unsigned int i = 0; i < size; i++) ma.elements[i][i] = (__zml_floating) size;
+	for (size_t i = 0; i < iters; i++) {
+		memcpy(mdst.data, ma.data, (size_t) size * size * sizeof(__zml_floating));
+		zmlLUDecompose(&mdst, pivots);
+	}
+	free(pivots);
+}
+static void benchCholeskyDecompose(size_t iters) {
+	// diagonally dominant, so positive definite (only the lower triangle is read)
+	for (unsigned int i = 0; i < size; i++) ma.elements[i][i] = (__zml_floating) size;
+	for (size_t i = 0; i < iters; i++) {
+		memcpy(mdst.data, ma.data, (size_t) size * size * sizeof(__zml_floating));
+		zmlCholeskyDecompose(&mdst);
+	}
+}
+static void benchQRDecompose(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		memcpy(mdst.data, ma.data, (size_t) size * size * sizeof(__zml_floating));
+		zmlVector tau = zmlQRDecompose(&mdst);
+		zmlFreeVector(&tau);
+	}
+}
+static void benchIdentityMatrix(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix r = zmlIdentityMatrix(size, size);
+		zmlFreeMatrix(&r);
+	}
+}
+
+// ---- sparse matrices ----
+
+// a 5-point Laplacian on a square grid of size points (about 5 nonzeros per row), and 16 right-hand sides.
+#define SPARSE_RHS 16
+static zmlSparseMatrix sa, sacsc;
+static unsigned int *tripletRows, *tripletCols;
+static __zml_floating *tripletValues;
+static size_t tripletCount;
+static zmlMatrix sb, sdst;
+
+static void setupSparse() {
+	const unsigned int side = (unsigned int) sqrt((double) size);
+	tripletRows = (unsigned int *) malloc((size_t) size * 5 * sizeof(unsigned int));
+	tripletCols = (unsigned int *) malloc((size_t) size * 5 * sizeof(unsigned int));
+	tripletValues = (__zml_floating *) malloc((size_t) size * 5 * sizeof(__zml_floating));
+	tripletCount = 0;
+	for (unsigned int i = 0; i < size; i++) {
+		const long neighbours[5] = { (long) i, (long) i - 1, (long) i + 1, (long) i - side, (long) i + side };
+		for (int n = 0; n < 5; n++) {
+			if (neighbours[n] >= 0 && neighbours[n] < (long) size) {
+				tripletRows[tripletCount] = i;
+				tripletCols[tripletCount] = (unsigned int) neighbours[n];
+				tripletValues[tripletCount] = (n == 0) ? (__zml_floating) 4.0 : (__zml_floating) -1.0;
+				tripletCount++;
+			}
+		}
+	}
+	sa = zmlSparseMatrixFromTriplets(size, size, tripletRows, tripletCols, tripletValues, tripletCount, ZML_CSR);
+	sacsc = zmlConvertedSparse(sa, ZML_CSC);
+
+	setupVectors();
+	sb = zmlAllocMatrix(size, SPARSE_RHS);
+	sdst = zmlAllocMatrix(size, SPARSE_RHS);
+	fillMatrix(sb);
+}
+static void teardownSparse() {
+	zmlFreeSparseMatrix(&sa);
+	zmlFreeSparseMatrix(&sacsc);
+	free(tripletRows);
+	free(tripletCols);
+	free(tripletValues);
+	teardownVectors();
+	zmlFreeMatrix(&sb);
+	zmlFreeMatrix(&sdst);
+}
+
+static void benchMultiplySparseVecInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplySparseVecInto(&vdst, sa, va);
+}
+static void benchMultiplySparseVecIntoCSC(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplySparseVecInto(&vdst, sacsc, va);
+}
+static void benchMultiplySparseMatInto(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplySparseMatInto(&sdst, sa, sb);
+}
+static void benchSparseMatrixFromTriplets(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlSparseMatrix s = zmlSparseMatrixFromTriplets(size, size, tripletRows, tripletCols, tripletValues, tripletCount, ZML_CSR);
+		zmlFreeSparseMatrix(&s);
+	}
+}
+static void benchTransposedSparse(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlSparseMatrix s = zmlTransposedSparse(sa);
+		zmlFreeSparseMatrix(&s);
+	}
+}
+
+// ---- fixed-size types ----
+
+static zmlVec3 f3a, f3b;
+static zmlVec4 f4a;
+static zmlMat4 f44a, f44b;
+
+static void setupFixed() {
+	for (unsigned int i = 0; i < 4; i++) {
+		if (i < 3) {
+			f3a.elements[i] = randomValue();
+			f3b.elements[i] = randomValue();
+		}
+		f4a.elements[i] = randomValue();
+		for (unsigned int j = 0; j < 4; j++) {
+			f44a.elements[i][j] = randomValue();
+			f44b.elements[i][j] = randomValue();
+		}
+	}
+}
+static void teardownFixed() {
+}
+
+static void benchDotVec3(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		sink = zmlDotVec3(f3a, f3b);
+		f3a.elements[0] = sink; // make each call depend on the last
+	}
+}
+static void benchCrossVec3(size_t iters) {
+	for (size_t i = 0; i < iters; i++) f3a = zmlNormalisedVec3(zmlCrossVec3(f3a, f3b));
+	sink = f3a.elements[0];
+}
+static void benchNormalisedVec4(size_t iters) {
+	for (size_t i = 0; i < iters; i++) f4a = zmlNormalisedVec4(f4a);
+	sink = f4a.elements[0];
+}
+static void benchMultiplyMat4s_r(size_t iters) {
+	zmlMat4 r = f44a;
+	for (size_t i = 0; i < iters; i++) r = zmlMultiplyMat4s_r(r, f44b);
+	sink = r.elements[0][0];
+}
+static void benchMultiplyVec4Mat4_r(size_t iters) {
+	zmlVec4 r = f4a;
+	for (size_t i = 0; i < iters; i++) r = zmlMultiplyVec4Mat4_r(r, f44a);
+	sink = r.elements[0];
+}
+static void benchTransposedMat4(size_t iters) {
+	zmlMat4 r = f44a;
+	for (size_t i = 0; i < iters; i++) r = zmlTransposedMat4(r);
+	sink = r.elements[0][1];
+}
+static void benchMultiplyQuats_r(size_t iters) {
+	zmlQuat r = zmlAxisAngleQuat((__zml_floating) 0.5, 1, 2, 3);
+	const zmlQuat q = zmlEulerQuat(ZML_EULER_XYZ, (__zml_floating) 0.01, (__zml_floating) 0.02, (__zml_floating) 0.03);
+	for (size_t i = 0; i < iters; i++) r = zmlMultiplyQuats_r(r, q);
+	sink = r.elements[0];
+}
+static void benchSlerpQuat(size_t iters) {
+	zmlQuat r = zmlAxisAngleQuat((__zml_floating) 0.5, 1, 2, 3);
+	const zmlQuat q = zmlAxisAngleQuat((__zml_floating) 2.0, 3, 2, 1);
+	for (size_t i = 0; i < iters; i++) r = zmlSlerpQuat(r, q, (__zml_floating) 0.01);
+	sink = r.elements[0];
+}
+static void benchRotatedVec3(size_t iters) {
+	const zmlQuat q = zmlAxisAngleQuat((__zml_floating) 0.5, 1, 2, 3);
+	for (size_t i = 0; i < iters; i++) f3a = zmlRotatedVec3(f3a, q);
+	sink = f3a.elements[0];
+}
+static void benchQuatToMat4(size_t iters) {
+	zmlQuat q = zmlAxisAngleQuat((__zml_floating) 0.5, 1, 2, 3);
+	for (size_t i = 0; i < iters; i++) {
+		zmlMat4 r = zmlQuatToMat4(q);
+		q.elements[0] = r.elements[0][1];
+	}
+	sink = q.elements[0];
+}
+static void benchInvertedMat4(size_t iters) {
+	zmlMat4 r = f44a;
+	for (size_t i = 0; i < iters; i++) r = zmlInvertedMat4(r);
+	sink = r.elements[0][0];
+}
+static void benchInvertedAffineMat4(size_t iters) {
+	zmlMat4 r = zmlRotatedMat4(zmlTranslateIdentityMat4(f3a), (__zml_floating) 0.5, 1, 2, 3);
+	for (size_t i = 0; i < iters; i++) r = zmlInvertedAffineMat4(r);
+	sink = r.elements[0][0];
+}
+static void benchInvertedRigidMat4(size_t iters) {
+	zmlMat4 r = zmlRotatedMat4(zmlTranslateIdentityMat4(f3a), (__zml_floating) 0.5, 1, 2, 3);
+	for (size_t i = 0; i < iters; i++) r = zmlInvertedRigidMat4(r);
+	sink = r.elements[0][0];
+}
+static void benchDeterminantMat4(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		sink = zmlDeterminantMat4(f44a);
+		f44a.elements[0][0] = sink;
+	}
+}
+static void benchCross(size_t iters) {
+	zmlVector v1 = zmlConstructVector(3, 1.0, 2.0, 3.0);
+	zmlVector v2 = zmlConstructVector(3, 3.0, 2.0, 1.0);
+	zmlVector r = zmlAllocVector(3);
+	for (size_t i = 0; i < iters; i++) zmlCrossInto(&r, v1, v2);
+	sink = r.elements[0];
+	zmlFreeVector(&v1);
+	zmlFreeVector(&v2);
+	zmlFreeVector(&r);
+}
+
+// ---- transformations ----
+
+static zmlMatrix tmat;
+static zmlVector tvec, tpos, tfocus, tup;
+
+// the cameras of a frame: 6 cubemap faces for each of 64 probes, plus 4 shadow cascades
+#define CUBEMAP_VIEWS (6 * 64)
+#define CAMERAS (CUBEMAP_VIEWS + 4)
+static __zml_floating campos[3][CAMERAS], camfocus[3][CAMERAS], camup[3][CAMERAS];
+static __zml_floating camnear[CAMERAS], camfar[CAMERAS], camfovy[CAMERAS], camaspect[CAMERAS];
+static zmlMat4 camview[CAMERAS], camviewinv[CAMERAS], camproj[CAMERAS], camprojinv[CAMERAS], camviewproj[CAMERAS], caminv[CAMERAS];
+
+static void setupTransforms() {
+	tmat = zmlIdentityMatrix(4, 4);
+	tvec = zmlConstructVector(3, 1.0, 2.0, 3.0);
+	tpos = zmlConstructVector(3, 1.0, 1.0, 0.0);
+	tfocus = zmlConstructVector(3, 0.0, 0.0, 1.0);
+	tup = zmlConstructVector(3, 0.0, 1.0, 0.0);
+
+	static const __zml_floating faces[6][6] = {
+		{ 1, 0, 0, 0, -1, 0 }, { -1, 0, 0, 0, -1, 0 }, { 0, 1, 0, 0, 0, 1 },
+		{ 0, -1, 0, 0, 0, -1 }, { 0, 0, 1, 0, -1, 0 }, { 0, 0, -1, 0, -1, 0 }
+	};
+	for (unsigned int c = 0; c < CAMERAS; c++) {
+		const unsigned int face = c % 6;
+		for (unsigned int a = 0; a < 3; a++) {
+			campos[a][c] = randomValue() * 10;
+			camfocus[a][c] = campos[a][c] + ((c < CUBEMAP_VIEWS) ? faces[face][a] : randomValue());
+			camup[a][c] = (c < CUBEMAP_VIEWS) ? faces[face][3 + a] : (a == 1);
+		}
+		camnear[c] = (__zml_floating) 0.1;
+		camfar[c] = 100;
+		camfovy[c] = (__zml_floating) (PI / 2);
+		camaspect[c] = 1;
+	}
+}
+static void teardownTransforms() {
+	zmlFreeMatrix(&tmat);
+	zmlFreeVector(&tvec);
+	zmlFreeVector(&tpos);
+	zmlFreeVector(&tfocus);
+	zmlFreeVector(&tup);
+}
+
+static void benchTranslate(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlTranslate(&tmat, tvec);
+}
+static void benchRotate(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlRotate(&tmat, (__zml_floating) 0.01, 0, 1, 0);
+}
+static void benchScale(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlScale(&tmat, tvec);
+}
+static void benchRotateEuler(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlRotateEuler(&tmat, ZML_EULER_XYZ, (__zml_floating) 0.01, (__zml_floating) 0.02, (__zml_floating) 0.03);
+}
+static void benchRotateIdentity(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix r = zmlRotateIdentity((__zml_floating) 0.01, 0, 1, 0);
+		zmlFreeMatrix(&r);
+	}
+}
+static void benchUpdatePerspectiveMatrixRH(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlUpdatePerspectiveMatrixRH(&tmat, (__zml_floating) 0.1, 100, (__zml_floating) 1.0, (__zml_floating) 1.5);
+}
+static void benchConstructLookAtMatrixRH(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix r = zmlConstructLookAtMatrixRH(tpos, tfocus, tup);
+		zmlFreeMatrix(&r);
+	}
+}
+static void benchUpdateLookAtMatrixRH(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlUpdateLookAtMatrixRH(&tmat, tpos, tfocus, tup);
+}
+static void benchRotatedMat4(size_t iters) {
+	zmlMat4 r = zmlIdentityMat4();
+	for (size_t i = 0; i < iters; i++) r = zmlRotatedMat4(r, (__zml_floating) 0.01, 0, 1, 0);
+	sink = r.elements[0][0];
+}
+static void benchRotatedEulerMat4(size_t iters) {
+	zmlMat4 r = zmlIdentityMat4();
+	for (size_t i = 0; i < iters; i++) r = zmlRotatedEulerMat4(r, ZML_EULER_ZYX, (__zml_floating) 0.01, (__zml_floating) 0.02, (__zml_floating) 0.03);
+	sink = r.elements[0][0];
+}
+static void benchConstructLookAtMat4RH(size_t iters) {
+	zmlVec3 pos = {{1, 1, 0}}, focus = {{0, 0, 1}}, up = {{0, 1, 0}};
+	for (size_t i = 0; i < iters; i++) {
+		zmlMat4 r = zmlConstructLookAtMat4RH(pos, focus, up);
+		pos.elements[0] = r.elements[0][0];
+	}
+	sink = pos.elements[0];
+}
+
+static void benchCamerasBatched(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlConstructLookAtMat4sRH(campos[0], campos[1], campos[2], camfocus[0], camfocus[1], camfocus[2],
+			camup[0], camup[1], camup[2], camview, camviewinv, CAMERAS);
+		zmlConstructPerspectiveMat4sRH(camnear, camfar, camfovy, camaspect, camproj, camprojinv, CAMERAS);
+		zmlCombineViewProjectionMat4s(camproj, camprojinv, sizeof(zmlMat4), camview, camviewinv, sizeof(zmlMat4), camviewproj, caminv, CAMERAS);
+	}
+}
+static void benchCamerasLoop(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int c = 0; c < CAMERAS; c++) {
+			const zmlVec3 pos = {{campos[0][c], campos[1][c], campos[2][c]}};
+			const zmlVec3 focus = {{camfocus[0][c], camfocus[1][c], camfocus[2][c]}};
+			const zmlVec3 up = {{camup[0][c], camup[1][c], camup[2][c]}};
+			const zmlMat4 view = zmlConstructLookAtMat4RH(pos, focus, up);
+			const zmlMat4 proj = zmlConstructPerspectiveMat4RH(camnear[c], camfar[c], camfovy[c], camaspect[c]);
+			camviewproj[c] = zmlMultiplyMat4s_r(proj, view);
+			caminv[c] = zmlInvertedMat4(camviewproj[c]);
+		}
+	}
+}
+static void benchCamerasMatrixLoop(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int c = 0; c < CAMERAS; c++) {
+			zmlVector pos = zmlConstructVector(3, (double) campos[0][c], (double) campos[1][c], (double) campos[2][c]);
+			zmlVector focus = zmlConstructVector(3, (double) camfocus[0][c], (double) camfocus[1][c], (double) camfocus[2][c]);
+			zmlVector up = zmlConstructVector(3, (double) camup[0][c], (double) camup[1][c], (double) camup[2][c]);
+			zmlMatrix view = zmlConstructLookAtMatrixRH(pos, focus, up);
+			zmlMatrix proj = zmlConstructPerspectiveMatrixRH(camnear[c], camfar[c], camfovy[c], camaspect[c]);
+			zmlMatrix viewproj = zmlMultiplyMats_r(proj, view);
+			zmlFreeVector(&pos);
+			zmlFreeVector(&focus);
+			zmlFreeVector(&up);
+			zmlFreeMatrix(&view);
+			zmlFreeMatrix(&proj);
+			zmlFreeMatrix(&viewproj);
+		}
+	}
+}
+
+// ---- point batches ----
+
+static __zml_floating *pin, *pout;
+static zmlMat4 pmat;
+static zmlMat4 *pmatsa, *pmatsb, *pmatsout;
+static zmlFrustum pfrustum;
+static __zml_floating *paabbs;
+static unsigned char *pvisible;
+
+static void setupPoints() {
+	pin = (__zml_floating *) malloc(4 * (size_t) size * sizeof(__zml_floating));
+	pout = (__zml_floating *) malloc(4 * (size_t) size * sizeof(__zml_floating));
+	fillArray(pin, 4 * (size_t) size);
+	pmat = zmlMultiplyMat4s_r(zmlTranslateIdentityMat4((zmlVec3) {{1, 2, 3}}), zmlRotateIdentityMat4((__zml_floating) 0.5, 0, 1, 0));
+
+	pmatsa = (zmlMat4 *) malloc((size_t) size * sizeof(zmlMat4));
+	pmatsb = (zmlMat4 *) malloc((size_t) size * sizeof(zmlMat4));
+	pmatsout = (zmlMat4 *) malloc((size_t) size * sizeof(zmlMat4));
+	fillArray((__zml_floating *) pmatsa, 16 * (size_t) size);
+	fillArray((__zml_floating *) pmatsb, 16 * (size_t) size);
+
+	// (pin's values are around 1, so from here every volume is visible and has to be tested against all 6 planes)
+	const zmlMat4 proj = zmlConstructPerspectiveMat4RH((__zml_floating) 0.1, 100, (__zml_floating) 1.0, (__zml_floating) 1.5);
+	const zmlMat4 view = zmlConstructLookAtMat4RH((zmlVec3) {{0, 5, -10}}, (zmlVec3) {{0, 0, 0}}, (zmlVec3) {{0, 1, 0}});
+	pfrustum = zmlConstructFrustum(zmlMultiplyMat4s_r(proj, view));
+	paabbs = (__zml_floating *) malloc(6 * (size_t) size * sizeof(__zml_floating));
+	pvisible = (unsigned char *) malloc(size);
+}
+static void teardownPoints() {
+	free(pin);
+	free(pout);
+	free(pmatsa);
+	free(pmatsb);
+	free(pmatsout);
+	free(paabbs);
+	free(pvisible);
+}
+
+static void benchTransformPoints(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlTransformPoints(&pmat, pin, pout, size);
+}
+static void benchTransformPoints4(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlTransformPoints4(&pmat, pin, pout, size);
+}
+static void benchTransformPointsSoA(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlTransformPointsSoA(&pmat, pin, pin + size, pin + 2 * (size_t) size, pout, pout + size, pout + 2 * (size_t) size, size);
+	}
+}
+static void benchSlerpQuats(size_t iters) {
+	const zmlQuat *q1 = (const zmlQuat *) pin, *q2 = q1 + size / 2;
+	for (size_t i = 0; i < iters; i++) zmlSlerpQuats(q1, q2, (__zml_floating) 0.25, (zmlQuat *) pout, size / 2);
+}
+static void benchTransformPointsLoop(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int p = 0; p < size; p++) {
+			zmlVec4 v = {{pin[4 * p], pin[4 * p + 1], pin[4 * p + 2], pin[4 * p + 3]}};
+			zmlVec4 r = zmlMultiplyVec4Mat4_r(v, pmat);
+			memcpy(pout + 4 * (size_t) p, r.elements, sizeof(r.elements));
+		}
+	}
+}
+
+static void benchMultiplyMat4Batch(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlMultiplyMat4Batch(pmatsa, pmatsb, pmatsout, size);
+}
+static void benchMultiplyMat4BatchStrided(size_t iters) {
+	// (the same parent matrix applied to every child, as when propagating a transform hierarchy)
+	for (size_t i = 0; i < iters; i++) zmlMultiplyMat4BatchStrided(&pmat, 0, pmatsb, sizeof(zmlMat4), pmatsout, sizeof(zmlMat4), size);
+}
+static void benchMultiplyMat4Loop(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int m = 0; m < size; m++) {
+			pmatsout[m] = zmlMultiplyMat4s_r(pmatsa[m], pmatsb[m]);
+		}
+	}
+}
+
+static void benchCullSpheres(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlCullSpheres(&pfrustum, pin, pin + size, pin + 2 * (size_t) size, pin + 3 * (size_t) size, pvisible, size);
+	}
+}
+static void benchCullAABBs(size_t iters) {
+	// (the half-extents overlap the centres, which doesn't matter for timing)
+	for (size_t i = 0; i < iters; i++) {
+		zmlCullAABBs(&pfrustum, pin, pin + size, pin + 2 * (size_t) size, pin + size, pin + 2 * (size_t) size, pin + 3 * (size_t) size, pvisible, size);
+	}
+}
+static void benchCullAABBsLoop(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int b = 0; b < size; b++) {
+			const zmlVec3 centre = {{pin[b], pin[size + b], pin[2 * (size_t) size + b]}};
+			const zmlVec3 extents = {{pin[size + b], pin[2 * (size_t) size + b], pin[3 * (size_t) size + b]}};
+			pvisible[b] = zmlAABBInFrustum(&pfrustum, centre, extents);
+		}
+	}
+}
+static void benchTransformAABBs(size_t iters) {
+	__zml_floating *out = paabbs;
+	const size_t n = size;
+	for (size_t i = 0; i < iters; i++) {
+		zmlTransformAABBs(&pmat, pin, pin + n, pin + 2 * n, pin + n, pin + 2 * n, pin + 3 * n,
+			out, out + n, out + 2 * n, out + 3 * n, out + 4 * n, out + 5 * n, size);
+	}
+}
+
+// ---- string formatting ----
+
+static char *strbuf;
+static FILE *nullfile;
+
+static void setupStrings() {
+	setupMatrices();
+	strbuf = (char *) malloc((size_t) size * size * 32 + 64);
+	nullfile = fopen("/dev/null", "w");
+}
+static void teardownStrings() {
+	teardownMatrices();
+	free(strbuf);
+	if (nullfile) fclose(nullfile);
+}
+
+static void benchToStringV(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlToStringV(va, strbuf);
+}
+static void benchToStringM(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlToStringM(ma, strbuf);
+}
+static void benchFPrintM(size_t iters) {
+	if (!nullfile) return;
+	for (size_t i = 0; i < iters; i++) zmlFPrintM(ma, nullfile);
+}
+
+// ---- files ----
+
+static const char *matrixfile = "zmlbench_matrix.zml";
+
+static void setupFiles() {
+	setupMatrices();
+	zmlSaveMatrix(ma, matrixfile);
+}
+static void teardownFiles() {
+	teardownMatrices();
+	remove(matrixfile);
+}
+
+static void benchSaveMatrix(size_t iters) {
+	for (size_t i = 0; i < iters; i++) zmlSaveMatrix(ma, matrixfile);
+}
+static void benchLoadMatrix(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix m = zmlLoadMatrix(matrixfile);
+		sink += m.data[0];
+		zmlFreeMatrix(&m);
+	}
+}
+static void benchMapMatrix(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix m = zmlMapMatrix(matrixfile);
+		sink += m.data[0];
+		zmlUnmapMatrix(&m);
+	}
+}
+
+// ---- memory ----
+
+static zmlArena *arena;
+
+static void setupMemory() {
+	arena = zmlCreateArena(0);
+}
+static void teardownMemory() {
+	zmlDestroyArena(arena);
+}
+
+static void benchAllocVector(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlVector r = zmlAllocVector(size);
+		zmlFreeVector(&r);
+	}
+}
+static void benchAllocMatrix(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		zmlMatrix r = zmlAllocMatrix(size, size);
+		zmlFreeMatrix(&r);
+	}
+}
+static void benchArenaAllocVector(size_t iters) {
+	zmlAllocator allocator = zmlArenaAllocator(arena);
+	zmlSetThreadAllocator(&allocator);
+	for (size_t i = 0; i < iters; i++) {
+		zmlVector r = zmlAllocVector(size);
+		zmlFreeVector(&r);
+		if ((i & 1023) == 1023) {
+			zmlResetArena(arena);
+		}
+	}
+	zmlResetArena(arena);
+	zmlSetThreadAllocator(NULL);
+}
+
+// ---- transform hierarchies ----
+
+// a hierarchy of size nodes, each with up to 8 children, where a different 2% of the nodes move each frame.
+static zmlHierarchy *hierarchy;
+static unsigned int *hparents;
+static zmlMat4 *hlocals, *hworlds;
+static unsigned int hframe;
+
+static void setupHierarchy() {
+	hierarchy = zmlCreateHierarchy(size);
+	hparents = (unsigned int *) malloc(size * sizeof(unsigned int));
+	hlocals = (zmlMat4 *) malloc(size * sizeof(zmlMat4));
+	hworlds = (zmlMat4 *) malloc(size * sizeof(zmlMat4));
+	for (unsigned int i = 0; i < size; i++) {
+		hparents[i] = i ? (i - 1) / 8 : ZML_NO_PARENT;
+		hlocals[i] = zmlRotatedMat4(zmlTranslateIdentityMat4((zmlVec3) {{randomValue(), randomValue(), randomValue()}}), randomValue(), 0, 1, 0);
+		zmlAddHierarchyNode(hierarchy, hparents[i], hlocals[i]);
+	}
+	zmlUpdateHierarchy(hierarchy);
+}
+static void teardownHierarchy() {
+	zmlDestroyHierarchy(hierarchy);
+	free(hparents);
+	free(hlocals);
+	free(hworlds);
+}
+
+static void benchUpdateHierarchy(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int k = 0; k < size / 50; k++) {
+			const unsigned int node = (unsigned int) (((size_t) (hframe + k) * 2654435761u) % size);
+			zmlSetHierarchyLocal(hierarchy, node, hlocals[node]);
+		}
+		hframe += size / 50;
+		zmlUpdateHierarchy(hierarchy);
+	}
+}
+static void benchHierarchyLoop(size_t iters) {
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int n = 0; n < size; n++) {
+			hworlds[n] = (hparents[n] == ZML_NO_PARENT) ? hlocals[n] : zmlMultiplyMat4s_r(hworlds[hparents[n]], hlocals[n]);
+		}
+	}
+}
+
+// ---- macro: a frame of a scene ----
+
+// size objects, each with a position, rotation and scale, are combined with a view-projection matrix,
+// then each object's 8 bounding box corners are transformed into clip space.
+static zmlVec3 *objpos;
+static __zml_floating *objangle;
+static __zml_floating corners[8 * 3];
+
+static void setupScene() {
+	objpos = (zmlVec3 *) malloc(size * sizeof(zmlVec3));
+	objangle = (__zml_floating *) malloc(size * sizeof(__zml_floating));
+	for (unsigned int i = 0; i < size; i++) {
+		objpos[i] = (zmlVec3) {{randomValue() * 10, randomValue() * 10, randomValue() * 10}};
+		objangle[i] = randomValue();
+	}
+	for (unsigned int i = 0; i < 8; i++) {
+		corners[i * 3] = (i & 1) ? 1 : -1;
+		corners[i * 3 + 1] = (i & 2) ? 1 : -1;
+		corners[i * 3 + 2] = (i & 4) ? 1 : -1;
+	}
+	setupPoints();
+}
+static void teardownScene() {
+	free(objpos);
+	free(objangle);
+	teardownPoints();
+}
+
+static void benchSceneFrame(size_t iters) {
+	zmlMat4 proj = zmlConstructPerspectiveMat4RH((__zml_floating) 0.1, 100, (__zml_floating) 1.0, (__zml_floating) 1.5);
+	zmlMat4 view = zmlConstructLookAtMat4RH((zmlVec3) {{0, 5, -10}}, (zmlVec3) {{0, 0, 0}}, (zmlVec3) {{0, 1, 0}});
+	zmlMat4 viewproj = zmlMultiplyMat4s_r(proj, view);
+
+	for (size_t i = 0; i < iters; i++) {
+		for (unsigned int o = 0; o < size; o++) {
+			zmlMat4 model = zmlRotatedMat4(zmlTranslateIdentityMat4(objpos[o]), objangle[o], 0, 1, 0);
+			model = zmlScaledMat4(model, (zmlVec3) {{2, 2, 2}});
+			zmlMat4 mvp = zmlMultiplyMat4s_r(viewproj, model);
+			zmlTransformPoints(&mvp, corners, pout + 24 * (size_t) (o % (size / 8 + 1)), 8);
+		}
+	}
+}
+
+// *****							  REGISTRY									*****
+// ==============================================================================
+
+typedef struct {
+	const char *name;
+	void (*setup)();
+	void (*teardown)();
+	unsigned int sizes[8]; // sizes to run each of the group's benchmarks at, ended by a 0 (a group of benchmarks that take no size has just {1})
+} benchGroup;
+
+typedef struct {
+	unsigned int group; // index into groups
+	const char *name; // usually the zetaml function being timed
+	void (*run)(size_t iters); // call the function iters times
+	double flops; // floating-point operations per call are flops * size^power (0 if not meaningful)
+	unsigned int power;
+} benchmark;
+
+enum { VECTOR, ARRAY, MATRIX, SPARSE, FIXED, TRANSFORM, POINTS, STRING, FILES, MEMORY, HIERARCHY, SCENE };
+
+static const benchGroup groups[] = {
+	[VECTOR]	= { "vector",		setupVectors,		teardownVectors,	{ 4, 64, 1024, 65536, 1048576 } },
+	[ARRAY]		= { "array",		setupArrays,		teardownArrays,		{ 1024, 65536, 1048576 } },
+	[MATRIX]	= { "matrix",		setupMatrices,		teardownMatrices,	{ 4, 16, 64, 256, 512 } },
+	[SPARSE]	= { "sparse",		setupSparse,		teardownSparse,		{ 4096, 262144 } },
+	[FIXED]		= { "fixed",		setupFixed,			teardownFixed,		{ 1 } },
+	[TRANSFORM]	= { "transform",	setupTransforms,	teardownTransforms,	{ 1 } },
+	[POINTS]	= { "points",		setupPoints,		teardownPoints,		{ 64, 4096, 262144 } },
+	[STRING]	= { "string",		setupStrings,		teardownStrings,	{ 4, 16, 256 } },
+	[FILES]		= { "files",		setupFiles,			teardownFiles,		{ 256, 2048 } },
+	[MEMORY]	= { "memory",		setupMemory,		teardownMemory,		{ 4, 64 } },
+	[HIERARCHY]	= { "hierarchy",	setupHierarchy,		teardownHierarchy,	{ 4096, 200000 } },
+	[SCENE]		= { "scene",		setupScene,			teardownScene,		{ 256, 4096 } },
+};
+
+static const benchmark benchmarks[] = {
+	{ VECTOR,		"zmlDot",						benchDot,						2, 1 },
+	{ VECTOR,		"zmlMagnitude",					benchMagnitude,					2, 1 },
+	{ VECTOR,		"zmlAddVecsInto",				benchAddVecsInto,				1, 1 },
+	{ VECTOR,		"zmlAddVecs_r",					benchAddVecs_r,					1, 1 },
+	{ VECTOR,		"zmlDivideVecsInto",			benchDivideVecsInto,			1, 1 },
+	{ VECTOR,		"zmlMultiplyVecScalarInto",		benchMultiplyVecScalarInto,		1, 1 },
+	{ VECTOR,		"zmlNormalisedInto",			benchNormalisedInto,			3, 1 },
+	{ VECTOR,		"zmlVecEquals",					benchVecEquals,					0, 0 },
+	{ VECTOR,		"zmlVecGTScalar",				benchVecGTScalar,				0, 0 },
+	{ VECTOR,		"zmlCopyVector",				benchCopyVector,				0, 0 },
+	{ VECTOR,		"zmlAppendVector",				benchAppendVector,				0, 0 },
+
+	{ ARRAY,		"zmlAddArraysf",				benchAddArraysf,				1, 1 },
+	{ ARRAY,		"zmlAddArraysd",				benchAddArraysd,				1, 1 },
+	{ ARRAY,		"zmlAxpyf",						benchAxpyf,						2, 1 },
+	{ ARRAY,		"zmlAxpyd",						benchAxpyd,						2, 1 },
+	{ ARRAY,		"zmlDotf",						benchDotf,						2, 1 },
+	{ ARRAY,		"zmlDotd",						benchDotd,						2, 1 },
+	{ ARRAY,		"zmlFloatsToDoubles",			benchFloatsToDoubles,			0, 0 },
+
+	{ MATRIX,		"zmlMultiplyMatsInto",			benchMultiplyMatsInto,			2, 3 },
+	{ MATRIX,		"zmlMultiplyMats_r",			benchMultiplyMats_r,			2, 3 },
+	{ MATRIX,		"zmlGemm (transposed)",			benchGemmTransposed,			2, 3 },
+	{ MATRIX,		"zmlAddMatsInto",				benchAddMatsInto,				1, 2 },
+	{ MATRIX,		"zmlMultiplyMatScalarInto",		benchMultiplyMatScalarInto,		1, 2 },
+	{ MATRIX,		"zmlMultiplyVecMatInto",		benchMultiplyVecMatInto,		2, 2 },
+	{ MATRIX,		"zmlTransposedInto",			benchTransposedInto,			0, 0 },
+	{ MATRIX,		"zmlTranspose",					benchTranspose,					0, 0 },
+	{ MATRIX,		"zmlCopyMatrix",				benchCopyMatrix,				0, 0 },
+	{ MATRIX,		"zmlMatEquals",					benchMatEquals,					0, 0 },
+	{ MATRIX,		"zmlInvertedInto",				benchInvertedInto,				2, 3 },
+	{ MATRIX,		"zmlDeterminant",				benchDeterminant,				0.6667, 3 },
+	{ MATRIX,		"zmlLUDecompose",				benchLUDecompose,				0.6667, 3 },
+	{ MATRIX,		"zmlCholeskyDecompose",			benchCholeskyDecompose,			0.3333, 3 },
+	{ MATRIX,		"zmlQRDecompose",				benchQRDecompose,				1.3333, 3 },
+	{ MATRIX,		"zmlIdentityMatrix",			benchIdentityMatrix,			0, 0 },
+
+	{ SPARSE,		"zmlMultiplySparseVecInto",		benchMultiplySparseVecInto,		10, 1 },
+	{ SPARSE,		"zmlMultiplySparseVecInto (CSC)",	benchMultiplySparseVecIntoCSC,	10, 1 },
+	{ SPARSE,		"zmlMultiplySparseMatInto",		benchMultiplySparseMatInto,		10 * SPARSE_RHS, 1 },
+	{ SPARSE,		"zmlSparseMatrixFromTriplets",	benchSparseMatrixFromTriplets,	0, 0 },
+	{ SPARSE,		"zmlTransposedSparse",			benchTransposedSparse,			0, 0 },
+
+	{ FIXED,		"zmlDotVec3",					benchDotVec3,					5, 0 },
+	{ FIXED,		"zmlCrossVec3",					benchCrossVec3,					17, 0 },
+	{ FIXED,		"zmlNormalisedVec4",			benchNormalisedVec4,			12, 0 },
+	{ FIXED,		"zmlMultiplyMat4s_r",			benchMultiplyMat4s_r,			112, 0 },
+	{ FIXED,		"zmlMultiplyVec4Mat4_r",		benchMultiplyVec4Mat4_r,		28, 0 },
+	{ FIXED,		"zmlTransposedMat4",			benchTransposedMat4,			0, 0 },
+	{ FIXED,		"zmlMultiplyQuats_r",			benchMultiplyQuats_r,			28, 0 },
+	{ FIXED,		"zmlSlerpQuat",					benchSlerpQuat,					0, 0 },
+	{ FIXED,		"zmlRotatedVec3",				benchRotatedVec3,				30, 0 },
+	{ FIXED,		"zmlQuatToMat4",				benchQuatToMat4,				0, 0 },
+	{ FIXED,		"zmlInvertedMat4",				benchInvertedMat4,				0, 0 },
+	{ FIXED,		"zmlInvertedAffineMat4",		benchInvertedAffineMat4,		0, 0 },
+	{ FIXED,		"zmlInvertedRigidMat4",			benchInvertedRigidMat4,			0, 0 },
+	{ FIXED,		"zmlDeterminantMat4",			benchDeterminantMat4,			0, 0 },
+	{ FIXED,		"zmlCrossInto",					benchCross,						9, 0 },
+
+	{ TRANSFORM,	"zmlTranslate",					benchTranslate,					0, 0 },
+	{ TRANSFORM,	"zmlRotate",					benchRotate,					0, 0 },
+	{ TRANSFORM,	"zmlScale",						benchScale,						0, 0 },
+	{ TRANSFORM,	"zmlRotateEuler",				benchRotateEuler,				0, 0 },
+	{ TRANSFORM,	"zmlRotateIdentity",			benchRotateIdentity,			0, 0 },
+	{ TRANSFORM,	"zmlUpdatePerspectiveMatrixRH",	benchUpdatePerspectiveMatrixRH,	0, 0 },
+	{ TRANSFORM,	"zmlConstructLookAtMatrixRH",	benchConstructLookAtMatrixRH,	0, 0 },
+	{ TRANSFORM,	"zmlUpdateLookAtMatrixRH",		benchUpdateLookAtMatrixRH,		0, 0 },
+	{ TRANSFORM,	"zmlRotatedMat4",				benchRotatedMat4,				0, 0 },
+	{ TRANSFORM,	"zmlRotatedEulerMat4",			benchRotatedEulerMat4,			0, 0 },
+	{ TRANSFORM,	"zmlConstructLookAtMat4RH",		benchConstructLookAtMat4RH,		0, 0 },
+	{ TRANSFORM,	"cameras (batched)",			benchCamerasBatched,			0, 0 },
+	{ TRANSFORM,	"cameras (zmlMat4 loop)",		benchCamerasLoop,				0, 0 },
+	{ TRANSFORM,	"cameras (zmlMatrix loop)",		benchCamerasMatrixLoop,			0, 0 },
+
+	{ POINTS,		"zmlTransformPoints",			benchTransformPoints,			18, 1 },
+	{ POINTS,		"zmlTransformPoints4",			benchTransformPoints4,			28, 1 },
+	{ POINTS,		"zmlTransformPointsSoA",		benchTransformPointsSoA,		18, 1 },
+	{ POINTS,		"zmlSlerpQuats",				benchSlerpQuats,				0, 0 },
+	{ POINTS,		"zmlMultiplyVec4Mat4_r (loop)",	benchTransformPointsLoop,		28, 1 },
+	{ POINTS,		"zmlMultiplyMat4Batch",			benchMultiplyMat4Batch,			112, 1 },
+	{ POINTS,		"zmlMultiplyMat4BatchStrided",	benchMultiplyMat4BatchStrided,	112, 1 },
+	{ POINTS,		"zmlMultiplyMat4s_r (loop)",	benchMultiplyMat4Loop,			112, 1 },
+	{ POINTS,		"zmlCullSpheres",				benchCullSpheres,				42, 1 },
+	{ POINTS,		"zmlCullAABBs",					benchCullAABBs,					78, 1 },
+	{ POINTS,		"zmlAABBInFrustum (loop)",		benchCullAABBsLoop,				78, 1 },
+	{ POINTS,		"zmlTransformAABBs",			benchTransformAABBs,			36, 1 },
+
+	{ STRING,		"zmlToStringV",					benchToStringV,					0, 0 },
+	{ STRING,		"zmlToStringM",					benchToStringM,					0, 0 },
+	{ STRING,		"zmlFPrintM",					benchFPrintM,					0, 0 },
+	{ FILES,		"zmlSaveMatrix",				benchSaveMatrix,				0, 0 },
+	{ FILES,		"zmlLoadMatrix",				benchLoadMatrix,				0, 0 },
+	{ FILES,		"zmlMapMatrix",					benchMapMatrix,					0, 0 },
+
+	{ MEMORY,		"zmlAllocVector",				benchAllocVector,				0, 0 },
+	{ MEMORY,		"zmlAllocMatrix",				benchAllocMatrix,				0, 0 },
+	{ MEMORY,		"zmlAllocVector (arena)",		benchArenaAllocVector,			0, 0 },
+
+	{ HIERARCHY,	"zmlUpdateHierarchy (2% moved)",	benchUpdateHierarchy,			0, 0 },
+	{ HIERARCHY,	"zmlMultiplyMat4s_r (loop)",	benchHierarchyLoop,				112, 1 },
+
+	{ SCENE,		"frame",						benchSceneFrame,				0, 0 },
+};
+
+// *****							   RUNNER									*****
+// ==============================================================================
+
+static double mintime = 0.02; // seconds per repetition
+static unsigned int repetitions = 5;
+
+static int compareDoubles(const void *a, const void *b) {
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+static double timeRun(const benchmark *b, size_t iters) {
+	double start = now();
+	b->run(iters);
+	return now() - start;
+}
+
+// time one benchmark at the current size and write its result as a JSON object.
+static void measure(const benchmark *b, FILE *out, unsigned char first) {
+	// find how many calls take at least mintime (this also warms up caches and the thread pool)
+	size_t iters = 1;
+	double t;
+	while ((t = timeRun(b, iters)) < mintime && iters < ((size_t) 1 << 40)) {
+		double scale = (t > 0) ? 1.2 * mintime / t : 100;
+		iters = (size_t) ((double) iters * ((scale < 2) ? 2 : (scale > 100) ? 100 : scale));
+	}
+
+	double nsperop[32];
+	unsigned int reps = (repetitions > 32) ? 32 : repetitions;
+	for (unsigned int r = 0; r < reps; r++) {
+		nsperop[r] = timeRun(b, iters) * 1e9 / (double) iters;
+	}
+	qsort(nsperop, reps, sizeof(double), compareDoubles);
+	double median = (reps % 2) ? nsperop[reps / 2] : 0.5 * (nsperop[reps / 2 - 1] + nsperop[reps / 2]);
+
+	// count allocations separately, so that the timed runs use the default allocator
+	size_t countiters = (iters < 1000) ? iters : 1000;
+	allocations = 0;
+	zmlSetAllocator(&countingAllocator);
+	b->run(countiters);
+	zmlSetAllocator(NULL);
+
+	unsigned int hassize = groups[b->group].sizes[0] != 1 || groups[b->group].sizes[1] != 0;
+	double flops = b->flops * pow((double) size, (double) b->power);
+
+	fprintf(out, "%s\n\t\t{ \"group\": \"%s\", \"name\": \"%s\", ", first ? "" : ",", groups[b->group].name, b->name);
+	if (hassize) {
+		fprintf(out, "\"size\": %u, ", size);
+	} else {
+		fprintf(out, "\"size\": null, ");
+	}
+	fprintf(out, "\"iterations\": %lu, \"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, ", (unsigned long) iters, median, nsperop[0]);
+	if (flops > 0) {
+		fprintf(out, "\"gflops\": %.4f, ", flops / median);
+	} else {
+		fprintf(out, "\"gflops\": null, ");
+	}
+	fprintf(out, "\"allocs_per_op\": %.3f }", (double) allocations / (double) countiters);
+	fflush(out);
+}
+
+int main(int argc, char **argv) {
+	const char *outpath = NULL;
+	const char *filter = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+			outpath = argv[++i];
+		} else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+			mintime = atof(argv[++i]) / 1000.0;
+		} else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+			repetitions = (unsigned int) atoi(argv[++i]);
+		} else if (argv[i][0] != '-' && !filter) {
+			filter = argv[i];
+		} else {
+			fprintf(stderr, "usage: %s [-o file] [-t milliseconds per repetition] [-r repetitions] [filter]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!repetitions) {
+		repetitions = 1;
+	}
+
+	FILE *out = stdout;
+	if (outpath && !(out = fopen(outpath, "w"))) {
+		fprintf(stderr, "zmlbench: can't open %s for writing\n", outpath);
+		return 1;
+	}
+
+	const char *cpu = getenv("ZML_CPU");
+	fprintf(out, "{\n\t\"library\": \"zetaml\",\n\t\"precision\": \"%s\",\n", (sizeof(__zml_floating) == sizeof(float)) ? "float" : "double");
+	fprintf(out, "\t\"threads\": %u,\n\t\"cpu\": \"%s\",\n", zmlGetThreadCount(), (cpu && *cpu) ? cpu : "auto");
+	fprintf(out, "\t\"ms_per_repetition\": %.1f,\n\t\"repetitions\": %u,\n\t\"benchmarks\": [", mintime * 1000.0, repetitions);
+
+	unsigned char first = 1;
+	for (unsigned int g = 0; g < sizeof(groups) / sizeof(groups[0]); g++) {
+		for (unsigned int s = 0; s < 8 && groups[g].sizes[s]; s++) {
+			size = groups[g].sizes[s];
+			unsigned char setup = 0;
+
+			for (unsigned int i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+				const benchmark *b = &benchmarks[i];
+				if (b->group != g || (filter && !strstr(groups[g].name, filter) && !strstr(b->name, filter))) {
+					continue;
+				}
+
+				if (!setup) {
+					groups[g].setup();
+					setup = 1;
+				}
+				measure(b, out, first);
+				first = 0;
+			}
+
+			if (setup) {
+				groups[g].teardown();
+			}
+		}
+	}
+
+	fprintf(out, "\n\t]\n}\n");
+	if (out != stdout) {
+		fclose(out);
+	}
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// Compares evaluating x + v * dt + 0.5 * a * dt * dt with zetaml.hpp's expressions against the same chain of _r functions.
+// usage: zmlbench_expressions [vector size] [repetitions]
+
+#include <zetaml.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+	const unsigned int size = (argc > 1) ? (unsigned int) std::atoi(argv[1]) : 1 << 22;
+	const unsigned int reps = (argc > 2) ? (unsigned int) std::atoi(argv[2]) : 20;
+	const zml::scalar dt = (zml::scalar) 0.01;
+
+	zml::vector x(size), v(size), a(size), out(size);
+	for (unsigned int i = 0; i < size; i++) {
+		x[i] = (zml::scalar) i;
+		v[i] = (zml::scalar) (i % 7);
+		a[i] = (zml::scalar) (i % 13);
+	}
+
+	// chain of _r functions: one allocation and one pass over memory per operator
+	double start = now();
+	for (unsigned int r = 0; r < reps; r++) {
+		zmlVector vdt = zmlMultiplyVecScalar_r(v.get(), dt);
+		zmlVector adt = zmlMultiplyVecScalar_r(a.get(), (zml::scalar) 0.5 * dt * dt);
+		zmlVector sum = zmlAddVecs_r(x.get(), vdt);
+		zmlAddVecs(&sum, adt);
+		zmlFreeVector(&vdt);
+		zmlFreeVector(&adt);
+		zmlFreeVector(&sum);
+	}
+	const double chained = (now() - start) / reps;
+
+	// one fused pass into a new vector
+	start = now();
+	for (unsigned int r = 0; r < reps; r++) {
+		zml::vector next = x + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	}
+	const double fused = (now() - start) / reps;
+
+	// one fused pass into an existing vector
+	start = now();
+	for (unsigned int r = 0; r < reps; r++) {
+		out = x + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	}
+	const double fusedInto = (now() - start) / reps;
+
+	std::printf("%u-element vectors of %u-byte elements:\n", size, (unsigned int) sizeof(zml::scalar));
+	std::printf("chained _r functions:   %8.3f ms\n", chained * 1e3);
+	std::printf("expression (new):       %8.3f ms (%.2fx)\n", fused * 1e3, chained / fused);
+	std::printf("expression (existing):  %8.3f ms (%.2fx)\n", fusedInto * 1e3, chained / fusedInto);
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// Compares building and applying a model matrix (translate * rotate * scale, then transforming a point) with zetaml.hpp's
+// zml::mat<4, 4, T> against the same with zmlMat4 and the C fixed-size functions.
+// usage: zmlbench_fixed [repetitions]
+
+#include <zetaml.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+}
+
+// time reps model matrices of element type T, returning the time per matrix in ns (sum keeps the results live).
+template <typename T>
+static double timeTemplates(unsigned int reps, double *sum) {
+	zml::vec<4, T> acc = zml::vec<4, T>::zero();
+	const double start = now();
+	for (unsigned int i = 0; i < reps; i++) {
+		const float t = (float) i * 1e-6f;
+		zml::mat<4, 4, T> model = zml::translation(zml::vec<3, T>(t, T(1.0f), T(2.0f)));
+		zml::rotate(model, t, 0, 1, 0);
+		zml::scale(model, zml::vec<3, T>(T(2.0f), T(2.0f), T(2.0f)));
+		acc += model * zml::vec<4, T>(T(1.0f), T(2.0f), T(3.0f), T(1.0f));
+	}
+	const double elapsed = now() - start;
+	*sum += (double) acc[0] + (double) acc[1] + (double) acc[2];
+	return elapsed / reps * 1e9;
+}
+
+static double timeC(unsigned int reps, double *sum) {
+	zmlVec4 acc = { { 0, 0, 0, 0 } };
+	const double start = now();
+	for (unsigned int i = 0; i < reps; i++) {
+		const zml::scalar t = (zml::scalar) i * (zml::scalar) 1e-6;
+		const zmlVec3 translation = { { t, 1, 2 } };
+		const zmlVec3 scale = { { 2, 2, 2 } };
+		zmlMat4 model = zmlTranslateIdentityMat4(translation);
+		model = zmlRotatedMat4(model, t, 0, 1, 0);
+		model = zmlScaledMat4(model, scale);
+		const zmlVec4 point = { { 1, 2, 3, 1 } };
+		acc = zmlAddVec4s_r(acc, zmlMultiplyVec4Mat4_r(point, model));
+	}
+	const double elapsed = now() - start;
+	*sum += acc.elements[0] + acc.elements[1] + acc.elements[2];
+	return elapsed / reps * 1e9;
+}
+
+int main(int argc, char **argv) {
+	const unsigned int reps = (argc > 1) ? (unsigned int) std::atoi(argv[1]) : 10000000;
+	double sum = 0;
+
+	const double c = timeC(reps, &sum);
+	const double f = timeTemplates<float>(reps, &sum);
+	const double d = timeTemplates<double>(reps, &sum);
+	const double h = timeTemplates<zml::half>(reps, &sum);
+
+	std::printf("model matrix and point transform, %u repetitions (checksum %g):\n", reps, sum);
+	std::printf("zmlMat4 (%u-byte elements): %8.2f ns\n", (unsigned int) sizeof(zml::scalar), c);
+	std::printf("zml::mat4f:                 %8.2f ns (%.2fx)\n", f, c / f);
+	std::printf("zml::mat4d:                 %8.2f ns (%.2fx)\n", d, c / d);
+	std::printf("zml::mat<4, 4, zml::half>:  %8.2f ns (%.2fx)\n", h, c / h);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+// Measures how much resident memory a large set of vectors takes, compared to the size of their elements.
+// usage: zmlbench_memory [vector count] [vector size]
+// Exits with a non-zero status if the large vectors use more than 25% more memory than their elements need.
+
+#include <zetaml.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+#	include <unistd.h>
+#endif
+
+// current resident set size in bytes (0 if it can't be measured on this platform).
+static size_t residentBytes() {
+#ifdef __linux__
+	FILE *f = fopen("/proc/self/statm", "r");
+	if (!f) {
+		return 0;
+	}
+
+	unsigned long pages = 0, resident = 0;
+	if (fscanf(f, "%lu %lu", &pages, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(f);
+
+	return (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+// allocate count vectors of size elements, touch every element, and return the resident memory they added per element.
+static double bytesPerElement(unsigned int count, unsigned int size) {
+	zmlVector *vecs = (zmlVector *) malloc(count * sizeof(zmlVector));
+	size_t before = residentBytes();
+
+	for (unsigned int i = 0; i < count; i++) {
+		vecs[i] = zmlConstructVectorDefault(size, (__zml_floating) i);
+	}
+
+	size_t after = residentBytes();
+
+	for (unsigned int i = 0; i < count; i++) {
+		zmlFreeVector(&vecs[i]);
+	}
+	free(vecs);
+
+	return (double) (after - before) / ((double) count * size);
+}
+
+int main(int argc, char **argv) {
+	unsigned int count = (argc > 1) ? (unsigned int) atoi(argv[1]) : 16;
+	unsigned int size = (argc > 2) ? (unsigned int) atoi(argv[2]) : 1000000;
+
+	if (!residentBytes()) {
+		printf("resident memory can't be measured on this platform\n");
+		return 0;
+	}
+
+	double large = bytesPerElement(count, size);
+	double small = bytesPerElement(count * (size / 4), 4);
+
+	printf("element size:                %u bytes\n", (unsigned int) sizeof(__zml_floating));
+	printf("%u x %u-element vectors: %.2f bytes per element (%.2fx)\n", count, size, large, large / sizeof(__zml_floating));
+	printf("%u x 4-element vectors:  %.2f bytes per element (%.2fx)\n", count * (size / 4), small, small / sizeof(__zml_floating));
+
+	if (large > 1.25 * sizeof(__zml_floating)) {
+		printf("FAIL: large vectors use more memory than their elements need\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -25,8 +25,18 @@ extern "C" {
 #	endif
 #endif
 
+#include <stddef.h>
+#include <stdio.h>
+
 #define PI 3.141592653589793238463
 
+// values for the trans arguments of zmlGemm().
+#define ZML_NO_TRANSPOSE 0
+#define ZML_TRANSPOSE 1
+
+// the parent of a root node in a zmlHierarchy.
+#define ZML_NO_PARENT 0xffffffffu
+
 // ==============================================================================
 // *****					  	PUBLIC STRUCTURES							*****
 // ==============================================================================
@@ -38,18 +48,184 @@ extern "C" {
 typedef struct {
 	unsigned int size;
 	__zml_floating *elements;
+	unsigned int capacity; // number of elements allocated (at least size)
 } zmlVector;
 
 /**
- * @brief Matrix structure
+ * @brief Matrix structure. Elements are stored contiguously in row-major order, starting at 'data'; element (r, c) is data[r * stride + c].
+ * 'elements' is a view of the same storage as an array of row pointers, so elements[r][c] can still be used.
  * 
  */
 typedef struct {
 	unsigned int rows;
 	unsigned int cols;
-	__zml_floating **elements; // 2d array of elements
+	__zml_floating **elements; // 2d array of elements (row pointers into data)
+	__zml_floating *data; // contiguous row-major element storage
+	unsigned int stride; // distance, in elements, between the start of each row in data
 } zmlMatrix;
 
+/**
+ * @brief A vector of floats, whatever __zml_floating is; see zmlAllocVectorf().
+ * 
+ */
+typedef struct {
+	unsigned int size;
+	float *elements;
+} zmlVectorf;
+
+/**
+ * @brief A vector of doubles, whatever __zml_floating is; see zmlAllocVectord().
+ * 
+ */
+typedef struct {
+	unsigned int size;
+	double *elements;
+} zmlVectord;
+
+/**
+ * @brief A matrix of floats, whatever __zml_floating is. Laid out as zmlMatrix (element (r, c) is data[r * stride + c]),
+ * but without the row pointers; see zmlAllocMatrixf().
+ * 
+ */
+typedef struct {
+	unsigned int rows;
+	unsigned int cols;
+	float *data; // contiguous row-major element storage
+	unsigned int stride; // distance, in elements, between the start of each row in data
+} zmlMatrixf;
+
+/**
+ * @brief A matrix of doubles, whatever __zml_floating is. Laid out as zmlMatrix (element (r, c) is data[r * stride + c]),
+ * but without the row pointers; see zmlAllocMatrixd().
+ * 
+ */
+typedef struct {
+	unsigned int rows;
+	unsigned int cols;
+	double *data; // contiguous row-major element storage
+	unsigned int stride; // distance, in elements, between the start of each row in data
+} zmlMatrixd;
+
+/**
+ * @brief The forms that a sparse matrix can be stored in (see zmlSparseMatrix).
+ * 
+ */
+typedef enum {
+	ZML_CSR, // compressed sparse rows: the nonzero elements are grouped by row
+	ZML_CSC // compressed sparse columns: the nonzero elements are grouped by column
+} zmlSparseFormat;
+
+/**
+ * @brief Sparse matrix structure: only the nonzero elements are stored, grouped by row (CSR) or by column (CSC).
+ * In CSR form, row r's elements are values[offsets[r]] to values[offsets[r + 1] - 1] and indices holds the column of each
+ * (in increasing order); CSC form is the same with rows and columns the other way round.
+ * 
+ */
+typedef struct {
+	unsigned int rows;
+	unsigned int cols;
+	zmlSparseFormat format;
+	size_t nonzeros; // the number of elements stored
+	size_t *offsets; // where each row (CSR) or column (CSC) starts in indices and values, plus the end of the last one
+	unsigned int *indices; // the column (CSR) or row (CSC) of each element
+	__zml_floating *values; // the elements
+} zmlSparseMatrix;
+
+/**
+ * @brief A 2-dimensional vector, stored by value.
+ * 
+ */
+typedef struct {
+	__zml_floating elements[2];
+} zmlVec2;
+
+/**
+ * @brief A 3-dimensional vector, stored by value.
+ * 
+ */
+typedef struct {
+	__zml_floating elements[3];
+} zmlVec3;
+
+/**
+ * @brief A 4-dimensional vector, stored by value.
+ * 
+ */
+typedef struct {
+	__zml_floating elements[4];
+} zmlVec4;
+
+/**
+ * @brief A 3x3 matrix, stored by value in row-major order (the same layout as a contiguous zmlMatrix).
+ * 
+ */
+typedef struct {
+	__zml_floating elements[3][3];
+} zmlMat3;
+
+/**
+ * @brief A 4x4 matrix, stored by value in row-major order (the same layout as a contiguous zmlMatrix).
+ * 
+ */
+typedef struct {
+	__zml_floating elements[4][4];
+} zmlMat4;
+
+/**
+ * @brief A quaternion, used to represent a rotation. Stored as (x, y, z, w), where w is the real part.
+ * 
+ */
+typedef struct {
+	__zml_floating elements[4];
+} zmlQuat;
+
+/**
+ * @brief A view frustum, stored as its 6 planes (left, right, bottom, top, near, far). Each plane is (a, b, c, d), where
+ * a * x + b * y + c * z + d >= 0 for points on the inside and (a, b, c) is normalised; see zmlConstructFrustum().
+ * 
+ */
+typedef struct {
+	zmlVec4 planes[6];
+} zmlFrustum;
+
+/**
+ * @brief The order that the rotations of an Euler angle rotation are applied in (see zmlRotateEuler()).
+ * 
+ */
+typedef enum {
+	ZML_EULER_XYZ, // rotate about X, then Y, then Z: mat * Rx * Ry * Rz
+	ZML_EULER_ZYX, // rotate about Z, then Y, then X: mat * Rz * Ry * Rx
+	ZML_EULER_YXZ // rotate about Y, then X, then Z: mat * Ry * Rx * Rz
+} zmlEulerOrder;
+
+/**
+ * @brief A memory allocator that zetaml can use in place of malloc() and free() (see zmlSetAllocator()).
+ * 
+ */
+typedef struct {
+	void *(*alloc)(void *context, size_t size, size_t alignment); // allocate size bytes aligned to alignment (a power of 2); returns NULL on failure
+	void (*free)(void *context, void *ptr); // free memory returned by alloc; may be NULL if memory is never freed individually
+	void *context; // passed to alloc and free
+} zmlAllocator;
+
+/**
+ * @brief A bump-pointer arena allocator; see zmlCreateArena().
+ * 
+ */
+typedef struct zmlArena zmlArena;
+
+/**
+ * @brief Writes a matrix to a file a group of rows at a time; see zmlOpenMatrixWriter().
+ * 
+ */
+typedef struct zmlMatrixWriter zmlMatrixWriter;
+
+/**
+ * @brief A tree of transforms, each relative to its parent; see zmlCreateHierarchy().
+ * 
+ */
+typedef struct zmlHierarchy zmlHierarchy;
+
 // ==============================================================================
 // *****				   PUBLIC VECTOR FUNCTIONALITY						*****
 // ==============================================================================
@@ -66,6 +242,13 @@ extern const zmlVector ZML_NULL_VECTOR;
  * @param size the size of the vector.
  */
 extern zmlVector zmlAllocVector(unsigned int size);
+/**
+ * @brief Allocate memory for a vector whose elements start at a multiple of the given alignment (e.g. 32 or 64 bytes). Elements are NOT initialised!
+ * 
+ * @param size the size of the vector.
+ * @param alignment the alignment, in bytes, of the elements. Must be a power of 2.
+ */
+extern zmlVector zmlAllocVectorAligned(unsigned int size, size_t alignment);
 /**
  * @brief Free a vector's memory.
  * 
@@ -73,6 +256,29 @@ extern zmlVector zmlAllocVector(unsigned int size);
  */
 extern void zmlFreeVector(zmlVector *vec);
 
+/**
+ * @brief make sure a vector has room for at least capacity elements without reallocating. Its size and elements are not changed.
+ * 
+ * @param vec the vector to modify.
+ * @param capacity the number of elements to make room for.
+ */
+extern void zmlReserveVector(zmlVector *vec, unsigned int capacity);
+/**
+ * @brief change the size of a vector, keeping its existing elements. New elements are set to 0.
+ * Growing the vector reallocates it at most logarithmically often, as its capacity is at least doubled each time.
+ * 
+ * @param vec the vector to modify.
+ * @param size the new size of the vector.
+ */
+extern void zmlResizeVector(zmlVector *vec, unsigned int size);
+/**
+ * @brief add an element onto the end of a vector (reallocating it, with room to spare, if it is full).
+ * 
+ * @param vec the vector to modify.
+ * @param val the value of the new element.
+ */
+extern void zmlAppendVector(zmlVector *vec, __zml_floating val);
+
 /**
  * @brief Construct a vector with a default value.
  * 
@@ -103,6 +309,14 @@ extern zmlVector zmlCopyVector(zmlVector *val);
  * @param v2 the second vector to operate on.
  */
 extern zmlVector zmlCross(zmlVector v1, zmlVector v2);
+/**
+ * @brief write the cross product of v1 and v2 into dst, which must already be a 3-dimensional vector (and may be v1 or v2).
+ * 
+ * @param dst the vector to write the result into.
+ * @param v1 the first vector to operate on.
+ * @param v2 the second vector to operate on.
+ */
+extern void zmlCrossInto(zmlVector *dst, zmlVector v1, zmlVector v2);
 
 /**
  * @brief produces a vector that is the dot (scalar) product of the two given vectors v1 and v2. 
@@ -125,6 +339,13 @@ extern __zml_floating zmlMagnitude(zmlVector vec);
  * @param vec the specified vector.
  */
 extern zmlVector zmlNormalised(zmlVector vec);
+/**
+ * @brief write the given vector in its normalised state into dst, which must already be the same size (and may be vec).
+ * 
+ * @param dst the vector to write the result into.
+ * @param vec the specified vector.
+ */
+extern void zmlNormalisedInto(zmlVector *dst, zmlVector vec);
 
 /**
  * @brief normalises (modifies) the specified vector.
@@ -139,7 +360,11 @@ extern void zmlNormalise(zmlVector *vec);
  * @param vec the vector to copy from.
  * @param arr the array buffer to copy into.
  */
+#ifdef __cplusplus
+extern void zmlCopyVectorElements(zmlVector vec, __zml_floating *arr); // (C++ has no variably-sized array parameters)
+#else
 extern void zmlCopyVectorElements(zmlVector vec, __zml_floating arr[vec.size]);
+#endif
 
 // -------------------------------------------
 // Boolean/arithmetic operation functions.
@@ -148,28 +373,39 @@ extern void zmlCopyVectorElements(zmlVector vec, __zml_floating arr[vec.size]);
 //	 zmlAddVecs_r adds two vectors and *returns* the result, hence the '_r'.
 // 	 zmlAddVecs adds v2 to v1, modifying v1. There is no '_r' - it does not return anything, but rather modifies v1.
 //	 zmlAddVecScalar_r adds a vector and a scalar and returns the result. etc.
+//	 zmlAddVecsInto adds v1 and v2 and writes the result into dst, which must already be allocated with the right size.
+//	  dst may be the same vector as v1 or v2, so these can be used to reuse storage instead of allocating a new result.
 // -------------------------------------------
 
 extern zmlVector 	zmlAddVecs_r(zmlVector v1, zmlVector v2);
 extern void			zmlAddVecs(zmlVector *v1, zmlVector v2);
+extern void			zmlAddVecsInto(zmlVector *dst, zmlVector v1, zmlVector v2);
 extern zmlVector 	zmlSubtractVecs_r(zmlVector v1, zmlVector v2);
 extern void 		zmlSubtractVecs(zmlVector *v1, zmlVector v2);
+extern void			zmlSubtractVecsInto(zmlVector *dst, zmlVector v1, zmlVector v2);
 extern zmlVector 	zmlMultiplyVecs_r(zmlVector v1, zmlVector v2);
 extern void 		zmlMultiplyVecs(zmlVector *v1, zmlVector v2);
+extern void			zmlMultiplyVecsInto(zmlVector *dst, zmlVector v1, zmlVector v2);
 extern zmlVector 	zmlDivideVecs_r(zmlVector v1, zmlVector v2);
 extern void 		zmlDivideVecs(zmlVector *v1, zmlVector v2);
+extern void			zmlDivideVecsInto(zmlVector *dst, zmlVector v1, zmlVector v2);
 
 extern zmlVector 	zmlAddVecScalar_r(zmlVector v1, __zml_floating v2);
 extern void		 	zmlAddVecScalar(zmlVector *v1, __zml_floating v2);
+extern void			zmlAddVecScalarInto(zmlVector *dst, zmlVector v1, __zml_floating v2);
 extern zmlVector 	zmlSubtractVecScalar_r(zmlVector v1, __zml_floating v2);
 extern void		 	zmlSubtractVecScalar(zmlVector *v1, __zml_floating v2);
+extern void			zmlSubtractVecScalarInto(zmlVector *dst, zmlVector v1, __zml_floating v2);
 extern zmlVector 	zmlMultiplyVecScalar_r(zmlVector v1, __zml_floating v2);
 extern void		 	zmlMultiplyVecScalar(zmlVector *v1, __zml_floating v2);
+extern void			zmlMultiplyVecScalarInto(zmlVector *dst, zmlVector v1, __zml_floating v2);
 extern zmlVector 	zmlDivideVecScalar_r(zmlVector v1, __zml_floating v2);
 extern void		 	zmlDivideVecScalar(zmlVector *v1, __zml_floating v2);
+extern void			zmlDivideVecScalarInto(zmlVector *dst, zmlVector v1, __zml_floating v2);
 
 extern zmlVector	zmlMultiplyVecMat_r(zmlVector v1, zmlMatrix v2);
 extern void			zmlMultiplyVecMat(zmlVector *v1, zmlMatrix v2);
+extern void			zmlMultiplyVecMatInto(zmlVector *dst, zmlVector v1, zmlMatrix v2);
 
 extern unsigned char zmlVecEquals(zmlVector v1, zmlVector v2);
 extern unsigned char zmlVecGT(zmlVector v1, zmlVector v2);
@@ -265,12 +501,102 @@ extern void zmlSetMatrixCol(zmlMatrix *mat, unsigned int index, zmlVector vec);
  */
 extern zmlMatrix zmlTransposed(zmlMatrix mat);
 /**
- * @brief transpose the given matrix by modifying it directly. 
+ * @brief write the given matrix in its transposed state into dst, which must already be allocated with mat's rows and columns swapped.
+ * dst may be mat.
+ * 
+ * @param dst the matrix to write the result into.
+ * @param mat the matrix to transpose
+ */
+extern void zmlTransposedInto(zmlMatrix *dst, zmlMatrix mat);
+/**
+ * @brief transpose the given matrix by modifying it directly. This is done in place, without a copy of the matrix: square matrices
+ * swap tiles across the main diagonal, and other shapes move their elements along the cycles of the transposition (which is slower,
+ * but only needs one bit of extra memory per element).
  * 
  * @param mat the matrix to transpose
  */
 extern void zmlTranspose(zmlMatrix *mat);
 
+/**
+ * @brief allocate the inverse of a square matrix. 4x4 matrices whose fourth row is [ 0, 0, 0, 1 ] (such as the transformation
+ * and view matrices zetaml constructs) take a faster path that only inverts the upper-left 3x3 block.
+ * 
+ * @param mat the matrix to invert.
+ */
+extern zmlMatrix zmlInverted(zmlMatrix mat);
+/**
+ * @brief alternative to zmlInverted() that writes the inverse into an existing matrix of the same size.
+ * Returns 1 on success, or 0 (leaving dst unchanged) if mat is singular.
+ * 
+ * @param dst the matrix to write the inverse into. May be the same matrix as mat.
+ * @param mat the matrix to invert.
+ */
+extern unsigned char zmlInvertedInto(zmlMatrix *dst, zmlMatrix mat);
+/**
+ * @brief alternative to zmlInverted() that replaces mat with its inverse.
+ * Returns 1 on success, or 0 (leaving mat unchanged) if it is singular.
+ * 
+ * @param mat the matrix to invert.
+ */
+extern unsigned char zmlInvert(zmlMatrix *mat);
+/**
+ * @brief get the determinant of a square matrix.
+ * 
+ * @param mat the specified matrix.
+ */
+extern __zml_floating zmlDeterminant(zmlMatrix mat);
+
+/**
+ * @brief LU decomposition with partial pivoting: P A = L U, where L is lower triangular with ones on its diagonal and U is upper triangular.
+ * mat is overwritten with U (on and above the diagonal) and L (below the diagonal, without its diagonal of ones).
+ * Returns 1 on success, or 0 if mat is singular (in which case its contents are unspecified).
+ * 
+ * @param mat the square matrix to decompose.
+ * @param pivots an array of mat->rows elements to store the row swaps in: row i was swapped with row pivots[i] at step i.
+ */
+extern unsigned char zmlLUDecompose(zmlMatrix *mat, unsigned int *pivots);
+/**
+ * @brief solve A X = B, given the LU decomposition of A from zmlLUDecompose(). b is overwritten with X.
+ * 
+ * @param lu the decomposition of A.
+ * @param pivots the row swaps from zmlLUDecompose().
+ * @param b the right-hand side(s), one per column. Must have as many rows as lu.
+ */
+extern void zmlLUSolve(zmlMatrix lu, const unsigned int *pivots, zmlMatrix *b);
+/**
+ * @brief Cholesky decomposition of a symmetric positive-definite matrix: A = L L^T, where L is lower triangular.
+ * Only the lower triangle of mat is read, and mat is overwritten with L (with zeros above the diagonal).
+ * Returns 1 on success, or 0 if mat is not positive definite (in which case its contents are unspecified).
+ * 
+ * @param mat the square matrix to decompose.
+ */
+extern unsigned char zmlCholeskyDecompose(zmlMatrix *mat);
+/**
+ * @brief solve A X = B, given the Cholesky decomposition L of A from zmlCholeskyDecompose(). b is overwritten with X.
+ * 
+ * @param l the decomposition of A.
+ * @param b the right-hand side(s), one per column. Must have as many rows as l.
+ */
+extern void zmlCholeskySolve(zmlMatrix l, zmlMatrix *b);
+/**
+ * @brief Householder QR decomposition: A = Q R, where Q is orthogonal and R is upper triangular. A must have at least as many rows as columns.
+ * mat is overwritten with R (on and above the diagonal) and the Householder vectors that make up Q (below the diagonal).
+ * Returns the scale factors of the Householder reflections (one per column), which must be given to zmlQRSolve() along with mat and
+ * freed with zmlFreeVector(); ZML_NULL_VECTOR is returned if mat has more columns than rows.
+ * 
+ * @param mat the matrix to decompose.
+ */
+extern zmlVector zmlQRDecompose(zmlMatrix *mat);
+/**
+ * @brief solve A X = B in the least-squares sense (minimising the 2-norm of each column of A X - B), given the QR decomposition
+ * of A from zmlQRDecompose(). A must have full column rank. b is replaced by X, which has as many rows as A has columns.
+ * 
+ * @param qr the decomposition of A.
+ * @param tau the scale factors returned by zmlQRDecompose().
+ * @param b the right-hand side(s), one per column. Must have as many rows as qr.
+ */
+extern void zmlQRSolve(zmlMatrix qr, zmlVector tau, zmlMatrix *b);
+
 /**
  * @brief augment vector 'vec' onto matrix 'mat'.
  * 
@@ -292,28 +618,78 @@ extern void zmlAugmentMat(zmlMatrix *mat, zmlMatrix val);
  * @param mat the matrix to copy from.
  * @param arr the array buffer to copy into.
  */
+#ifdef __cplusplus
+extern void zmlCopyMatrixElements(zmlMatrix mat, __zml_floating *arr);
+#else
 extern void zmlCopyMatrixElements(zmlMatrix mat, __zml_floating arr[mat.rows][mat.cols]);
+#endif
 
 // -------------------------------------------
 // Boolean/arithmetic operation functions.
 // These are self-explanatory, and so are not extensively documented.
+// They follow the same naming convention as the vector operations above (including the Into variants).
 // -------------------------------------------
 
 extern zmlMatrix 	zmlAddMats_r(zmlMatrix v1, zmlMatrix v2);
 extern void			zmlAddMats(zmlMatrix *v1, zmlMatrix v2);
+extern void			zmlAddMatsInto(zmlMatrix *dst, zmlMatrix v1, zmlMatrix v2);
 extern zmlMatrix 	zmlSubtractMats_r(zmlMatrix v1, zmlMatrix v2);
 extern void			zmlSubtractMats(zmlMatrix *v1, zmlMatrix v2);
+extern void			zmlSubtractMatsInto(zmlMatrix *dst, zmlMatrix v1, zmlMatrix v2);
 extern zmlMatrix 	zmlMultiplyMats_r(zmlMatrix v1, zmlMatrix v2);
 extern void			zmlMultiplyMats(zmlMatrix *v1, zmlMatrix v2);
+extern void			zmlMultiplyMatsInto(zmlMatrix *dst, zmlMatrix v1, zmlMatrix v2);
 
 extern zmlMatrix 	zmlAddMatScalar_r(zmlMatrix v1, __zml_floating v2);
 extern void		 	zmlAddMatScalar(zmlMatrix *v1, __zml_floating v2);
+extern void			zmlAddMatScalarInto(zmlMatrix *dst, zmlMatrix v1, __zml_floating v2);
 extern zmlMatrix 	zmlSubtractMatScalar_r(zmlMatrix v1, __zml_floating v2);
 extern void		 	zmlSubtractMatScalar(zmlMatrix *v1, __zml_floating v2);
+extern void			zmlSubtractMatScalarInto(zmlMatrix *dst, zmlMatrix v1, __zml_floating v2);
 extern zmlMatrix 	zmlMultiplyMatScalar_r(zmlMatrix v1, __zml_floating v2);
 extern void		 	zmlMultiplyMatScalar(zmlMatrix *v1, __zml_floating v2);
+extern void			zmlMultiplyMatScalarInto(zmlMatrix *dst, zmlMatrix v1, __zml_floating v2);
 extern zmlMatrix 	zmlDivideMatScalar_r(zmlMatrix v1, __zml_floating v2);
 extern void		 	zmlDivideMatScalar(zmlMatrix *v1, __zml_floating v2);
+extern void			zmlDivideMatScalarInto(zmlMatrix *dst, zmlMatrix v1, __zml_floating v2);
+
+/**
+ * @brief general matrix multiply: c = alpha * op(a) * op(b) + beta * c, where op(x) is x, or the transpose of x if the matching trans argument is set.
+ * Any compatible sizes are accepted: op(a) is m x k, op(b) is k x n and c is m x n.
+ * 
+ * @param transa ZML_TRANSPOSE to use the transpose of a, otherwise ZML_NO_TRANSPOSE.
+ * @param transb ZML_TRANSPOSE to use the transpose of b, otherwise ZML_NO_TRANSPOSE.
+ * @param alpha the factor to multiply op(a) * op(b) by.
+ * @param a the left-hand matrix.
+ * @param b the right-hand matrix.
+ * @param beta the factor to multiply the existing values in c by.
+ * @param c the matrix to add the result onto. Must already be allocated as m x n, and must not share storage with a or b.
+ */
+extern void zmlGemm(unsigned char transa, unsigned char transb, __zml_floating alpha, zmlMatrix a, zmlMatrix b, __zml_floating beta, zmlMatrix *c);
+/**
+ * @brief general matrix multiply of matrices of floats, as zmlGemm(): c = alpha * op(a) * op(b) + beta * c.
+ * 
+ * @param transa ZML_TRANSPOSE to use the transpose of a, otherwise ZML_NO_TRANSPOSE.
+ * @param transb ZML_TRANSPOSE to use the transpose of b, otherwise ZML_NO_TRANSPOSE.
+ * @param alpha the factor to multiply op(a) * op(b) by.
+ * @param a the left-hand matrix (m x k after op() is applied).
+ * @param b the right-hand matrix (k x n after op() is applied).
+ * @param beta the factor to multiply the existing values in c by.
+ * @param c the matrix to add the result onto. Must already be allocated as m x n, and must not share storage with a or b.
+ */
+extern void zmlGemmf(unsigned char transa, unsigned char transb, float alpha, zmlMatrixf a, zmlMatrixf b, float beta, zmlMatrixf *c);
+/**
+ * @brief general matrix multiply of matrices of doubles, as zmlGemm(): c = alpha * op(a) * op(b) + beta * c.
+ * 
+ * @param transa ZML_TRANSPOSE to use the transpose of a, otherwise ZML_NO_TRANSPOSE.
+ * @param transb ZML_TRANSPOSE to use the transpose of b, otherwise ZML_NO_TRANSPOSE.
+ * @param alpha the factor to multiply op(a) * op(b) by.
+ * @param a the left-hand matrix (m x k after op() is applied).
+ * @param b the right-hand matrix (k x n after op() is applied).
+ * @param beta the factor to multiply the existing values in c by.
+ * @param c the matrix to add the result onto. Must already be allocated as m x n, and must not share storage with a or b.
+ */
+extern void zmlGemmd(unsigned char transa, unsigned char transb, double alpha, zmlMatrixd a, zmlMatrixd b, double beta, zmlMatrixd *c);
 
 extern unsigned char zmlMatEquals(zmlMatrix v1, zmlMatrix v2);
 extern unsigned char zmlMatGT(zmlMatrix v1, zmlMatrix v2);
@@ -322,146 +698,452 @@ extern unsigned char zmlMatLT(zmlMatrix v1, zmlMatrix v2);
 extern unsigned char zmlMatLTE(zmlMatrix v1, zmlMatrix v2);
 
 // ==============================================================================
-// *****					PUBLIC UTILITY FUNCTIONS						*****
+// *****				PUBLIC SPARSE MATRIX FUNCTIONALITY					*****
 // ==============================================================================
 
 /**
- * @brief Takes a value rad, expressed in radians, and converts it to degrees. 
+ * @brief An undefined sparse matrix; no elements.
  * 
- * @param rad the value, in radians, to convert to degrees.
  */
-extern __zml_floating zmlToDegrees(__zml_floating rad);
+extern const zmlSparseMatrix ZML_NULL_SPARSE_MATRIX;
 
 /**
- * @brief Takes a value deg, expressed in degrees, and converts it to radians. 
+ * @brief build a sparse matrix from a list of (row, column, value) triplets, in any order.
+ * Values given for the same element more than once are added together. Returns ZML_NULL_SPARSE_MATRIX if any of
+ * the triplets are outside of the matrix.
  * 
- * @param deg the value, in degrees, to convert to radians.
+ * @param rows the number of rows in the matrix.
+ * @param cols the number of columns in the matrix.
+ * @param rowIndices the row of each triplet.
+ * @param colIndices the column of each triplet.
+ * @param values the value of each triplet.
+ * @param count the number of triplets.
+ * @param format the form to store the matrix in.
  */
-extern __zml_floating zmlToRadians(__zml_floating deg);
+extern zmlSparseMatrix zmlSparseMatrixFromTriplets(unsigned int rows, unsigned int cols, const unsigned int *rowIndices, const unsigned int *colIndices, const __zml_floating *values, size_t count, zmlSparseFormat format);
 
 /**
- * @brief Takes a vector value, val, and converts it to a formatted string.
+ * @brief build a sparse matrix holding the nonzero elements of a (dense) matrix.
  * 
- * @param val the vector to format and express as a string.
- * @param str the string to return the value into.
+ * @param mat the matrix to convert.
+ * @param format the form to store the sparse matrix in.
  */
-extern void zmlToStringV(zmlVector val, char *str);
+extern zmlSparseMatrix zmlSparseMatrixFromMatrix(zmlMatrix mat, zmlSparseFormat format);
 
 /**
- * @brief Takes a matrix value, val, and converts it to a formatted string.
+ * @brief build a (dense) matrix from a sparse matrix, with zeros everywhere that the sparse matrix has no element.
  * 
- * @param val the matrix to format and express as a string.
- * @param str the string to return the value into.
+ * @param s the sparse matrix to convert.
  */
-extern void zmlToStringM(zmlMatrix val, char *str);
+extern zmlMatrix zmlMatrixFromSparse(zmlSparseMatrix s);
 
 /**
- * @brief Prints the output of zmlToStringV(val) to stdout (with new line!).
+ * @brief copy a sparse matrix, converting it to the given form.
  * 
- * @param val the vector to format and print.
+ * @param s the sparse matrix to copy.
+ * @param format the form to store the copy in.
  */
-extern void zmlPrintV(zmlVector val);
+extern zmlSparseMatrix zmlConvertedSparse(zmlSparseMatrix s, zmlSparseFormat format);
 
 /**
- * @brief Prints the output of zmlToStringM(val) to stdout (with new line!).
+ * @brief get the transpose of a sparse matrix, stored in the same form.
+ * (The transpose of a CSR matrix has the same arrays as the original in CSC form and vice versa, so zmlConvertedSparse()
+ * does the work.)
  * 
- * @param val the matrix to format and print.
+ * @param s the sparse matrix to transpose.
  */
-extern void zmlPrintM(zmlMatrix val);
+extern zmlSparseMatrix zmlTransposedSparse(zmlSparseMatrix s);
 
 /**
- * @brief Performs a linear interpolation operation on value val.
+ * @brief Free a sparse matrix's memory.
  * 
- * @param val the value to interpolate
- * @param start1 the min point of the input range
- * @param stop1 the max point of the input range
- * @param start2 the min point of the output range
- * @param stop2 the max point of the output range
+ * @param s the sparse matrix to free.
  */
-extern __zml_floating zmlLerp(__zml_floating val, __zml_floating start1, __zml_floating stop1, __zml_floating start2, __zml_floating stop2);
+extern void zmlFreeSparseMatrix(zmlSparseMatrix *s);
 
-// ==============================================================================
-// *****				   PUBLIC TRANSFORMATION FUNCTIONS					*****
-// ==============================================================================
+/**
+ * @brief multiply a sparse matrix by a (dense) vector, storing the result in dst.
+ * a must have as many columns as v has elements, and dst as many elements as a has rows; dst may be v.
+ * Large products are split across threads (by rows, for CSR matrices, which are the faster form to multiply).
+ * 
+ * @param dst the vector to store the result in.
+ * @param a the sparse matrix.
+ * @param v the vector.
+ */
+extern void zmlMultiplySparseVecInto(zmlVector *dst, zmlSparseMatrix a, zmlVector v);
+extern zmlVector zmlMultiplySparseVec_r(zmlSparseMatrix a, zmlVector v);
 
 /**
- * @brief produces a translation matrix from a given matrix (mat) and the desired 3D vector vec. 
+ * @brief multiply a sparse matrix by a (dense) matrix, storing the result in dst.
+ * a must have as many columns as b has rows, and dst must have a's rows and b's columns; dst may be b.
+ * Large products are split across threads (by rows for CSR matrices, and by the columns of b for CSC matrices).
  * 
- * @param mat the matrix to base the translation matrix on.
- * @param vec the vector to use as the translation factor.
+ * @param dst the matrix to store the result in.
+ * @param a the sparse matrix.
+ * @param b the matrix.
  */
-extern zmlMatrix zmlTranslated(zmlMatrix mat, zmlVector vec);
+extern void zmlMultiplySparseMatInto(zmlMatrix *dst, zmlSparseMatrix a, zmlMatrix b);
+extern zmlMatrix zmlMultiplySparseMat_r(zmlSparseMatrix a, zmlMatrix b);
+
+// ==============================================================================
+// *****				   PUBLIC MEMORY FUNCTIONALITY						*****
+// ==============================================================================
+
 /**
- * @brief alternative to zmlTranslated() that modifies mat instead of allocating and returning a new matrix.
+ * @brief The default allocator, which uses malloc() and free().
  * 
- * @param mat the matrix to base the translation matrix on.
- * @param vec the vector to use as the translation factor.
  */
-extern void zmlTranslate(zmlMatrix *mat, zmlVector vec);
+extern const zmlAllocator ZML_DEFAULT_ALLOCATOR;
+
 /**
- * @brief produces a translation matrix from an identity matrix and the desired 3D vector vec. 
+ * @brief set the allocator used by every thread that hasn't set its own with zmlSetThreadAllocator().
+ * Must not be called while other zetaml functions are running.
  * 
- * @param vec the vector to use as the translation factor.
+ * @param allocator the allocator to use (it is copied), or NULL to go back to ZML_DEFAULT_ALLOCATOR.
  */
-extern zmlMatrix zmlTranslateIdentity(zmlVector vec);
+extern void zmlSetAllocator(const zmlAllocator *allocator);
 
 /**
- * @brief produces a rotation matrix by rotating mat by angle on the given axes.
+ * @brief set the allocator used by the calling thread only, overriding the one set with zmlSetAllocator().
  * 
- * @param mat the matrix to base the rotation matrix on.
- * @param angle the angle to rotate the specified axes by.
- * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
- * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
- * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ * @param allocator the allocator to use (it is copied), or NULL to go back to the global allocator.
  */
-extern zmlMatrix zmlRotated(zmlMatrix mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+extern void zmlSetThreadAllocator(const zmlAllocator *allocator);
+
 /**
- * @brief alternative to zmlRotated() that modifies mat instead of allocating and returning a new matrix.
+ * @brief get the allocator that zetaml uses on the calling thread.
  * 
- * @param mat the matrix to base the rotation matrix on.
- * @param angle the angle to rotate the specified axes by.
- * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
- * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
- * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
  */
-extern void zmlRotate(zmlMatrix *mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+extern zmlAllocator zmlGetAllocator(void);
+
 /**
- * @brief produces a rotation matrix by rotating a new identity matrix by angle on the given axes.
+ * @brief create an arena: a bump-pointer allocator whose memory is all released at once by zmlResetArena().
+ * Arenas are not thread-safe, so use a separate one on each thread (see zmlSetThreadAllocator()).
  * 
- * @param angle the angle to rotate the specified axes by.
- * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
- * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
- * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ * @param blocksize the size, in bytes, of the blocks the arena takes from malloc(). 0 uses a default of 64 KiB.
  */
-extern zmlMatrix zmlRotateIdentity(__zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+extern zmlArena *zmlCreateArena(size_t blocksize);
 
 /**
- * @brief produces a scale matrix from a given matrix (mat) and the desired 3D vector vec. 
+ * @brief get an allocator that allocates from the given arena. Freeing memory from it does nothing.
  * 
- * @param mat the matrix to base the scale matrix on.
- * @param vec the vector to use as the scale factor.
+ * @param arena the arena to allocate from.
  */
-extern zmlMatrix zmlScaled(zmlMatrix *mat, zmlVector vec);
+extern zmlAllocator zmlArenaAllocator(zmlArena *arena);
+
 /**
- * @brief alternative to zmlScaled() that modifies mat instead of allocating and returning a new matrix.
+ * @brief release everything allocated from an arena, so that its memory can be used again.
+ * Any vectors or matrices allocated from it must no longer be used.
  * 
- * @param mat the matrix to base the scale matrix on.
- * @param vec the vector to use as the scale factor.
+ * @param arena the arena to reset.
  */
-extern void zmlScale(zmlMatrix *mat, zmlVector vec);
+extern void zmlResetArena(zmlArena *arena);
+
 /**
- * @brief produces a scale matrix from an identity matrix and the desired 3D vector vec. 
+ * @brief free an arena and all of the memory it holds.
  * 
- * @param vec the vector to use as the scale factor.
+ * @param arena the arena to destroy.
  */
-extern zmlMatrix zmlScaleIdentity(zmlVector vec);
+extern void zmlDestroyArena(zmlArena *arena);
 
 // ==============================================================================
-// *****		    PUBLIC TRANSFORMATION (PROJECTION) FUNCTIONS			*****
+// *****				   PUBLIC FILE FUNCTIONALITY						*****
 // ==============================================================================
 
 /**
- * @brief allocates and initialises an orthographic projection matrix based on the given values. Uses left-handed coordinates!
+ * @brief save a matrix to the file at path, in zetaml's binary format (see zmlLoadMatrix() and zmlMapMatrix()).
+ * Returns 1 if the file was written, or 0 if not.
+ * 
+ * @param mat the matrix to save.
+ * @param path the file to write (replaced if it exists).
+ */
+extern unsigned char zmlSaveMatrix(zmlMatrix mat, const char *path);
+
+/**
+ * @brief read a matrix from a file written by zmlSaveMatrix() or a zmlMatrixWriter into a new matrix, which must be freed with
+ * zmlFreeMatrix(). Files of floats can be read by builds using doubles and vice versa (the elements are converted).
+ * Returns ZML_NULL_MATRIX if the file couldn't be read.
+ * 
+ * @param path the file to read.
+ */
+extern zmlMatrix zmlLoadMatrix(const char *path);
+
+/**
+ * @brief map a file written by zmlSaveMatrix() or a zmlMatrixWriter into memory and return a read-only matrix whose elements
+ * are read straight from it, without copying them: pages are only read from disk as they are first used, so this is
+ * practically instant whatever the size of the file. The elements must not be modified, and the matrix must be
+ * released with zmlUnmapMatrix() (not zmlFreeMatrix()). The file's elements must be of the type zetaml was built with.
+ * Returns ZML_NULL_MATRIX if the file couldn't be mapped.
+ * 
+ * @param path the file to map.
+ */
+extern zmlMatrix zmlMapMatrix(const char *path);
+
+/**
+ * @brief release a matrix returned by zmlMapMatrix().
+ * 
+ * @param mat the matrix to release.
+ */
+extern void zmlUnmapMatrix(zmlMatrix *mat);
+
+/**
+ * @brief start writing a matrix with the given dimensions to the file at path, a group of rows at a time, so that
+ * large matrices can be saved without ever being held in memory all at once.
+ * Write the rows with zmlWriteMatrixRows(), then finish with zmlCloseMatrixWriter(). Returns NULL if the file
+ * couldn't be opened.
+ * 
+ * @param path the file to write (replaced if it exists).
+ * @param rows the number of rows in the matrix.
+ * @param cols the number of columns in the matrix.
+ */
+extern zmlMatrixWriter *zmlOpenMatrixWriter(const char *path, unsigned int rows, unsigned int cols);
+
+/**
+ * @brief write the next count rows of the matrix being written by writer.
+ * Returns 1 if they were written, or 0 if they would go past the last row or the file couldn't be written.
+ * 
+ * @param writer the writer, from zmlOpenMatrixWriter().
+ * @param rows the rows to write: count * cols contiguous elements, in row-major order.
+ * @param count the number of rows to write.
+ */
+extern unsigned char zmlWriteMatrixRows(zmlMatrixWriter *writer, const __zml_floating *rows, unsigned int count);
+
+/**
+ * @brief finish writing a matrix and free the writer.
+ * Returns 1 if the whole matrix was written successfully, or 0 if any writes failed or not every row was written.
+ * 
+ * @param writer the writer, from zmlOpenMatrixWriter().
+ */
+extern unsigned char zmlCloseMatrixWriter(zmlMatrixWriter *writer);
+
+// ==============================================================================
+// *****					PUBLIC UTILITY FUNCTIONS						*****
+// ==============================================================================
+
+/**
+ * @brief Takes a value rad, expressed in radians, and converts it to degrees. 
+ * 
+ * @param rad the value, in radians, to convert to degrees.
+ */
+extern __zml_floating zmlToDegrees(__zml_floating rad);
+
+/**
+ * @brief Takes a value deg, expressed in degrees, and converts it to radians. 
+ * 
+ * @param deg the value, in degrees, to convert to radians.
+ */
+extern __zml_floating zmlToRadians(__zml_floating deg);
+
+/**
+ * @brief set the number of threads that zetaml splits large operations across (including the calling thread).
+ * Must not be called while other zetaml functions are running.
+ * 
+ * @param count the number of threads to use. 0 uses the number of processors (or the ZML_NUM_THREADS environment variable if set); 1 disables multithreading.
+ */
+extern void zmlSetThreadCount(unsigned int count);
+
+/**
+ * @brief get the number of threads that zetaml splits large operations across (including the calling thread).
+ * 
+ */
+extern unsigned int zmlGetThreadCount(void);
+
+/**
+ * @brief Formats a vector value, val, into the string str, writing at most size characters (including the null terminator).
+ * Like snprintf(), the output is truncated if it doesn't fit but is always null-terminated (as long as size is not 0), and
+ * the length of the full output is returned - so zmlFormatV(val, NULL, 0) + 1 is the size needed to hold it.
+ * 
+ * @param val the vector to format.
+ * @param str the string to write the output into (may be NULL if size is 0).
+ * @param size the amount of space available in str.
+ */
+extern size_t zmlFormatV(zmlVector val, char *str, size_t size);
+
+/**
+ * @brief Formats a matrix value, val, into the string str, writing at most size characters (including the null terminator).
+ * Like snprintf(), the output is truncated if it doesn't fit but is always null-terminated (as long as size is not 0), and
+ * the length of the full output is returned - so zmlFormatM(val, NULL, 0) + 1 is the size needed to hold it.
+ * 
+ * @param val the matrix to format.
+ * @param str the string to write the output into (may be NULL if size is 0).
+ * @param size the amount of space available in str.
+ */
+extern size_t zmlFormatM(zmlMatrix val, char *str, size_t size);
+
+/**
+ * @brief Writes the formatted vector value, val, straight to the stream file (without building the string in memory first).
+ * The output is the same as zmlFormatV()'s, with no new line added. Returns the number of characters written.
+ * 
+ * @param val the vector to format and write.
+ * @param file the stream to write to.
+ */
+extern size_t zmlFPrintV(zmlVector val, FILE *file);
+
+/**
+ * @brief Writes the formatted matrix value, val, straight to the stream file (without building the string in memory first).
+ * The output is the same as zmlFormatM()'s, with no new line added. Returns the number of characters written.
+ * 
+ * @param val the matrix to format and write.
+ * @param file the stream to write to.
+ */
+extern size_t zmlFPrintM(zmlMatrix val, FILE *file);
+
+/**
+ * @brief Takes a vector value, val, and converts it to a formatted string.
+ * str must be large enough to hold the result: use zmlFormatV() to find the size needed, or to format into a buffer of limited size.
+ * 
+ * @param val the vector to format and express as a string.
+ * @param str the string to return the value into.
+ */
+extern void zmlToStringV(zmlVector val, char *str);
+
+/**
+ * @brief Takes a matrix value, val, and converts it to a formatted string.
+ * str must be large enough to hold the result: use zmlFormatM() to find the size needed, or to format into a buffer of limited size.
+ * 
+ * @param val the matrix to format and express as a string.
+ * @param str the string to return the value into.
+ */
+extern void zmlToStringM(zmlMatrix val, char *str);
+
+/**
+ * @brief Prints the output of zmlToStringV(val) to stdout (with new line!).
+ * 
+ * @param val the vector to format and print.
+ */
+extern void zmlPrintV(zmlVector val);
+
+/**
+ * @brief Prints the output of zmlToStringM(val) to stdout (with new line!).
+ * 
+ * @param val the matrix to format and print.
+ */
+extern void zmlPrintM(zmlMatrix val);
+
+/**
+ * @brief Performs a linear interpolation operation on value val.
+ * 
+ * @param val the value to interpolate
+ * @param start1 the min point of the input range
+ * @param stop1 the max point of the input range
+ * @param start2 the min point of the output range
+ * @param stop2 the max point of the output range
+ */
+extern __zml_floating zmlLerp(__zml_floating val, __zml_floating start1, __zml_floating stop1, __zml_floating start2, __zml_floating stop2);
+
+// ==============================================================================
+// *****				   PUBLIC TRANSFORMATION FUNCTIONS					*****
+// ==============================================================================
+
+/**
+ * @brief produces a translation matrix from a given matrix (mat) and the desired 3D vector vec. 
+ * 
+ * @param mat the matrix to base the translation matrix on.
+ * @param vec the vector to use as the translation factor.
+ */
+extern zmlMatrix zmlTranslated(zmlMatrix mat, zmlVector vec);
+/**
+ * @brief alternative to zmlTranslated() that modifies mat instead of allocating and returning a new matrix.
+ * 
+ * @param mat the matrix to base the translation matrix on.
+ * @param vec the vector to use as the translation factor.
+ */
+extern void zmlTranslate(zmlMatrix *mat, zmlVector vec);
+/**
+ * @brief produces a translation matrix from an identity matrix and the desired 3D vector vec. 
+ * 
+ * @param vec the vector to use as the translation factor.
+ */
+extern zmlMatrix zmlTranslateIdentity(zmlVector vec);
+
+/**
+ * @brief produces a rotation matrix by rotating mat by angle on the given axes.
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+extern zmlMatrix zmlRotated(zmlMatrix mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief alternative to zmlRotated() that modifies mat instead of allocating and returning a new matrix.
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+extern void zmlRotate(zmlMatrix *mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief produces a rotation matrix by rotating a new identity matrix by angle on the given axes.
+ * 
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+extern zmlMatrix zmlRotateIdentity(__zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+
+/**
+ * @brief produces a rotation matrix by rotating mat by the Euler angles x, y and z, in one step.
+ * ZML_EULER_XYZ gives the same result as rotating by x about the X axis, then y about the Y axis, then z about the Z axis with zmlRotated().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+extern zmlMatrix zmlRotatedEuler(zmlMatrix mat, zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief alternative to zmlRotatedEuler() that modifies mat instead of allocating and returning a new matrix.
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+extern void zmlRotateEuler(zmlMatrix *mat, zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief produces a rotation matrix by rotating a new identity matrix by the Euler angles x, y and z.
+ * 
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+extern zmlMatrix zmlRotateIdentityEuler(zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+
+/**
+ * @brief produces a scale matrix from a given matrix (mat) and the desired 3D vector vec. 
+ * 
+ * @param mat the matrix to base the scale matrix on.
+ * @param vec the vector to use as the scale factor.
+ */
+extern zmlMatrix zmlScaled(zmlMatrix *mat, zmlVector vec);
+/**
+ * @brief alternative to zmlScaled() that modifies mat instead of allocating and returning a new matrix.
+ * 
+ * @param mat the matrix to base the scale matrix on.
+ * @param vec the vector to use as the scale factor.
+ */
+extern void zmlScale(zmlMatrix *mat, zmlVector vec);
+/**
+ * @brief produces a scale matrix from an identity matrix and the desired 3D vector vec. 
+ * 
+ * @param vec the vector to use as the scale factor.
+ */
+extern zmlMatrix zmlScaleIdentity(zmlVector vec);
+
+// ==============================================================================
+// *****		    PUBLIC TRANSFORMATION (PROJECTION) FUNCTIONS			*****
+// ==============================================================================
+
+/**
+ * @brief allocates and initialises an orthographic projection matrix based on the given values. Uses left-handed coordinates!
  * 
  * @param lm the left-most boundary.
  * @param rm the right-most boundary.
@@ -584,6 +1266,1043 @@ extern void zmlUpdateLookAtMatrixLH(zmlMatrix *mat, zmlVector pos, zmlVector foc
  */
 extern void zmlUpdateLookAtMatrixRH(zmlMatrix *mat, zmlVector pos, zmlVector focus, zmlVector up);
 
+// ==============================================================================
+// *****				  PUBLIC FIXED-SIZE TYPE FUNCTIONALITY				*****
+// ==============================================================================
+
+// -------------------------------------------
+// Functions on the fixed-size types (zmlVec2, zmlVec3, zmlVec4, zmlMat3, zmlMat4).
+// These take and return their operands by value, so they never allocate any memory.
+// 	Their operators follow the same naming convention as the other operators, but there is only a '_r' version of each.
+// -------------------------------------------
+
+extern zmlVec2		zmlAddVec2s_r(zmlVec2 v1, zmlVec2 v2);
+extern zmlVec2		zmlSubtractVec2s_r(zmlVec2 v1, zmlVec2 v2);
+extern zmlVec2		zmlMultiplyVec2s_r(zmlVec2 v1, zmlVec2 v2);
+extern zmlVec2		zmlDivideVec2s_r(zmlVec2 v1, zmlVec2 v2);
+extern zmlVec2		zmlAddVec2Scalar_r(zmlVec2 v1, __zml_floating v2);
+extern zmlVec2		zmlSubtractVec2Scalar_r(zmlVec2 v1, __zml_floating v2);
+extern zmlVec2		zmlMultiplyVec2Scalar_r(zmlVec2 v1, __zml_floating v2);
+extern zmlVec2		zmlDivideVec2Scalar_r(zmlVec2 v1, __zml_floating v2);
+extern __zml_floating	zmlDotVec2(zmlVec2 v1, zmlVec2 v2);
+extern __zml_floating	zmlMagnitudeVec2(zmlVec2 vec);
+extern zmlVec2		zmlNormalisedVec2(zmlVec2 vec);
+
+extern zmlVec3		zmlAddVec3s_r(zmlVec3 v1, zmlVec3 v2);
+extern zmlVec3		zmlSubtractVec3s_r(zmlVec3 v1, zmlVec3 v2);
+extern zmlVec3		zmlMultiplyVec3s_r(zmlVec3 v1, zmlVec3 v2);
+extern zmlVec3		zmlDivideVec3s_r(zmlVec3 v1, zmlVec3 v2);
+extern zmlVec3		zmlAddVec3Scalar_r(zmlVec3 v1, __zml_floating v2);
+extern zmlVec3		zmlSubtractVec3Scalar_r(zmlVec3 v1, __zml_floating v2);
+extern zmlVec3		zmlMultiplyVec3Scalar_r(zmlVec3 v1, __zml_floating v2);
+extern zmlVec3		zmlDivideVec3Scalar_r(zmlVec3 v1, __zml_floating v2);
+extern __zml_floating	zmlDotVec3(zmlVec3 v1, zmlVec3 v2);
+extern __zml_floating	zmlMagnitudeVec3(zmlVec3 vec);
+extern zmlVec3		zmlNormalisedVec3(zmlVec3 vec);
+extern zmlVec3		zmlCrossVec3(zmlVec3 v1, zmlVec3 v2);
+
+extern zmlVec4		zmlAddVec4s_r(zmlVec4 v1, zmlVec4 v2);
+extern zmlVec4		zmlSubtractVec4s_r(zmlVec4 v1, zmlVec4 v2);
+extern zmlVec4		zmlMultiplyVec4s_r(zmlVec4 v1, zmlVec4 v2);
+extern zmlVec4		zmlDivideVec4s_r(zmlVec4 v1, zmlVec4 v2);
+extern zmlVec4		zmlAddVec4Scalar_r(zmlVec4 v1, __zml_floating v2);
+extern zmlVec4		zmlSubtractVec4Scalar_r(zmlVec4 v1, __zml_floating v2);
+extern zmlVec4		zmlMultiplyVec4Scalar_r(zmlVec4 v1, __zml_floating v2);
+extern zmlVec4		zmlDivideVec4Scalar_r(zmlVec4 v1, __zml_floating v2);
+extern __zml_floating	zmlDotVec4(zmlVec4 v1, zmlVec4 v2);
+extern __zml_floating	zmlMagnitudeVec4(zmlVec4 vec);
+extern zmlVec4		zmlNormalisedVec4(zmlVec4 vec);
+
+extern zmlMat3		zmlIdentityMat3(void);
+extern zmlMat3		zmlTransposedMat3(zmlMat3 mat);
+extern zmlMat3		zmlMultiplyMat3s_r(zmlMat3 v1, zmlMat3 v2);
+extern zmlVec3		zmlMultiplyVec3Mat3_r(zmlVec3 v1, zmlMat3 v2);
+
+extern zmlMat4		zmlIdentityMat4(void);
+extern zmlMat4		zmlTransposedMat4(zmlMat4 mat);
+extern zmlMat4		zmlMultiplyMat4s_r(zmlMat4 v1, zmlMat4 v2);
+extern zmlVec4		zmlMultiplyVec4Mat4_r(zmlVec4 v1, zmlMat4 v2);
+
+/**
+ * @brief get the inverse of a 3x3 matrix. If it is singular, a zero matrix is returned.
+ * 
+ * @param mat the matrix to invert.
+ */
+extern zmlMat3 zmlInvertedMat3(zmlMat3 mat);
+/**
+ * @brief get the inverse of a 4x4 matrix. If it is singular, a zero matrix is returned.
+ * See zmlInvertedAffineMat4() and zmlInvertedRigidMat4() for faster versions for transformation matrices.
+ * 
+ * @param mat the matrix to invert.
+ */
+extern zmlMat4 zmlInvertedMat4(zmlMat4 mat);
+/**
+ * @brief get the inverse of an affine 4x4 matrix, i.e. one whose fourth row is [ 0, 0, 0, 1 ], such as any combination of
+ * translations, rotations and scales. If it is singular, a zero matrix is returned.
+ * 
+ * @param mat the matrix to invert.
+ */
+extern zmlMat4 zmlInvertedAffineMat4(zmlMat4 mat);
+/**
+ * @brief get the inverse of a rigid 4x4 transformation (rotations and translations only, such as a view matrix from
+ * zmlConstructLookAtMat4RH()), by transposing the rotation and rotating the negated translation.
+ * The result is wrong if the matrix contains any scale.
+ * 
+ * @param mat the matrix to invert.
+ */
+extern zmlMat4 zmlInvertedRigidMat4(zmlMat4 mat);
+/**
+ * @brief get the determinant of a 3x3 matrix.
+ * 
+ * @param mat the specified matrix.
+ */
+extern __zml_floating zmlDeterminantMat3(zmlMat3 mat);
+/**
+ * @brief get the determinant of a 4x4 matrix.
+ * 
+ * @param mat the specified matrix.
+ */
+extern __zml_floating zmlDeterminantMat4(zmlMat4 mat);
+
+/**
+ * @brief allocate a zmlMatrix holding the same values as the given fixed-size matrix.
+ * 
+ * @param mat the matrix to copy.
+ */
+extern zmlMatrix zmlMat3ToMatrix(zmlMat3 mat);
+/**
+ * @brief allocate a zmlMatrix holding the same values as the given fixed-size matrix.
+ * 
+ * @param mat the matrix to copy.
+ */
+extern zmlMatrix zmlMat4ToMatrix(zmlMat4 mat);
+/**
+ * @brief copy the top-left 3x3 elements of mat into a fixed-size matrix. Elements that mat does not have are taken from the identity matrix.
+ * 
+ * @param mat the matrix to copy.
+ */
+extern zmlMat3 zmlMatrixToMat3(zmlMatrix mat);
+/**
+ * @brief copy the top-left 4x4 elements of mat into a fixed-size matrix. Elements that mat does not have are taken from the identity matrix.
+ * 
+ * @param mat the matrix to copy.
+ */
+extern zmlMat4 zmlMatrixToMat4(zmlMatrix mat);
+
+/**
+ * @brief fixed-size equivalent of zmlTranslated().
+ * 
+ * @param mat the matrix to base the translation matrix on.
+ * @param vec the vector to use as the translation factor.
+ */
+extern zmlMat4 zmlTranslatedMat4(zmlMat4 mat, zmlVec3 vec);
+/**
+ * @brief fixed-size equivalent of zmlTranslateIdentity().
+ * 
+ * @param vec the vector to use as the translation factor.
+ */
+extern zmlMat4 zmlTranslateIdentityMat4(zmlVec3 vec);
+
+/**
+ * @brief fixed-size equivalent of zmlRotated().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+extern zmlMat4 zmlRotatedMat4(zmlMat4 mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief fixed-size equivalent of zmlRotateIdentity().
+ * 
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+extern zmlMat4 zmlRotateIdentityMat4(__zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief fixed-size equivalent of zmlRotatedEuler().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+extern zmlMat4 zmlRotatedEulerMat4(zmlMat4 mat, zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief fixed-size equivalent of zmlRotateIdentityEuler().
+ * 
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+extern zmlMat4 zmlRotateIdentityEulerMat4(zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+
+/**
+ * @brief fixed-size equivalent of zmlScaled().
+ * 
+ * @param mat the matrix to base the scale matrix on.
+ * @param vec the vector to use as the scale factor.
+ */
+extern zmlMat4 zmlScaledMat4(zmlMat4 mat, zmlVec3 vec);
+/**
+ * @brief fixed-size equivalent of zmlScaleIdentity().
+ * 
+ * @param vec the vector to use as the scale factor.
+ */
+extern zmlMat4 zmlScaleIdentityMat4(zmlVec3 vec);
+
+/**
+ * @brief fixed-size equivalent of zmlConstructOrthoMatrixLH(). Uses left-handed coordinates!
+ * 
+ * @param lm the left-most boundary.
+ * @param rm the right-most boundary.
+ * @param bm the bottom-most boundary.
+ * @param tm the top-most boundary.
+ * @param zn the nearest Z coordinate that will be rendered.
+ * @param zf the farthest Z coordinate that will be rendered.
+ */
+extern zmlMat4 zmlConstructOrthoMat4LH(__zml_floating lm, __zml_floating rm, __zml_floating bm, __zml_floating tm, __zml_floating zn, __zml_floating zf);
+/**
+ * @brief fixed-size equivalent of zmlConstructOrthoMatrixRH(). Uses right-handed coordinates!
+ * 
+ * @param lm the left-most boundary.
+ * @param rm the right-most boundary.
+ * @param bm the bottom-most boundary.
+ * @param tm the top-most boundary.
+ * @param zn the nearest Z coordinate that will be rendered.
+ * @param zf the farthest Z coordinate that will be rendered.
+ */
+extern zmlMat4 zmlConstructOrthoMat4RH(__zml_floating lm, __zml_floating rm, __zml_floating bm, __zml_floating tm, __zml_floating zn, __zml_floating zf);
+
+/**
+ * @brief fixed-size equivalent of zmlConstructPerspectiveMatrixLH(). Uses left-handed coordinates!
+ * 
+ * @param near specifies the distance from the viewer to the nearest clipping plane.
+ * @param far specifies the distance from the viewer to the farthest clipping plane.
+ * @param fovy the angle of the field of view in the y direction.
+ * @param aspect_ratio the aspect ratio of the viewport.
+ */
+extern zmlMat4 zmlConstructPerspectiveMat4LH(__zml_floating near, __zml_floating far, __zml_floating fovy, __zml_floating aspect_ratio);
+/**
+ * @brief fixed-size equivalent of zmlConstructPerspectiveMatrixRH(). Uses right-handed coordinates!
+ * 
+ * @param near specifies the distance from the viewer to the nearest clipping plane.
+ * @param far specifies the distance from the viewer to the farthest clipping plane.
+ * @param fovy the angle of the field of view in the y direction.
+ * @param aspect_ratio the aspect ratio of the viewport.
+ */
+extern zmlMat4 zmlConstructPerspectiveMat4RH(__zml_floating near, __zml_floating far, __zml_floating fovy, __zml_floating aspect_ratio);
+
+/**
+ * @brief fixed-size equivalent of zmlConstructLookAtMatrixLH(). Uses left-handed coordinates!
+ * 
+ * @param pos the position of the viewer/camera.
+ * @param focus the position the viewer/camera is looking at.
+ * @param up an absolute unit vector indicating the up direction. If Y is the 'up' axis, set this to be ( 0, 1, 0 ), for example.
+ */
+extern zmlMat4 zmlConstructLookAtMat4LH(zmlVec3 pos, zmlVec3 focus, zmlVec3 up);
+/**
+ * @brief fixed-size equivalent of zmlConstructLookAtMatrixRH(). Uses right-handed coordinates!
+ * 
+ * @param pos the position of the viewer/camera.
+ * @param focus the position the viewer/camera is looking at.
+ * @param up an absolute unit vector indicating the up direction. If Y is the 'up' axis, set this to be ( 0, 1, 0 ), for example.
+ */
+extern zmlMat4 zmlConstructLookAtMat4RH(zmlVec3 pos, zmlVec3 focus, zmlVec3 up);
+
+// ==============================================================================
+// *****				   PUBLIC QUATERNION FUNCTIONALITY					*****
+// ==============================================================================
+
+/**
+ * @brief get the identity quaternion (no rotation).
+ * 
+ */
+extern zmlQuat zmlIdentityQuat(void);
+/**
+ * @brief multiply two quaternions (the Hamilton product). The result rotates by v2, then by v1.
+ * 
+ * @param v1 the first quaternion to operate on.
+ * @param v2 the second quaternion to operate on.
+ */
+extern zmlQuat zmlMultiplyQuats_r(zmlQuat v1, zmlQuat v2);
+/**
+ * @brief get the conjugate of a quaternion, which is its inverse if it is normalised.
+ * 
+ * @param q the quaternion to conjugate.
+ */
+extern zmlQuat zmlConjugateQuat(zmlQuat q);
+/**
+ * @brief get the inverse of a quaternion. For normalised quaternions, zmlConjugateQuat() is cheaper.
+ * 
+ * @param q the quaternion to invert.
+ */
+extern zmlQuat zmlInverseQuat(zmlQuat q);
+/**
+ * @brief get the dot product of two quaternions.
+ * 
+ * @param v1 the first quaternion to operate on.
+ * @param v2 the second quaternion to operate on.
+ */
+extern __zml_floating zmlDotQuat(zmlQuat v1, zmlQuat v2);
+/**
+ * @brief get the magnitude (length) of a quaternion.
+ * 
+ * @param q the specified quaternion.
+ */
+extern __zml_floating zmlMagnitudeQuat(zmlQuat q);
+/**
+ * @brief get a quaternion scaled to a magnitude of 1. A quaternion with a magnitude of 0 gives the identity quaternion.
+ * 
+ * @param q the quaternion to normalise.
+ */
+extern zmlQuat zmlNormalisedQuat(zmlQuat q);
+
+/**
+ * @brief linearly interpolate between two rotations and normalise the result, taking the shortest path.
+ * Cheaper than zmlSlerpQuat(), but the rotation doesn't move at a constant speed as t changes.
+ * 
+ * @param v1 the rotation at t = 0.
+ * @param v2 the rotation at t = 1.
+ * @param t the interpolation factor.
+ */
+extern zmlQuat zmlNlerpQuat(zmlQuat v1, zmlQuat v2, __zml_floating t);
+/**
+ * @brief spherically interpolate between two normalised rotations, taking the shortest path at a constant angular speed.
+ * 
+ * @param v1 the rotation at t = 0.
+ * @param v2 the rotation at t = 1.
+ * @param t the interpolation factor.
+ */
+extern zmlQuat zmlSlerpQuat(zmlQuat v1, zmlQuat v2, __zml_floating t);
+
+/**
+ * @brief get the quaternion of a rotation by angle about the given axis (the same rotation as zmlRotateIdentity()).
+ * 
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+extern zmlQuat zmlAxisAngleQuat(__zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief get the angle and (normalised) axis of the rotation of a quaternion.
+ * If there is no rotation, the angle is 0 and the axis is the X axis.
+ * 
+ * @param q the quaternion.
+ * @param angle the variable to write the angle into.
+ * @param axis the variable to write the axis into.
+ */
+extern void zmlQuatToAxisAngle(zmlQuat q, __zml_floating *angle, zmlVec3 *axis);
+/**
+ * @brief get the quaternion of a rotation by the Euler angles x, y and z (the same rotation as zmlRotateIdentityEuler()).
+ * 
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+extern zmlQuat zmlEulerQuat(zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+/**
+ * @brief get the Euler angles x, y and z of the rotation of a quaternion, for the given order (so that
+ * zmlEulerQuat(order, x, y, z) is the same rotation as q). The middle rotation's angle is in [-pi/2, pi/2], and the
+ * others are in [-pi, pi]. At gimbal lock (when the middle angle is +-pi/2), the first and last rotations are about the
+ * same axis, so the first angle is taken to be 0 and the last one gives the whole of their rotation.
+ * 
+ * @param q the rotation.
+ * @param order the order that the three rotations are applied in.
+ * @param x the variable to write the angle about the X axis into.
+ * @param y the variable to write the angle about the Y axis into.
+ * @param z the variable to write the angle about the Z axis into.
+ */
+extern void zmlQuatToEuler(zmlQuat q, zmlEulerOrder order, __zml_floating *x, __zml_floating *y, __zml_floating *z);
+
+/**
+ * @brief rotate a 3D vector by a normalised quaternion.
+ * 
+ * @param vec the vector to rotate.
+ * @param q the rotation.
+ */
+extern zmlVec3 zmlRotatedVec3(zmlVec3 vec, zmlQuat q);
+
+/**
+ * @brief get the 3x3 rotation matrix of a normalised quaternion.
+ * 
+ * @param q the rotation.
+ */
+extern zmlMat3 zmlQuatToMat3(zmlQuat q);
+/**
+ * @brief get the 4x4 rotation matrix of a normalised quaternion.
+ * 
+ * @param q the rotation.
+ */
+extern zmlMat4 zmlQuatToMat4(zmlQuat q);
+/**
+ * @brief allocate a 4x4 rotation matrix from a normalised quaternion.
+ * 
+ * @param q the rotation.
+ */
+extern zmlMatrix zmlQuatToMatrix(zmlQuat q);
+/**
+ * @brief get the rotation of a 3x3 rotation matrix as a quaternion.
+ * 
+ * @param mat the rotation matrix.
+ */
+extern zmlQuat zmlMat3ToQuat(zmlMat3 mat);
+/**
+ * @brief get the rotation in the upper-left 3x3 block of a 4x4 matrix as a quaternion. The block must have no scale or shear.
+ * 
+ * @param mat the rotation matrix.
+ */
+extern zmlQuat zmlMat4ToQuat(zmlMat4 mat);
+/**
+ * @brief get the rotation in the upper-left 3x3 block of a matrix (at least 3x3) as a quaternion. The block must have no scale or shear.
+ * 
+ * @param mat the rotation matrix.
+ */
+extern zmlQuat zmlMatrixToQuat(zmlMatrix mat);
+
+/**
+ * @brief apply the rotation of a normalised quaternion to mat, as with zmlRotatedMat4().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param q the rotation.
+ */
+extern zmlMat4 zmlRotatedMat4Quat(zmlMat4 mat, zmlQuat q);
+/**
+ * @brief apply the rotation of a normalised quaternion to a 4x4 matrix, as with zmlRotate().
+ * 
+ * @param mat the matrix to rotate.
+ * @param q the rotation.
+ */
+extern void zmlRotateQuat(zmlMatrix *mat, zmlQuat q);
+
+// ==============================================================================
+// *****				   PUBLIC BATCH FUNCTIONALITY						*****
+// ==============================================================================
+
+/**
+ * @brief transform an array of points, stored as interleaved x, y, z triples, by a matrix (as with zmlMultiplyVec4Mat4_r()).
+ * Every point's w is taken to be 1, and the w of the result is discarded (no perspective divide is done).
+ * 
+ * @param mat the transformation matrix.
+ * @param in the points to transform (3 * count values).
+ * @param out the array to write the transformed points into (3 * count values). May be the same array as in.
+ * @param count the number of points.
+ */
+extern void zmlTransformPoints(const zmlMat4 *mat, const __zml_floating *in, __zml_floating *out, size_t count);
+/**
+ * @brief transform an array of points, stored as interleaved x, y, z, w quadruples, by a matrix (as with zmlMultiplyVec4Mat4_r()).
+ * 
+ * @param mat the transformation matrix.
+ * @param in the points to transform (4 * count values).
+ * @param out the array to write the transformed points into (4 * count values). May be the same array as in.
+ * @param count the number of points.
+ */
+extern void zmlTransformPoints4(const zmlMat4 *mat, const __zml_floating *in, __zml_floating *out, size_t count);
+/**
+ * @brief transform an array of points stored as separate arrays of x, y and z coordinates (Structure-of-Arrays) by a matrix.
+ * Every point's w is taken to be 1, and the w of the result is discarded (no perspective divide is done).
+ * 
+ * @param mat the transformation matrix.
+ * @param x, y, z the coordinates of the points to transform (count values each).
+ * @param outx, outy, outz the arrays to write the coordinates of the transformed points into. Each may be the same array as any input.
+ * @param count the number of points.
+ */
+extern void zmlTransformPointsSoA(const zmlMat4 *mat, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	__zml_floating *outx, __zml_floating *outy, __zml_floating *outz, size_t count);
+
+/**
+ * @brief spherically interpolate between two arrays of normalised rotations, as with zmlSlerpQuat().
+ * 
+ * @param v1 the rotations at t = 0 (count quaternions).
+ * @param v2 the rotations at t = 1 (count quaternions).
+ * @param t the interpolation factor.
+ * @param out the array to write the interpolated rotations into (count quaternions). May be the same array as v1 or v2.
+ * @param count the number of rotations.
+ */
+extern void zmlSlerpQuats(const zmlQuat *v1, const zmlQuat *v2, __zml_floating t, zmlQuat *out, size_t count);
+
+/**
+ * @brief multiply arrays of matrices pairwise: out[i] = a[i] * b[i] (as with zmlMultiplyMat4s_r()).
+ * out may be the same array as a or b.
+ * 
+ * @param a the first matrix of each product (count matrices).
+ * @param b the second matrix of each product (count matrices).
+ * @param out the array to store the results in (count matrices).
+ * @param count the number of products.
+ */
+extern void zmlMultiplyMat4Batch(const zmlMat4 *a, const zmlMat4 *b, zmlMat4 *out, size_t count);
+/**
+ * @brief multiply a strided batch of matrices: the ith product multiplies the matrices at a + i * astride and b + i * bstride
+ * (as with zmlMultiplyMat4s_r()) and stores the result at out + i * outstride, where the strides are in bytes. This lets the
+ * matrices be members of larger structures (such as the nodes of a scene graph), and a stride of 0 uses the same matrix for
+ * every product (such as a parent's transform applied to each of its children).
+ * out[i] may be the same matrix as a[i] or b[i], but must not overlap any other input.
+ * 
+ * @param a the first matrix of the first product.
+ * @param astride the distance, in bytes, between the first matrices of successive products.
+ * @param b the second matrix of the first product.
+ * @param bstride the distance, in bytes, between the second matrices of successive products.
+ * @param out where to store the first result.
+ * @param outstride the distance, in bytes, between successive results.
+ * @param count the number of products.
+ */
+extern void zmlMultiplyMat4BatchStrided(const zmlMat4 *a, size_t astride, const zmlMat4 *b, size_t bstride, zmlMat4 *out, size_t outstride, size_t count);
+
+/**
+ * @brief construct an array of look-at matrices (as with zmlConstructLookAtMat4LH()), and optionally their inverses, from
+ * separate arrays of coordinates. Uses left-handed coordinates!
+ * 
+ * @param posx, posy, posz the positions of the viewers/cameras (count values each).
+ * @param focusx, focusy, focusz the positions the viewers/cameras are looking at (count values each).
+ * @param upx, upy, upz the absolute unit vectors indicating each camera's up direction (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+extern void zmlConstructLookAtMat4sLH(const __zml_floating *posx, const __zml_floating *posy, const __zml_floating *posz,
+	const __zml_floating *focusx, const __zml_floating *focusy, const __zml_floating *focusz,
+	const __zml_floating *upx, const __zml_floating *upy, const __zml_floating *upz, zmlMat4 *out, zmlMat4 *inverse, size_t count);
+/**
+ * @brief construct an array of look-at matrices (as with zmlConstructLookAtMat4RH()), and optionally their inverses, from
+ * separate arrays of coordinates. Uses right-handed coordinates!
+ * 
+ * @param posx, posy, posz the positions of the viewers/cameras (count values each).
+ * @param focusx, focusy, focusz the positions the viewers/cameras are looking at (count values each).
+ * @param upx, upy, upz the absolute unit vectors indicating each camera's up direction (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+extern void zmlConstructLookAtMat4sRH(const __zml_floating *posx, const __zml_floating *posy, const __zml_floating *posz,
+	const __zml_floating *focusx, const __zml_floating *focusy, const __zml_floating *focusz,
+	const __zml_floating *upx, const __zml_floating *upy, const __zml_floating *upz, zmlMat4 *out, zmlMat4 *inverse, size_t count);
+
+/**
+ * @brief construct an array of perspective projection matrices (as with zmlConstructPerspectiveMat4LH()), and optionally
+ * their inverses. Uses left-handed coordinates!
+ * 
+ * @param near the distance from each viewer to the nearest clipping plane (count values).
+ * @param far the distance from each viewer to the farthest clipping plane (count values).
+ * @param fovy the angle of each field of view in the y direction (count values).
+ * @param aspect_ratio the aspect ratio of each viewport (count values).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+extern void zmlConstructPerspectiveMat4sLH(const __zml_floating *near, const __zml_floating *far, const __zml_floating *fovy,
+	const __zml_floating *aspect_ratio, zmlMat4 *out, zmlMat4 *inverse, size_t count);
+/**
+ * @brief construct an array of perspective projection matrices (as with zmlConstructPerspectiveMat4RH()), and optionally
+ * their inverses. Uses right-handed coordinates!
+ * 
+ * @param near the distance from each viewer to the nearest clipping plane (count values).
+ * @param far the distance from each viewer to the farthest clipping plane (count values).
+ * @param fovy the angle of each field of view in the y direction (count values).
+ * @param aspect_ratio the aspect ratio of each viewport (count values).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+extern void zmlConstructPerspectiveMat4sRH(const __zml_floating *near, const __zml_floating *far, const __zml_floating *fovy,
+	const __zml_floating *aspect_ratio, zmlMat4 *out, zmlMat4 *inverse, size_t count);
+
+/**
+ * @brief construct an array of orthographic projection matrices (as with zmlConstructOrthoMat4LH()), and optionally their
+ * inverses. Uses left-handed coordinates!
+ * 
+ * @param lm, rm the left-most and right-most boundaries (count values each).
+ * @param bm, tm the bottom-most and top-most boundaries (count values each).
+ * @param zn, zf the nearest and farthest Z coordinates that will be rendered (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+extern void zmlConstructOrthoMat4sLH(const __zml_floating *lm, const __zml_floating *rm, const __zml_floating *bm,
+	const __zml_floating *tm, const __zml_floating *zn, const __zml_floating *zf, zmlMat4 *out, zmlMat4 *inverse, size_t count);
+/**
+ * @brief construct an array of orthographic projection matrices (as with zmlConstructOrthoMat4RH()), and optionally their
+ * inverses. Uses right-handed coordinates!
+ * 
+ * @param lm, rm the left-most and right-most boundaries (count values each).
+ * @param bm, tm the bottom-most and top-most boundaries (count values each).
+ * @param zn, zf the nearest and farthest Z coordinates that will be rendered (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+extern void zmlConstructOrthoMat4sRH(const __zml_floating *lm, const __zml_floating *rm, const __zml_floating *bm,
+	const __zml_floating *tm, const __zml_floating *zn, const __zml_floating *zf, zmlMat4 *out, zmlMat4 *inverse, size_t count);
+
+/**
+ * @brief combine arrays of projection and view matrices into view-projection matrices (projection * view), and optionally
+ * their inverses (view inverse * projection inverse). As with zmlMultiplyMat4BatchStrided(), the strides are in bytes, and
+ * a stride of 0 uses the same matrix for every view: the 6 faces of a cubemap share one projection, for example, and the
+ * cascades of a shadow map share one view.
+ * 
+ * @param proj the first projection matrix.
+ * @param projinverse the inverse of the first projection matrix (see zmlConstructPerspectiveMat4sRH()), at the same stride as proj.
+ * @param projstride the distance, in bytes, between successive projection matrices (and their inverses).
+ * @param view the first view matrix.
+ * @param viewinverse the inverse of the first view matrix (see zmlConstructLookAtMat4sRH()), at the same stride as view.
+ * @param viewstride the distance, in bytes, between successive view matrices (and their inverses).
+ * @param viewproj the array to write the view-projection matrices into (count matrices).
+ * @param inverse the array to write the inverse of each view-projection matrix into (count matrices), or NULL if they aren't
+ * needed. If projinverse or viewinverse is NULL, these are found with zmlInvertedMat4() instead.
+ * @param count the number of view-projection matrices.
+ */
+extern void zmlCombineViewProjectionMat4s(const zmlMat4 *proj, const zmlMat4 *projinverse, size_t projstride,
+	const zmlMat4 *view, const zmlMat4 *viewinverse, size_t viewstride, zmlMat4 *viewproj, zmlMat4 *inverse, size_t count);
+
+// ==============================================================================
+// *****				   PUBLIC HIERARCHY FUNCTIONALITY					*****
+// ==============================================================================
+
+/**
+ * @brief create an empty transform hierarchy: a set of nodes, each with a local transform relative to its parent, whose
+ * world transforms (parent's world * local) are kept up to date by zmlUpdateHierarchy().
+ * Returns NULL if there wasn't enough memory.
+ * 
+ * @param capacity the number of nodes to make room for (more can be added regardless).
+ */
+extern zmlHierarchy *zmlCreateHierarchy(unsigned int capacity);
+/**
+ * @brief free a transform hierarchy and all of its nodes.
+ * 
+ * @param h the hierarchy to destroy.
+ */
+extern void zmlDestroyHierarchy(zmlHierarchy *h);
+
+/**
+ * @brief add a node to a transform hierarchy, returning its handle (handles are given out in order, starting from 0).
+ * Its world transform is calculated by the next zmlUpdateHierarchy(). Returns ZML_NO_PARENT if the parent doesn't exist
+ * or there wasn't enough memory.
+ * 
+ * @param h the hierarchy to add the node to.
+ * @param parent the handle of the node's parent, or ZML_NO_PARENT to add a root node.
+ * @param local the node's transform relative to its parent.
+ */
+extern unsigned int zmlAddHierarchyNode(zmlHierarchy *h, unsigned int parent, zmlMat4 local);
+/**
+ * @brief set the local transform of a node in a transform hierarchy. The world transforms of it and every node below it
+ * are recalculated by the next zmlUpdateHierarchy().
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ * @param local the node's new transform relative to its parent.
+ */
+extern void zmlSetHierarchyLocal(zmlHierarchy *h, unsigned int node, zmlMat4 local);
+
+/**
+ * @brief get the local transform of a node in a transform hierarchy.
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ */
+extern zmlMat4 zmlGetHierarchyLocal(const zmlHierarchy *h, unsigned int node);
+/**
+ * @brief get the world transform of a node in a transform hierarchy, as of the last zmlUpdateHierarchy().
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ */
+extern zmlMat4 zmlGetHierarchyWorld(const zmlHierarchy *h, unsigned int node);
+/**
+ * @brief copy the world transforms of every node in a transform hierarchy (as of the last zmlUpdateHierarchy()) into out,
+ * in order of handle.
+ * 
+ * @param h the hierarchy.
+ * @param out the array to copy the transforms into (one for each node, see zmlGetHierarchySize()).
+ */
+extern void zmlCopyHierarchyWorlds(const zmlHierarchy *h, zmlMat4 *out);
+/**
+ * @brief get the parent of a node in a transform hierarchy (ZML_NO_PARENT if it is a root).
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ */
+extern unsigned int zmlGetHierarchyParent(const zmlHierarchy *h, unsigned int node);
+/**
+ * @brief get the number of nodes in a transform hierarchy.
+ * 
+ * @param h the hierarchy.
+ */
+extern unsigned int zmlGetHierarchySize(const zmlHierarchy *h);
+
+/**
+ * @brief recalculate the world transforms of every node in a transform hierarchy whose local transform, or that of any node
+ * above it, has changed since the last update (and of nodes that have been added). Large updates are split across threads.
+ * Returns the number of nodes whose world transforms were recalculated.
+ * 
+ * @param h the hierarchy to update.
+ */
+extern unsigned int zmlUpdateHierarchy(zmlHierarchy *h);
+
+// ==============================================================================
+// *****				   PUBLIC CULLING FUNCTIONALITY						*****
+// ==============================================================================
+
+/**
+ * @brief construct a view frustum from a view-projection matrix (projection * view, as built by zmlConstructPerspectiveMat4LH()
+ * or zmlConstructOrthoMat4RH() and the like, multiplied by a view matrix). The planes are in world space; to cull in
+ * another space (such as an object's local space), pass projection * view * model instead.
+ * 
+ * @param viewproj the view-projection matrix.
+ */
+extern zmlFrustum zmlConstructFrustum(zmlMat4 viewproj);
+
+/**
+ * @brief check whether a sphere is (at least partly) inside a frustum.
+ * 
+ * @param f the frustum.
+ * @param centre the centre of the sphere.
+ * @param radius the radius of the sphere.
+ */
+extern unsigned char zmlSphereInFrustum(const zmlFrustum *f, zmlVec3 centre, __zml_floating radius);
+/**
+ * @brief check whether an axis-aligned bounding box is (at least partly) inside a frustum.
+ * 
+ * @param f the frustum.
+ * @param centre the centre of the box.
+ * @param extents the half-extents of the box (half its size along each axis).
+ */
+extern unsigned char zmlAABBInFrustum(const zmlFrustum *f, zmlVec3 centre, zmlVec3 extents);
+
+/**
+ * @brief test an array of bounding spheres, stored as separate arrays of centre coordinates and radii (Structure-of-Arrays),
+ * against a frustum, as with zmlSphereInFrustum(). Returns the number of spheres that are visible.
+ * 
+ * @param f the frustum.
+ * @param x, y, z the coordinates of the centres of the spheres (count values each).
+ * @param radius the radii of the spheres (count values).
+ * @param visible the array to write the results into (count values): 1 for each sphere that is at least partly inside the frustum, otherwise 0.
+ * @param count the number of spheres.
+ */
+extern size_t zmlCullSpheres(const zmlFrustum *f, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	const __zml_floating *radius, unsigned char *visible, size_t count);
+/**
+ * @brief test an array of axis-aligned bounding boxes, stored as separate arrays of centre coordinates and half-extents
+ * (Structure-of-Arrays), against a frustum, as with zmlAABBInFrustum(). Returns the number of boxes that are visible.
+ * 
+ * @param f the frustum.
+ * @param cx, cy, cz the coordinates of the centres of the boxes (count values each).
+ * @param ex, ey, ez the half-extents of the boxes along each axis (count values each).
+ * @param visible the array to write the results into (count values): 1 for each box that is at least partly inside the frustum, otherwise 0.
+ * @param count the number of boxes.
+ */
+extern size_t zmlCullAABBs(const zmlFrustum *f, const __zml_floating *cx, const __zml_floating *cy, const __zml_floating *cz,
+	const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez, unsigned char *visible, size_t count);
+
+/**
+ * @brief transform an array of axis-aligned bounding boxes, stored as separate arrays of centre coordinates and half-extents
+ * (Structure-of-Arrays), by a matrix, giving the smallest axis-aligned boxes that contain the transformed boxes. The centres
+ * are transformed as points, and each new half-extent is the sum of the old ones weighted by the absolute values of the
+ * matrix's row (so the boxes grow as they are rotated). No perspective divide is done.
+ * 
+ * @param mat the transformation matrix (such as an object's model matrix).
+ * @param cx, cy, cz the coordinates of the centres of the boxes (count values each).
+ * @param ex, ey, ez the half-extents of the boxes along each axis (count values each).
+ * @param outcx, outcy, outcz the arrays to write the centres of the transformed boxes into. Each may be the same array as any of cx, cy and cz.
+ * @param outex, outey, outez the arrays to write the half-extents of the transformed boxes into. Each may be the same array as any of ex, ey and ez.
+ * @param count the number of boxes.
+ */
+extern void zmlTransformAABBs(const zmlMat4 *mat, const __zml_floating *cx, const __zml_floating *cy, const __zml_floating *cz,
+	const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez,
+	__zml_floating *outcx, __zml_floating *outcy, __zml_floating *outcz, __zml_floating *outex, __zml_floating *outey, __zml_floating *outez,
+	size_t count);
+
+// ==============================================================================
+// *****			   PUBLIC FLOAT AND DOUBLE ARRAY FUNCTIONALITY				*****
+// ==============================================================================
+
+// -------------------------------------------
+// Functions on plain arrays of floats (f suffix) and doubles (d suffix).
+// These are built into the library whatever __zml_floating is, so big arrays can be kept in floats (halving the memory
+// traffic of the bulk operations on them) while sums that need the precision are done in doubles.
+// dst may be the same array as a or b. Big arrays are split across threads.
+// -------------------------------------------
+
+extern void			zmlAddArraysf(float *dst, const float *a, const float *b, size_t n);
+extern void			zmlSubtractArraysf(float *dst, const float *a, const float *b, size_t n);
+extern void			zmlMultiplyArraysf(float *dst, const float *a, const float *b, size_t n);
+extern void			zmlDivideArraysf(float *dst, const float *a, const float *b, size_t n);
+extern void			zmlAddArrayScalarf(float *dst, const float *a, float s, size_t n);
+extern void			zmlSubtractArrayScalarf(float *dst, const float *a, float s, size_t n);
+extern void			zmlMultiplyArrayScalarf(float *dst, const float *a, float s, size_t n);
+extern void			zmlDivideArrayScalarf(float *dst, const float *a, float s, size_t n);
+
+extern void			zmlAddArraysd(double *dst, const double *a, const double *b, size_t n);
+extern void			zmlSubtractArraysd(double *dst, const double *a, const double *b, size_t n);
+extern void			zmlMultiplyArraysd(double *dst, const double *a, const double *b, size_t n);
+extern void			zmlDivideArraysd(double *dst, const double *a, const double *b, size_t n);
+extern void			zmlAddArrayScalard(double *dst, const double *a, double s, size_t n);
+extern void			zmlSubtractArrayScalard(double *dst, const double *a, double s, size_t n);
+extern void			zmlMultiplyArrayScalard(double *dst, const double *a, double s, size_t n);
+extern void			zmlDivideArrayScalard(double *dst, const double *a, double s, size_t n);
+
+/**
+ * @brief y += alpha * x, for arrays of floats.
+ * 
+ * @param y the array to add onto (n values).
+ * @param alpha the factor to multiply x by.
+ * @param x the array to add (n values).
+ * @param n the number of values in each array.
+ */
+extern void zmlAxpyf(float *y, float alpha, const float *x, size_t n);
+/**
+ * @brief y += alpha * x, for arrays of doubles.
+ * 
+ * @param y the array to add onto (n values).
+ * @param alpha the factor to multiply x by.
+ * @param x the array to add (n values).
+ * @param n the number of values in each array.
+ */
+extern void zmlAxpyd(double *y, double alpha, const double *x, size_t n);
+
+/**
+ * @brief return the dot product of two arrays of floats, accumulated in double.
+ * 
+ * @param a the first array (n values).
+ * @param b the second array (n values).
+ * @param n the number of values in each array.
+ */
+extern double zmlDotf(const float *a, const float *b, size_t n);
+/**
+ * @brief return the dot product of two arrays of doubles.
+ * 
+ * @param a the first array (n values).
+ * @param b the second array (n values).
+ * @param n the number of values in each array.
+ */
+extern double zmlDotd(const double *a, const double *b, size_t n);
+
+/**
+ * @brief return the sum of an array of floats, accumulated in double.
+ * 
+ * @param a the array (n values).
+ * @param n the number of values in the array.
+ */
+extern double zmlSumf(const float *a, size_t n);
+/**
+ * @brief return the sum of an array of doubles.
+ * 
+ * @param a the array (n values).
+ * @param n the number of values in the array.
+ */
+extern double zmlSumd(const double *a, size_t n);
+
+/**
+ * @brief convert an array of floats to doubles.
+ * 
+ * @param dst the array to write the doubles into (n values).
+ * @param src the floats to convert (n values).
+ * @param n the number of values.
+ */
+extern void zmlFloatsToDoubles(double *dst, const float *src, size_t n);
+/**
+ * @brief convert an array of doubles to floats (rounding each to the nearest float).
+ * 
+ * @param dst the array to write the floats into (n values).
+ * @param src the doubles to convert (n values).
+ * @param n the number of values.
+ */
+extern void zmlDoublesToFloats(float *dst, const double *src, size_t n);
+
+/**
+ * @brief allocate a vector holding the values of an array of floats (converted to __zml_floating).
+ * 
+ * @param arr the values of the vector.
+ * @param size the number of values.
+ */
+extern zmlVector zmlVectorFromArrayf(const float *arr, unsigned int size);
+/**
+ * @brief allocate a vector holding the values of an array of doubles (converted to __zml_floating).
+ * 
+ * @param arr the values of the vector.
+ * @param size the number of values.
+ */
+extern zmlVector zmlVectorFromArrayd(const double *arr, unsigned int size);
+
+/**
+ * @brief copy the elements of a vector into an array of floats.
+ * 
+ * @param vec the vector to copy from.
+ * @param arr the array to copy into (vec.size values).
+ */
+extern void zmlCopyVectorElementsf(zmlVector vec, float *arr);
+/**
+ * @brief copy the elements of a vector into an array of doubles.
+ * 
+ * @param vec the vector to copy from.
+ * @param arr the array to copy into (vec.size values).
+ */
+extern void zmlCopyVectorElementsd(zmlVector vec, double *arr);
+
+// -------------------------------------------
+// Vectors and matrices of floats and doubles (zmlVectorf, zmlVectord, zmlMatrixf and zmlMatrixd), which are also there
+// whatever __zml_floating is. Their products use the array functions above, so sums are done in doubles; matrices of
+// either type can also be multiplied with zmlGemmf() and zmlGemmd().
+// -------------------------------------------
+
+/**
+ * @brief allocate a vector of floats. Elements are NOT initialised!
+ * 
+ * @param size the number of elements.
+ */
+extern zmlVectorf zmlAllocVectorf(unsigned int size);
+/**
+ * @brief allocate a vector of doubles. Elements are NOT initialised!
+ * 
+ * @param size the number of elements.
+ */
+extern zmlVectord zmlAllocVectord(unsigned int size);
+/**
+ * @brief free a vector of floats.
+ * 
+ * @param vec the vector to free.
+ */
+extern void zmlFreeVectorf(zmlVectorf *vec);
+/**
+ * @brief free a vector of doubles.
+ * 
+ * @param vec the vector to free.
+ */
+extern void zmlFreeVectord(zmlVectord *vec);
+
+/**
+ * @brief allocate a matrix of floats. Elements are NOT initialised!
+ * 
+ * @param rows the number of rows.
+ * @param cols the number of columns.
+ */
+extern zmlMatrixf zmlAllocMatrixf(unsigned int rows, unsigned int cols);
+/**
+ * @brief allocate a matrix of doubles. Elements are NOT initialised!
+ * 
+ * @param rows the number of rows.
+ * @param cols the number of columns.
+ */
+extern zmlMatrixd zmlAllocMatrixd(unsigned int rows, unsigned int cols);
+/**
+ * @brief free a matrix of floats.
+ * 
+ * @param mat the matrix to free.
+ */
+extern void zmlFreeMatrixf(zmlMatrixf *mat);
+/**
+ * @brief free a matrix of doubles.
+ * 
+ * @param mat the matrix to free.
+ */
+extern void zmlFreeMatrixd(zmlMatrixd *mat);
+
+/**
+ * @brief allocate a vector of floats holding the values of vec.
+ * 
+ * @param vec the vector to convert.
+ */
+extern zmlVectorf zmlVectorToFloats(zmlVector vec);
+/**
+ * @brief allocate a vector of doubles holding the values of vec.
+ * 
+ * @param vec the vector to convert.
+ */
+extern zmlVectord zmlVectorToDoubles(zmlVector vec);
+/**
+ * @brief allocate a vector holding the values of a vector of floats (converted to __zml_floating).
+ * 
+ * @param vec the vector to convert.
+ */
+extern zmlVector zmlVectorFromFloats(zmlVectorf vec);
+/**
+ * @brief allocate a vector holding the values of a vector of doubles (converted to __zml_floating).
+ * 
+ * @param vec the vector to convert.
+ */
+extern zmlVector zmlVectorFromDoubles(zmlVectord vec);
+
+/**
+ * @brief allocate a matrix of floats holding the values of mat.
+ * 
+ * @param mat the matrix to convert.
+ */
+extern zmlMatrixf zmlMatrixToFloats(zmlMatrix mat);
+/**
+ * @brief allocate a matrix of doubles holding the values of mat.
+ * 
+ * @param mat the matrix to convert.
+ */
+extern zmlMatrixd zmlMatrixToDoubles(zmlMatrix mat);
+/**
+ * @brief allocate a matrix holding the values of a matrix of floats (converted to __zml_floating).
+ * 
+ * @param mat the matrix to convert.
+ */
+extern zmlMatrix zmlMatrixFromFloats(zmlMatrixf mat);
+/**
+ * @brief allocate a matrix holding the values of a matrix of doubles (converted to __zml_floating).
+ * 
+ * @param mat the matrix to convert.
+ */
+extern zmlMatrix zmlMatrixFromDoubles(zmlMatrixd mat);
+
+/**
+ * @brief return the dot product of two vectors of floats, accumulated in double (0 if they are different sizes).
+ * 
+ * @param v1 the first vector.
+ * @param v2 the second vector.
+ */
+extern double zmlDotVecsf(zmlVectorf v1, zmlVectorf v2);
+/**
+ * @brief return the dot product of two vectors of doubles (0 if they are different sizes).
+ * 
+ * @param v1 the first vector.
+ * @param v2 the second vector.
+ */
+extern double zmlDotVecsd(zmlVectord v1, zmlVectord v2);
+
+/**
+ * @brief y += alpha * x, for vectors of floats of the same size.
+ * 
+ * @param y the vector to add onto.
+ * @param alpha the factor to multiply x by.
+ * @param x the vector to add.
+ */
+extern void zmlAxpyVecf(zmlVectorf *y, float alpha, zmlVectorf x);
+/**
+ * @brief y += alpha * x, for vectors of doubles of the same size.
+ * 
+ * @param y the vector to add onto.
+ * @param alpha the factor to multiply x by.
+ * @param x the vector to add.
+ */
+extern void zmlAxpyVecd(zmlVectord *y, double alpha, zmlVectord x);
+
+/**
+ * @brief dst = mat * vec, for a matrix and vector of floats, with each element accumulated in double.
+ * dst must already be allocated with as many elements as mat has rows, and must not be vec.
+ * 
+ * @param dst the vector to store the result in.
+ * @param mat the matrix.
+ * @param vec the vector (as many elements as mat has columns).
+ */
+extern void zmlMultiplyMatVecIntof(zmlVectorf *dst, zmlMatrixf mat, zmlVectorf vec);
+/**
+ * @brief dst = mat * vec, for a matrix and vector of doubles.
+ * dst must already be allocated with as many elements as mat has rows, and must not be vec.
+ * 
+ * @param dst the vector to store the result in.
+ * @param mat the matrix.
+ * @param vec the vector (as many elements as mat has columns).
+ */
+extern void zmlMultiplyMatVecIntod(zmlVectord *dst, zmlMatrixd mat, zmlVectord vec);
+
 #ifdef __cplusplus
 }
 #endif
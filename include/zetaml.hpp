@@ -0,0 +1,1773 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#pragma once
+#ifndef __ZETAML_HPP__
+#define __ZETAML_HPP__
+
+#include "zetaml.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// ==============================================================================
+// C++ expression layer over zmlVector and zmlMatrix (requires C++11).
+// Element-wise arithmetic on zml::vector and zml::matrix (and on existing zmlVectors and zmlMatrices, through zml::ref())
+// doesn't compute anything straight away: it builds a small expression object that records the operation. The whole
+// expression is evaluated when it's assigned to a vector or matrix, in a single loop that computes every operator for one
+// element before moving on to the next. So
+//
+//		zml::vector next = x + v * dt + 0.5 * a * dt * dt;
+//
+// makes one allocation and one pass over x, v and a, where the same chain of _r functions would make one of each per operator.
+// Expressions hold pointers to the vectors and matrices they read, so they must not outlive them.
+// ==============================================================================
+
+// the evaluation loop of an expression has no dependencies between elements, even when it writes over its own operands.
+#if defined(__clang__)
+#	define _ZML_SIMD_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#	define _ZML_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#	define _ZML_SIMD_LOOP
+#endif
+
+namespace zml {
+
+typedef __zml_floating scalar;
+
+namespace detail {
+
+// the size of a scalar operand, which fits an expression of any size.
+static const std::size_t anySize = (std::size_t) -1;
+
+// base of every expression type E: an expression has rows(), cols() and at(row, col).
+template <typename E>
+struct expr {
+	const E &self() const {
+		return static_cast<const E &>(*this);
+	}
+};
+
+// a vector or matrix being read.
+struct leaf : expr<leaf> {
+	const scalar *data;
+	std::size_t stride;
+	std::size_t nrows;
+	std::size_t ncols;
+
+	leaf(const scalar *data, std::size_t stride, std::size_t rows, std::size_t cols) : data(data), stride(stride), nrows(rows), ncols(cols) {}
+	leaf(const zmlVector &vec) : data(vec.elements), stride(vec.size), nrows(1), ncols(vec.size) {}
+	leaf(const zmlMatrix &mat) : data(mat.data), stride(mat.stride), nrows(mat.rows), ncols(mat.cols) {}
+
+	std::size_t rows() const { return nrows; }
+	std::size_t cols() const { return ncols; }
+	scalar at(std::size_t row, std::size_t col) const { return data[row * stride + col]; }
+};
+
+// a scalar operand.
+struct constant : expr<constant> {
+	scalar value;
+
+	explicit constant(scalar value) : value(value) {}
+
+	std::size_t rows() const { return anySize; }
+	std::size_t cols() const { return anySize; }
+	scalar at(std::size_t, std::size_t) const { return value; }
+};
+
+// the type an operand is held as inside an expression: vectors and matrices are read through a leaf (rather than copied),
+// and everything else is held by value.
+template <typename E> struct operand { typedef E type; };
+
+// the size of a binary expression along one dimension, from those of its operands.
+inline std::size_t combinedSize(std::size_t a, std::size_t b) {
+	return (a < b) ? a : b;
+}
+inline bool sizesMatch(std::size_t a, std::size_t b) {
+	return a == b || a == anySize || b == anySize;
+}
+
+// l (op) r, element by element.
+template <typename Op, typename L, typename R>
+struct binary : expr<binary<Op, L, R> > {
+	L l;
+	R r;
+
+	binary(const L &l, const R &r) : l(l), r(r) {
+		if (!sizesMatch(l.rows(), r.rows()) || !sizesMatch(l.cols(), r.cols())) {
+			std::printf("zetaml: %s: operands must be the same size! the result only covers their overlap!\n", Op::name());
+		}
+	}
+
+	std::size_t rows() const { return combinedSize(l.rows(), r.rows()); }
+	std::size_t cols() const { return combinedSize(l.cols(), r.cols()); }
+	scalar at(std::size_t row, std::size_t col) const { return Op::apply(l.at(row, col), r.at(row, col)); }
+};
+
+// -e, element by element.
+template <typename E>
+struct negate : expr<negate<E> > {
+	E e;
+
+	explicit negate(const E &e) : e(e) {}
+
+	std::size_t rows() const { return e.rows(); }
+	std::size_t cols() const { return e.cols(); }
+	scalar at(std::size_t row, std::size_t col) const { return -e.at(row, col); }
+};
+
+// element-wise operations, on any element type (they're also used by zml::vec and zml::mat).
+struct add { template <typename T> static T apply(T a, T b) { return a + b; } static const char *name() { return "zml::operator+()"; } };
+struct subtract { template <typename T> static T apply(T a, T b) { return a - b; } static const char *name() { return "zml::operator-()"; } };
+struct multiply { template <typename T> static T apply(T a, T b) { return a * b; } static const char *name() { return "zml::operator*()"; } };
+struct divide { template <typename T> static T apply(T a, T b) { return a / b; } static const char *name() { return "zml::operator/()"; } };
+
+// write the rows x cols expression e into out (rows stride elements apart), one row at a time.
+template <typename E>
+inline void evaluate(const E &e, scalar *out, std::size_t stride, std::size_t rows, std::size_t cols) {
+	for (std::size_t row = 0; row < rows; row++) {
+		scalar *dst = out + row * stride;
+		_ZML_SIMD_LOOP
+		for (std::size_t col = 0; col < cols; col++) {
+			dst[col] = e.at(row, col);
+		}
+	}
+}
+
+} // namespace detail
+
+// -------------------------------------------
+// vectors
+// -------------------------------------------
+
+/**
+ * @brief A zmlVector that frees itself, and that element-wise arithmetic can be done on with operators (see above).
+ * The underlying zmlVector is available as .get(), so it can still be passed to any zml function.
+ * 
+ */
+class vector : public detail::expr<vector> {
+public:
+	vector() : vec(ZML_NULL_VECTOR) {}
+	/**
+	 * @brief allocate a vector of the given size. Elements are NOT initialised!
+	 * 
+	 * @param size the size of the vector.
+	 */
+	explicit vector(unsigned int size) : vec(zmlAllocVector(size)) {}
+	vector(const vector &other) : vec(zmlCopyVector(const_cast<zmlVector *>(&other.vec))) {}
+	vector(vector &&other) : vec(other.vec) {
+		other.vec = ZML_NULL_VECTOR;
+	}
+	/**
+	 * @brief allocate a vector holding the result of an expression, evaluating it in one pass.
+	 * 
+	 * @param e the expression to evaluate.
+	 */
+	template <typename E>
+	vector(const detail::expr<E> &e) : vec(ZML_NULL_VECTOR) {
+		assign(e.self());
+	}
+	~vector() {
+		zmlFreeVector(&vec);
+	}
+
+	/**
+	 * @brief take ownership of an existing zmlVector, which the vector will free.
+	 * 
+	 * @param vec the vector to take.
+	 */
+	static vector adopt(zmlVector vec) {
+		vector r;
+		r.vec = vec;
+		return r;
+	}
+	/**
+	 * @brief give up ownership of the underlying zmlVector, which must then be freed with zmlFreeVector(). The vector is left empty.
+	 * 
+	 */
+	zmlVector release() {
+		zmlVector r = vec;
+		vec = ZML_NULL_VECTOR;
+		return r;
+	}
+
+	vector &operator=(const vector &other) {
+		if (this != &other) {
+			assign(detail::leaf(other.vec));
+		}
+		return *this;
+	}
+	vector &operator=(vector &&other) {
+		if (this != &other) {
+			zmlFreeVector(&vec);
+			vec = other.vec;
+			other.vec = ZML_NULL_VECTOR;
+		}
+		return *this;
+	}
+	/**
+	 * @brief evaluate an expression into the vector. If the vector is already the right size its elements are overwritten in place
+	 * (which is safe even if the expression reads the vector itself); otherwise it is reallocated.
+	 * 
+	 * @param e the expression to evaluate.
+	 */
+	template <typename E>
+	vector &operator=(const detail::expr<E> &e) {
+		assign(e.self());
+		return *this;
+	}
+
+	template <typename E> vector &operator+=(const detail::expr<E> &e);
+	template <typename E> vector &operator-=(const detail::expr<E> &e);
+	template <typename E> vector &operator*=(const detail::expr<E> &e);
+	template <typename E> vector &operator/=(const detail::expr<E> &e);
+	vector &operator+=(scalar s);
+	vector &operator-=(scalar s);
+	vector &operator*=(scalar s);
+	vector &operator/=(scalar s);
+
+	unsigned int size() const { return vec.size; }
+	scalar *data() { return vec.elements; }
+	const scalar *data() const { return vec.elements; }
+	scalar &operator[](unsigned int i) { return vec.elements[i]; }
+	const scalar &operator[](unsigned int i) const { return vec.elements[i]; }
+
+	zmlVector &get() { return vec; }
+	const zmlVector &get() const { return vec; }
+
+	// (expression interface: a vector is one row)
+	std::size_t rows() const { return 1; }
+	std::size_t cols() const { return vec.size; }
+	scalar at(std::size_t, std::size_t col) const { return vec.elements[col]; }
+
+private:
+	zmlVector vec;
+
+	template <typename E>
+	void assign(const E &e) {
+		if (e.rows() != 1 || e.cols() == detail::anySize) {
+			std::printf("zetaml: zml::vector: only single-row expressions of a known size can be assigned to a vector! vector left unchanged!\n");
+			return;
+		}
+
+		const unsigned int size = (unsigned int) e.cols();
+		if (vec.size == size && vec.elements) {
+			detail::evaluate(e, vec.elements, size, 1, size);
+			return;
+		}
+
+		// (the old elements may be read by the expression, so they're only freed once it's been evaluated)
+		zmlVector r = zmlAllocVector(size);
+		detail::evaluate(e, r.elements, size, 1, size);
+		zmlFreeVector(&vec);
+		vec = r;
+	}
+};
+
+/**
+ * @brief A reference to an existing zmlVector that expressions can be evaluated into, and read from. See zml::ref().
+ * 
+ */
+class vectorRef : public detail::expr<vectorRef> {
+public:
+	explicit vectorRef(zmlVector &vec) : vec(&vec) {}
+
+	/**
+	 * @brief evaluate an expression into the referenced vector, in place. The expression must be the same size as the vector.
+	 * 
+	 * @param e the expression to evaluate.
+	 */
+	template <typename E>
+	vectorRef &operator=(const detail::expr<E> &e) {
+		const E &x = e.self();
+		if (x.rows() != 1 || !detail::sizesMatch(x.cols(), vec->size)) {
+			std::printf("zetaml: zml::vectorRef: expression is not the same size as the vector! vector left unchanged!\n");
+			return *this;
+		}
+		detail::evaluate(x, vec->elements, vec->size, 1, vec->size);
+		return *this;
+	}
+	vectorRef &operator=(const vectorRef &other) {
+		return *this = detail::leaf(*other.vec);
+	}
+
+	template <typename E> vectorRef &operator+=(const detail::expr<E> &e);
+	template <typename E> vectorRef &operator-=(const detail::expr<E> &e);
+	template <typename E> vectorRef &operator*=(const detail::expr<E> &e);
+	template <typename E> vectorRef &operator/=(const detail::expr<E> &e);
+	vectorRef &operator+=(scalar s);
+	vectorRef &operator-=(scalar s);
+	vectorRef &operator*=(scalar s);
+	vectorRef &operator/=(scalar s);
+
+	const zmlVector &get() const { return *vec; }
+
+	std::size_t rows() const { return 1; }
+	std::size_t cols() const { return vec->size; }
+	scalar at(std::size_t, std::size_t col) const { return vec->elements[col]; }
+
+private:
+	zmlVector *vec;
+};
+
+// -------------------------------------------
+// matrices
+// -------------------------------------------
+
+/**
+ * @brief A zmlMatrix that frees itself, and that element-wise arithmetic can be done on with operators (see above).
+ * As with the C functions, * and / between two matrices are element-wise; use zmlMultiplyMats() or zmlGemm() on .get() for the matrix product.
+ * 
+ */
+class matrix : public detail::expr<matrix> {
+public:
+	matrix() : mat(ZML_NULL_MATRIX) {}
+	/**
+	 * @brief allocate a matrix of the given size. Elements are NOT initialised!
+	 * 
+	 * @param rows the number of rows.
+	 * @param cols the number of columns.
+	 */
+	matrix(unsigned int rows, unsigned int cols) : mat(zmlAllocMatrix(rows, cols)) {}
+	matrix(const matrix &other) : mat(zmlCopyMatrix(const_cast<zmlMatrix *>(&other.mat))) {}
+	matrix(matrix &&other) : mat(other.mat) {
+		other.mat = ZML_NULL_MATRIX;
+	}
+	/**
+	 * @brief allocate a matrix holding the result of an expression, evaluating it in one pass.
+	 * 
+	 * @param e the expression to evaluate.
+	 */
+	template <typename E>
+	matrix(const detail::expr<E> &e) : mat(ZML_NULL_MATRIX) {
+		assign(e.self());
+	}
+	~matrix() {
+		zmlFreeMatrix(&mat);
+	}
+
+	/**
+	 * @brief take ownership of an existing zmlMatrix, which the matrix will free.
+	 * 
+	 * @param mat the matrix to take.
+	 */
+	static matrix adopt(zmlMatrix mat) {
+		matrix r;
+		r.mat = mat;
+		return r;
+	}
+	/**
+	 * @brief give up ownership of the underlying zmlMatrix, which must then be freed with zmlFreeMatrix(). The matrix is left empty.
+	 * 
+	 */
+	zmlMatrix release() {
+		zmlMatrix r = mat;
+		mat = ZML_NULL_MATRIX;
+		return r;
+	}
+
+	matrix &operator=(const matrix &other) {
+		if (this != &other) {
+			assign(detail::leaf(other.mat));
+		}
+		return *this;
+	}
+	matrix &operator=(matrix &&other) {
+		if (this != &other) {
+			zmlFreeMatrix(&mat);
+			mat = other.mat;
+			other.mat = ZML_NULL_MATRIX;
+		}
+		return *this;
+	}
+	/**
+	 * @brief evaluate an expression into the matrix. If the matrix is already the right size its elements are overwritten in place
+	 * (which is safe even if the expression reads the matrix itself); otherwise it is reallocated.
+	 * 
+	 * @param e the expression to evaluate.
+	 */
+	template <typename E>
+	matrix &operator=(const detail::expr<E> &e) {
+		assign(e.self());
+		return *this;
+	}
+
+	template <typename E> matrix &operator+=(const detail::expr<E> &e);
+	template <typename E> matrix &operator-=(const detail::expr<E> &e);
+	template <typename E> matrix &operator*=(const detail::expr<E> &e);
+	template <typename E> matrix &operator/=(const detail::expr<E> &e);
+	matrix &operator+=(scalar s);
+	matrix &operator-=(scalar s);
+	matrix &operator*=(scalar s);
+	matrix &operator/=(scalar s);
+
+	scalar &operator()(unsigned int row, unsigned int col) { return mat.data[(std::size_t) row * mat.stride + col]; }
+	const scalar &operator()(unsigned int row, unsigned int col) const { return mat.data[(std::size_t) row * mat.stride + col]; }
+
+	zmlMatrix &get() { return mat; }
+	const zmlMatrix &get() const { return mat; }
+
+	// (expression interface)
+	std::size_t rows() const { return mat.rows; }
+	std::size_t cols() const { return mat.cols; }
+	scalar at(std::size_t row, std::size_t col) const { return mat.data[row * mat.stride + col]; }
+
+private:
+	zmlMatrix mat;
+
+	template <typename E>
+	void assign(const E &e) {
+		if (e.rows() == detail::anySize || e.cols() == detail::anySize) {
+			std::printf("zetaml: zml::matrix: only expressions of a known size can be assigned to a matrix! matrix left unchanged!\n");
+			return;
+		}
+
+		const unsigned int rows = (unsigned int) e.rows(), cols = (unsigned int) e.cols();
+		if (mat.rows == rows && mat.cols == cols && mat.data) {
+			detail::evaluate(e, mat.data, mat.stride, rows, cols);
+			return;
+		}
+
+		zmlMatrix r = zmlAllocMatrix(rows, cols);
+		detail::evaluate(e, r.data, r.stride, rows, cols);
+		zmlFreeMatrix(&mat);
+		mat = r;
+	}
+};
+
+/**
+ * @brief A reference to an existing zmlMatrix that expressions can be evaluated into, and read from. See zml::ref().
+ * 
+ */
+class matrixRef : public detail::expr<matrixRef> {
+public:
+	explicit matrixRef(zmlMatrix &mat) : mat(&mat) {}
+
+	/**
+	 * @brief evaluate an expression into the referenced matrix, in place. The expression must be the same size as the matrix.
+	 * 
+	 * @param e the expression to evaluate.
+	 */
+	template <typename E>
+	matrixRef &operator=(const detail::expr<E> &e) {
+		const E &x = e.self();
+		if (!detail::sizesMatch(x.rows(), mat->rows) || !detail::sizesMatch(x.cols(), mat->cols)) {
+			std::printf("zetaml: zml::matrixRef: expression is not the same size as the matrix! matrix left unchanged!\n");
+			return *this;
+		}
+		detail::evaluate(x, mat->data, mat->stride, mat->rows, mat->cols);
+		return *this;
+	}
+	matrixRef &operator=(const matrixRef &other) {
+		return *this = detail::leaf(*other.mat);
+	}
+
+	template <typename E> matrixRef &operator+=(const detail::expr<E> &e);
+	template <typename E> matrixRef &operator-=(const detail::expr<E> &e);
+	template <typename E> matrixRef &operator*=(const detail::expr<E> &e);
+	template <typename E> matrixRef &operator/=(const detail::expr<E> &e);
+	matrixRef &operator+=(scalar s);
+	matrixRef &operator-=(scalar s);
+	matrixRef &operator*=(scalar s);
+	matrixRef &operator/=(scalar s);
+
+	const zmlMatrix &get() const { return *mat; }
+
+	std::size_t rows() const { return mat->rows; }
+	std::size_t cols() const { return mat->cols; }
+	scalar at(std::size_t row, std::size_t col) const { return mat->data[row * mat->stride + col]; }
+
+private:
+	zmlMatrix *mat;
+};
+
+/**
+ * @brief use an existing zmlVector or zmlMatrix in expressions. A non-const one can also be assigned to, which evaluates the expression
+ * into its elements in place, e.g. zml::ref(pos) = zml::ref(pos) + zml::ref(vel) * dt, or zml::ref(pos) += zml::ref(vel) * dt.
+ * 
+ * @param x the vector or matrix to refer to.
+ */
+inline vectorRef ref(zmlVector &x) { return vectorRef(x); }
+inline detail::leaf ref(const zmlVector &x) { return detail::leaf(x); }
+inline matrixRef ref(zmlMatrix &x) { return matrixRef(x); }
+inline detail::leaf ref(const zmlMatrix &x) { return detail::leaf(x); }
+
+namespace detail {
+
+// vectors and matrices (owned or referenced) are read through a leaf.
+template <> struct operand<vector> { typedef leaf type; };
+template <> struct operand<vectorRef> { typedef leaf type; };
+template <> struct operand<matrix> { typedef leaf type; };
+template <> struct operand<matrixRef> { typedef leaf type; };
+
+template <typename E> inline const E &operandOf(const E &e) { return e; }
+inline leaf operandOf(const vector &x) { return leaf(x.get()); }
+inline leaf operandOf(const vectorRef &x) { return leaf(x.get()); }
+inline leaf operandOf(const matrix &x) { return leaf(x.get()); }
+inline leaf operandOf(const matrixRef &x) { return leaf(x.get()); }
+
+// -------------------------------------------
+// operators
+// (these are in zml::detail with the expression types, which is where argument-dependent lookup finds them)
+// -------------------------------------------
+
+// define an element-wise operator between two expressions, and between an expression and a scalar (on either side).
+#define _ZML_DEFINE_OPERATOR(sym, op) \
+	template <typename L, typename R> \
+	inline binary<op, typename operand<L>::type, typename operand<R>::type> operator sym(const expr<L> &l, const expr<R> &r) { \
+		return binary<op, typename operand<L>::type, typename operand<R>::type>(operandOf(l.self()), operandOf(r.self())); \
+	} \
+	template <typename L> \
+	inline binary<op, typename operand<L>::type, constant> operator sym(const expr<L> &l, scalar r) { \
+		return binary<op, typename operand<L>::type, constant>(operandOf(l.self()), constant(r)); \
+	} \
+	template <typename R> \
+	inline binary<op, constant, typename operand<R>::type> operator sym(scalar l, const expr<R> &r) { \
+		return binary<op, constant, typename operand<R>::type>(constant(l), operandOf(r.self())); \
+	}
+
+_ZML_DEFINE_OPERATOR(+, add)
+_ZML_DEFINE_OPERATOR(-, subtract)
+_ZML_DEFINE_OPERATOR(*, multiply)
+_ZML_DEFINE_OPERATOR(/, divide)
+
+#undef _ZML_DEFINE_OPERATOR
+
+template <typename E>
+inline negate<typename operand<E>::type> operator-(const expr<E> &e) {
+	return negate<typename operand<E>::type>(operandOf(e.self()));
+}
+
+} // namespace detail
+
+// compound assignments evaluate in place, e.g. x += v * dt is one pass over x and v.
+#define _ZML_DEFINE_COMPOUND(type, sym) \
+	template <typename E> inline type &type::operator sym##=(const detail::expr<E> &e) { return *this = *this sym e; } \
+	inline type &type::operator sym##=(scalar s) { return *this = *this sym s; }
+
+_ZML_DEFINE_COMPOUND(vector, +)
+_ZML_DEFINE_COMPOUND(vector, -)
+_ZML_DEFINE_COMPOUND(vector, *)
+_ZML_DEFINE_COMPOUND(vector, /)
+_ZML_DEFINE_COMPOUND(matrix, +)
+_ZML_DEFINE_COMPOUND(matrix, -)
+_ZML_DEFINE_COMPOUND(matrix, *)
+_ZML_DEFINE_COMPOUND(matrix, /)
+_ZML_DEFINE_COMPOUND(vectorRef, +)
+_ZML_DEFINE_COMPOUND(vectorRef, -)
+_ZML_DEFINE_COMPOUND(vectorRef, *)
+_ZML_DEFINE_COMPOUND(vectorRef, /)
+_ZML_DEFINE_COMPOUND(matrixRef, +)
+_ZML_DEFINE_COMPOUND(matrixRef, -)
+_ZML_DEFINE_COMPOUND(matrixRef, *)
+_ZML_DEFINE_COMPOUND(matrixRef, /)
+
+#undef _ZML_DEFINE_COMPOUND
+
+} // namespace zml
+
+// ==============================================================================
+// Compile-time-sized vectors and matrices (requires C++11).
+// zml::vec<N, T> and zml::mat<R, C, T> hold their elements by value, and are templated on their element type as well as their
+// size: T can be float, double or zml::half (a 16-bit float), whichever __zml_floating the library itself was built with, so
+// different precisions can be mixed in one program. Since their sizes are known at compile time, every loop over their
+// elements is unrolled, and operations on them compile down to straight-line code.
+// They're laid out like the C fixed-size types (vec<2, 3 or 4> is a zmlVec2, 3 or 4 and mat<3, 3> and mat<4, 4> are a zmlMat3
+// and zmlMat4 when T is zml::scalar, and matrices are row-major), and convert to and from them implicitly.
+// ==============================================================================
+
+namespace zml {
+
+/**
+ * @brief A 16-bit (IEEE 754 binary16) floating value. zml::half is only a storage format: arithmetic on it is done in float.
+ * 
+ */
+struct half {
+	std::uint16_t bits;
+
+	half() = default;
+	half(float f) : bits(fromFloat(f)) {}
+
+	operator float() const { return toFloat(bits); }
+
+	/**
+	 * @brief make a half from its bit pattern.
+	 *
+	 * @param bits the sign (bit 15), exponent (bits 10-14) and mantissa (bits 0-9) of the value.
+	 */
+	static half fromBits(std::uint16_t bits) {
+		half r;
+		r.bits = bits;
+		return r;
+	}
+
+private:
+	// round f to the nearest half (ties to even).
+	static std::uint16_t fromFloat(float f) {
+		std::uint32_t x;
+		std::memcpy(&x, &f, sizeof(x));
+		const std::uint16_t sign = (std::uint16_t) ((x >> 16) & 0x8000);
+		std::uint32_t abs = x & 0x7fffffff;
+
+		// infinity and NaN (which stays a NaN)
+		if (abs >= 0x7f800000) {
+			return (std::uint16_t) (sign | 0x7c00 | ((abs > 0x7f800000) ? 0x200 : 0));
+		}
+		// too large for a half: rounds to infinity
+		if (abs >= 0x477ff000) {
+			return (std::uint16_t) (sign | 0x7c00);
+		}
+		// too small for a normal half: adding 0.5 lines the half's subnormal mantissa up with the bottom of the float's,
+		// and the addition itself does the rounding.
+		if (abs < 0x38800000) {
+			float a, magic = 0.5f;
+			std::memcpy(&a, &abs, sizeof(a));
+			a += magic;
+			std::uint32_t m;
+			std::memcpy(&m, &a, sizeof(m));
+			std::memcpy(&abs, &magic, sizeof(abs));
+			return (std::uint16_t) (sign | (m - abs));
+		}
+		// normal: rebias the exponent and round the 13 bits that are dropped from the mantissa
+		abs += ((std::uint32_t) (15 - 127) << 23) + 0xfff + ((abs >> 13) & 1);
+		return (std::uint16_t) (sign | (abs >> 13));
+	}
+
+	static float toFloat(std::uint16_t h) {
+		const std::uint32_t sign = (std::uint32_t) (h & 0x8000) << 16;
+		const std::uint32_t exponent = (h >> 10) & 0x1f;
+		const std::uint32_t mantissa = h & 0x3ff;
+
+		std::uint32_t x;
+		if (exponent == 0) {
+			// zero or subnormal (mantissa * 2^-24)
+			float f = (float) mantissa * 5.9604644775390625e-8f;
+			std::memcpy(&x, &f, sizeof(x));
+			x |= sign;
+		} else if (exponent == 0x1f) {
+			// infinity or NaN
+			x = sign | 0x7f800000 | (mantissa << 13);
+		} else {
+			x = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+		}
+
+		float f;
+		std::memcpy(&f, &x, sizeof(f));
+		return f;
+	}
+};
+
+template <std::size_t N, typename T = scalar> struct vec;
+template <std::size_t R, std::size_t C, typename T = scalar> struct mat;
+
+namespace detail {
+
+// the type that arithmetic on elements of type T is done in (zml::half is computed with as a float).
+template <typename T> struct compute { typedef T type; };
+template <> struct compute<half> { typedef float type; };
+
+// call f(i) for every i in [begin, end), unrolled at compile time. The range is split in half at each level, so the recursion is
+// only log2(end - begin) deep.
+template <std::size_t begin, std::size_t end, std::size_t count = end - begin>
+struct unroll {
+	template <typename F> static void apply(F &f) {
+		unroll<begin, begin + count / 2>::apply(f);
+		unroll<begin + count / 2, end>::apply(f);
+	}
+};
+template <std::size_t begin, std::size_t end>
+struct unroll<begin, end, 1> {
+	template <typename F> static void apply(F &f) { f(begin); }
+};
+template <std::size_t begin, std::size_t end>
+struct unroll<begin, end, 0> {
+	template <typename F> static void apply(F &) {}
+};
+template <std::size_t count, typename F>
+inline void unrolled(F f) {
+	unroll<0, count>::apply(f);
+}
+
+// dst[i] = a[i] (op) b[i], for the count elements of fixed-size vectors and matrices. dst may be a or b.
+template <typename Op, std::size_t count, typename T>
+inline void elementwise(T *dst, const T *a, const T *b) {
+	typedef typename compute<T>::type C;
+	unrolled<count>([&](std::size_t i) { dst[i] = T(Op::apply(C(a[i]), C(b[i]))); });
+}
+// dst[i] = a[i] (op) s
+template <typename Op, std::size_t count, typename T>
+inline void elementwise(T *dst, const T *a, typename compute<T>::type s) {
+	typedef typename compute<T>::type C;
+	unrolled<count>([&](std::size_t i) { dst[i] = T(Op::apply(C(a[i]), s)); });
+}
+// dst[i] = s (op) a[i]
+template <typename Op, std::size_t count, typename T>
+inline void elementwise(T *dst, typename compute<T>::type s, const T *a) {
+	typedef typename compute<T>::type C;
+	unrolled<count>([&](std::size_t i) { dst[i] = T(Op::apply(s, C(a[i]))); });
+}
+
+// comparisons done by the comparison operators of fixed-size vectors and matrices.
+struct equal { template <typename T> static bool apply(T a, T b) { return a == b; } };
+struct greater { template <typename T> static bool apply(T a, T b) { return a > b; } };
+struct greaterEqual { template <typename T> static bool apply(T a, T b) { return a >= b; } };
+struct less { template <typename T> static bool apply(T a, T b) { return a < b; } };
+struct lessEqual { template <typename T> static bool apply(T a, T b) { return a <= b; } };
+
+// true if a[i] (op) b[i] for every one of the count elements.
+template <typename Op, std::size_t count, typename T>
+inline bool all(const T *a, const T *b) {
+	typedef typename compute<T>::type C;
+	bool r = true;
+	unrolled<count>([&](std::size_t i) { r &= Op::apply(C(a[i]), C(b[i])); });
+	return r;
+}
+// true if a[i] (op) s for every one of the count elements.
+template <typename Op, std::size_t count, typename T>
+inline bool all(const T *a, typename compute<T>::type s) {
+	typedef typename compute<T>::type C;
+	bool r = true;
+	unrolled<count>([&](std::size_t i) { r &= Op::apply(C(a[i]), s); });
+	return r;
+}
+
+// convert the count elements of src to the element type of dst.
+template <std::size_t count, typename T, typename U>
+inline void convert(T *dst, const U *src) {
+	typedef typename compute<U>::type C;
+	unrolled<count>([&](std::size_t i) { dst[i] = T(C(src[i])); });
+}
+
+// the C fixed-size type that a fixed-size vector or matrix is laid out like (none, for sizes and element types that the
+// C API doesn't have).
+struct none {};
+template <std::size_t R, std::size_t C, typename T> struct cType { typedef none type; };
+template <> struct cType<1, 2, scalar> { typedef zmlVec2 type; };
+template <> struct cType<1, 3, scalar> { typedef zmlVec3 type; };
+template <> struct cType<1, 4, scalar> { typedef zmlVec4 type; };
+template <> struct cType<3, 3, scalar> { typedef zmlMat3 type; };
+template <> struct cType<4, 4, scalar> { typedef zmlMat4 type; };
+
+} // namespace detail
+
+/**
+ * @brief An N-dimensional vector of elements of type T, stored by value.
+ * 
+ */
+template <std::size_t N, typename T>
+struct vec {
+	T elements[N];
+
+	static const std::size_t size = N;
+
+	// (like the C types, elements are left uninitialised unless the vector is value-initialised, e.g. zml::vec<3> v{})
+	vec() = default;
+
+	/**
+	 * @brief construct a vector from one value per element.
+	 *
+	 */
+	template <typename... A>
+	vec(T first, A... rest) : elements{ first, T(rest)... } {
+		static_assert(sizeof...(A) + 1 == N, "zml::vec: one value must be given for each element");
+	}
+
+	/**
+	 * @brief convert a vector of another element type.
+	 *
+	 * @param v the vector to convert.
+	 */
+	template <typename U>
+	explicit vec(const vec<N, U> &v) {
+		detail::convert<N>(elements, v.elements);
+	}
+
+	// conversions to and from the C type with the same layout.
+	vec(const typename detail::cType<1, N, T>::type &v) {
+		std::memcpy(elements, v.elements, sizeof(elements));
+	}
+	operator typename detail::cType<1, N, T>::type() const {
+		typename detail::cType<1, N, T>::type r;
+		std::memcpy(r.elements, elements, sizeof(elements));
+		return r;
+	}
+
+	/**
+	 * @brief return a vector with every element set to 0.
+	 *
+	 */
+	static vec zero() {
+		return filled((typename detail::compute<T>::type) 0);
+	}
+
+	/**
+	 * @brief return a vector with every element set to val. Fixed-size equivalent of zmlConstructVectorDefault().
+	 *
+	 * @param val the value of every element.
+	 */
+	static vec filled(typename detail::compute<T>::type val) {
+		vec r;
+		detail::unrolled<N>([&](std::size_t i) { r.elements[i] = T(val); });
+		return r;
+	}
+
+	/**
+	 * @brief copy the first N elements of a zmlVector into a fixed-size vector. Elements that vec does not have are set to 0.
+	 *
+	 * @param vec the vector to copy.
+	 */
+	static vec from(const zmlVector &v) {
+		vec r;
+		detail::unrolled<N>([&](std::size_t i) { r.elements[i] = (i < v.size) ? T(v.elements[i]) : T(0.0f); });
+		return r;
+	}
+
+	/**
+	 * @brief allocate a zmlVector holding the same values as this vector (which must be freed with zmlFreeVector()).
+	 *
+	 */
+	zmlVector toVector() const {
+		zmlVector r = zmlAllocVector(N);
+		detail::unrolled<N>([&](std::size_t i) { r.elements[i] = (__zml_floating) (typename detail::compute<T>::type) elements[i]; });
+		return r;
+	}
+
+	T *data() { return elements; }
+	const T *data() const { return elements; }
+
+	T &operator[](std::size_t i) { return elements[i]; }
+	const T &operator[](std::size_t i) const { return elements[i]; }
+};
+
+/**
+ * @brief An R x C matrix of elements of type T, stored by value in row-major order.
+ * 
+ */
+template <std::size_t R, std::size_t C, typename T>
+struct mat {
+	T elements[R][C];
+
+	static const std::size_t rows = R;
+	static const std::size_t cols = C;
+
+	// (like the C types, elements are left uninitialised unless the matrix is value-initialised, e.g. zml::mat<4, 4> m{})
+	mat() = default;
+
+	/**
+	 * @brief construct a matrix from one value per element, in row-major order.
+	 *
+	 */
+	template <typename... A>
+	mat(T first, A... rest) {
+		static_assert(sizeof...(A) + 1 == R * C, "zml::mat: one value must be given for each element");
+		const T values[R * C] = { first, T(rest)... };
+		std::memcpy(elements, values, sizeof(elements));
+	}
+
+	/**
+	 * @brief convert a matrix of another element type.
+	 *
+	 * @param m the matrix to convert.
+	 */
+	template <typename U>
+	explicit mat(const mat<R, C, U> &m) {
+		detail::convert<R * C>(&elements[0][0], &m.elements[0][0]);
+	}
+
+	// conversions to and from the C type with the same layout.
+	mat(const typename detail::cType<R, C, T>::type &m) {
+		std::memcpy(elements, m.elements, sizeof(elements));
+	}
+	operator typename detail::cType<R, C, T>::type() const {
+		typename detail::cType<R, C, T>::type r;
+		std::memcpy(r.elements, elements, sizeof(elements));
+		return r;
+	}
+
+	/**
+	 * @brief return a matrix with every element set to 0. Fixed-size equivalent of zmlZeroMatrix().
+	 *
+	 */
+	static mat zero() {
+		mat r;
+		detail::unrolled<R * C>([&](std::size_t i) { r.data()[i] = T(0.0f); });
+		return r;
+	}
+
+	/**
+	 * @brief return an identity matrix. Fixed-size equivalent of zmlIdentityMatrix().
+	 *
+	 */
+	static mat identity() {
+		mat r;
+		detail::unrolled<R * C>([&](std::size_t i) { r.data()[i] = T((i / C == i % C) ? 1.0f : 0.0f); });
+		return r;
+	}
+
+	/**
+	 * @brief copy the top-left R x C elements of a zmlMatrix into a fixed-size matrix. Elements that mat does not have are taken
+	 * from the identity matrix.
+	 *
+	 * @param m the matrix to copy.
+	 */
+	static mat from(const zmlMatrix &m) {
+		mat r = identity();
+		for (std::size_t row = 0; row < R && row < m.rows; row++) {
+			for (std::size_t col = 0; col < C && col < m.cols; col++) {
+				r.elements[row][col] = T(m.data[row * m.stride + col]);
+			}
+		}
+		return r;
+	}
+
+	/**
+	 * @brief allocate a zmlMatrix holding the same values as this matrix (which must be freed with zmlFreeMatrix()).
+	 *
+	 */
+	zmlMatrix toMatrix() const {
+		zmlMatrix r = zmlAllocMatrix(R, C);
+		detail::unrolled<R * C>([&](std::size_t i) {
+			r.data[(i / C) * r.stride + i % C] = (__zml_floating) (typename detail::compute<T>::type) elements[i / C][i % C];
+		});
+		return r;
+	}
+
+	T *data() { return &elements[0][0]; }
+	const T *data() const { return &elements[0][0]; }
+
+	// m[row][col]
+	T *operator[](std::size_t row) { return elements[row]; }
+	const T *operator[](std::size_t row) const { return elements[row]; }
+};
+
+typedef vec<2, float> vec2f;
+typedef vec<3, float> vec3f;
+typedef vec<4, float> vec4f;
+typedef vec<2, double> vec2d;
+typedef vec<3, double> vec3d;
+typedef vec<4, double> vec4d;
+typedef vec<2, half> vec2h;
+typedef vec<3, half> vec3h;
+typedef vec<4, half> vec4h;
+typedef mat<3, 3, float> mat3f;
+typedef mat<4, 4, float> mat4f;
+typedef mat<3, 3, double> mat3d;
+typedef mat<4, 4, double> mat4d;
+
+// -------------------------------------------
+// element-wise operators
+// (vectors have all four between each other; matrices only add and subtract element-wise, since their * is the matrix product)
+// -------------------------------------------
+
+#define _ZML_DEFINE_FIXED_OPERATOR(cls, params, count, sym, op) \
+	template <params> \
+	inline cls operator sym(const cls &a, const cls &b) { \
+		cls r; \
+		detail::elementwise<op, count>(r.data(), a.data(), b.data()); \
+		return r; \
+	} \
+	template <params> \
+	inline cls &operator sym##=(cls &a, const cls &b) { \
+		detail::elementwise<op, count>(a.data(), a.data(), b.data()); \
+		return a; \
+	}
+#define _ZML_DEFINE_FIXED_SCALAR_OPERATOR(cls, params, count, sym, op) \
+	template <params> \
+	inline cls operator sym(const cls &a, typename detail::compute<T>::type s) { \
+		cls r; \
+		detail::elementwise<op, count>(r.data(), a.data(), s); \
+		return r; \
+	} \
+	template <params> \
+	inline cls operator sym(typename detail::compute<T>::type s, const cls &a) { \
+		cls r; \
+		detail::elementwise<op, count>(r.data(), s, a.data()); \
+		return r; \
+	} \
+	template <params> \
+	inline cls &operator sym##=(cls &a, typename detail::compute<T>::type s) { \
+		detail::elementwise<op, count>(a.data(), a.data(), s); \
+		return a; \
+	}
+
+// (the template parameter lists contain commas, so they are passed through these)
+#define _ZML_VEC vec<N, T>
+#define _ZML_VEC_PARAMS std::size_t N, typename T
+#define _ZML_MAT mat<R, C, T>
+#define _ZML_MAT_PARAMS std::size_t R, std::size_t C, typename T
+
+_ZML_DEFINE_FIXED_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, +, detail::add)
+_ZML_DEFINE_FIXED_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, -, detail::subtract)
+_ZML_DEFINE_FIXED_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, *, detail::multiply)
+_ZML_DEFINE_FIXED_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, /, detail::divide)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, +, detail::add)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, -, detail::subtract)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, *, detail::multiply)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_VEC, _ZML_VEC_PARAMS, N, /, detail::divide)
+
+_ZML_DEFINE_FIXED_OPERATOR(_ZML_MAT, _ZML_MAT_PARAMS, R * C, +, detail::add)
+_ZML_DEFINE_FIXED_OPERATOR(_ZML_MAT, _ZML_MAT_PARAMS, R * C, -, detail::subtract)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_MAT, _ZML_MAT_PARAMS, R * C, +, detail::add)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_MAT, _ZML_MAT_PARAMS, R * C, -, detail::subtract)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_MAT, _ZML_MAT_PARAMS, R * C, *, detail::multiply)
+_ZML_DEFINE_FIXED_SCALAR_OPERATOR(_ZML_MAT, _ZML_MAT_PARAMS, R * C, /, detail::divide)
+
+#undef _ZML_DEFINE_FIXED_OPERATOR
+#undef _ZML_DEFINE_FIXED_SCALAR_OPERATOR
+
+template <std::size_t N, typename T>
+inline vec<N, T> operator-(const vec<N, T> &v) {
+	return (typename detail::compute<T>::type) 0 - v;
+}
+template <std::size_t R, std::size_t C, typename T>
+inline mat<R, C, T> operator-(const mat<R, C, T> &m) {
+	return (typename detail::compute<T>::type) 0 - m;
+}
+
+// -------------------------------------------
+// comparisons
+// (each is true if it is true for every element, as with zmlVecEquals() etc.; a != b is !(a == b))
+// -------------------------------------------
+
+#define _ZML_DEFINE_FIXED_COMPARISON(cls, params, count, sym, op) \
+	template <params> \
+	inline bool operator sym(const cls &a, const cls &b) { \
+		return detail::all<op, count>(a.data(), b.data()); \
+	} \
+	template <params> \
+	inline bool operator sym(const cls &a, typename detail::compute<T>::type s) { \
+		return detail::all<op, count>(a.data(), s); \
+	}
+
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_VEC, _ZML_VEC_PARAMS, N, ==, detail::equal)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_VEC, _ZML_VEC_PARAMS, N, >, detail::greater)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_VEC, _ZML_VEC_PARAMS, N, >=, detail::greaterEqual)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_VEC, _ZML_VEC_PARAMS, N, <, detail::less)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_VEC, _ZML_VEC_PARAMS, N, <=, detail::lessEqual)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_MAT, _ZML_MAT_PARAMS, R * C, ==, detail::equal)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_MAT, _ZML_MAT_PARAMS, R * C, >, detail::greater)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_MAT, _ZML_MAT_PARAMS, R * C, >=, detail::greaterEqual)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_MAT, _ZML_MAT_PARAMS, R * C, <, detail::less)
+_ZML_DEFINE_FIXED_COMPARISON(_ZML_MAT, _ZML_MAT_PARAMS, R * C, <=, detail::lessEqual)
+
+#undef _ZML_DEFINE_FIXED_COMPARISON
+#undef _ZML_VEC
+#undef _ZML_VEC_PARAMS
+#undef _ZML_MAT
+#undef _ZML_MAT_PARAMS
+
+template <std::size_t N, typename T>
+inline bool operator!=(const vec<N, T> &a, const vec<N, T> &b) { return !(a == b); }
+template <std::size_t R, std::size_t C, typename T>
+inline bool operator!=(const mat<R, C, T> &a, const mat<R, C, T> &b) { return !(a == b); }
+
+// -------------------------------------------
+// vector functions
+// -------------------------------------------
+
+/**
+ * @brief return the dot product of two vectors.
+ * 
+ * @param a the first vector.
+ * @param b the second vector.
+ */
+template <std::size_t N, typename T>
+inline typename detail::compute<T>::type dot(const vec<N, T> &a, const vec<N, T> &b) {
+	typedef typename detail::compute<T>::type C;
+	C r = 0;
+	detail::unrolled<N>([&](std::size_t i) { r += C(a.elements[i]) * C(b.elements[i]); });
+	return r;
+}
+
+/**
+ * @brief return the cross product of two 3-dimensional vectors.
+ * 
+ * @param a the first vector.
+ * @param b the second vector.
+ */
+template <typename T>
+inline vec<3, T> cross(const vec<3, T> &a, const vec<3, T> &b) {
+	typedef typename detail::compute<T>::type C;
+	const C a0 = a.elements[0], a1 = a.elements[1], a2 = a.elements[2];
+	const C b0 = b.elements[0], b1 = b.elements[1], b2 = b.elements[2];
+	return vec<3, T>(T(a1 * b2 - a2 * b1), T(a2 * b0 - a0 * b2), T(a0 * b1 - a1 * b0));
+}
+
+/**
+ * @brief return the magnitude of a vector.
+ * 
+ * @param v the vector.
+ */
+template <std::size_t N, typename T>
+inline typename detail::compute<T>::type magnitude(const vec<N, T> &v) {
+	return std::sqrt(dot(v, v));
+}
+
+/**
+ * @brief return a normalised copy of a vector.
+ * 
+ * @param v the vector to normalise.
+ */
+template <std::size_t N, typename T>
+inline vec<N, T> normalised(const vec<N, T> &v) {
+	return v / magnitude(v);
+}
+
+/**
+ * @brief normalise a vector in place.
+ * 
+ * @param v the vector to normalise.
+ */
+template <std::size_t N, typename T>
+inline void normalise(vec<N, T> &v) {
+	v /= magnitude(v);
+}
+
+// -------------------------------------------
+// matrix functions
+// -------------------------------------------
+
+/**
+ * @brief return the matrix product of a and b.
+ * 
+ * @param a the R x K matrix on the left.
+ * @param b the K x C matrix on the right.
+ */
+template <std::size_t R, std::size_t K, std::size_t C, typename T>
+inline mat<R, C, T> operator*(const mat<R, K, T> &a, const mat<K, C, T> &b) {
+	typedef typename detail::compute<T>::type F;
+	mat<R, C, T> r;
+	detail::unrolled<R * C>([&](std::size_t i) {
+		const std::size_t row = i / C, col = i % C;
+		F sum = 0;
+		detail::unrolled<K>([&](std::size_t k) { sum += F(a.elements[row][k]) * F(b.elements[k][col]); });
+		r.elements[row][col] = T(sum);
+	});
+	return r;
+}
+template <std::size_t N, typename T>
+inline mat<N, N, T> &operator*=(mat<N, N, T> &a, const mat<N, N, T> &b) {
+	return a = a * b;
+}
+
+/**
+ * @brief return the product of matrix m and column vector v (as zmlMultiplyVecMat()).
+ * 
+ * @param m the R x C matrix.
+ * @param v the C-dimensional vector.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline vec<R, T> operator*(const mat<R, C, T> &m, const vec<C, T> &v) {
+	typedef typename detail::compute<T>::type F;
+	vec<R, T> r;
+	detail::unrolled<R>([&](std::size_t row) {
+		F sum = 0;
+		detail::unrolled<C>([&](std::size_t col) { sum += F(m.elements[row][col]) * F(v.elements[col]); });
+		r.elements[row] = T(sum);
+	});
+	return r;
+}
+
+/**
+ * @brief return a row of a matrix.
+ * 
+ * @param m the matrix.
+ * @param index the index of the row.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline vec<C, T> getRow(const mat<R, C, T> &m, std::size_t index) {
+	vec<C, T> r;
+	std::memcpy(r.elements, m.elements[index], sizeof(r.elements));
+	return r;
+}
+
+/**
+ * @brief set a row of a matrix.
+ * 
+ * @param m the matrix to modify.
+ * @param index the index of the row.
+ * @param v the values of the row.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline void setRow(mat<R, C, T> &m, std::size_t index, const vec<C, T> &v) {
+	std::memcpy(m.elements[index], v.elements, sizeof(v.elements));
+}
+
+/**
+ * @brief return a column of a matrix.
+ * 
+ * @param m the matrix.
+ * @param index the index of the column.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline vec<R, T> getCol(const mat<R, C, T> &m, std::size_t index) {
+	vec<R, T> r;
+	detail::unrolled<R>([&](std::size_t row) { r.elements[row] = m.elements[row][index]; });
+	return r;
+}
+
+/**
+ * @brief set a column of a matrix.
+ * 
+ * @param m the matrix to modify.
+ * @param index the index of the column.
+ * @param v the values of the column.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline void setCol(mat<R, C, T> &m, std::size_t index, const vec<R, T> &v) {
+	detail::unrolled<R>([&](std::size_t row) { m.elements[row][index] = v.elements[row]; });
+}
+
+/**
+ * @brief return the transpose of a matrix.
+ * 
+ * @param m the matrix to transpose.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline mat<C, R, T> transposed(const mat<R, C, T> &m) {
+	mat<C, R, T> r;
+	detail::unrolled<R * C>([&](std::size_t i) { r.elements[i % C][i / C] = m.elements[i / C][i % C]; });
+	return r;
+}
+
+/**
+ * @brief transpose a square matrix in place.
+ * 
+ * @param m the matrix to transpose.
+ */
+template <std::size_t N, typename T>
+inline void transpose(mat<N, N, T> &m) {
+	m = transposed(m);
+}
+
+/**
+ * @brief return matrix m with vector v added to it as a new row.
+ * 
+ * @param m the matrix to augment.
+ * @param v the new last row.
+ */
+template <std::size_t R, std::size_t C, typename T>
+inline mat<R + 1, C, T> augmented(const mat<R, C, T> &m, const vec<C, T> &v) {
+	mat<R + 1, C, T> r;
+	std::memcpy(r.elements, m.elements, sizeof(m.elements));
+	std::memcpy(r.elements[R], v.elements, sizeof(v.elements));
+	return r;
+}
+
+/**
+ * @brief return matrix m with the rows of matrix val added after its own.
+ * 
+ * @param m the matrix to augment.
+ * @param val the matrix whose rows are added.
+ */
+template <std::size_t R, std::size_t R2, std::size_t C, typename T>
+inline mat<R + R2, C, T> augmented(const mat<R, C, T> &m, const mat<R2, C, T> &val) {
+	mat<R + R2, C, T> r;
+	std::memcpy(r.elements, m.elements, sizeof(m.elements));
+	std::memcpy(r.elements[R], val.elements, sizeof(val.elements));
+	return r;
+}
+
+namespace detail {
+
+// reduce a to the identity by Gauss-Jordan elimination with partial pivoting, doing the same row operations to b (if it isn't
+// null) so that b ends up as a^-1 * b. Only the rows below each pivot are eliminated if b is null, which is enough for the
+// determinant. Returns the determinant of a, which is 0 (with a and b left part-way through) if a is singular.
+template <std::size_t N, typename F>
+inline F gaussJordan(F (&a)[N][N], F (*b)[N]) {
+	F det = 1;
+	for (std::size_t k = 0; k < N; k++) {
+		// the largest remaining element in column k is the pivot
+		std::size_t p = k;
+		for (std::size_t i = k + 1; i < N; i++) {
+			if (std::abs(a[i][k]) > std::abs(a[p][k])) {
+				p = i;
+			}
+		}
+		if (a[p][k] == (F) 0) {
+			return 0;
+		}
+		if (p != k) {
+			unrolled<N>([&](std::size_t j) {
+				const F t = a[k][j]; a[k][j] = a[p][j]; a[p][j] = t;
+				if (b) {
+					const F u = b[k][j]; b[k][j] = b[p][j]; b[p][j] = u;
+				}
+			});
+			det = -det;
+		}
+		det *= a[k][k];
+
+		const F inv = (F) 1 / a[k][k];
+		unrolled<N>([&](std::size_t j) {
+			a[k][j] *= inv;
+			if (b) {
+				b[k][j] *= inv;
+			}
+		});
+		for (std::size_t i = (b ? 0 : k + 1); i < N; i++) {
+			const F f = a[i][k];
+			if (i == k || f == (F) 0) {
+				continue;
+			}
+			unrolled<N>([&](std::size_t j) {
+				a[i][j] -= f * a[k][j];
+				if (b) {
+					b[i][j] -= f * b[k][j];
+				}
+			});
+		}
+	}
+	return det;
+}
+
+} // namespace detail
+
+/**
+ * @brief return the determinant of a square matrix.
+ * 
+ * @param m the matrix.
+ */
+template <std::size_t N, typename T>
+inline typename detail::compute<T>::type determinant(const mat<N, N, T> &m) {
+	typedef typename detail::compute<T>::type F;
+	F a[N][N];
+	detail::convert<N * N>(&a[0][0], &m.elements[0][0]);
+	return detail::gaussJordan<N, F>(a, (F (*)[N]) 0);
+}
+
+/**
+ * @brief invert a square matrix into dst. Returns 0, leaving dst unchanged, if m is singular.
+ * 
+ * @param dst the matrix to write the inverse into (which may be m).
+ * @param m the matrix to invert.
+ */
+template <std::size_t N, typename T>
+inline bool invertedInto(mat<N, N, T> &dst, const mat<N, N, T> &m) {
+	typedef typename detail::compute<T>::type F;
+	F a[N][N];
+	F b[N][N];
+	detail::convert<N * N>(&a[0][0], &m.elements[0][0]);
+	detail::unrolled<N * N>([&](std::size_t i) { b[i / N][i % N] = (i / N == i % N) ? (F) 1 : (F) 0; });
+	if (detail::gaussJordan<N, F>(a, b) == (F) 0) {
+		return false;
+	}
+	detail::convert<N * N>(&dst.elements[0][0], &b[0][0]);
+	return true;
+}
+
+/**
+ * @brief return the inverse of a square matrix. If m is singular, a message is printed and a zero matrix returned.
+ * 
+ * @param m the matrix to invert.
+ */
+template <std::size_t N, typename T>
+inline mat<N, N, T> inverted(const mat<N, N, T> &m) {
+	mat<N, N, T> r;
+	if (!invertedInto(r, m)) {
+		std::printf("zetaml: zml::inverted(): given matrix is singular! zero matrix returned!\n");
+		r = mat<N, N, T>::zero();
+	}
+	return r;
+}
+
+/**
+ * @brief invert a square matrix in place. Returns 0, leaving m unchanged, if m is singular.
+ * 
+ * @param m the matrix to invert.
+ */
+template <std::size_t N, typename T>
+inline bool invert(mat<N, N, T> &m) {
+	return invertedInto(m, m);
+}
+
+// -------------------------------------------
+// transformations (on 4x4 matrices, as in transform.c)
+// -------------------------------------------
+
+namespace detail {
+
+// write the rotation by angle about the axis (x, y, z) (which needn't be normalised) into r, as _zml_axisAngleRotation().
+// Returns 0, leaving r unset, if there is no rotation.
+template <typename F>
+inline bool axisAngleRotation(F (&r)[3][3], F angle, F x, F y, F z) {
+	const F lensq = x * x + y * y + z * z;
+
+	// there is no rotation without an angle or an axis
+	if (angle == (F) 0 || lensq == (F) 0) {
+		return false;
+	}
+
+	const F invlen = (F) 1 / std::sqrt(lensq);
+	x *= invlen;
+	y *= invlen;
+	z *= invlen;
+
+	const F c = std::cos(angle);
+	const F s = std::sin(angle);
+	const F t = (F) 1 - c;
+
+	// Rodrigues' rotation formula
+	const F tx = t * x, ty = t * y, tz = t * z;
+	const F sx = s * x, sy = s * y, sz = s * z;
+
+	r[0][0] = tx * x + c;	r[0][1] = tx * y - sz;	r[0][2] = tx * z + sy;
+	r[1][0] = tx * y + sz;	r[1][1] = ty * y + c;	r[1][2] = ty * z - sx;
+	r[2][0] = tx * z - sy;	r[2][1] = ty * z + sx;	r[2][2] = tz * z + c;
+
+	return true;
+}
+
+// write the rotation by the Euler angles x, y and z, applied in the given order, into r, as _zml_eulerRotation().
+template <typename F>
+inline void eulerRotation(F (&r)[3][3], zmlEulerOrder order, F x, F y, F z) {
+	const F cx = std::cos(x), sx = std::sin(x);
+	const F cy = std::cos(y), sy = std::sin(y);
+	const F cz = std::cos(z), sz = std::sin(z);
+
+	switch (order) {
+		case ZML_EULER_ZYX: // Rz * Ry * Rx
+			r[0][0] = cz * cy;	r[0][1] = cz * sy * sx - sz * cx;	r[0][2] = cz * sy * cx + sz * sx;
+			r[1][0] = sz * cy;	r[1][1] = sz * sy * sx + cz * cx;	r[1][2] = sz * sy * cx - cz * sx;
+			r[2][0] = -sy;		r[2][1] = cy * sx;					r[2][2] = cy * cx;
+			break;
+		case ZML_EULER_YXZ: // Ry * Rx * Rz
+			r[0][0] = cy * cz + sy * sx * sz;	r[0][1] = sy * sx * cz - cy * sz;	r[0][2] = sy * cx;
+			r[1][0] = cx * sz;					r[1][1] = cx * cz;					r[1][2] = -sx;
+			r[2][0] = cy * sx * sz - sy * cz;	r[2][1] = sy * sz + cy * sx * cz;	r[2][2] = cy * cx;
+			break;
+		default: // ZML_EULER_XYZ: Rx * Ry * Rz
+			r[0][0] = cy * cz;					r[0][1] = -cy * sz;					r[0][2] = sy;
+			r[1][0] = cx * sz + sx * sy * cz;	r[1][1] = cx * cz - sx * sy * sz;	r[1][2] = -sx * cy;
+			r[2][0] = sx * sz - cx * sy * cz;	r[2][1] = sx * cz + cx * sy * sz;	r[2][2] = cx * cy;
+			break;
+	}
+}
+
+// m = m * r, where r is a rotation that only affects the first three columns (the fourth column is unchanged).
+template <typename T, typename F>
+inline void rotateRows(mat<4, 4, T> &m, const F (&r)[3][3]) {
+	unrolled<4>([&](std::size_t row) {
+		const F m0 = F(m.elements[row][0]), m1 = F(m.elements[row][1]), m2 = F(m.elements[row][2]);
+		unrolled<3>([&](std::size_t col) { m.elements[row][col] = T(m0 * r[0][col] + m1 * r[1][col] + m2 * r[2][col]); });
+	});
+}
+
+// the view matrix for a camera at pos looking at focus; forward is 1 for left-handed coordinates and -1 for right-handed ones.
+template <typename T>
+inline mat<4, 4, T> lookAt(const vec<3, T> &pos, const vec<3, T> &focus, const vec<3, T> &up, typename compute<T>::type forward) {
+	// the direction the camera is facing in, and the right and up directions relative to it
+	const vec<3, T> dir = normalised(focus - pos);
+	const vec<3, T> right = normalised(cross(dir, up));
+	const vec<3, T> rup = cross(right, dir);
+	const vec<3, T> fwd = dir * forward;
+
+	// the rows are the relative right, up and forward directions, and the fourth column is the negated dot product of each with the position
+	mat<4, 4, T> r = mat<4, 4, T>::identity();
+	setRow(r, 0, vec<4, T>(right[0], right[1], right[2], T(-dot(right, pos))));
+	setRow(r, 1, vec<4, T>(rup[0], rup[1], rup[2], T(-dot(rup, pos))));
+	setRow(r, 2, vec<4, T>(fwd[0], fwd[1], fwd[2], T(-dot(fwd, pos))));
+	return r;
+}
+
+} // namespace detail
+
+/**
+ * @brief translate a transformation matrix in place.
+ * 
+ * @param m the matrix to translate.
+ * @param v the translation.
+ */
+template <typename T>
+inline void translate(mat<4, 4, T> &m, const vec<3, T> &v) {
+	typedef typename detail::compute<T>::type F;
+	// the fourth column becomes the sum of the first three columns (each multiplied by the appropriate vector element) and itself.
+	detail::unrolled<4>([&](std::size_t row) {
+		const T *e = m.elements[row];
+		m.elements[row][3] = T(F(e[3]) + F(e[0]) * F(v[0]) + F(e[1]) * F(v[1]) + F(e[2]) * F(v[2]));
+	});
+}
+
+/**
+ * @brief return a translated copy of a transformation matrix. Fixed-size equivalent of zmlTranslated().
+ * 
+ * @param m the matrix to base the translation matrix on.
+ * @param v the translation.
+ */
+template <typename T>
+inline mat<4, 4, T> translated(mat<4, 4, T> m, const vec<3, T> &v) {
+	translate(m, v);
+	return m;
+}
+
+/**
+ * @brief return a translation matrix. Fixed-size equivalent of zmlTranslateIdentity().
+ * 
+ * @param v the translation.
+ */
+template <typename T>
+inline mat<4, 4, T> translation(const vec<3, T> &v) {
+	return translated(mat<4, 4, T>::identity(), v);
+}
+
+/**
+ * @brief rotate a transformation matrix in place by angle radians about the axis (x, y, z).
+ * 
+ * @param m the matrix to rotate.
+ * @param angle the angle of the rotation, in radians.
+ * @param x the x component of the axis.
+ * @param y the y component of the axis.
+ * @param z the z component of the axis.
+ */
+template <typename T>
+inline void rotate(mat<4, 4, T> &m, typename detail::compute<T>::type angle, typename detail::compute<T>::type x, typename detail::compute<T>::type y, typename detail::compute<T>::type z) {
+	typename detail::compute<T>::type r[3][3];
+	// (if there is no rotation then the matrix is left unchanged)
+	if (detail::axisAngleRotation(r, angle, x, y, z)) {
+		detail::rotateRows(m, r);
+	}
+}
+
+/**
+ * @brief return a rotated copy of a transformation matrix. Fixed-size equivalent of zmlRotated().
+ * 
+ */
+template <typename T>
+inline mat<4, 4, T> rotated(mat<4, 4, T> m, typename detail::compute<T>::type angle, typename detail::compute<T>::type x, typename detail::compute<T>::type y, typename detail::compute<T>::type z) {
+	rotate(m, angle, x, y, z);
+	return m;
+}
+
+/**
+ * @brief return a rotation matrix. Fixed-size equivalent of zmlRotateIdentity().
+ * 
+ */
+template <typename T = scalar>
+inline mat<4, 4, T> rotation(typename detail::compute<T>::type angle, typename detail::compute<T>::type x, typename detail::compute<T>::type y, typename detail::compute<T>::type z) {
+	return rotated(mat<4, 4, T>::identity(), angle, x, y, z);
+}
+
+/**
+ * @brief rotate a transformation matrix in place by the Euler angles x, y and z (in radians), applied in the given order.
+ * 
+ * @param m the matrix to rotate.
+ * @param order the order in which the rotations are applied.
+ * @param x the rotation about the x axis.
+ * @param y the rotation about the y axis.
+ * @param z the rotation about the z axis.
+ */
+template <typename T>
+inline void rotateEuler(mat<4, 4, T> &m, zmlEulerOrder order, typename detail::compute<T>::type x, typename detail::compute<T>::type y, typename detail::compute<T>::type z) {
+	typename detail::compute<T>::type r[3][3];
+	detail::eulerRotation(r, order, x, y, z);
+	detail::rotateRows(m, r);
+}
+
+/**
+ * @brief return a copy of a transformation matrix rotated by Euler angles. Fixed-size equivalent of zmlRotatedEuler().
+ * 
+ */
+template <typename T>
+inline mat<4, 4, T> rotatedEuler(mat<4, 4, T> m, zmlEulerOrder order, typename detail::compute<T>::type x, typename detail::compute<T>::type y, typename detail::compute<T>::type z) {
+	rotateEuler(m, order, x, y, z);
+	return m;
+}
+
+/**
+ * @brief return a rotation matrix from Euler angles. Fixed-size equivalent of zmlRotateIdentityEuler().
+ * 
+ */
+template <typename T = scalar>
+inline mat<4, 4, T> rotationEuler(zmlEulerOrder order, typename detail::compute<T>::type x, typename detail::compute<T>::type y, typename detail::compute<T>::type z) {
+	return rotatedEuler(mat<4, 4, T>::identity(), order, x, y, z);
+}
+
+/**
+ * @brief scale a transformation matrix in place.
+ * 
+ * @param m the matrix to scale.
+ * @param v the scale factor along each axis.
+ */
+template <typename T>
+inline void scale(mat<4, 4, T> &m, const vec<3, T> &v) {
+	typedef typename detail::compute<T>::type F;
+	// the fourth column is not modified.
+	detail::unrolled<12>([&](std::size_t i) { m.elements[i / 3][i % 3] = T(F(m.elements[i / 3][i % 3]) * F(v[i % 3])); });
+}
+
+/**
+ * @brief return a scaled copy of a transformation matrix. Fixed-size equivalent of zmlScaled().
+ * 
+ */
+template <typename T>
+inline mat<4, 4, T> scaled(mat<4, 4, T> m, const vec<3, T> &v) {
+	scale(m, v);
+	return m;
+}
+
+/**
+ * @brief return a scale matrix. Fixed-size equivalent of zmlScaleIdentity().
+ * 
+ */
+template <typename T>
+inline mat<4, 4, T> scaling(const vec<3, T> &v) {
+	return scaled(mat<4, 4, T>::identity(), v);
+}
+
+/**
+ * @brief set the scale and translation of m to those of a left-handed orthographic projection. Fixed-size equivalent of
+ * zmlUpdateOrthoMatrixLH().
+ * 
+ */
+template <typename T>
+inline void updateOrthoLH(mat<4, 4, T> &m, typename detail::compute<T>::type lm, typename detail::compute<T>::type rm, typename detail::compute<T>::type bm, typename detail::compute<T>::type tm, typename detail::compute<T>::type zn, typename detail::compute<T>::type zf) {
+	m.elements[0][0] = T(2 / (rm - lm));
+	m.elements[1][1] = T(2 / (tm - bm));
+	m.elements[2][2] = T(2 / (zf - zn));
+
+	m.elements[0][3] = T(-(rm + lm) / (rm - lm));
+	m.elements[1][3] = T(-(tm + bm) / (tm - bm));
+	m.elements[2][3] = T(-(zf + zn) / (zf - zn));
+}
+
+/**
+ * @brief as updateOrthoLH(), for right-handed coordinates.
+ * 
+ */
+template <typename T>
+inline void updateOrthoRH(mat<4, 4, T> &m, typename detail::compute<T>::type lm, typename detail::compute<T>::type rm, typename detail::compute<T>::type bm, typename detail::compute<T>::type tm, typename detail::compute<T>::type zn, typename detail::compute<T>::type zf) {
+	updateOrthoLH(m, lm, rm, bm, tm, zn, zf);
+	m.elements[2][2] = T(-2 / (zf - zn));
+}
+
+/**
+ * @brief return a left-handed orthographic projection matrix. Fixed-size equivalent of zmlConstructOrthoMatrixLH().
+ * 
+ */
+template <typename T = scalar>
+inline mat<4, 4, T> orthoLH(typename detail::compute<T>::type lm, typename detail::compute<T>::type rm, typename detail::compute<T>::type bm, typename detail::compute<T>::type tm, typename detail::compute<T>::type zn, typename detail::compute<T>::type zf) {
+	mat<4, 4, T> r = mat<4, 4, T>::identity();
+	updateOrthoLH(r, lm, rm, bm, tm, zn, zf);
+	return r;
+}
+
+/**
+ * @brief return a right-handed orthographic projection matrix. Fixed-size equivalent of zmlConstructOrthoMatrixRH().
+ * 
+ */
+template <typename T = scalar>
+inline mat<4, 4, T> orthoRH(typename detail::compute<T>::type lm, typename detail::compute<T>::type rm, typename detail::compute<T>::type bm, typename detail::compute<T>::type tm, typename detail::compute<T>::type zn, typename detail::compute<T>::type zf) {
+	mat<4, 4, T> r = mat<4, 4, T>::identity();
+	updateOrthoRH(r, lm, rm, bm, tm, zn, zf);
+	return r;
+}
+
+/**
+ * @brief set the elements of m that a left-handed perspective projection uses. Fixed-size equivalent of zmlUpdatePerspectiveMatrixLH().
+ * 
+ */
+template <typename T>
+inline void updatePerspectiveLH(mat<4, 4, T> &m, typename detail::compute<T>::type near, typename detail::compute<T>::type far, typename detail::compute<T>::type fovy, typename detail::compute<T>::type aspect_ratio) {
+	typedef typename detail::compute<T>::type F;
+	const F tfovy_half = std::tan(fovy / 2);
+
+	m.elements[0][0] = T(1 / (aspect_ratio * tfovy_half));
+	m.elements[1][1] = T(1 / tfovy_half);
+
+	m.elements[2][2] = T((near + far) / (far - near));
+	m.elements[3][2] = T(1.0f);
+
+	m.elements[2][3] = T(-(2 * far * near) / (far - near));
+}
+
+/**
+ * @brief as updatePerspectiveLH(), for right-handed coordinates.
+ * 
+ */
+template <typename T>
+inline void updatePerspectiveRH(mat<4, 4, T> &m, typename detail::compute<T>::type near, typename detail::compute<T>::type far, typename detail::compute<T>::type fovy, typename detail::compute<T>::type aspect_ratio) {
+	updatePerspectiveLH(m, near, far, fovy, aspect_ratio);
+	m.elements[2][2] = T(-(near + far) / (far - near));
+	m.elements[3][2] = T(-1.0f);
+}
+
+/**
+ * @brief return a left-handed perspective projection matrix. Fixed-size equivalent of zmlConstructPerspectiveMatrixLH().
+ * 
+ */
+template <typename T = scalar>
+inline mat<4, 4, T> perspectiveLH(typename detail::compute<T>::type near, typename detail::compute<T>::type far, typename detail::compute<T>::type fovy, typename detail::compute<T>::type aspect_ratio) {
+	mat<4, 4, T> r = mat<4, 4, T>::identity();
+	updatePerspectiveLH(r, near, far, fovy, aspect_ratio);
+	return r;
+}
+
+/**
+ * @brief return a right-handed perspective projection matrix. Fixed-size equivalent of zmlConstructPerspectiveMatrixRH().
+ * 
+ */
+template <typename T = scalar>
+inline mat<4, 4, T> perspectiveRH(typename detail::compute<T>::type near, typename detail::compute<T>::type far, typename detail::compute<T>::type fovy, typename detail::compute<T>::type aspect_ratio) {
+	mat<4, 4, T> r = mat<4, 4, T>::identity();
+	updatePerspectiveRH(r, near, far, fovy, aspect_ratio);
+	return r;
+}
+
+/**
+ * @brief return a left-handed view matrix for a camera at pos, looking at focus. Fixed-size equivalent of zmlConstructLookAtMatrixLH().
+ * 
+ * @param pos the position of the camera.
+ * @param focus the position that the camera is looking at.
+ * @param up the up direction.
+ */
+template <typename T>
+inline mat<4, 4, T> lookAtLH(const vec<3, T> &pos, const vec<3, T> &focus, const vec<3, T> &up) {
+	return detail::lookAt(pos, focus, up, 1);
+}
+
+/**
+ * @brief as lookAtLH(), for right-handed coordinates.
+ * 
+ */
+template <typename T>
+inline mat<4, 4, T> lookAtRH(const vec<3, T> &pos, const vec<3, T> &focus, const vec<3, T> &up) {
+	// (the third row is reversed for right-handed coordinates)
+	return detail::lookAt(pos, focus, up, -1);
+}
+
+/**
+ * @brief set m to a left-handed view matrix. Fixed-size equivalent of zmlUpdateLookAtMatrixLH().
+ * 
+ */
+template <typename T>
+inline void updateLookAtLH(mat<4, 4, T> &m, const vec<3, T> &pos, const vec<3, T> &focus, const vec<3, T> &up) {
+	m = lookAtLH(pos, focus, up);
+}
+
+/**
+ * @brief set m to a right-handed view matrix. Fixed-size equivalent of zmlUpdateLookAtMatrixRH().
+ * 
+ */
+template <typename T>
+inline void updateLookAtRH(mat<4, 4, T> &m, const vec<3, T> &pos, const vec<3, T> &focus, const vec<3, T> &up) {
+	m = lookAtRH(pos, focus, up);
+}
+
+} // namespace zml
+
+#endif
@@ -0,0 +1,226 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+#ifdef ZML_X86_SIMD
+#	include <immintrin.h>
+#endif
+
+// ==============================================================================
+// A 4x4 product is too small to keep the vector units busy on its own: each row of the result is a chain of
+// four dependent multiply-adds (row i of a times the rows of b), so one product leaves most of the FMA
+// latency exposed. The kernels here hold as many rows as fit in a register and work on several products at
+// once, so that about eight independent chains are in flight at any time.
+// Matrices are addressed with byte strides so that the same kernels serve contiguous arrays, matrices inside
+// larger structures, and a single matrix repeated across the batch (a stride of 0).
+// ==============================================================================
+
+// multiply count pairs of matrices: out[i] = a[i] * b[i], each address advancing by its stride (in bytes) every product.
+typedef void (*_zml_mat4BatchKernel)(const unsigned char *a, size_t astride, const unsigned char *b, size_t bstride,
+	unsigned char *out, size_t outstride, size_t count);
+
+// one product (out may be a or b).
+static inline void _zml_multiplyMat4(const zmlMat4 *a, const zmlMat4 *b, zmlMat4 *out) {
+	zmlMat4 r;
+	for (unsigned int row = 0; row < 4; row++) {
+		for (unsigned int col = 0; col < 4; col++) {
+			r.elements[row][col] = a->elements[row][0] * b->elements[0][col] + a->elements[row][1] * b->elements[1][col] +
+				a->elements[row][2] * b->elements[2][col] + a->elements[row][3] * b->elements[3][col];
+		}
+	}
+	*out = r;
+}
+
+static void _zml_multiplyMat4BatchScalar(const unsigned char *a, size_t astride, const unsigned char *b, size_t bstride,
+	unsigned char *out, size_t outstride, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		_zml_multiplyMat4((const zmlMat4 *) (a + i * astride), (const zmlMat4 *) (b + i * bstride), (zmlMat4 *) (out + i * outstride));
+	}
+}
+
+#ifdef ZML_X86_SIMD
+
+// the kernel is written once in terms of the _ZML_V* macros, which are redefined for each instruction set:
+// _ZML_VROWS rows of a matrix fit in a register, _ZML_VROW(p) loads a row of b into each of those slots, and
+// _ZML_VSPLAT(v, p, k) gives element k of each row of v (which was loaded from p), in every position of that row's slot.
+// _ZML_VINFLIGHT products are worked on at once.
+#define _ZML_DEFINE_MAT4_BATCH_KERNEL(name, isa) \
+	__attribute__((target(isa)))\
+	static void name(const unsigned char *a, size_t astride, const unsigned char *b, size_t bstride,\
+		unsigned char *out, size_t outstride, size_t count) {\
+		size_t i = 0;\
+		for (; i + _ZML_VINFLIGHT <= count; i += _ZML_VINFLIGHT) {\
+			_ZML_VT brows[_ZML_VINFLIGHT][4];\
+			_ZML_VT res[_ZML_VINFLIGHT][4 / _ZML_VROWS];\
+			for (unsigned int p = 0; p < _ZML_VINFLIGHT; p++) {\
+				const __zml_floating *bm = (const __zml_floating *) (b + (i + p) * bstride);\
+				for (unsigned int k = 0; k < 4; k++) {\
+					brows[p][k] = _ZML_VROW(bm + 4 * k);\
+				}\
+			}\
+			for (unsigned int p = 0; p < _ZML_VINFLIGHT; p++) {\
+				const __zml_floating *am = (const __zml_floating *) (a + (i + p) * astride);\
+				for (unsigned int g = 0; g < 4 / _ZML_VROWS; g++) {\
+					const __zml_floating *ap = am + 4 * _ZML_VROWS * g;\
+					const _ZML_VT av = _ZML_VLOADU(ap);\
+					_ZML_VT acc = _ZML_VOP(mul)(_ZML_VSPLAT(av, ap, 0), brows[p][0]);\
+					acc = _ZML_VFMA(_ZML_VSPLAT(av, ap, 1), brows[p][1], acc);\
+					acc = _ZML_VFMA(_ZML_VSPLAT(av, ap, 2), brows[p][2], acc);\
+					res[p][g] = _ZML_VFMA(_ZML_VSPLAT(av, ap, 3), brows[p][3], acc);\
+				}\
+			}\
+			/* (stored after every product is computed, in case the output overwrites the inputs) */\
+			for (unsigned int p = 0; p < _ZML_VINFLIGHT; p++) {\
+				__zml_floating *om = (__zml_floating *) (out + (i + p) * outstride);\
+				for (unsigned int g = 0; g < 4 / _ZML_VROWS; g++) {\
+					_ZML_VOP(storeu)(om + 4 * _ZML_VROWS * g, res[p][g]);\
+				}\
+			}\
+		}\
+		_zml_multiplyMat4BatchScalar(a + i * astride, astride, b + i * bstride, bstride, out + i * outstride, outstride, count - i);\
+	}
+
+// AVX2 + FMA: a row of doubles fills a register (and elements of a are broadcast straight from memory), or two rows of floats do
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m256
+#	define _ZML_VOP(op) _mm256_##op##_ps
+#	define _ZML_VROWS 2
+#	define _ZML_VINFLIGHT 4
+#	define _ZML_VROW(p) _mm256_broadcast_ps((const __m128 *) (p))
+#	define _ZML_VSPLAT(v, p, k) _mm256_shuffle_ps(v, v, (k) * 0x55)
+#else
+#	define _ZML_VT __m256d
+#	define _ZML_VOP(op) _mm256_##op##_pd
+#	define _ZML_VROWS 1
+#	define _ZML_VINFLIGHT 2
+#	define _ZML_VROW(p) _mm256_loadu_pd(p)
+#	define _ZML_VSPLAT(v, p, k) ((void) (v), _mm256_broadcast_sd((p) + (k)))
+#endif
+#define _ZML_VLOADU _ZML_VOP(loadu)
+#define _ZML_VFMA _ZML_VOP(fmadd)
+
+_ZML_DEFINE_MAT4_BATCH_KERNEL(_zml_multiplyMat4BatchAVX2, "avx2,fma")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VROWS
+#undef _ZML_VINFLIGHT
+#undef _ZML_VROW
+#undef _ZML_VSPLAT
+
+// AVX-512: two rows of doubles, or a whole matrix of floats, fill a register
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m512
+#	define _ZML_VOP(op) _mm512_##op##_ps
+#	define _ZML_VROWS 4
+#	define _ZML_VINFLIGHT 8
+#	define _ZML_VROW(p) _mm512_broadcast_f32x4(_mm_loadu_ps(p))
+#	define _ZML_VSPLAT(v, p, k) _mm512_permute_ps(v, (k) * 0x55)
+#else
+#	define _ZML_VT __m512d
+#	define _ZML_VOP(op) _mm512_##op##_pd
+#	define _ZML_VROWS 2
+#	define _ZML_VINFLIGHT 4
+#	define _ZML_VROW(p) _mm512_broadcast_f64x4(_mm256_loadu_pd(p))
+#	define _ZML_VSPLAT(v, p, k) _mm512_permutex_pd(v, (k) * 0x55)
+#endif
+
+_ZML_DEFINE_MAT4_BATCH_KERNEL(_zml_multiplyMat4BatchAVX512, "avx512f")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VROWS
+#undef _ZML_VINFLIGHT
+#undef _ZML_VROW
+#undef _ZML_VSPLAT
+#undef _ZML_VLOADU
+#undef _ZML_VFMA
+
+#endif
+
+// select the best kernel for the CPU.
+static _zml_mat4BatchKernel _zml_selectMat4BatchKernel(void) {
+#ifdef ZML_X86_SIMD
+	const unsigned int features = _zml_cpuFeatures();
+	if (features & ZML_CPU_AVX512) return _zml_multiplyMat4BatchAVX512;
+	if (features & ZML_CPU_AVX2) return _zml_multiplyMat4BatchAVX2;
+#endif
+	// (the scalar loop is vectorised with SSE2 by the compiler well enough that it needs no kernel of its own)
+	return _zml_multiplyMat4BatchScalar;
+}
+
+typedef struct {
+	_zml_mat4BatchKernel kernel;
+	const unsigned char *a;
+	size_t astride;
+	const unsigned char *b;
+	size_t bstride;
+	unsigned char *out;
+	size_t outstride;
+} _zml_mat4BatchArgs;
+
+// multiply products [begin, end).
+static void _zml_multiplyMat4Range(void *ctx, size_t begin, size_t end) {
+	const _zml_mat4BatchArgs *args = (const _zml_mat4BatchArgs *) ctx;
+	args->kernel(args->a + begin * args->astride, args->astride, args->b + begin * args->bstride, args->bstride,
+		args->out + begin * args->outstride, args->outstride, end - begin);
+}
+
+/**
+ * @brief multiply a strided batch of matrices: the ith product multiplies the matrices at a + i * astride and b + i * bstride
+ * (as with zmlMultiplyMat4s_r()) and stores the result at out + i * outstride, where the strides are in bytes. This lets the
+ * matrices be members of larger structures (such as the nodes of a scene graph), and a stride of 0 uses the same matrix for
+ * every product (such as a parent's transform applied to each of its children).
+ * out[i] may be the same matrix as a[i] or b[i], but must not overlap any other input.
+ * 
+ * @param a the first matrix of the first product.
+ * @param astride the distance, in bytes, between the first matrices of successive products.
+ * @param b the second matrix of the first product.
+ * @param bstride the distance, in bytes, between the second matrices of successive products.
+ * @param out where to store the first result.
+ * @param outstride the distance, in bytes, between successive results.
+ * @param count the number of products.
+ */
+void zmlMultiplyMat4BatchStrided(const zmlMat4 *a, size_t astride, const zmlMat4 *b, size_t bstride, zmlMat4 *out, size_t outstride, size_t count) {
+	_zml_mat4BatchArgs args;
+	args.kernel = _zml_selectMat4BatchKernel();
+	args.a = (const unsigned char *) a;
+	args.astride = astride;
+	args.b = (const unsigned char *) b;
+	args.bstride = bstride;
+	args.out = (unsigned char *) out;
+	args.outstride = outstride;
+
+	// (each product is 112 flops)
+	if (count < ZML_PARALLEL_THRESHOLD / 16) {
+		_zml_multiplyMat4Range(&args, 0, count);
+		return;
+	}
+
+	_zml_parallelFor(count, ZML_PARALLEL_THRESHOLD / 64, _zml_multiplyMat4Range, &args);
+}
+
+/**
+ * @brief multiply arrays of matrices pairwise: out[i] = a[i] * b[i] (as with zmlMultiplyMat4s_r()).
+ * out may be the same array as a or b.
+ * 
+ * @param a the first matrix of each product (count matrices).
+ * @param b the second matrix of each product (count matrices).
+ * @param out the array to store the results in (count matrices).
+ * @param count the number of products.
+ */
+void zmlMultiplyMat4Batch(const zmlMat4 *a, const zmlMat4 *b, zmlMat4 *out, size_t count) {
+	zmlMultiplyMat4BatchStrided(a, sizeof(zmlMat4), b, sizeof(zmlMat4), out, sizeof(zmlMat4), count);
+}
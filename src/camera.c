@@ -0,0 +1,242 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+// ==============================================================================
+// Camera matrices are built in batches (the faces of many cubemaps, or the cascades of a shadow map, for example)
+// from Structure-of-Arrays parameters, with no allocations. Each can also write the inverse of every matrix, which
+// is cheap to find from the parameters (a view matrix is rigid, and a projection has only a few nonzero elements),
+// so that zmlCombineViewProjectionMat4s() can give the inverse view-projection matrices without a general 4x4 inversion.
+// ==============================================================================
+
+// build count look-at matrices; 'handed' is 1 for left-handed coordinates and -1 for right-handed coordinates.
+static void _zml_constructLookAtMat4s(const __zml_floating *posx, const __zml_floating *posy, const __zml_floating *posz,
+	const __zml_floating *focusx, const __zml_floating *focusy, const __zml_floating *focusz,
+	const __zml_floating *upx, const __zml_floating *upy, const __zml_floating *upz, zmlMat4 *out, zmlMat4 *inverse, size_t count,
+	__zml_floating handed) {
+	for (size_t i = 0; i < count; i++) {
+		const zmlVec3 pos = { { posx[i], posy[i], posz[i] } };
+		const zmlVec3 focus = { { focusx[i], focusy[i], focusz[i] } };
+		const zmlVec3 up = { { upx[i], upy[i], upz[i] } };
+
+		const zmlMat4 view = (handed > 0) ? zmlConstructLookAtMat4LH(pos, focus, up) : zmlConstructLookAtMat4RH(pos, focus, up);
+		out[i] = view;
+		if (inverse) {
+			inverse[i] = zmlInvertedRigidMat4(view);
+		}
+	}
+}
+
+/**
+ * @brief construct an array of look-at matrices (as with zmlConstructLookAtMat4LH()), and optionally their inverses, from
+ * separate arrays of coordinates. Uses left-handed coordinates!
+ * 
+ * @param posx, posy, posz the positions of the viewers/cameras (count values each).
+ * @param focusx, focusy, focusz the positions the viewers/cameras are looking at (count values each).
+ * @param upx, upy, upz the absolute unit vectors indicating each camera's up direction (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+void zmlConstructLookAtMat4sLH(const __zml_floating *posx, const __zml_floating *posy, const __zml_floating *posz,
+	const __zml_floating *focusx, const __zml_floating *focusy, const __zml_floating *focusz,
+	const __zml_floating *upx, const __zml_floating *upy, const __zml_floating *upz, zmlMat4 *out, zmlMat4 *inverse, size_t count) {
+	_zml_constructLookAtMat4s(posx, posy, posz, focusx, focusy, focusz, upx, upy, upz, out, inverse, count, (__zml_floating) 1.0);
+}
+/**
+ * @brief construct an array of look-at matrices (as with zmlConstructLookAtMat4RH()), and optionally their inverses, from
+ * separate arrays of coordinates. Uses right-handed coordinates!
+ * 
+ * @param posx, posy, posz the positions of the viewers/cameras (count values each).
+ * @param focusx, focusy, focusz the positions the viewers/cameras are looking at (count values each).
+ * @param upx, upy, upz the absolute unit vectors indicating each camera's up direction (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+void zmlConstructLookAtMat4sRH(const __zml_floating *posx, const __zml_floating *posy, const __zml_floating *posz,
+	const __zml_floating *focusx, const __zml_floating *focusy, const __zml_floating *focusz,
+	const __zml_floating *upx, const __zml_floating *upy, const __zml_floating *upz, zmlMat4 *out, zmlMat4 *inverse, size_t count) {
+	_zml_constructLookAtMat4s(posx, posy, posz, focusx, focusy, focusz, upx, upy, upz, out, inverse, count, (__zml_floating) -1.0);
+}
+
+// build count perspective matrices; 'handed' is 1 for left-handed coordinates and -1 for right-handed coordinates.
+static void _zml_constructPerspectiveMat4s(const __zml_floating *near, const __zml_floating *far, const __zml_floating *fovy,
+	const __zml_floating *aspect_ratio, zmlMat4 *out, zmlMat4 *inverse, size_t count, __zml_floating handed) {
+	// (views usually share a field of view, so tan() is only called when it changes)
+	__zml_floating lastFovy = 0, tfovy_half = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		if (i == 0 || fovy[i] != lastFovy) {
+			lastFovy = fovy[i];
+			tfovy_half = (__zml_floating) tan(fovy[i] / 2);
+		}
+
+		const __zml_floating sx = 1 / (aspect_ratio[i] * tfovy_half);
+		const __zml_floating sy = 1 / tfovy_half;
+		const __zml_floating a = handed * (near[i] + far[i]) / (far[i] - near[i]);
+		const __zml_floating b = -(2 * far[i] * near[i]) / (far[i] - near[i]);
+
+		zmlMat4 r = zmlIdentityMat4();
+		r.elements[0][0] = sx;
+		r.elements[1][1] = sy;
+		r.elements[2][2] = a;
+		r.elements[2][3] = b;
+		r.elements[3][2] = handed;
+		r.elements[3][3] = 0;
+		out[i] = r;
+
+		// z and w only depend on z' and w', through the inverse of the bottom-right 2x2 block
+		if (inverse) {
+			const __zml_floating det = -b * handed;
+			zmlMat4 inv = { { { 0 } } };
+			inv.elements[0][0] = 1 / sx;
+			inv.elements[1][1] = 1 / sy;
+			inv.elements[2][3] = -b / det;
+			inv.elements[3][2] = -handed / det;
+			inv.elements[3][3] = a / det;
+			inverse[i] = inv;
+		}
+	}
+}
+
+/**
+ * @brief construct an array of perspective projection matrices (as with zmlConstructPerspectiveMat4LH()), and optionally
+ * their inverses. Uses left-handed coordinates!
+ * 
+ * @param near the distance from each viewer to the nearest clipping plane (count values).
+ * @param far the distance from each viewer to the farthest clipping plane (count values).
+ * @param fovy the angle of each field of view in the y direction (count values).
+ * @param aspect_ratio the aspect ratio of each viewport (count values).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+void zmlConstructPerspectiveMat4sLH(const __zml_floating *near, const __zml_floating *far, const __zml_floating *fovy,
+	const __zml_floating *aspect_ratio, zmlMat4 *out, zmlMat4 *inverse, size_t count) {
+	_zml_constructPerspectiveMat4s(near, far, fovy, aspect_ratio, out, inverse, count, (__zml_floating) 1.0);
+}
+/**
+ * @brief construct an array of perspective projection matrices (as with zmlConstructPerspectiveMat4RH()), and optionally
+ * their inverses. Uses right-handed coordinates!
+ * 
+ * @param near the distance from each viewer to the nearest clipping plane (count values).
+ * @param far the distance from each viewer to the farthest clipping plane (count values).
+ * @param fovy the angle of each field of view in the y direction (count values).
+ * @param aspect_ratio the aspect ratio of each viewport (count values).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+void zmlConstructPerspectiveMat4sRH(const __zml_floating *near, const __zml_floating *far, const __zml_floating *fovy,
+	const __zml_floating *aspect_ratio, zmlMat4 *out, zmlMat4 *inverse, size_t count) {
+	_zml_constructPerspectiveMat4s(near, far, fovy, aspect_ratio, out, inverse, count, (__zml_floating) -1.0);
+}
+
+// build count orthographic matrices; 'handed' is 1 for left-handed coordinates and -1 for right-handed coordinates.
+static void _zml_constructOrthoMat4s(const __zml_floating *lm, const __zml_floating *rm, const __zml_floating *bm,
+	const __zml_floating *tm, const __zml_floating *zn, const __zml_floating *zf, zmlMat4 *out, zmlMat4 *inverse, size_t count,
+	__zml_floating handed) {
+	for (size_t i = 0; i < count; i++) {
+		// scale and translation of each axis
+		const __zml_floating s[3] = { 2 / (rm[i] - lm[i]), 2 / (tm[i] - bm[i]), handed * 2 / (zf[i] - zn[i]) };
+		const __zml_floating t[3] = {
+			-(rm[i] + lm[i]) / (rm[i] - lm[i]),
+			-(tm[i] + bm[i]) / (tm[i] - bm[i]),
+			-(zf[i] + zn[i]) / (zf[i] - zn[i])
+		};
+
+		zmlMat4 r = zmlIdentityMat4();
+		for (unsigned int a = 0; a < 3; a++) {
+			r.elements[a][a] = s[a];
+			r.elements[a][3] = t[a];
+		}
+		out[i] = r;
+
+		if (inverse) {
+			zmlMat4 inv = zmlIdentityMat4();
+			for (unsigned int a = 0; a < 3; a++) {
+				inv.elements[a][a] = 1 / s[a];
+				inv.elements[a][3] = -t[a] / s[a];
+			}
+			inverse[i] = inv;
+		}
+	}
+}
+
+/**
+ * @brief construct an array of orthographic projection matrices (as with zmlConstructOrthoMat4LH()), and optionally their
+ * inverses. Uses left-handed coordinates!
+ * 
+ * @param lm, rm the left-most and right-most boundaries (count values each).
+ * @param bm, tm the bottom-most and top-most boundaries (count values each).
+ * @param zn, zf the nearest and farthest Z coordinates that will be rendered (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+void zmlConstructOrthoMat4sLH(const __zml_floating *lm, const __zml_floating *rm, const __zml_floating *bm,
+	const __zml_floating *tm, const __zml_floating *zn, const __zml_floating *zf, zmlMat4 *out, zmlMat4 *inverse, size_t count) {
+	_zml_constructOrthoMat4s(lm, rm, bm, tm, zn, zf, out, inverse, count, (__zml_floating) 1.0);
+}
+/**
+ * @brief construct an array of orthographic projection matrices (as with zmlConstructOrthoMat4RH()), and optionally their
+ * inverses. Uses right-handed coordinates!
+ * 
+ * @param lm, rm the left-most and right-most boundaries (count values each).
+ * @param bm, tm the bottom-most and top-most boundaries (count values each).
+ * @param zn, zf the nearest and farthest Z coordinates that will be rendered (count values each).
+ * @param out the array to write the matrices into (count matrices).
+ * @param inverse the array to write the inverse of each matrix into (count matrices), or NULL if they aren't needed.
+ * @param count the number of matrices.
+ */
+void zmlConstructOrthoMat4sRH(const __zml_floating *lm, const __zml_floating *rm, const __zml_floating *bm,
+	const __zml_floating *tm, const __zml_floating *zn, const __zml_floating *zf, zmlMat4 *out, zmlMat4 *inverse, size_t count) {
+	_zml_constructOrthoMat4s(lm, rm, bm, tm, zn, zf, out, inverse, count, (__zml_floating) -1.0);
+}
+
+/**
+ * @brief combine arrays of projection and view matrices into view-projection matrices (projection * view), and optionally
+ * their inverses (view inverse * projection inverse). As with zmlMultiplyMat4BatchStrided(), the strides are in bytes, and
+ * a stride of 0 uses the same matrix for every view: the 6 faces of a cubemap share one projection, for example, and the
+ * cascades of a shadow map share one view.
+ * 
+ * @param proj the first projection matrix.
+ * @param projinverse the inverse of the first projection matrix (see zmlConstructPerspectiveMat4sRH()), at the same stride as proj.
+ * @param projstride the distance, in bytes, between successive projection matrices (and their inverses).
+ * @param view the first view matrix.
+ * @param viewinverse the inverse of the first view matrix (see zmlConstructLookAtMat4sRH()), at the same stride as view.
+ * @param viewstride the distance, in bytes, between successive view matrices (and their inverses).
+ * @param viewproj the array to write the view-projection matrices into (count matrices).
+ * @param inverse the array to write the inverse of each view-projection matrix into (count matrices), or NULL if they aren't
+ * needed. If projinverse or viewinverse is NULL, these are found with zmlInvertedMat4() instead.
+ * @param count the number of view-projection matrices.
+ */
+void zmlCombineViewProjectionMat4s(const zmlMat4 *proj, const zmlMat4 *projinverse, size_t projstride,
+	const zmlMat4 *view, const zmlMat4 *viewinverse, size_t viewstride, zmlMat4 *viewproj, zmlMat4 *inverse, size_t count) {
+	zmlMultiplyMat4BatchStrided(proj, projstride, view, viewstride, viewproj, sizeof(zmlMat4), count);
+
+	if (!inverse) {
+		return;
+	}
+
+	if (projinverse && viewinverse) {
+		zmlMultiplyMat4BatchStrided(viewinverse, viewstride, projinverse, projstride, inverse, sizeof(zmlMat4), count);
+	} else {
+		for (size_t i = 0; i < count; i++) {
+			inverse[i] = zmlInvertedMat4(viewproj[i]);
+		}
+	}
+}
@@ -0,0 +1,61 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+// detect the features once; the result never changes so it doesn't matter if two threads race to detect them.
+static unsigned int _zml_detectedFeatures = 0;
+static unsigned char _zml_featuresDetected = 0;
+
+/**
+ * @brief get the SIMD features supported by the CPU that zetaml is running on.
+ * The ZML_CPU environment variable can be set to 'scalar', 'sse2' or 'avx2' to limit which code paths are used (useful for testing).
+ * 
+ */
+unsigned int _zml_cpuFeatures(void) {
+	if (_zml_featuresDetected) {
+		return _zml_detectedFeatures;
+	}
+
+	unsigned int features = 0;
+
+#ifdef ZML_X86_SIMD
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("sse2")) {
+		features |= ZML_CPU_SSE2;
+	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		features |= ZML_CPU_AVX2;
+	}
+	if (__builtin_cpu_supports("avx512f")) {
+		features |= ZML_CPU_AVX512;
+	}
+#endif
+
+	const char *limit = getenv("ZML_CPU");
+	if (limit) {
+		if (!strcmp(limit, "scalar")) {
+			features = 0;
+		} else if (!strcmp(limit, "sse2")) {
+			features &= ZML_CPU_SSE2;
+		} else if (!strcmp(limit, "avx2")) {
+			features &= ZML_CPU_SSE2 | ZML_CPU_AVX2;
+		}
+	}
+
+	_zml_detectedFeatures = features;
+	_zml_featuresDetected = 1;
+
+	return features;
+}
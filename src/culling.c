@@ -0,0 +1,370 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+#ifdef ZML_X86_SIMD
+#	include <immintrin.h>
+#endif
+
+// ==============================================================================
+// A frustum is stored as its 6 planes, (a, b, c, d) with a * x + b * y + c * z + d >= 0 inside, and with (a, b, c)
+// normalised so that plane distances can be compared with radii. Bounding volumes are culled from
+// Structure-of-Arrays data, so that every SIMD lane tests a different volume against the same plane: a sphere is
+// outside if its centre is further than its radius behind any plane, and a box (stored as its centre and half-extents)
+// is outside if its centre is further behind any plane than the box's extent along that plane's normal,
+// |a| * ex + |b| * ey + |c| * ez. Volumes that are near a corner of the frustum but outside it can pass both tests,
+// which is the usual trade-off for their speed.
+// ==============================================================================
+
+/**
+ * @brief construct a view frustum from a view-projection matrix (projection * view, as built by zmlConstructPerspectiveMat4LH()
+ * or zmlConstructOrthoMat4RH() and the like, multiplied by a view matrix). The planes are in world space; to cull in
+ * another space (such as an object's local space), pass projection * view * model instead.
+ * 
+ * @param viewproj the view-projection matrix.
+ */
+zmlFrustum zmlConstructFrustum(zmlMat4 viewproj) {
+	zmlFrustum f;
+
+	// a point is inside when -w <= x, y, z <= w in clip space, so each plane is the fourth row plus or minus one of the others
+	for (unsigned int p = 0; p < 6; p++) {
+		const unsigned int row = p / 2;
+		const __zml_floating sign = (p % 2) ? -1 : 1;
+		for (unsigned int c = 0; c < 4; c++) {
+			f.planes[p].elements[c] = viewproj.elements[3][c] + sign * viewproj.elements[row][c];
+		}
+
+		const __zml_floating length = (__zml_floating) sqrt(f.planes[p].elements[0] * f.planes[p].elements[0] +
+			f.planes[p].elements[1] * f.planes[p].elements[1] + f.planes[p].elements[2] * f.planes[p].elements[2]);
+		if (length > 0) {
+			for (unsigned int c = 0; c < 4; c++) {
+				f.planes[p].elements[c] /= length;
+			}
+		}
+	}
+
+	return f;
+}
+
+/**
+ * @brief check whether a sphere is (at least partly) inside a frustum.
+ * 
+ * @param f the frustum.
+ * @param centre the centre of the sphere.
+ * @param radius the radius of the sphere.
+ */
+unsigned char zmlSphereInFrustum(const zmlFrustum *f, zmlVec3 centre, __zml_floating radius) {
+	for (unsigned int p = 0; p < 6; p++) {
+		const __zml_floating *plane = f->planes[p].elements;
+		const __zml_floating d = plane[0] * centre.elements[0] + plane[1] * centre.elements[1] + plane[2] * centre.elements[2] + plane[3];
+		if (!(d + radius >= 0)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief check whether an axis-aligned bounding box is (at least partly) inside a frustum.
+ * 
+ * @param f the frustum.
+ * @param centre the centre of the box.
+ * @param extents the half-extents of the box (half its size along each axis).
+ */
+unsigned char zmlAABBInFrustum(const zmlFrustum *f, zmlVec3 centre, zmlVec3 extents) {
+	for (unsigned int p = 0; p < 6; p++) {
+		const __zml_floating *plane = f->planes[p].elements;
+		const __zml_floating d = plane[0] * centre.elements[0] + plane[1] * centre.elements[1] + plane[2] * centre.elements[2] + plane[3];
+		const __zml_floating r = (__zml_floating) (fabs(plane[0]) * extents.elements[0] + fabs(plane[1]) * extents.elements[1] +
+			fabs(plane[2]) * extents.elements[2]);
+		if (!(d + r >= 0)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// -------------------------------------------
+// culling kernels
+// -------------------------------------------
+
+// test count spheres (if radius isn't NULL) or boxes (with half-extents ex, ey, ez) centred at x, y, z against a frustum,
+// setting visible[i] to 1 or 0, and return how many are visible.
+typedef size_t (*_zml_cullKernel)(const zmlFrustum *f, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	const __zml_floating *radius, const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez,
+	unsigned char *visible, size_t count);
+
+static size_t _zml_cullScalar(const zmlFrustum *f, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	const __zml_floating *radius, const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez,
+	unsigned char *visible, size_t count) {
+	size_t visibleCount = 0;
+	for (size_t i = 0; i < count; i++) {
+		const zmlVec3 centre = { { x[i], y[i], z[i] } };
+		if (radius) {
+			visible[i] = zmlSphereInFrustum(f, centre, radius[i]);
+		} else {
+			const zmlVec3 extents = { { ex[i], ey[i], ez[i] } };
+			visible[i] = zmlAABBInFrustum(f, centre, extents);
+		}
+		visibleCount += visible[i];
+	}
+	return visibleCount;
+}
+
+#ifdef ZML_X86_SIMD
+
+// the kernel is written once in terms of the _ZML_V* macros, which are redefined for each instruction set.
+// _ZML_VNONNEG(v) gives a bit mask of the lanes of v that are >= 0 (so NaNs are culled).
+#define _ZML_DEFINE_CULL_KERNEL(name, isa) \
+	__attribute__((target(isa)))\
+	static size_t name(const zmlFrustum *f, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,\
+		const __zml_floating *radius, const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez,\
+		unsigned char *visible, size_t count) {\
+		_ZML_VT pv[6][4], av[6][3];\
+		for (unsigned int p = 0; p < 6; p++) {\
+			for (unsigned int c = 0; c < 4; c++) {\
+				pv[p][c] = _ZML_VSET1(f->planes[p].elements[c]);\
+			}\
+			for (unsigned int c = 0; c < 3; c++) {\
+				av[p][c] = _ZML_VSET1((__zml_floating) fabs(f->planes[p].elements[c]));\
+			}\
+		}\
+		const unsigned int all = (1u << _ZML_VLANES) - 1;\
+		size_t visibleCount = 0, i = 0;\
+		for (; i + _ZML_VLANES <= count; i += _ZML_VLANES) {\
+			const _ZML_VT vx = _ZML_VLOADU(x + i);\
+			const _ZML_VT vy = _ZML_VLOADU(y + i);\
+			const _ZML_VT vz = _ZML_VLOADU(z + i);\
+			_ZML_VT vr = _ZML_VSET1((__zml_floating) 0.0), vex = vr, vey = vr, vez = vr;\
+			if (radius) {\
+				vr = _ZML_VLOADU(radius + i);\
+			} else {\
+				vex = _ZML_VLOADU(ex + i);\
+				vey = _ZML_VLOADU(ey + i);\
+				vez = _ZML_VLOADU(ez + i);\
+			}\
+			unsigned int inside = all;\
+			for (unsigned int p = 0; p < 6 && inside; p++) {\
+				const _ZML_VT d = _ZML_VFMA(pv[p][0], vx, _ZML_VFMA(pv[p][1], vy, _ZML_VFMA(pv[p][2], vz, pv[p][3])));\
+				const _ZML_VT r = radius ? vr : _ZML_VFMA(av[p][0], vex, _ZML_VFMA(av[p][1], vey, _ZML_VMUL(av[p][2], vez)));\
+				inside &= _ZML_VNONNEG(_ZML_VADD(d, r));\
+			}\
+			for (unsigned int l = 0; l < _ZML_VLANES; l++) {\
+				visible[i + l] = (unsigned char) ((inside >> l) & 1);\
+			}\
+			visibleCount += (size_t) __builtin_popcount(inside);\
+		}\
+		if (i < count) {\
+			visibleCount += _zml_cullScalar(f, x + i, y + i, z + i, radius ? radius + i : NULL,\
+				radius ? NULL : ex + i, radius ? NULL : ey + i, radius ? NULL : ez + i, visible + i, count - i);\
+		}\
+		return visibleCount;\
+	}
+
+// SSE2
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m128
+#	define _ZML_VOP(op) _mm_##op##_ps
+#else
+#	define _ZML_VT __m128d
+#	define _ZML_VOP(op) _mm_##op##_pd
+#endif
+#define _ZML_VLANES (16 / sizeof(__zml_floating))
+#define _ZML_VSET1 _ZML_VOP(set1)
+#define _ZML_VLOADU _ZML_VOP(loadu)
+#define _ZML_VMUL _ZML_VOP(mul)
+#define _ZML_VADD _ZML_VOP(add)
+#define _ZML_VFMA(x, y, z) _ZML_VOP(add)(_ZML_VOP(mul)(x, y), z)
+#define _ZML_VNONNEG(v) (unsigned int) _ZML_VOP(movemask)(_ZML_VOP(cmpge)(v, _ZML_VOP(setzero)()))
+
+_ZML_DEFINE_CULL_KERNEL(_zml_cullSSE2, "sse2")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VNONNEG
+
+// AVX2 + FMA
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m256
+#	define _ZML_VOP(op) _mm256_##op##_ps
+#else
+#	define _ZML_VT __m256d
+#	define _ZML_VOP(op) _mm256_##op##_pd
+#endif
+#define _ZML_VLANES (32 / sizeof(__zml_floating))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+#define _ZML_VNONNEG(v) (unsigned int) _ZML_VOP(movemask)(_ZML_VOP(cmp)(v, _ZML_VOP(setzero)(), _CMP_GE_OQ))
+
+_ZML_DEFINE_CULL_KERNEL(_zml_cullAVX2, "avx2,fma")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VNONNEG
+
+// AVX-512
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m512
+#	define _ZML_VOP(op) _mm512_##op##_ps
+#	define _ZML_VNONNEG(v) (unsigned int) _mm512_cmp_ps_mask(v, _mm512_setzero_ps(), _CMP_GE_OQ)
+#else
+#	define _ZML_VT __m512d
+#	define _ZML_VOP(op) _mm512_##op##_pd
+#	define _ZML_VNONNEG(v) (unsigned int) _mm512_cmp_pd_mask(v, _mm512_setzero_pd(), _CMP_GE_OQ)
+#endif
+#define _ZML_VLANES (64 / sizeof(__zml_floating))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+
+_ZML_DEFINE_CULL_KERNEL(_zml_cullAVX512, "avx512f")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VNONNEG
+#undef _ZML_VSET1
+#undef _ZML_VLOADU
+#undef _ZML_VMUL
+#undef _ZML_VADD
+
+#endif
+
+// select the best kernel for the CPU.
+static _zml_cullKernel _zml_selectCullKernel(void) {
+#ifdef ZML_X86_SIMD
+	const unsigned int features = _zml_cpuFeatures();
+	if (features & ZML_CPU_AVX512) return _zml_cullAVX512;
+	if (features & ZML_CPU_AVX2) return _zml_cullAVX2;
+	if (features & ZML_CPU_SSE2) return _zml_cullSSE2;
+#endif
+	return _zml_cullScalar;
+}
+
+// -------------------------------------------
+// splitting the work across threads
+// -------------------------------------------
+
+typedef struct {
+	_zml_cullKernel kernel;
+	const zmlFrustum *f;
+	const __zml_floating *x, *y, *z, *radius, *ex, *ey, *ez;
+	unsigned char *visible;
+	size_t visibleCount;
+} _zml_cullArgs;
+
+// cull volumes [begin, end).
+static void _zml_cullRange(void *ctx, size_t begin, size_t end) {
+	_zml_cullArgs *args = (_zml_cullArgs *) ctx;
+	const unsigned char spheres = args->radius != NULL;
+
+	const size_t visibleCount = args->kernel(args->f, args->x + begin, args->y + begin, args->z + begin,
+		spheres ? args->radius + begin : NULL, spheres ? NULL : args->ex + begin, spheres ? NULL : args->ey + begin,
+		spheres ? NULL : args->ez + begin, args->visible + begin, end - begin);
+
+	__atomic_add_fetch(&args->visibleCount, visibleCount, __ATOMIC_RELAXED);
+}
+
+static size_t _zml_cull(_zml_cullArgs *args, size_t count) {
+	args->kernel = _zml_selectCullKernel();
+
+	if (count < ZML_PARALLEL_THRESHOLD) {
+		_zml_cullRange(args, 0, count);
+	} else {
+		_zml_parallelFor(count, ZML_PARALLEL_THRESHOLD / 4, _zml_cullRange, args);
+	}
+
+	return args->visibleCount;
+}
+
+/**
+ * @brief test an array of bounding spheres, stored as separate arrays of centre coordinates and radii (Structure-of-Arrays),
+ * against a frustum, as with zmlSphereInFrustum(). Returns the number of spheres that are visible.
+ * 
+ * @param f the frustum.
+ * @param x, y, z the coordinates of the centres of the spheres (count values each).
+ * @param radius the radii of the spheres (count values).
+ * @param visible the array to write the results into (count values): 1 for each sphere that is at least partly inside the frustum, otherwise 0.
+ * @param count the number of spheres.
+ */
+size_t zmlCullSpheres(const zmlFrustum *f, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	const __zml_floating *radius, unsigned char *visible, size_t count) {
+	_zml_cullArgs args = { 0 };
+	args.f = f;
+	args.x = x;
+	args.y = y;
+	args.z = z;
+	args.radius = radius;
+	args.visible = visible;
+
+	return _zml_cull(&args, count);
+}
+
+/**
+ * @brief test an array of axis-aligned bounding boxes, stored as separate arrays of centre coordinates and half-extents
+ * (Structure-of-Arrays), against a frustum, as with zmlAABBInFrustum(). Returns the number of boxes that are visible.
+ * 
+ * @param f the frustum.
+ * @param cx, cy, cz the coordinates of the centres of the boxes (count values each).
+ * @param ex, ey, ez the half-extents of the boxes along each axis (count values each).
+ * @param visible the array to write the results into (count values): 1 for each box that is at least partly inside the frustum, otherwise 0.
+ * @param count the number of boxes.
+ */
+size_t zmlCullAABBs(const zmlFrustum *f, const __zml_floating *cx, const __zml_floating *cy, const __zml_floating *cz,
+	const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez, unsigned char *visible, size_t count) {
+	_zml_cullArgs args = { 0 };
+	args.f = f;
+	args.x = cx;
+	args.y = cy;
+	args.z = cz;
+	args.ex = ex;
+	args.ey = ey;
+	args.ez = ez;
+	args.visible = visible;
+
+	return _zml_cull(&args, count);
+}
+
+/**
+ * @brief transform an array of axis-aligned bounding boxes, stored as separate arrays of centre coordinates and half-extents
+ * (Structure-of-Arrays), by a matrix, giving the smallest axis-aligned boxes that contain the transformed boxes. The centres
+ * are transformed as points, and each new half-extent is the sum of the old ones weighted by the absolute values of the
+ * matrix's row (so the boxes grow as they are rotated). No perspective divide is done.
+ * 
+ * @param mat the transformation matrix (such as an object's model matrix).
+ * @param cx, cy, cz the coordinates of the centres of the boxes (count values each).
+ * @param ex, ey, ez the half-extents of the boxes along each axis (count values each).
+ * @param outcx, outcy, outcz the arrays to write the centres of the transformed boxes into. Each may be the same array as any of cx, cy and cz.
+ * @param outex, outey, outez the arrays to write the half-extents of the transformed boxes into. Each may be the same array as any of ex, ey and ez.
+ * @param count the number of boxes.
+ */
+void zmlTransformAABBs(const zmlMat4 *mat, const __zml_floating *cx, const __zml_floating *cy, const __zml_floating *cz,
+	const __zml_floating *ex, const __zml_floating *ey, const __zml_floating *ez,
+	__zml_floating *outcx, __zml_floating *outcy, __zml_floating *outcz, __zml_floating *outex, __zml_floating *outey, __zml_floating *outez,
+	size_t count) {
+	// the extents are transformed as directions by |mat| (so without the translation)
+	zmlMat4 absolute = zmlIdentityMat4();
+	for (unsigned int r = 0; r < 3; r++) {
+		for (unsigned int c = 0; c < 3; c++) {
+			absolute.elements[r][c] = (__zml_floating) fabs(mat->elements[r][c]);
+		}
+		absolute.elements[r][3] = 0;
+	}
+
+	zmlTransformPointsSoA(mat, cx, cy, cz, outcx, outcy, outcz, count);
+	zmlTransformPointsSoA(&absolute, ex, ey, ez, outex, outey, outez, count);
+}
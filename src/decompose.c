@@ -0,0 +1,575 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+// ==============================================================================
+// The decompositions are blocked and right-looking, in the same way as LAPACK's: each step factors a panel of
+// _ZML_DECOMPOSE_NB columns with a simple loop, then updates the whole trailing matrix with zmlGemm(), which is
+// where almost all of the work for large matrices ends up.
+// The triangular solves are blocked the same way.
+// ==============================================================================
+
+#define _ZML_DECOMPOSE_NB 64
+
+#define _zml_min(a, b) (((a) < (b)) ? (a) : (b))
+
+// a view of the rows x cols block of mat starting at (r, c). It shares mat's storage and has no row pointers, so it
+// can only be given to functions that go through data and stride (such as zmlGemm()).
+static zmlMatrix _zml_block(const zmlMatrix *mat, size_t r, size_t c, size_t rows, size_t cols) {
+	zmlMatrix v;
+	v.rows = (unsigned int) rows;
+	v.cols = (unsigned int) cols;
+	v.elements = NULL;
+	v.data = mat->data + r * mat->stride + c;
+	v.stride = mat->stride;
+	return v;
+}
+
+// y -= a * x, for n elements.
+static void _zml_subtractScaledRow(__zml_floating *y, const __zml_floating *x, __zml_floating a, size_t n) {
+	for (size_t j = 0; j < n; j++) {
+		y[j] -= a * x[j];
+	}
+}
+
+// swap n elements of two rows.
+static void _zml_swapRows(__zml_floating *a, __zml_floating *b, size_t n) {
+	for (size_t j = 0; j < n; j++) {
+		const __zml_floating t = a[j];
+		a[j] = b[j];
+		b[j] = t;
+	}
+}
+
+// -------------------------------------------
+// triangular solves
+// -------------------------------------------
+
+// solve op(t) x = b for the n x w block b (rows ldb elements apart), overwriting it with x. t is an n x n triangular block
+// (rows ldt elements apart) of which only the lower or upper triangle is read; op(t) is t, or its transpose if trans is set.
+// If unit is set, the diagonal of t is taken to be all ones. Every update is a multiple of one row of b subtracted from another.
+static void _zml_solveTriangularBlock(const __zml_floating *t, size_t ldt, unsigned char lower, unsigned char trans, unsigned char unit,
+	__zml_floating *b, size_t ldb, size_t n, size_t w) {
+	#define _t(r, c) t[(r) * ldt + (c)]
+	#define _b(r) (b + (r) * ldb)
+
+	if (!trans) {
+		// row i of x only depends on the rows of x before it (lower) or after it (upper)
+		for (size_t s = 0; s < n; s++) {
+			const size_t i = lower ? s : n - 1 - s;
+			const size_t p0 = lower ? 0 : i + 1;
+			const size_t p1 = lower ? i : n;
+			for (size_t p = p0; p < p1; p++) {
+				_zml_subtractScaledRow(_b(i), _b(p), _t(i, p), w);
+			}
+			if (!unit) {
+				const __zml_floating inv = (__zml_floating) 1.0 / _t(i, i);
+				for (size_t j = 0; j < w; j++) {
+					_b(i)[j] *= inv;
+				}
+			}
+		}
+	} else {
+		// with the transpose, each row of x is finished first and then removed from the rows that depend on it
+		for (size_t s = 0; s < n; s++) {
+			const size_t i = lower ? n - 1 - s : s;
+			if (!unit) {
+				const __zml_floating inv = (__zml_floating) 1.0 / _t(i, i);
+				for (size_t j = 0; j < w; j++) {
+					_b(i)[j] *= inv;
+				}
+			}
+			const size_t p0 = lower ? 0 : i + 1;
+			const size_t p1 = lower ? i : n;
+			for (size_t p = p0; p < p1; p++) {
+				_zml_subtractScaledRow(_b(p), _b(i), _t(i, p), w);
+			}
+		}
+	}
+
+	#undef _t
+	#undef _b
+}
+
+// solve op(t) x = b for x, overwriting b, where t is n x n and b is n x w (see _zml_solveTriangularBlock()).
+// Blocks of _ZML_DECOMPOSE_NB rows are solved directly, and then removed from the rest of b with zmlGemm().
+static void _zml_solveTriangular(const zmlMatrix *t, unsigned char lower, unsigned char trans, unsigned char unit, zmlMatrix *b) {
+	const size_t n = t->rows;
+	const size_t w = b->cols;
+
+	if (lower != trans) {
+		// op(t) is lower triangular: go forwards
+		for (size_t k = 0; k < n; k += _ZML_DECOMPOSE_NB) {
+			const size_t kb = _zml_min(_ZML_DECOMPOSE_NB, n - k);
+			_zml_solveTriangularBlock(&_zml_at(*t, k, k), t->stride, lower, trans, unit, &_zml_at(*b, k, 0), b->stride, kb, w);
+
+			if (k + kb < n) {
+				const size_t rest = n - k - kb;
+				const zmlMatrix tk = trans ? _zml_block(t, k, k + kb, kb, rest) : _zml_block(t, k + kb, k, rest, kb);
+				zmlMatrix below = _zml_block(b, k + kb, 0, rest, w);
+				zmlGemm(trans, ZML_NO_TRANSPOSE, (__zml_floating) -1.0, tk, _zml_block(b, k, 0, kb, w), (__zml_floating) 1.0, &below);
+			}
+		}
+	} else {
+		// op(t) is upper triangular: go backwards
+		size_t end = n;
+		while (end > 0) {
+			const size_t k = (end > _ZML_DECOMPOSE_NB) ? end - _ZML_DECOMPOSE_NB : 0;
+			const size_t kb = end - k;
+			_zml_solveTriangularBlock(&_zml_at(*t, k, k), t->stride, lower, trans, unit, &_zml_at(*b, k, 0), b->stride, kb, w);
+
+			if (k > 0) {
+				const zmlMatrix tk = trans ? _zml_block(t, k, 0, kb, k) : _zml_block(t, 0, k, k, kb);
+				zmlMatrix above = _zml_block(b, 0, 0, k, w);
+				zmlGemm(trans, ZML_NO_TRANSPOSE, (__zml_floating) -1.0, tk, _zml_block(b, k, 0, kb, w), (__zml_floating) 1.0, &above);
+			}
+			end = k;
+		}
+	}
+}
+
+// -------------------------------------------
+// LU decomposition
+// -------------------------------------------
+
+// panels at most this wide are factored directly rather than split in half.
+#define _ZML_LU_PANEL_MIN 8
+
+// factor the columns [j0, j1) of mat from row j0 down, with whole rows swapped for pivoting; the columns before j0 must already be
+// factored and the updates from them applied. Wide panels are split in half recursively, so that most of their work also goes
+// through zmlGemm(). Returns 0 if a zero pivot is found.
+static unsigned char _zml_luPanel(zmlMatrix *mat, unsigned int *pivots, size_t j0, size_t j1) {
+	const size_t n = mat->rows;
+
+	if (j1 - j0 <= _ZML_LU_PANEL_MIN) {
+		for (size_t j = j0; j < j1; j++) {
+			size_t p = j;
+			__zml_floating best = (__zml_floating) fabs(_zml_at(*mat, j, j));
+			for (size_t i = j + 1; i < n; i++) {
+				const __zml_floating v = (__zml_floating) fabs(_zml_at(*mat, i, j));
+				if (v > best) {
+					best = v;
+					p = i;
+				}
+			}
+			pivots[j] = (unsigned int) p;
+			if (best == (__zml_floating) 0.0) {
+				return 0;
+			}
+			if (p != j) {
+				_zml_swapRows(&_zml_at(*mat, j, 0), &_zml_at(*mat, p, 0), mat->cols);
+			}
+
+			const __zml_floating *pivot = &_zml_at(*mat, j, 0);
+			const __zml_floating invpivot = (__zml_floating) 1.0 / pivot[j];
+			for (size_t i = j + 1; i < n; i++) {
+				__zml_floating *row = &_zml_at(*mat, i, 0);
+				const __zml_floating l = row[j] * invpivot;
+				row[j] = l;
+				_zml_subtractScaledRow(row + j + 1, pivot + j + 1, l, j1 - j - 1);
+			}
+		}
+		return 1;
+	}
+
+	const size_t mid = j0 + (j1 - j0) / 2;
+	if (!_zml_luPanel(mat, pivots, j0, mid)) {
+		return 0;
+	}
+
+	// bring the right half up to date with the left half, as in the main loop of _zml_luFactor()
+	_zml_solveTriangularBlock(&_zml_at(*mat, j0, j0), mat->stride, 1, 0, 1, &_zml_at(*mat, j0, mid), mat->stride, mid - j0, j1 - mid);
+	zmlMatrix right = _zml_block(mat, mid, mid, n - mid, j1 - mid);
+	zmlGemm(ZML_NO_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) -1.0, _zml_block(mat, mid, j0, n - mid, mid - j0), _zml_block(mat, j0, mid, mid - j0, j1 - mid),
+		(__zml_floating) 1.0, &right);
+
+	return _zml_luPanel(mat, pivots, mid, j1);
+}
+
+unsigned char _zml_luFactor(zmlMatrix *mat, unsigned int *pivots) {
+	const size_t n = mat->rows;
+
+	for (size_t k = 0; k < n; k += _ZML_DECOMPOSE_NB) {
+		const size_t kb = _zml_min(_ZML_DECOMPOSE_NB, n - k);
+		const size_t kend = k + kb;
+
+		if (!_zml_luPanel(mat, pivots, k, kend)) {
+			return 0;
+		}
+
+		if (kend < n) {
+			const size_t rest = n - kend;
+
+			// U12 = L11^-1 A12
+			_zml_solveTriangularBlock(&_zml_at(*mat, k, k), mat->stride, 1, 0, 1, &_zml_at(*mat, k, kend), mat->stride, kb, rest);
+
+			// A22 -= L21 U12
+			zmlMatrix a22 = _zml_block(mat, kend, kend, rest, rest);
+			zmlGemm(ZML_NO_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) -1.0, _zml_block(mat, kend, k, rest, kb), _zml_block(mat, k, kend, kb, rest),
+				(__zml_floating) 1.0, &a22);
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief LU decomposition with partial pivoting: P A = L U, where L is lower triangular with ones on its diagonal and U is upper triangular.
+ * mat is overwritten with U (on and above the diagonal) and L (below the diagonal, without its diagonal of ones).
+ * Returns 1 on success, or 0 if mat is singular (in which case its contents are unspecified).
+ * 
+ * @param mat the square matrix to decompose.
+ * @param pivots an array of mat->rows elements to store the row swaps in: row i was swapped with row pivots[i] at step i.
+ */
+unsigned char zmlLUDecompose(zmlMatrix *mat, unsigned int *pivots) {
+	if (mat->rows != mat->cols) {
+		printf("zetaml: zmlLUDecompose(): given matrix is not square! no decomposition performed!\n");
+		return 0;
+	}
+
+	if (!_zml_luFactor(mat, pivots)) {
+		printf("zetaml: zmlLUDecompose(): given matrix is singular!\n");
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief solve A X = B, given the LU decomposition of A from zmlLUDecompose(). b is overwritten with X.
+ * 
+ * @param lu the decomposition of A.
+ * @param pivots the row swaps from zmlLUDecompose().
+ * @param b the right-hand side(s), one per column. Must have as many rows as lu.
+ */
+void zmlLUSolve(zmlMatrix lu, const unsigned int *pivots, zmlMatrix *b) {
+	if (lu.rows != lu.cols || b->rows != lu.rows) {
+		printf("zetaml: zmlLUSolve(): b must have as many rows as the (square) decomposition! nothing solved!\n");
+		return;
+	}
+
+	for (unsigned int i = 0; i < lu.rows; i++) {
+		if (pivots[i] != i) {
+			_zml_swapRows(&_zml_at(*b, i, 0), &_zml_at(*b, pivots[i], 0), b->cols);
+		}
+	}
+
+	_zml_solveTriangular(&lu, 1, 0, 1, b);
+	_zml_solveTriangular(&lu, 0, 0, 0, b);
+}
+
+// -------------------------------------------
+// Cholesky decomposition
+// -------------------------------------------
+
+// factor the lower triangle of mat in place, using buf (_ZML_DECOMPOSE_NB * mat->rows elements) for the panels; returns 0 if it
+// isn't positive definite.
+static unsigned char _zml_choleskyFactor(zmlMatrix *mat, __zml_floating *buf) {
+	const size_t n = mat->rows;
+
+	for (size_t k = 0; k < n; k += _ZML_DECOMPOSE_NB) {
+		const size_t kb = _zml_min(_ZML_DECOMPOSE_NB, n - k);
+		const size_t kend = k + kb;
+
+		// factor the diagonal block; the columns before k have already been subtracted from it
+		for (size_t j = k; j < kend; j++) {
+			const __zml_floating *lj = &_zml_at(*mat, j, 0);
+
+			__zml_floating d = lj[j];
+			for (size_t p = k; p < j; p++) {
+				d -= lj[p] * lj[p];
+			}
+			if (!(d > (__zml_floating) 0.0)) {
+				return 0;
+			}
+			const __zml_floating diag = _zml_sqrt(d);
+			_zml_at(*mat, j, j) = diag;
+
+			const __zml_floating inv = (__zml_floating) 1.0 / diag;
+			for (size_t i = j + 1; i < kend; i++) {
+				__zml_floating *li = &_zml_at(*mat, i, 0);
+				__zml_floating s = li[j];
+				for (size_t p = k; p < j; p++) {
+					s -= li[p] * lj[p];
+				}
+				li[j] = s * inv;
+			}
+		}
+		if (kend == n) {
+			break;
+		}
+
+		// L21 = A21 L11^-T, solved as L11 L21^T = A21^T on a transposed copy so that the updates run along whole rows
+		const size_t rest = n - kend;
+		for (size_t i = 0; i < rest; i++) {
+			const __zml_floating *src = &_zml_at(*mat, kend + i, k);
+			for (size_t j = 0; j < kb; j++) {
+				buf[j * rest + i] = src[j];
+			}
+		}
+		_zml_solveTriangularBlock(&_zml_at(*mat, k, k), mat->stride, 1, 0, 0, buf, rest, kb, rest);
+		for (size_t i = 0; i < rest; i++) {
+			__zml_floating *dst = &_zml_at(*mat, kend + i, k);
+			for (size_t j = 0; j < kb; j++) {
+				dst[j] = buf[j * rest + i];
+			}
+		}
+
+		// A22 -= L21 L21^T, for the lower triangle only: one block column at a time, each starting at the diagonal
+		for (size_t j = kend; j < n; j += _ZML_DECOMPOSE_NB) {
+			const size_t jb = _zml_min(_ZML_DECOMPOSE_NB, n - j);
+			zmlMatrix c = _zml_block(mat, j, j, n - j, jb);
+			zmlGemm(ZML_NO_TRANSPOSE, ZML_TRANSPOSE, (__zml_floating) -1.0, _zml_block(mat, j, k, n - j, kb), _zml_block(mat, j, k, jb, kb),
+				(__zml_floating) 1.0, &c);
+		}
+	}
+
+	// the updates above also write over the upper triangle of each diagonal block, so clear it to leave L on its own
+	for (size_t r = 0; r < n; r++) {
+		memset(&_zml_at(*mat, r, r + 1), 0, (n - r - 1) * sizeof(__zml_floating));
+	}
+	return 1;
+}
+
+/**
+ * @brief Cholesky decomposition of a symmetric positive-definite matrix: A = L L^T, where L is lower triangular.
+ * Only the lower triangle of mat is read, and mat is overwritten with L (with zeros above the diagonal).
+ * Returns 1 on success, or 0 if mat is not positive definite (in which case its contents are unspecified).
+ * 
+ * @param mat the square matrix to decompose.
+ */
+unsigned char zmlCholeskyDecompose(zmlMatrix *mat) {
+	if (mat->rows != mat->cols) {
+		printf("zetaml: zmlCholeskyDecompose(): given matrix is not square! no decomposition performed!\n");
+		return 0;
+	}
+
+	__zml_floating *buf = (__zml_floating *) _zml_alloc((size_t) _ZML_DECOMPOSE_NB * mat->rows * sizeof(__zml_floating), ZML_ALIGNMENT);
+	if (!buf) {
+		printf("zetaml: zmlCholeskyDecompose(): out of memory! no decomposition performed!\n");
+		return 0;
+	}
+
+	const unsigned char ok = _zml_choleskyFactor(mat, buf);
+	_zml_free(buf);
+
+	if (!ok) {
+		printf("zetaml: zmlCholeskyDecompose(): given matrix is not positive definite!\n");
+	}
+	return ok;
+}
+
+/**
+ * @brief solve A X = B, given the Cholesky decomposition L of A from zmlCholeskyDecompose(). b is overwritten with X.
+ * 
+ * @param l the decomposition of A.
+ * @param b the right-hand side(s), one per column. Must have as many rows as l.
+ */
+void zmlCholeskySolve(zmlMatrix l, zmlMatrix *b) {
+	if (l.rows != l.cols || b->rows != l.rows) {
+		printf("zetaml: zmlCholeskySolve(): b must have as many rows as the (square) decomposition! nothing solved!\n");
+		return;
+	}
+
+	_zml_solveTriangular(&l, 1, 0, 0, b);
+	_zml_solveTriangular(&l, 1, 1, 0, b);
+}
+
+// -------------------------------------------
+// QR decomposition
+// -------------------------------------------
+
+// form the block reflector of the kb Householder vectors stored in columns [k, k + kb) of qr:
+// H(k) H(k + 1) ... H(k + kb - 1) = I - V T V^T. v must be at least (qr->rows - k) x kb; the vectors are copied into it with
+// their implicit unit diagonal and the zeros above it filled in. tau holds the kb scale factors of the block, and t (kb x kb, row-major) is
+// written with the upper triangular T.
+static void _zml_qrBlockReflector(const zmlMatrix *qr, const __zml_floating *tau, size_t k, size_t kb, zmlMatrix *v, __zml_floating *t) {
+	const size_t m = qr->rows - k;
+
+	for (size_t i = 0; i < m; i++) {
+		const __zml_floating *src = &_zml_at(*qr, k + i, k);
+		__zml_floating *dst = &_zml_at(*v, i, 0);
+		for (size_t j = 0; j < kb; j++) {
+			dst[j] = (j < i) ? src[j] : (j == i) ? (__zml_floating) 1.0 : (__zml_floating) 0.0;
+		}
+	}
+
+	// G = V^T V, then column j of T is -tau[j] * T[0:j, 0:j] * G[0:j, j]
+	__zml_floating g[_ZML_DECOMPOSE_NB * _ZML_DECOMPOSE_NB];
+	zmlMatrix gmat = { (unsigned int) kb, (unsigned int) kb, NULL, g, (unsigned int) kb };
+	zmlGemm(ZML_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) 1.0, *v, *v, (__zml_floating) 0.0, &gmat);
+
+	for (size_t j = 0; j < kb; j++) {
+		for (size_t p = 0; p < j; p++) {
+			__zml_floating s = (__zml_floating) 0.0;
+			for (size_t q = p; q < j; q++) {
+				s += t[p * kb + q] * g[q * kb + j];
+			}
+			t[p * kb + j] = -tau[j] * s;
+		}
+		t[j * kb + j] = tau[j];
+		for (size_t p = j + 1; p < kb; p++) {
+			t[p * kb + j] = (__zml_floating) 0.0;
+		}
+	}
+}
+
+// c = (I - V T V^T)^T c = (I - V T^T V^T) c, where c has as many rows as v. w is a kb x c->cols buffer.
+static void _zml_qrApplyBlockReflector(const zmlMatrix *v, const __zml_floating *t, size_t kb, zmlMatrix *c, zmlMatrix *w) {
+	// W = V^T C
+	zmlGemm(ZML_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) 1.0, *v, *c, (__zml_floating) 0.0, w);
+
+	// W = T^T W; T^T is lower triangular, so each row only depends on the ones above it and can be done bottom-up in place
+	for (size_t p = kb; p-- > 0;) {
+		__zml_floating *wp = &_zml_at(*w, p, 0);
+		const __zml_floating tpp = t[p * kb + p];
+		for (size_t j = 0; j < w->cols; j++) {
+			wp[j] *= tpp;
+		}
+		for (size_t q = 0; q < p; q++) {
+			_zml_subtractScaledRow(wp, &_zml_at(*w, q, 0), -t[q * kb + p], w->cols);
+		}
+	}
+
+	// C -= V W
+	zmlGemm(ZML_NO_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) -1.0, *v, *w, (__zml_floating) 1.0, c);
+}
+
+/**
+ * @brief Householder QR decomposition: A = Q R, where Q is orthogonal and R is upper triangular. A must have at least as many rows as columns.
+ * mat is overwritten with R (on and above the diagonal) and the Householder vectors that make up Q (below the diagonal).
+ * Returns the scale factors of the Householder reflections (one per column), which must be given to zmlQRSolve() along with mat and
+ * freed with zmlFreeVector(); ZML_NULL_VECTOR is returned if mat has more columns than rows.
+ * 
+ * @param mat the matrix to decompose.
+ */
+zmlVector zmlQRDecompose(zmlMatrix *mat) {
+	if (mat->rows < mat->cols) {
+		printf("zetaml: zmlQRDecompose(): given matrix has more columns than rows! null vector returned!\n");
+		return ZML_NULL_VECTOR;
+	}
+
+	const size_t m = mat->rows;
+	const size_t n = mat->cols;
+	zmlVector tau = zmlAllocVector(mat->cols);
+
+	zmlMatrix v = zmlAllocMatrix(mat->rows, _ZML_DECOMPOSE_NB);
+	zmlMatrix w = zmlAllocMatrix(_ZML_DECOMPOSE_NB, mat->cols);
+	__zml_floating t[_ZML_DECOMPOSE_NB * _ZML_DECOMPOSE_NB];
+	__zml_floating dots[_ZML_DECOMPOSE_NB];
+
+	for (size_t k = 0; k < n; k += _ZML_DECOMPOSE_NB) {
+		const size_t kb = _zml_min(_ZML_DECOMPOSE_NB, n - k);
+		const size_t kend = k + kb;
+
+		// factor the panel of columns [k, kend) one column at a time
+		for (size_t j = k; j < kend; j++) {
+			// the reflection that maps column j (from the diagonal down) onto a multiple of the first axis
+			const __zml_floating alpha = _zml_at(*mat, j, j);
+			__zml_floating sigma = (__zml_floating) 0.0;
+			for (size_t i = j + 1; i < m; i++) {
+				sigma += _zml_at(*mat, i, j) * _zml_at(*mat, i, j);
+			}
+			if (sigma == (__zml_floating) 0.0) {
+				tau.elements[j] = (__zml_floating) 0.0;
+				continue;
+			}
+
+			const __zml_floating norm = _zml_sqrt(alpha * alpha + sigma);
+			const __zml_floating beta = (alpha >= (__zml_floating) 0.0) ? -norm : norm;
+			tau.elements[j] = (beta - alpha) / beta;
+			const __zml_floating scale = (__zml_floating) 1.0 / (alpha - beta);
+			for (size_t i = j + 1; i < m; i++) {
+				_zml_at(*mat, i, j) *= scale;
+			}
+			_zml_at(*mat, j, j) = beta;
+
+			// apply it to the rest of the panel: A -= tau v (v^T A), where v[j] is an implicit 1
+			const size_t cols = kend - j - 1;
+			if (cols == 0) {
+				continue;
+			}
+			memcpy(dots, &_zml_at(*mat, j, j + 1), cols * sizeof(__zml_floating));
+			for (size_t i = j + 1; i < m; i++) {
+				_zml_subtractScaledRow(dots, &_zml_at(*mat, i, j + 1), -_zml_at(*mat, i, j), cols);
+			}
+			for (size_t c = 0; c < cols; c++) {
+				dots[c] *= tau.elements[j];
+			}
+			_zml_subtractScaledRow(&_zml_at(*mat, j, j + 1), dots, (__zml_floating) 1.0, cols);
+			for (size_t i = j + 1; i < m; i++) {
+				_zml_subtractScaledRow(&_zml_at(*mat, i, j + 1), dots, _zml_at(*mat, i, j), cols);
+			}
+		}
+
+		// apply the panel's reflections to the trailing columns all at once
+		if (kend < n) {
+			zmlMatrix vk = _zml_block(&v, 0, 0, m - k, kb);
+			zmlMatrix wk = _zml_block(&w, 0, 0, kb, n - kend);
+			zmlMatrix trailing = _zml_block(mat, k, kend, m - k, n - kend);
+			_zml_qrBlockReflector(mat, tau.elements + k, k, kb, &vk, t);
+			_zml_qrApplyBlockReflector(&vk, t, kb, &trailing, &wk);
+		}
+	}
+
+	zmlFreeMatrix(&w);
+	zmlFreeMatrix(&v);
+	return tau;
+}
+
+/**
+ * @brief solve A X = B in the least-squares sense (minimising the 2-norm of each column of A X - B), given the QR decomposition
+ * of A from zmlQRDecompose(). A must have full column rank. b is replaced by X, which has as many rows as A has columns.
+ * 
+ * @param qr the decomposition of A.
+ * @param tau the scale factors returned by zmlQRDecompose().
+ * @param b the right-hand side(s), one per column. Must have as many rows as qr.
+ */
+void zmlQRSolve(zmlMatrix qr, zmlVector tau, zmlMatrix *b) {
+	if (b->rows != qr.rows || tau.size != qr.cols || qr.rows < qr.cols) {
+		printf("zetaml: zmlQRSolve(): b must have as many rows as the decomposition, and tau must come from its zmlQRDecompose() call! nothing solved!\n");
+		return;
+	}
+
+	const size_t m = qr.rows;
+	const size_t n = qr.cols;
+
+	// B = Q^T B, one block of reflections at a time
+	zmlMatrix v = zmlAllocMatrix(qr.rows, _ZML_DECOMPOSE_NB);
+	zmlMatrix w = zmlAllocMatrix(_ZML_DECOMPOSE_NB, b->cols);
+	__zml_floating t[_ZML_DECOMPOSE_NB * _ZML_DECOMPOSE_NB];
+
+	for (size_t k = 0; k < n; k += _ZML_DECOMPOSE_NB) {
+		const size_t kb = _zml_min(_ZML_DECOMPOSE_NB, n - k);
+		zmlMatrix vk = _zml_block(&v, 0, 0, m - k, kb);
+		zmlMatrix wk = _zml_block(&w, 0, 0, kb, b->cols);
+		zmlMatrix bk = _zml_block(b, k, 0, m - k, b->cols);
+		_zml_qrBlockReflector(&qr, tau.elements + k, k, kb, &vk, t);
+		_zml_qrApplyBlockReflector(&vk, t, kb, &bk, &wk);
+	}
+
+	zmlFreeMatrix(&w);
+	zmlFreeMatrix(&v);
+
+	// R X = (Q^T B)[0:n]
+	zmlMatrix x = zmlAllocMatrix(qr.cols, b->cols);
+	for (unsigned int r = 0; r < qr.cols; r++) {
+		memcpy(&_zml_at(x, r, 0), &_zml_at(*b, r, 0), b->cols * sizeof(__zml_floating));
+	}
+	const zmlMatrix rmat = _zml_block(&qr, 0, 0, n, n);
+	_zml_solveTriangular(&rmat, 0, 0, 0, &x);
+
+	zmlFreeMatrix(b);
+	*b = x;
+}
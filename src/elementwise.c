@@ -0,0 +1,39 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+typedef struct {
+	_zml_elementwiseOp op;
+	__zml_floating *dst;
+	const __zml_floating *a;
+	const __zml_floating *b;
+	__zml_floating scalar;
+} _zml_elementwiseArgs;
+
+static void _zml_elementwiseRange(void *ctx, size_t begin, size_t end) {
+	_zml_elementwiseArgs *args = (_zml_elementwiseArgs *) ctx;
+	_zml_kernels()->elementwise(args->op, args->dst + begin, args->a + begin, args->b ? args->b + begin : NULL, args->scalar, end - begin);
+}
+
+void _zml_applyElementwise(_zml_elementwiseOp op, __zml_floating *dst, const __zml_floating *a, const __zml_floating *b, __zml_floating scalar, size_t n) {
+	_zml_elementwiseArgs args = { op, dst, a, b, scalar };
+
+	// these are memory-bound, so only really big arrays gain anything from extra threads
+	if (n < ZML_PARALLEL_THRESHOLD * 4) {
+		_zml_elementwiseRange(&args, 0, n);
+		return;
+	}
+
+	_zml_parallelFor(n, ZML_PARALLEL_THRESHOLD, _zml_elementwiseRange, &args);
+}
@@ -0,0 +1,456 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+// defines the by-value operators of the fixed-size vector type zmlVec[n]
+#define _zml_defineVecOperators(n) \
+	zmlVec##n zmlAddVec##n##s_r(zmlVec##n v1, zmlVec##n v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] += v2.elements[i];\
+		return v1;\
+	}\
+	zmlVec##n zmlSubtractVec##n##s_r(zmlVec##n v1, zmlVec##n v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] -= v2.elements[i];\
+		return v1;\
+	}\
+	zmlVec##n zmlMultiplyVec##n##s_r(zmlVec##n v1, zmlVec##n v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] *= v2.elements[i];\
+		return v1;\
+	}\
+	zmlVec##n zmlDivideVec##n##s_r(zmlVec##n v1, zmlVec##n v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] /= v2.elements[i];\
+		return v1;\
+	}\
+	zmlVec##n zmlAddVec##n##Scalar_r(zmlVec##n v1, __zml_floating v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] += v2;\
+		return v1;\
+	}\
+	zmlVec##n zmlSubtractVec##n##Scalar_r(zmlVec##n v1, __zml_floating v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] -= v2;\
+		return v1;\
+	}\
+	zmlVec##n zmlMultiplyVec##n##Scalar_r(zmlVec##n v1, __zml_floating v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] *= v2;\
+		return v1;\
+	}\
+	zmlVec##n zmlDivideVec##n##Scalar_r(zmlVec##n v1, __zml_floating v2) {\
+		for (unsigned int i = 0; i < n; i++) v1.elements[i] /= v2;\
+		return v1;\
+	}\
+	__zml_floating zmlDotVec##n(zmlVec##n v1, zmlVec##n v2) {\
+		__zml_floating r = (__zml_floating) 0.0;\
+		for (unsigned int i = 0; i < n; i++) r += v1.elements[i] * v2.elements[i];\
+		return r;\
+	}\
+	__zml_floating zmlMagnitudeVec##n(zmlVec##n vec) {\
+		return (__zml_floating) sqrt(zmlDotVec##n(vec, vec));\
+	}\
+	zmlVec##n zmlNormalisedVec##n(zmlVec##n vec) {\
+		return zmlDivideVec##n##Scalar_r(vec, zmlMagnitudeVec##n(vec));\
+	}
+
+_zml_defineVecOperators(2)
+_zml_defineVecOperators(3)
+_zml_defineVecOperators(4)
+
+zmlVec3 zmlCrossVec3(zmlVec3 v1, zmlVec3 v2) {
+	zmlVec3 r;
+
+	r.elements[0] = v1.elements[1] * v2.elements[2] - v1.elements[2] * v2.elements[1];
+	r.elements[1] = v1.elements[2] * v2.elements[0] - v1.elements[0] * v2.elements[2];
+	r.elements[2] = v1.elements[0] * v2.elements[1] - v1.elements[1] * v2.elements[0];
+
+	return r;
+}
+
+// defines the by-value functions of the fixed-size square matrix type zmlMat[n] (and its vector type zmlVec[n])
+#define _zml_defineMatFunctions(n) \
+	zmlMat##n zmlIdentityMat##n(void) {\
+		zmlMat##n r;\
+		for (unsigned int row = 0; row < n; row++) {\
+			for (unsigned int col = 0; col < n; col++) {\
+				r.elements[row][col] = (row == col) ? (__zml_floating) 1.0 : (__zml_floating) 0.0;\
+			}\
+		}\
+		return r;\
+	}\
+	zmlMat##n zmlTransposedMat##n(zmlMat##n mat) {\
+		zmlMat##n r;\
+		for (unsigned int row = 0; row < n; row++) {\
+			for (unsigned int col = 0; col < n; col++) {\
+				r.elements[col][row] = mat.elements[row][col];\
+			}\
+		}\
+		return r;\
+	}\
+	zmlMat##n zmlMultiplyMat##n##s_r(zmlMat##n v1, zmlMat##n v2) {\
+		zmlMat##n r;\
+		for (unsigned int row = 0; row < n; row++) {\
+			for (unsigned int col = 0; col < n; col++) {\
+				r.elements[row][col] = v1.elements[row][0] * v2.elements[0][col];\
+			}\
+			for (unsigned int k = 1; k < n; k++) {\
+				for (unsigned int col = 0; col < n; col++) {\
+					r.elements[row][col] += v1.elements[row][k] * v2.elements[k][col];\
+				}\
+			}\
+		}\
+		return r;\
+	}\
+	zmlVec##n zmlMultiplyVec##n##Mat##n##_r(zmlVec##n v1, zmlMat##n v2) {\
+		zmlVec##n r;\
+		for (unsigned int row = 0; row < n; row++) {\
+			r.elements[row] = (__zml_floating) 0.0;\
+			for (unsigned int col = 0; col < n; col++) {\
+				r.elements[row] += v2.elements[row][col] * v1.elements[col];\
+			}\
+		}\
+		return r;\
+	}\
+	zmlMatrix zmlMat##n##ToMatrix(zmlMat##n mat) {\
+		zmlMatrix r = zmlAllocMatrix(n, n);\
+		for (unsigned int row = 0; row < n; row++) {\
+			memcpy(&_zml_at(r, row, 0), mat.elements[row], n * sizeof(__zml_floating));\
+		}\
+		return r;\
+	}\
+	zmlMat##n zmlMatrixToMat##n(zmlMatrix mat) {\
+		zmlMat##n r = zmlIdentityMat##n();\
+		for (unsigned int row = 0; row < n && row < mat.rows; row++) {\
+			for (unsigned int col = 0; col < n && col < mat.cols; col++) {\
+				r.elements[row][col] = _zml_at(mat, row, col);\
+			}\
+		}\
+		return r;\
+	}
+
+_zml_defineMatFunctions(3)
+_zml_defineMatFunctions(4)
+
+/**
+ * @brief fixed-size equivalent of zmlTranslated().
+ * 
+ * @param mat the matrix to base the translation matrix on.
+ * @param vec the vector to use as the translation factor.
+ */
+zmlMat4 zmlTranslatedMat4(zmlMat4 mat, zmlVec3 vec) {
+	// the fourth column becomes the sum of the first three columns (each multiplied by the appropriate vector element) and itself.
+	for (unsigned int r = 0; r < 4; r++) {
+		mat.elements[r][3] += mat.elements[r][0] * vec.elements[0] + mat.elements[r][1] * vec.elements[1] + mat.elements[r][2] * vec.elements[2];
+	}
+	return mat;
+}
+/**
+ * @brief fixed-size equivalent of zmlTranslateIdentity().
+ * 
+ * @param vec the vector to use as the translation factor.
+ */
+zmlMat4 zmlTranslateIdentityMat4(zmlVec3 vec) {
+	return zmlTranslatedMat4(zmlIdentityMat4(), vec);
+}
+
+unsigned char _zml_axisAngleRotation(__zml_floating r[3][3], __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z) {
+	const __zml_floating lensq = x * x + y * y + z * z;
+
+	// there is no rotation without an angle or an axis
+	if (angle == (__zml_floating) 0.0 || lensq == (__zml_floating) 0.0) {
+		return 0;
+	}
+
+	// normalise the axis
+	const __zml_floating invlen = (__zml_floating) 1.0 / _zml_sqrt(lensq);
+	x *= invlen;
+	y *= invlen;
+	z *= invlen;
+
+	const __zml_floating c = _zml_cos(angle);
+	const __zml_floating s = _zml_sin(angle);
+	const __zml_floating t = (__zml_floating) 1.0 - c;
+
+	// Rodrigues' rotation formula
+	const __zml_floating tx = t * x, ty = t * y, tz = t * z;
+	const __zml_floating sx = s * x, sy = s * y, sz = s * z;
+
+	r[0][0] = tx * x + c;	r[0][1] = tx * y - sz;	r[0][2] = tx * z + sy;
+	r[1][0] = tx * y + sz;	r[1][1] = ty * y + c;	r[1][2] = ty * z - sx;
+	r[2][0] = tx * z - sy;	r[2][1] = ty * z + sx;	r[2][2] = tz * z + c;
+
+	return 1;
+}
+
+void _zml_eulerRotation(__zml_floating r[3][3], zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	const __zml_floating cx = _zml_cos(x), sx = _zml_sin(x);
+	const __zml_floating cy = _zml_cos(y), sy = _zml_sin(y);
+	const __zml_floating cz = _zml_cos(z), sz = _zml_sin(z);
+
+	// each case is the product of the three single-axis rotations, multiplied out
+	switch (order) {
+		case ZML_EULER_ZYX: // Rz * Ry * Rx
+			r[0][0] = cz * cy;	r[0][1] = cz * sy * sx - sz * cx;	r[0][2] = cz * sy * cx + sz * sx;
+			r[1][0] = sz * cy;	r[1][1] = sz * sy * sx + cz * cx;	r[1][2] = sz * sy * cx - cz * sx;
+			r[2][0] = -sy;		r[2][1] = cy * sx;					r[2][2] = cy * cx;
+			break;
+		case ZML_EULER_YXZ: // Ry * Rx * Rz
+			r[0][0] = cy * cz + sy * sx * sz;	r[0][1] = sy * sx * cz - cy * sz;	r[0][2] = sy * cx;
+			r[1][0] = cx * sz;					r[1][1] = cx * cz;					r[1][2] = -sx;
+			r[2][0] = cy * sx * sz - sy * cz;	r[2][1] = sy * sz + cy * sx * cz;	r[2][2] = cy * cx;
+			break;
+		default: // ZML_EULER_XYZ: Rx * Ry * Rz
+			r[0][0] = cy * cz;					r[0][1] = -cy * sz;					r[0][2] = sy;
+			r[1][0] = cx * sz + sx * sy * cz;	r[1][1] = cx * cz - sx * sy * sz;	r[1][2] = -sx * cy;
+			r[2][0] = sx * sz - cx * sy * cz;	r[2][1] = sx * cz + cx * sy * sz;	r[2][2] = cx * cy;
+			break;
+	}
+}
+
+void _zml_rotateRows(__zml_floating *m, size_t stride, const __zml_floating r[3][3]) {
+	// the fourth column is unchanged
+	for (unsigned int row = 0; row < 4; row++, m += stride) {
+		const __zml_floating m0 = m[0], m1 = m[1], m2 = m[2];
+
+		m[0] = m0 * r[0][0] + m1 * r[1][0] + m2 * r[2][0];
+		m[1] = m0 * r[0][1] + m1 * r[1][1] + m2 * r[2][1];
+		m[2] = m0 * r[0][2] + m1 * r[1][2] + m2 * r[2][2];
+	}
+}
+
+/**
+ * @brief fixed-size equivalent of zmlRotated().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+zmlMat4 zmlRotatedMat4(zmlMat4 mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z) {
+	__zml_floating rotation[3][3];
+
+	// if there is no rotation then the matrix is returned unchanged
+	if (_zml_axisAngleRotation(rotation, angle, x, y, z)) {
+		_zml_rotateRows(&mat.elements[0][0], 4, rotation);
+	}
+
+	return mat;
+}
+/**
+ * @brief fixed-size equivalent of zmlRotateIdentity().
+ * 
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+zmlMat4 zmlRotateIdentityMat4(__zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z) {
+	return zmlRotatedMat4(zmlIdentityMat4(), angle, x, y, z);
+}
+/**
+ * @brief fixed-size equivalent of zmlRotatedEuler().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+zmlMat4 zmlRotatedEulerMat4(zmlMat4 mat, zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	__zml_floating rotation[3][3];
+	_zml_eulerRotation(rotation, order, x, y, z);
+	_zml_rotateRows(&mat.elements[0][0], 4, rotation);
+	return mat;
+}
+/**
+ * @brief fixed-size equivalent of zmlRotateIdentityEuler().
+ * 
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+zmlMat4 zmlRotateIdentityEulerMat4(zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	__zml_floating rotation[3][3];
+	_zml_eulerRotation(rotation, order, x, y, z);
+
+	// the rotation is the upper-left 3x3 block of an identity matrix
+	zmlMat4 r = zmlIdentityMat4();
+	for (unsigned int row = 0; row < 3; row++) {
+		memcpy(r.elements[row], rotation[row], 3 * sizeof(__zml_floating));
+	}
+	return r;
+}
+
+/**
+ * @brief fixed-size equivalent of zmlScaled().
+ * 
+ * @param mat the matrix to base the scale matrix on.
+ * @param vec the vector to use as the scale factor.
+ */
+zmlMat4 zmlScaledMat4(zmlMat4 mat, zmlVec3 vec) {
+	// the fourth column is not modified.
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int i = 0; i < 3; i++) {
+			mat.elements[r][i] *= vec.elements[i];
+		}
+	}
+	return mat;
+}
+/**
+ * @brief fixed-size equivalent of zmlScaleIdentity().
+ * 
+ * @param vec the vector to use as the scale factor.
+ */
+zmlMat4 zmlScaleIdentityMat4(zmlVec3 vec) {
+	return zmlScaledMat4(zmlIdentityMat4(), vec);
+}
+
+/**
+ * @brief fixed-size equivalent of zmlConstructOrthoMatrixLH(). Uses left-handed coordinates!
+ * 
+ * @param lm the left-most boundary.
+ * @param rm the right-most boundary.
+ * @param bm the bottom-most boundary.
+ * @param tm the top-most boundary.
+ * @param zn the nearest Z coordinate that will be rendered.
+ * @param zf the farthest Z coordinate that will be rendered.
+ */
+zmlMat4 zmlConstructOrthoMat4LH(__zml_floating lm, __zml_floating rm, __zml_floating bm, __zml_floating tm, __zml_floating zn, __zml_floating zf) {
+	zmlMat4 r = zmlIdentityMat4();
+
+	// scale
+	r.elements[0][0] = 2 / (rm - lm);
+	r.elements[1][1] = 2 / (tm - bm);
+	r.elements[2][2] = 2 / (zf - zn);
+
+	// translation
+	r.elements[0][3] = -(rm + lm) / (rm - lm);
+	r.elements[1][3] = -(tm + bm) / (tm - bm);
+	r.elements[2][3] = -(zf + zn) / (zf - zn);
+
+	return r;
+}
+/**
+ * @brief fixed-size equivalent of zmlConstructOrthoMatrixRH(). Uses right-handed coordinates!
+ * 
+ * @param lm the left-most boundary.
+ * @param rm the right-most boundary.
+ * @param bm the bottom-most boundary.
+ * @param tm the top-most boundary.
+ * @param zn the nearest Z coordinate that will be rendered.
+ * @param zf the farthest Z coordinate that will be rendered.
+ */
+zmlMat4 zmlConstructOrthoMat4RH(__zml_floating lm, __zml_floating rm, __zml_floating bm, __zml_floating tm, __zml_floating zn, __zml_floating zf) {
+	zmlMat4 r = zmlConstructOrthoMat4LH(lm, rm, bm, tm, zn, zf);
+
+	// only the Z scale differs from the left-handed matrix
+	r.elements[2][2] = -r.elements[2][2];
+
+	return r;
+}
+
+/**
+ * @brief fixed-size equivalent of zmlConstructPerspectiveMatrixLH(). Uses left-handed coordinates!
+ * 
+ * @param near specifies the distance from the viewer to the nearest clipping plane.
+ * @param far specifies the distance from the viewer to the farthest clipping plane.
+ * @param fovy the angle of the field of view in the y direction.
+ * @param aspect_ratio the aspect ratio of the viewport.
+ */
+zmlMat4 zmlConstructPerspectiveMat4LH(__zml_floating near, __zml_floating far, __zml_floating fovy, __zml_floating aspect_ratio) {
+	zmlMat4 r = zmlIdentityMat4();
+
+	const __zml_floating tfovy_half = (__zml_floating) tan(fovy / 2);
+
+	r.elements[0][0] = 1 / (aspect_ratio * tfovy_half);
+	r.elements[1][1] = 1 / tfovy_half;
+
+	r.elements[2][2] = (near + far) / (far - near);
+	r.elements[3][2] = 1;
+	r.elements[3][3] = 0; // (w is the depth alone)
+
+	r.elements[2][3] = -(2 * far * near) / (far - near);
+
+	return r;
+}
+/**
+ * @brief fixed-size equivalent of zmlConstructPerspectiveMatrixRH(). Uses right-handed coordinates!
+ * 
+ * @param near specifies the distance from the viewer to the nearest clipping plane.
+ * @param far specifies the distance from the viewer to the farthest clipping plane.
+ * @param fovy the angle of the field of view in the y direction.
+ * @param aspect_ratio the aspect ratio of the viewport.
+ */
+zmlMat4 zmlConstructPerspectiveMat4RH(__zml_floating near, __zml_floating far, __zml_floating fovy, __zml_floating aspect_ratio) {
+	zmlMat4 r = zmlConstructPerspectiveMat4LH(near, far, fovy, aspect_ratio);
+
+	// the Z axis is reversed for right-handed coordinates
+	r.elements[2][2] = -r.elements[2][2];
+	r.elements[3][2] = -1;
+
+	return r;
+}
+
+// builds a look-at matrix. 'forward' is multiplied onto the direction the camera is facing in to get the third row,
+// so it is 1 for left-handed coordinates and -1 for right-handed coordinates.
+static zmlMat4 _zml_constructLookAtMat4(zmlVec3 pos, zmlVec3 focus, zmlVec3 up, __zml_floating forward) {
+	// the direction the camera is facing in
+	const zmlVec3 dir = zmlNormalisedVec3(zmlSubtractVec3s_r(focus, pos));
+	// right direction relative to the camera's direction
+	const zmlVec3 right = zmlNormalisedVec3(zmlCrossVec3(dir, up));
+	// up direction relative to the camera's direction
+	const zmlVec3 rup = zmlCrossVec3(right, dir);
+	// relative forward direction
+	const zmlVec3 fwd = zmlMultiplyVec3Scalar_r(dir, forward);
+
+	zmlMat4 r;
+
+	// first row = relative right direction, second row = relative up direction, third row = relative forward direction
+	// the fourth column is the negated dot product of the vector on each row and the position of the camera
+	for (unsigned int i = 0; i < 3; i++) {
+		r.elements[0][i] = right.elements[i];
+		r.elements[1][i] = rup.elements[i];
+		r.elements[2][i] = fwd.elements[i];
+	}
+	r.elements[0][3] = -zmlDotVec3(right, pos);
+	r.elements[1][3] = -zmlDotVec3(rup, pos);
+	r.elements[2][3] = -zmlDotVec3(fwd, pos);
+
+	// the fourth row is [ 0, 0, 0, 1 ].
+	r.elements[3][0] = (__zml_floating) 0.0;
+	r.elements[3][1] = (__zml_floating) 0.0;
+	r.elements[3][2] = (__zml_floating) 0.0;
+	r.elements[3][3] = (__zml_floating) 1.0;
+
+	return r;
+}
+
+/**
+ * @brief fixed-size equivalent of zmlConstructLookAtMatrixLH(). Uses left-handed coordinates!
+ * 
+ * @param pos the position of the viewer/camera.
+ * @param focus the position the viewer/camera is looking at.
+ * @param up an absolute unit vector indicating the up direction. If Y is the 'up' axis, set this to be ( 0, 1, 0 ), for example.
+ */
+zmlMat4 zmlConstructLookAtMat4LH(zmlVec3 pos, zmlVec3 focus, zmlVec3 up) {
+	return _zml_constructLookAtMat4(pos, focus, up, (__zml_floating) 1.0);
+}
+/**
+ * @brief fixed-size equivalent of zmlConstructLookAtMatrixRH(). Uses right-handed coordinates!
+ * 
+ * @param pos the position of the viewer/camera.
+ * @param focus the position the viewer/camera is looking at.
+ * @param up an absolute unit vector indicating the up direction. If Y is the 'up' axis, set this to be ( 0, 1, 0 ), for example.
+ */
+zmlMat4 zmlConstructLookAtMat4RH(zmlVec3 pos, zmlVec3 focus, zmlVec3 up) {
+	// (the third row is reversed for right-handed coordinates)
+	return _zml_constructLookAtMat4(pos, focus, up, (__zml_floating) -1.0);
+}
@@ -0,0 +1,160 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+#ifdef ZML_X86_SIMD
+#	include <immintrin.h>
+#endif
+
+// ==============================================================================
+// The general matrix multiply is organised the same way as most optimised BLAS libraries:
+//  - op(b) is split into KC x NC blocks, which are packed into panels of NR columns;
+//  - op(a) is split into MC x KC blocks, which are packed into panels of MR rows;
+//  - a micro-kernel multiplies one MR-row panel of a by one NR-column panel of b, keeping the MR x NR
+//    tile of c in registers for the whole KC-long loop.
+// The block sizes are chosen so that a packed B panel stays in L1 and a packed A block stays in L2.
+// The multiply itself is in gemmimpl.h, which is built once for floats and once for doubles: zmlGemm() uses whichever
+// matches __zml_floating, and zmlGemmf() and zmlGemmd() are always there for the typed matrices.
+// ==============================================================================
+
+#define _ZML_GEMM_KC 256
+#define _ZML_GEMM_MC 144
+#define _ZML_GEMM_NC 4096
+
+// largest MR and NR of any micro-kernel (used to size the buffer for partial tiles).
+#define _ZML_GEMM_MAX_MR 12
+#define _ZML_GEMM_MAX_NR (128 / sizeof(float))
+
+// products with fewer multiply-adds than this skip packing and use a simple loop.
+#define _ZML_GEMM_SMALL (32 * 32 * 32)
+
+#ifdef ZML_X86_SIMD
+
+// -------------------------------------------
+// SIMD micro-kernels. Each keeps two vectors of c per row in registers, so NR is twice the vector width.
+// The kernels are written once in terms of the _ZML_V* macros, which gemmimpl.h defines for each instruction set and type.
+// -------------------------------------------
+
+#define _ZML_ROWS4(X) X(0) X(1) X(2) X(3)
+#define _ZML_ROWS6(X) _ZML_ROWS4(X) X(4) X(5)
+#define _ZML_ROWS12(X) _ZML_ROWS6(X) X(6) X(7) X(8) X(9) X(10) X(11)
+
+#define _ZML_KERNEL_DECLARE(i) _ZML_VT c##i##_0 = _ZML_VZERO(), c##i##_1 = _ZML_VZERO();
+#define _ZML_KERNEL_STEP(i) {\
+	const _ZML_VT ai = _ZML_VSET1(a[i]);\
+	c##i##_0 = _ZML_VFMA(ai, b0, c##i##_0);\
+	c##i##_1 = _ZML_VFMA(ai, b1, c##i##_1);\
+}
+#define _ZML_KERNEL_STORE(i) {\
+	_ZML_GEMM_T *ci = c + (i) * rsc;\
+	_ZML_VSTOREU(ci, _ZML_VFMA(va, c##i##_0, _ZML_VLOADU(ci)));\
+	_ZML_VSTOREU(ci + _ZML_VLANES, _ZML_VFMA(va, c##i##_1, _ZML_VLOADU(ci + _ZML_VLANES)));\
+}
+
+#define _ZML_DEFINE_KERNEL(name, isa, rows, mr) \
+	__attribute__((target(isa)))\
+	static void name(size_t kc, const _ZML_GEMM_T *a, const _ZML_GEMM_T *b, _ZML_GEMM_T *c, size_t rsc, _ZML_GEMM_T alpha) {\
+		rows(_ZML_KERNEL_DECLARE)\
+		for (size_t p = 0; p < kc; p++) {\
+			const _ZML_VT b0 = _ZML_VLOADU(b);\
+			const _ZML_VT b1 = _ZML_VLOADU(b + _ZML_VLANES);\
+			rows(_ZML_KERNEL_STEP)\
+			a += mr;\
+			b += 2 * _ZML_VLANES;\
+		}\
+		const _ZML_VT va = _ZML_VSET1(alpha);\
+		rows(_ZML_KERNEL_STORE)\
+	}
+
+#endif
+
+#define _ZML_GEMM_CONCAT(name, suffix) name##suffix
+#define _ZML_GEMM_EXPAND(name, suffix) _ZML_GEMM_CONCAT(name, suffix)
+#define _ZML_GEMM_NAME(name) _ZML_GEMM_EXPAND(name, _ZML_GEMM_SUFFIX)
+
+// floats
+#define _ZML_GEMM_T float
+#define _ZML_GEMM_MATRIX zmlMatrixf
+#define _ZML_GEMM_SUFFIX f
+#define _ZML_GEMM_FLOATS
+#include "gemmimpl.h"
+#undef _ZML_GEMM_T
+#undef _ZML_GEMM_MATRIX
+#undef _ZML_GEMM_SUFFIX
+#undef _ZML_GEMM_FLOATS
+
+// doubles
+#define _ZML_GEMM_T double
+#define _ZML_GEMM_MATRIX zmlMatrixd
+#define _ZML_GEMM_SUFFIX d
+#include "gemmimpl.h"
+#undef _ZML_GEMM_T
+#undef _ZML_GEMM_MATRIX
+#undef _ZML_GEMM_SUFFIX
+
+// the multiply and matrix type of the same precision as __zml_floating.
+#ifdef ZML_USING_FLOATS
+#	define _zml_gemmTyped _zml_gemmf
+typedef zmlMatrixf _zml_gemmTypedMatrix;
+#else
+#	define _zml_gemmTyped _zml_gemmd
+typedef zmlMatrixd _zml_gemmTypedMatrix;
+#endif
+
+/**
+ * @brief general matrix multiply: c = alpha * op(a) * op(b) + beta * c, where op(x) is x, or the transpose of x if the matching trans argument is set.
+ * 
+ * @param transa ZML_TRANSPOSE to use the transpose of a, otherwise ZML_NO_TRANSPOSE.
+ * @param transb ZML_TRANSPOSE to use the transpose of b, otherwise ZML_NO_TRANSPOSE.
+ * @param alpha the factor to multiply op(a) * op(b) by.
+ * @param a the left-hand matrix (m x k after op() is applied).
+ * @param b the right-hand matrix (k x n after op() is applied).
+ * @param beta the factor to multiply the existing values in c by.
+ * @param c the matrix to add the result onto. Must already be allocated as m x n, and must not share storage with a or b.
+ */
+void zmlGemm(unsigned char transa, unsigned char transb, __zml_floating alpha, zmlMatrix a, zmlMatrix b, __zml_floating beta, zmlMatrix *c) {
+	// the elements of a zmlMatrix are laid out the same way as those of the typed matrix, so it can be multiplied as one
+	const _zml_gemmTypedMatrix ta = { a.rows, a.cols, a.data, a.stride };
+	const _zml_gemmTypedMatrix tb = { b.rows, b.cols, b.data, b.stride };
+	_zml_gemmTypedMatrix tc = { c->rows, c->cols, c->data, c->stride };
+	_zml_gemmTyped("zmlGemm", transa, transb, alpha, ta, tb, beta, &tc);
+}
+/**
+ * @brief general matrix multiply of matrices of floats, as zmlGemm(): c = alpha * op(a) * op(b) + beta * c.
+ * 
+ * @param transa ZML_TRANSPOSE to use the transpose of a, otherwise ZML_NO_TRANSPOSE.
+ * @param transb ZML_TRANSPOSE to use the transpose of b, otherwise ZML_NO_TRANSPOSE.
+ * @param alpha the factor to multiply op(a) * op(b) by.
+ * @param a the left-hand matrix (m x k after op() is applied).
+ * @param b the right-hand matrix (k x n after op() is applied).
+ * @param beta the factor to multiply the existing values in c by.
+ * @param c the matrix to add the result onto. Must already be allocated as m x n, and must not share storage with a or b.
+ */
+void zmlGemmf(unsigned char transa, unsigned char transb, float alpha, zmlMatrixf a, zmlMatrixf b, float beta, zmlMatrixf *c) {
+	_zml_gemmf("zmlGemmf", transa, transb, alpha, a, b, beta, c);
+}
+/**
+ * @brief general matrix multiply of matrices of doubles, as zmlGemm(): c = alpha * op(a) * op(b) + beta * c.
+ * 
+ * @param transa ZML_TRANSPOSE to use the transpose of a, otherwise ZML_NO_TRANSPOSE.
+ * @param transb ZML_TRANSPOSE to use the transpose of b, otherwise ZML_NO_TRANSPOSE.
+ * @param alpha the factor to multiply op(a) * op(b) by.
+ * @param a the left-hand matrix (m x k after op() is applied).
+ * @param b the right-hand matrix (k x n after op() is applied).
+ * @param beta the factor to multiply the existing values in c by.
+ * @param c the matrix to add the result onto. Must already be allocated as m x n, and must not share storage with a or b.
+ */
+void zmlGemmd(unsigned char transa, unsigned char transb, double alpha, zmlMatrixd a, zmlMatrixd b, double beta, zmlMatrixd *c) {
+	_zml_gemmd("zmlGemmd", transa, transb, alpha, a, b, beta, c);
+}
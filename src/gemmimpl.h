@@ -0,0 +1,407 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// The general matrix multiply for one element type, included by gemm.c once for floats and once for doubles.
+// Before each inclusion, gemm.c defines:
+//  - _ZML_GEMM_T, the element type;
+//  - _ZML_GEMM_MATRIX, the matrix type with elements of that type;
+//  - _ZML_GEMM_NAME(name), which gives the name of this type's version of each function and structure;
+//  - _ZML_GEMM_FLOATS, if the elements are floats.
+// (No include guard, since it's meant to be included more than once.)
+
+// micro-kernel: c[i * rsc + j] += alpha * sum(a[p * MR + i] * b[p * NR + j]) for an MR x NR tile of c.
+typedef void (*_ZML_GEMM_NAME(_zml_gemmKernelFunc))(size_t kc, const _ZML_GEMM_T *a, const _ZML_GEMM_T *b, _ZML_GEMM_T *c, size_t rsc, _ZML_GEMM_T alpha);
+
+typedef struct {
+	unsigned int mr;
+	unsigned int nr;
+	_ZML_GEMM_NAME(_zml_gemmKernelFunc) kernel;
+} _ZML_GEMM_NAME(_zml_gemmKernel);
+
+// -------------------------------------------
+// scalar micro-kernel (4 x 4), used when no SIMD path is available.
+// -------------------------------------------
+
+static void _ZML_GEMM_NAME(_zml_gemmKernelScalar)(size_t kc, const _ZML_GEMM_T *a, const _ZML_GEMM_T *b, _ZML_GEMM_T *c, size_t rsc, _ZML_GEMM_T alpha) {
+	_ZML_GEMM_T ab[4][4] = { { 0 } };
+
+	for (size_t p = 0; p < kc; p++) {
+		for (unsigned int i = 0; i < 4; i++) {
+			for (unsigned int j = 0; j < 4; j++) {
+				ab[i][j] += a[i] * b[j];
+			}
+		}
+		a += 4;
+		b += 4;
+	}
+
+	for (unsigned int i = 0; i < 4; i++) {
+		for (unsigned int j = 0; j < 4; j++) {
+			c[i * rsc + j] += alpha * ab[i][j];
+		}
+	}
+}
+
+#ifdef ZML_X86_SIMD
+
+// -------------------------------------------
+// SIMD micro-kernels (see _ZML_DEFINE_KERNEL() in gemm.c).
+// -------------------------------------------
+
+// SSE2: 4 x (2 * 128-bit)
+#ifdef _ZML_GEMM_FLOATS
+#	define _ZML_VT __m128
+#	define _ZML_VOP(op) _mm_##op##_ps
+#else
+#	define _ZML_VT __m128d
+#	define _ZML_VOP(op) _mm_##op##_pd
+#endif
+#define _ZML_VLANES (16 / sizeof(_ZML_GEMM_T))
+#define _ZML_VZERO _ZML_VOP(setzero)
+#define _ZML_VSET1 _ZML_VOP(set1)
+#define _ZML_VLOADU _ZML_VOP(loadu)
+#define _ZML_VSTOREU _ZML_VOP(storeu)
+#define _ZML_VFMA(x, y, z) _ZML_VOP(add)(_ZML_VOP(mul)(x, y), z)
+
+_ZML_DEFINE_KERNEL(_ZML_GEMM_NAME(_zml_gemmKernelSSE2), "sse2", _ZML_ROWS4, 4)
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+
+// AVX2 + FMA: 6 x (2 * 256-bit)
+#ifdef _ZML_GEMM_FLOATS
+#	define _ZML_VT __m256
+#	define _ZML_VOP(op) _mm256_##op##_ps
+#else
+#	define _ZML_VT __m256d
+#	define _ZML_VOP(op) _mm256_##op##_pd
+#endif
+#define _ZML_VLANES (32 / sizeof(_ZML_GEMM_T))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+
+_ZML_DEFINE_KERNEL(_ZML_GEMM_NAME(_zml_gemmKernelAVX2), "avx2,fma", _ZML_ROWS6, 6)
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+
+// AVX-512: 12 x (2 * 512-bit)
+#ifdef _ZML_GEMM_FLOATS
+#	define _ZML_VT __m512
+#	define _ZML_VOP(op) _mm512_##op##_ps
+#else
+#	define _ZML_VT __m512d
+#	define _ZML_VOP(op) _mm512_##op##_pd
+#endif
+#define _ZML_VLANES (64 / sizeof(_ZML_GEMM_T))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+
+_ZML_DEFINE_KERNEL(_ZML_GEMM_NAME(_zml_gemmKernelAVX512), "avx512f", _ZML_ROWS12, 12)
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VZERO
+#undef _ZML_VSET1
+#undef _ZML_VLOADU
+#undef _ZML_VSTOREU
+
+#endif
+
+// select the best micro-kernel for the CPU (once).
+static const _ZML_GEMM_NAME(_zml_gemmKernel) *_ZML_GEMM_NAME(_zml_selectGemmKernel)(void) {
+	static const _ZML_GEMM_NAME(_zml_gemmKernel) scalar = { 4, 4, _ZML_GEMM_NAME(_zml_gemmKernelScalar) };
+#ifdef ZML_X86_SIMD
+	static const _ZML_GEMM_NAME(_zml_gemmKernel) sse2 = { 4, 2 * 16 / sizeof(_ZML_GEMM_T), _ZML_GEMM_NAME(_zml_gemmKernelSSE2) };
+	static const _ZML_GEMM_NAME(_zml_gemmKernel) avx2 = { 6, 2 * 32 / sizeof(_ZML_GEMM_T), _ZML_GEMM_NAME(_zml_gemmKernelAVX2) };
+	static const _ZML_GEMM_NAME(_zml_gemmKernel) avx512 = { 12, 2 * 64 / sizeof(_ZML_GEMM_T), _ZML_GEMM_NAME(_zml_gemmKernelAVX512) };
+
+	const unsigned int features = _zml_cpuFeatures();
+	if (features & ZML_CPU_AVX512) return &avx512;
+	if (features & ZML_CPU_AVX2) return &avx2;
+	if (features & ZML_CPU_SSE2) return &sse2;
+#endif
+	return &scalar;
+}
+
+// -------------------------------------------
+// packing
+// -------------------------------------------
+
+// an operand of the multiplication: element (i, j) of op(x) is data[i * rs + j * cs].
+typedef struct {
+	const _ZML_GEMM_T *data;
+	size_t rs;
+	size_t cs;
+} _ZML_GEMM_NAME(_zml_gemmOperand);
+
+static _ZML_GEMM_NAME(_zml_gemmOperand) _ZML_GEMM_NAME(_zml_gemmMakeOperand)(_ZML_GEMM_MATRIX mat, unsigned char trans) {
+	_ZML_GEMM_NAME(_zml_gemmOperand) r;
+	r.data = mat.data;
+	r.rs = trans ? 1 : mat.stride;
+	r.cs = trans ? mat.stride : 1;
+	return r;
+}
+
+// pack the mc x kc block of a starting at (i0, p0) into panels of mr rows; rows past mc are zero-filled.
+static void _ZML_GEMM_NAME(_zml_gemmPackA)(const _ZML_GEMM_NAME(_zml_gemmOperand) *a, size_t i0, size_t p0, size_t mc, size_t kc, unsigned int mr, _ZML_GEMM_T *dst) {
+	for (size_t ir = 0; ir < mc; ir += mr) {
+		const size_t rows = (mc - ir < mr) ? mc - ir : mr;
+		const _ZML_GEMM_T *src = a->data + (i0 + ir) * a->rs + p0 * a->cs;
+
+		for (size_t p = 0; p < kc; p++) {
+			for (size_t i = 0; i < rows; i++) {
+				dst[i] = src[i * a->rs + p * a->cs];
+			}
+			for (size_t i = rows; i < mr; i++) {
+				dst[i] = (_ZML_GEMM_T) 0.0;
+			}
+			dst += mr;
+		}
+	}
+}
+
+// pack the kc x nc block of b starting at (p0, j0) into panels of nr columns; columns past nc are zero-filled.
+static void _ZML_GEMM_NAME(_zml_gemmPackB)(const _ZML_GEMM_NAME(_zml_gemmOperand) *b, size_t p0, size_t j0, size_t kc, size_t nc, unsigned int nr, _ZML_GEMM_T *dst) {
+	for (size_t jr = 0; jr < nc; jr += nr) {
+		const size_t cols = (nc - jr < nr) ? nc - jr : nr;
+		const _ZML_GEMM_T *src = b->data + p0 * b->rs + (j0 + jr) * b->cs;
+
+		for (size_t p = 0; p < kc; p++) {
+			const _ZML_GEMM_T *row = src + p * b->rs;
+			if (b->cs == 1) {
+				memcpy(dst, row, cols * sizeof(_ZML_GEMM_T));
+			} else {
+				for (size_t j = 0; j < cols; j++) {
+					dst[j] = row[j * b->cs];
+				}
+			}
+			for (size_t j = cols; j < nr; j++) {
+				dst[j] = (_ZML_GEMM_T) 0.0;
+			}
+			dst += nr;
+		}
+	}
+}
+
+// multiply a packed mc x kc block of a by a packed kc x nc block of b, adding alpha times the result onto c.
+static void _ZML_GEMM_NAME(_zml_gemmMacroKernel)(const _ZML_GEMM_NAME(_zml_gemmKernel) *k, size_t mc, size_t nc, size_t kc, _ZML_GEMM_T alpha,
+	const _ZML_GEMM_T *apack, const _ZML_GEMM_T *bpack, _ZML_GEMM_T *c, size_t ldc) {
+	for (size_t jr = 0; jr < nc; jr += k->nr) {
+		const size_t cols = (nc - jr < k->nr) ? nc - jr : k->nr;
+		const _ZML_GEMM_T *bp = bpack + jr * kc;
+
+		for (size_t ir = 0; ir < mc; ir += k->mr) {
+			const size_t rows = (mc - ir < k->mr) ? mc - ir : k->mr;
+			const _ZML_GEMM_T *ap = apack + ir * kc;
+			_ZML_GEMM_T *cp = c + ir * ldc + jr;
+
+			if (rows == k->mr && cols == k->nr) {
+				k->kernel(kc, ap, bp, cp, ldc, alpha);
+				continue;
+			}
+
+			// partial tile: compute the whole tile into a buffer and only add the valid part onto c
+			_ZML_GEMM_T tile[_ZML_GEMM_MAX_MR * _ZML_GEMM_MAX_NR];
+			memset(tile, 0, k->mr * k->nr * sizeof(_ZML_GEMM_T));
+			k->kernel(kc, ap, bp, tile, k->nr, alpha);
+
+			for (size_t i = 0; i < rows; i++) {
+				for (size_t j = 0; j < cols; j++) {
+					cp[i * ldc + j] += tile[i * k->nr + j];
+				}
+			}
+		}
+	}
+}
+
+// state shared by the tasks of one multiplication.
+typedef struct {
+	const _ZML_GEMM_NAME(_zml_gemmKernel) *kern;
+	const _ZML_GEMM_NAME(_zml_gemmOperand) *opa;
+	const _ZML_GEMM_NAME(_zml_gemmOperand) *opb;
+	_ZML_GEMM_MATRIX *c;
+	_ZML_GEMM_T alpha;
+	size_t m;
+
+	// the current KC x NC block of op(b), packed into bpack
+	size_t jc, nc, pc, kc;
+	_ZML_GEMM_T *bpack;
+
+	// how many NR-column panels the block has, and how many column ranges each MC-row block of c is split into
+	size_t npanels, nsplit;
+} _ZML_GEMM_NAME(_zml_gemmArgs);
+
+// pack panels [begin, end) of the current block of op(b).
+static void _ZML_GEMM_NAME(_zml_gemmPackBRange)(void *ctx, size_t begin, size_t end) {
+	_ZML_GEMM_NAME(_zml_gemmArgs) *args = (_ZML_GEMM_NAME(_zml_gemmArgs) *) ctx;
+	const size_t nr = args->kern->nr;
+	const size_t j0 = begin * nr;
+	const size_t j1 = (end * nr < args->nc) ? end * nr : args->nc;
+
+	_ZML_GEMM_NAME(_zml_gemmPackB)(args->opb, args->pc, args->jc + j0, args->kc, j1 - j0, nr, args->bpack + j0 * args->kc);
+}
+
+// compute tasks [begin, end); task t covers MC-row block (t / nsplit) and column range (t % nsplit) of the current block of c.
+static void _ZML_GEMM_NAME(_zml_gemmBlocks)(void *ctx, size_t begin, size_t end) {
+	_ZML_GEMM_NAME(_zml_gemmArgs) *args = (_ZML_GEMM_NAME(_zml_gemmArgs) *) ctx;
+	const _ZML_GEMM_NAME(_zml_gemmKernel) *kern = args->kern;
+	const size_t mcmax = (args->m < _ZML_GEMM_MC) ? args->m : _ZML_GEMM_MC;
+
+	_ZML_GEMM_T *apack = (_ZML_GEMM_T *) _zml_alloc(((mcmax + kern->mr - 1) / kern->mr) * kern->mr * args->kc * sizeof(_ZML_GEMM_T), ZML_ALIGNMENT);
+	size_t packed = (size_t) -1;
+
+	for (size_t t = begin; t < end; t++) {
+		const size_t ib = t / args->nsplit;
+		const size_t js = t % args->nsplit;
+
+		const size_t ic = ib * _ZML_GEMM_MC;
+		const size_t mc = (args->m - ic < _ZML_GEMM_MC) ? args->m - ic : _ZML_GEMM_MC;
+
+		// consecutive tasks usually share the same rows, so A only needs packing when the row block changes
+		if (ib != packed) {
+			_ZML_GEMM_NAME(_zml_gemmPackA)(args->opa, ic, args->pc, mc, args->kc, kern->mr, apack);
+			packed = ib;
+		}
+
+		// this task's share of the column panels
+		const size_t p0 = args->npanels * js / args->nsplit;
+		const size_t p1 = args->npanels * (js + 1) / args->nsplit;
+		const size_t j0 = p0 * kern->nr;
+		const size_t j1 = (p1 * kern->nr < args->nc) ? p1 * kern->nr : args->nc;
+		if (j0 >= j1) {
+			continue;
+		}
+
+		_ZML_GEMM_NAME(_zml_gemmMacroKernel)(kern, mc, j1 - j0, args->kc, args->alpha, apack, args->bpack + j0 * args->kc,
+			&_zml_at(*args->c, ic, args->jc + j0), args->c->stride);
+	}
+
+	_zml_free(apack);
+}
+
+// c = beta * c
+static void _ZML_GEMM_NAME(_zml_gemmScaleC)(_ZML_GEMM_MATRIX *c, _ZML_GEMM_T beta) {
+	if (beta == (_ZML_GEMM_T) 1.0) {
+		return;
+	}
+
+	for (unsigned int r = 0; r < c->rows; r++) {
+		_ZML_GEMM_T *row = &_zml_at(*c, r, 0);
+		for (unsigned int col = 0; col < c->cols; col++) {
+			// (beta == 0 overwrites c, so any NaNs or infinities already in it are not kept)
+			row[col] = (beta == (_ZML_GEMM_T) 0.0) ? (_ZML_GEMM_T) 0.0 : row[col] * beta;
+		}
+	}
+}
+
+// c = alpha * op(a) * op(b) + beta * c, as zmlGemm(); caller is the name of the public function, for error messages.
+static void _ZML_GEMM_NAME(_zml_gemm)(const char *caller, unsigned char transa, unsigned char transb, _ZML_GEMM_T alpha,
+	_ZML_GEMM_MATRIX a, _ZML_GEMM_MATRIX b, _ZML_GEMM_T beta, _ZML_GEMM_MATRIX *c) {
+	const size_t m = transa ? a.cols : a.rows;
+	const size_t k = transa ? a.rows : a.cols;
+	const size_t n = transb ? b.rows : b.cols;
+
+	if ((transb ? b.cols : b.rows) != k) {
+		printf("zetaml: %s(): inner dimensions of op(a) and op(b) do not match, no multiplication performed!\n", caller);
+		return;
+	}
+	if (c->rows != m || c->cols != n) {
+		printf("zetaml: %s(): c is not the same size as op(a) * op(b), no multiplication performed!\n", caller);
+		return;
+	}
+
+	_ZML_GEMM_NAME(_zml_gemmScaleC)(c, beta);
+	if (m == 0 || n == 0 || k == 0 || alpha == (_ZML_GEMM_T) 0.0) {
+		return;
+	}
+
+	const _ZML_GEMM_NAME(_zml_gemmOperand) opa = _ZML_GEMM_NAME(_zml_gemmMakeOperand)(a, transa);
+	const _ZML_GEMM_NAME(_zml_gemmOperand) opb = _ZML_GEMM_NAME(_zml_gemmMakeOperand)(b, transb);
+
+	// small products aren't worth packing: use a plain i-k-j loop instead
+	if (m * n * k <= _ZML_GEMM_SMALL) {
+		for (size_t i = 0; i < m; i++) {
+			_ZML_GEMM_T *out = &_zml_at(*c, i, 0);
+			for (size_t p = 0; p < k; p++) {
+				const _ZML_GEMM_T av = alpha * opa.data[i * opa.rs + p * opa.cs];
+				const _ZML_GEMM_T *brow = opb.data + p * opb.rs;
+				for (size_t j = 0; j < n; j++) {
+					out[j] += av * brow[j * opb.cs];
+				}
+			}
+		}
+		return;
+	}
+
+	const _ZML_GEMM_NAME(_zml_gemmKernel) *kern = _ZML_GEMM_NAME(_zml_selectGemmKernel)();
+
+	const size_t kcmax = (k < _ZML_GEMM_KC) ? k : _ZML_GEMM_KC;
+	const size_t ncmax = (n < _ZML_GEMM_NC) ? n : _ZML_GEMM_NC;
+
+	// packing buffer for B, rounded up to whole panels (each thread packs its own blocks of A)
+	_ZML_GEMM_T *bpack = (_ZML_GEMM_T *) _zml_alloc(((ncmax + kern->nr - 1) / kern->nr) * kern->nr * kcmax * sizeof(_ZML_GEMM_T), ZML_ALIGNMENT);
+
+	_ZML_GEMM_NAME(_zml_gemmArgs) args;
+	args.kern = kern;
+	args.opa = &opa;
+	args.opb = &opb;
+	args.c = c;
+	args.alpha = alpha;
+	args.m = m;
+	args.bpack = bpack;
+
+	// decide how the blocks of c are split into tasks: every MC-row block is one task, and if there are too few of
+	// them to keep every thread busy, each is split further into column ranges (which all need their own copy of A)
+	const unsigned char parallel = m * n * k >= (size_t) ZML_PARALLEL_THRESHOLD * 64;
+	const size_t nthreads = parallel ? zmlGetThreadCount() : 1;
+	const size_t mblocks = (m + _ZML_GEMM_MC - 1) / _ZML_GEMM_MC;
+
+	for (size_t jc = 0; jc < n; jc += _ZML_GEMM_NC) {
+		const size_t nc = (n - jc < _ZML_GEMM_NC) ? n - jc : _ZML_GEMM_NC;
+		const size_t npanels = (nc + kern->nr - 1) / kern->nr;
+
+		size_t nsplit = (nthreads * 2 + mblocks - 1) / mblocks;
+		if (nthreads == 1 || nsplit < 1) {
+			nsplit = 1;
+		}
+		if (nsplit > npanels) {
+			nsplit = npanels;
+		}
+
+		args.jc = jc;
+		args.nc = nc;
+		args.npanels = npanels;
+		args.nsplit = nsplit;
+
+		for (size_t pc = 0; pc < k; pc += _ZML_GEMM_KC) {
+			args.pc = pc;
+			args.kc = (k - pc < _ZML_GEMM_KC) ? k - pc : _ZML_GEMM_KC;
+
+			if (nthreads > 1) {
+				_zml_parallelFor(npanels, 8, _ZML_GEMM_NAME(_zml_gemmPackBRange), &args);
+				_zml_parallelFor(mblocks * nsplit, 1, _ZML_GEMM_NAME(_zml_gemmBlocks), &args);
+			} else {
+				_ZML_GEMM_NAME(_zml_gemmPackBRange)(&args, 0, npanels);
+				_ZML_GEMM_NAME(_zml_gemmBlocks)(&args, 0, mblocks * nsplit);
+			}
+		}
+	}
+
+	_zml_free(bpack);
+}
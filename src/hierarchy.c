@@ -0,0 +1,473 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+#include <limits.h>
+
+// ==============================================================================
+// A hierarchy keeps its nodes in breadth-first order, so that the nodes at each depth are contiguous and the
+// children of a node are contiguous in the next depth's range (like the offsets of a CSR matrix, children[s] to
+// children[s + 1] are the children of slot s). Nodes are referred to by handles, which stay the same when the
+// nodes are reordered, and the order is only rebuilt (by zmlUpdateHierarchy()) after nodes have been added.
+// An update goes down the depths in order, and at each one multiplies the runs of dirty siblings by their parent's
+// world matrix with zmlMultiplyMat4BatchStrided() and marks their children dirty - so only nodes that changed,
+// or are below one that did, are recomputed. Every child has one parent, so the work at each depth can be split
+// across threads without any locking.
+// ==============================================================================
+
+struct zmlHierarchy {
+	unsigned int count;
+	unsigned int capacity;
+	unsigned char ordered; // whether the slots are in breadth-first order (false after nodes have been added)
+
+	// by handle
+	unsigned int *parents; // parent handle of each node (ZML_NO_PARENT for roots)
+	unsigned int *slots; // where each node is stored
+
+	// by slot
+	zmlMat4 *locals;
+	zmlMat4 *worlds;
+	unsigned char *dirty;
+	unsigned int *parentSlots;
+	unsigned int *handles;
+	unsigned int *children; // (count + 1 entries)
+
+	unsigned int *depths; // the first slot of each depth (depthCount + 1 entries)
+	unsigned int depthCount;
+
+	// the range of depths that have had nodes marked dirty since the last update
+	unsigned int firstDirtyDepth;
+	unsigned int lastDirtyDepth;
+};
+
+// grow a hierarchy's arrays so that they can hold capacity nodes.
+static unsigned char _zml_reserveHierarchy(zmlHierarchy *h, unsigned int capacity) {
+	if (capacity <= h->capacity) {
+		return 1;
+	}
+
+	// (each array is moved to a bigger allocation of its own, so that everything goes through the zetaml allocator; only
+	// the entries in use are copied over)
+	#define _ZML_GROW(array, n, used) do {\
+		void *grown = _zml_alloc((size_t) (n) * sizeof(*h->array), ZML_ALIGNMENT);\
+		if (!grown) return 0;\
+		if (h->array) memcpy(grown, h->array, (size_t) (used) * sizeof(*h->array));\
+		_zml_free(h->array);\
+		h->array = grown;\
+	} while (0)
+
+	_ZML_GROW(parents, capacity, h->count);
+	_ZML_GROW(slots, capacity, h->count);
+	_ZML_GROW(locals, capacity, h->count);
+	_ZML_GROW(worlds, capacity, h->count);
+	_ZML_GROW(dirty, capacity, h->count);
+	_ZML_GROW(parentSlots, capacity, h->count);
+	_ZML_GROW(handles, capacity, h->count);
+	_ZML_GROW(children, capacity + 1, h->count + 1);
+	_ZML_GROW(depths, capacity + 1, h->depthCount + 1);
+
+	#undef _ZML_GROW
+
+	h->capacity = capacity;
+	return 1;
+}
+
+/**
+ * @brief create an empty transform hierarchy: a set of nodes, each with a local transform relative to its parent, whose
+ * world transforms (parent's world * local) are kept up to date by zmlUpdateHierarchy().
+ * Returns NULL if there wasn't enough memory.
+ * 
+ * @param capacity the number of nodes to make room for (more can be added regardless).
+ */
+zmlHierarchy *zmlCreateHierarchy(unsigned int capacity) {
+	zmlHierarchy *h = (zmlHierarchy *) _zml_alloc(sizeof(zmlHierarchy), sizeof(void *));
+	if (!h) {
+		return NULL;
+	}
+	memset(h, 0, sizeof(zmlHierarchy));
+
+	h->ordered = 1;
+	h->firstDirtyDepth = UINT_MAX;
+	if (!_zml_reserveHierarchy(h, capacity ? capacity : 16)) {
+		zmlDestroyHierarchy(h);
+		return NULL;
+	}
+	h->children[0] = 0;
+	h->depths[0] = 0;
+
+	return h;
+}
+
+/**
+ * @brief free a transform hierarchy and all of its nodes.
+ * 
+ * @param h the hierarchy to destroy.
+ */
+void zmlDestroyHierarchy(zmlHierarchy *h) {
+	if (!h) {
+		return;
+	}
+
+	_zml_free(h->parents);
+	_zml_free(h->slots);
+	_zml_free(h->locals);
+	_zml_free(h->worlds);
+	_zml_free(h->dirty);
+	_zml_free(h->parentSlots);
+	_zml_free(h->handles);
+	_zml_free(h->children);
+	_zml_free(h->depths);
+	_zml_free(h);
+}
+
+/**
+ * @brief add a node to a transform hierarchy, returning its handle (handles are given out in order, starting from 0).
+ * Its world transform is calculated by the next zmlUpdateHierarchy(). Returns ZML_NO_PARENT if the parent doesn't exist
+ * or there wasn't enough memory.
+ * 
+ * @param h the hierarchy to add the node to.
+ * @param parent the handle of the node's parent, or ZML_NO_PARENT to add a root node.
+ * @param local the node's transform relative to its parent.
+ */
+unsigned int zmlAddHierarchyNode(zmlHierarchy *h, unsigned int parent, zmlMat4 local) {
+	if (parent != ZML_NO_PARENT && parent >= h->count) {
+		printf("zetaml: zmlAddHierarchyNode(): parent node %u doesn't exist!\n", parent);
+		return ZML_NO_PARENT;
+	}
+	if (h->count == h->capacity && !_zml_reserveHierarchy(h, h->capacity * 2)) {
+		printf("zetaml: zmlAddHierarchyNode(): out of memory!\n");
+		return ZML_NO_PARENT;
+	}
+
+	// the new node goes at the end until the order is rebuilt
+	const unsigned int node = h->count++;
+	h->parents[node] = parent;
+	h->slots[node] = node;
+	h->handles[node] = node;
+	h->locals[node] = local;
+	h->worlds[node] = local;
+	h->dirty[node] = 1;
+	h->ordered = 0;
+
+	return node;
+}
+
+// put the slots into breadth-first order (see the top of the file).
+static unsigned char _zml_orderHierarchy(zmlHierarchy *h) {
+	const unsigned int n = h->count;
+
+	// the children of each node, by handle: kids[first[p]] to kids[first[p + 1]] (roots are listed under p = n)
+	unsigned int *first = (unsigned int *) _zml_alloc(((size_t) n + 2) * sizeof(unsigned int), ZML_ALIGNMENT);
+	unsigned int *kids = (unsigned int *) _zml_alloc(((size_t) n + 1) * sizeof(unsigned int), ZML_ALIGNMENT);
+	unsigned int *order = (unsigned int *) _zml_alloc(((size_t) n + 1) * sizeof(unsigned int), ZML_ALIGNMENT);
+	zmlMat4 *locals = (zmlMat4 *) _zml_alloc(((size_t) n + 1) * sizeof(zmlMat4), ZML_ALIGNMENT);
+	zmlMat4 *worlds = (zmlMat4 *) _zml_alloc(((size_t) n + 1) * sizeof(zmlMat4), ZML_ALIGNMENT);
+	unsigned char *dirty = (unsigned char *) _zml_alloc((size_t) n + 1, ZML_ALIGNMENT);
+	if (!first || !kids || !order || !locals || !worlds || !dirty) {
+		_zml_free(first);
+		_zml_free(kids);
+		_zml_free(order);
+		_zml_free(locals);
+		_zml_free(worlds);
+		_zml_free(dirty);
+		return 0;
+	}
+	memset(first, 0, ((size_t) n + 2) * sizeof(unsigned int));
+
+	for (unsigned int i = 0; i < n; i++) {
+		first[((h->parents[i] == ZML_NO_PARENT) ? n : h->parents[i]) + 1]++;
+	}
+	for (unsigned int p = 0; p <= n; p++) {
+		first[p + 1] += first[p];
+	}
+	for (unsigned int i = 0; i < n; i++) {
+		kids[first[(h->parents[i] == ZML_NO_PARENT) ? n : h->parents[i]]++] = i;
+	}
+	memmove(first + 1, first, ((size_t) n + 1) * sizeof(unsigned int));
+	first[0] = 0;
+
+	// breadth-first: the roots, then the children of each node in turn. A depth ends where the children of its
+	// last node have been added.
+	unsigned int tail = 0;
+	for (unsigned int k = first[n]; k < first[n + 1]; k++) {
+		order[tail++] = kids[k];
+	}
+	h->depthCount = 0;
+	h->depths[0] = 0;
+	unsigned int depthEnd = tail;
+	for (unsigned int s = 0; s < n; s++) {
+		if (s == depthEnd) {
+			h->depths[++h->depthCount] = s;
+			depthEnd = tail;
+		}
+		const unsigned int node = order[s];
+		h->children[s] = tail;
+		for (unsigned int k = first[node]; k < first[node + 1]; k++) {
+			order[tail++] = kids[k];
+		}
+	}
+	h->children[n] = n;
+	if (n > 0) {
+		h->depths[++h->depthCount] = n;
+	}
+
+	// move the nodes into their new slots
+	for (unsigned int s = 0; s < n; s++) {
+		const unsigned int node = order[s];
+		const unsigned int old = h->slots[node];
+		locals[s] = h->locals[old];
+		worlds[s] = h->worlds[old];
+		dirty[s] = h->dirty[old];
+	}
+	for (unsigned int s = 0; s < n; s++) {
+		const unsigned int node = order[s];
+		h->slots[node] = s;
+		h->handles[s] = node;
+	}
+	for (unsigned int s = 0; s < n; s++) {
+		const unsigned int parent = h->parents[order[s]];
+		h->parentSlots[s] = (parent == ZML_NO_PARENT) ? ZML_NO_PARENT : h->slots[parent];
+	}
+	memcpy(h->locals, locals, (size_t) n * sizeof(zmlMat4));
+	memcpy(h->worlds, worlds, (size_t) n * sizeof(zmlMat4));
+	memcpy(h->dirty, dirty, n);
+
+	_zml_free(first);
+	_zml_free(kids);
+	_zml_free(order);
+	_zml_free(locals);
+	_zml_free(worlds);
+	_zml_free(dirty);
+
+	// (the dirty nodes could now be anywhere)
+	h->firstDirtyDepth = 0;
+	h->lastDirtyDepth = h->depthCount;
+	h->ordered = 1;
+	return 1;
+}
+
+// the depth of a slot (the hierarchy must be ordered).
+static unsigned int _zml_depthOfSlot(const zmlHierarchy *h, unsigned int slot) {
+	unsigned int lo = 0, hi = h->depthCount;
+	while (hi - lo > 1) {
+		const unsigned int mid = lo + (hi - lo) / 2;
+		if (h->depths[mid] <= slot) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * @brief set the local transform of a node in a transform hierarchy. The world transforms of it and every node below it
+ * are recalculated by the next zmlUpdateHierarchy().
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ * @param local the node's new transform relative to its parent.
+ */
+void zmlSetHierarchyLocal(zmlHierarchy *h, unsigned int node, zmlMat4 local) {
+	if (node >= h->count) {
+		printf("zetaml: zmlSetHierarchyLocal(): node %u doesn't exist!\n", node);
+		return;
+	}
+
+	const unsigned int slot = h->slots[node];
+	h->locals[slot] = local;
+
+	if (!h->dirty[slot]) {
+		h->dirty[slot] = 1;
+		if (h->ordered) {
+			const unsigned int depth = _zml_depthOfSlot(h, slot);
+			if (h->firstDirtyDepth == UINT_MAX) {
+				h->firstDirtyDepth = h->lastDirtyDepth = depth;
+			} else if (depth < h->firstDirtyDepth) {
+				h->firstDirtyDepth = depth;
+			} else if (depth > h->lastDirtyDepth) {
+				h->lastDirtyDepth = depth;
+			}
+		}
+	}
+}
+
+/**
+ * @brief get the local transform of a node in a transform hierarchy.
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ */
+zmlMat4 zmlGetHierarchyLocal(const zmlHierarchy *h, unsigned int node) {
+	if (node >= h->count) {
+		printf("zetaml: zmlGetHierarchyLocal(): node %u doesn't exist!\n", node);
+		return zmlIdentityMat4();
+	}
+	return h->locals[h->slots[node]];
+}
+
+/**
+ * @brief get the world transform of a node in a transform hierarchy, as of the last zmlUpdateHierarchy().
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ */
+zmlMat4 zmlGetHierarchyWorld(const zmlHierarchy *h, unsigned int node) {
+	if (node >= h->count) {
+		printf("zetaml: zmlGetHierarchyWorld(): node %u doesn't exist!\n", node);
+		return zmlIdentityMat4();
+	}
+	return h->worlds[h->slots[node]];
+}
+
+/**
+ * @brief copy the world transforms of every node in a transform hierarchy (as of the last zmlUpdateHierarchy()) into out,
+ * in order of handle.
+ * 
+ * @param h the hierarchy.
+ * @param out the array to copy the transforms into (one for each node, see zmlGetHierarchySize()).
+ */
+void zmlCopyHierarchyWorlds(const zmlHierarchy *h, zmlMat4 *out) {
+	for (unsigned int node = 0; node < h->count; node++) {
+		out[node] = h->worlds[h->slots[node]];
+	}
+}
+
+/**
+ * @brief get the parent of a node in a transform hierarchy (ZML_NO_PARENT if it is a root).
+ * 
+ * @param h the hierarchy.
+ * @param node the handle of the node.
+ */
+unsigned int zmlGetHierarchyParent(const zmlHierarchy *h, unsigned int node) {
+	if (node >= h->count) {
+		printf("zetaml: zmlGetHierarchyParent(): node %u doesn't exist!\n", node);
+		return ZML_NO_PARENT;
+	}
+	return h->parents[node];
+}
+
+/**
+ * @brief get the number of nodes in a transform hierarchy.
+ * 
+ * @param h the hierarchy.
+ */
+unsigned int zmlGetHierarchySize(const zmlHierarchy *h) {
+	return h->count;
+}
+
+typedef struct {
+	zmlHierarchy *h;
+	unsigned int begin; // the first slot of the depth being updated
+	unsigned int updated; // the number of nodes recomputed
+	unsigned char dirtied; // whether any children were marked dirty
+} _zml_hierarchyArgs;
+
+// recompute the dirty nodes in slots [begin, end) of the current depth (relative to its first slot), and mark their children dirty.
+static void _zml_updateHierarchyRange(void *ctx, size_t begin, size_t end) {
+	_zml_hierarchyArgs *args = (_zml_hierarchyArgs *) ctx;
+	zmlHierarchy *h = args->h;
+	unsigned int s = args->begin + (unsigned int) begin;
+	const unsigned int last = args->begin + (unsigned int) end;
+	unsigned int updated = 0;
+	unsigned char dirtied = 0;
+
+	while (s < last) {
+		// skip clean nodes 8 at a time
+		if (s + 8 <= last) {
+			uint64_t flags;
+			memcpy(&flags, h->dirty + s, sizeof(flags));
+			if (!flags) {
+				s += 8;
+				continue;
+			}
+		}
+		if (!h->dirty[s]) {
+			s++;
+			continue;
+		}
+
+		// a run of dirty siblings
+		const unsigned int parent = h->parentSlots[s];
+		unsigned int runEnd = s + 1;
+		while (runEnd < last && h->dirty[runEnd] && h->parentSlots[runEnd] == parent) {
+			runEnd++;
+		}
+
+		if (parent == ZML_NO_PARENT) {
+			memcpy(h->worlds + s, h->locals + s, (size_t) (runEnd - s) * sizeof(zmlMat4));
+		} else {
+			zmlMultiplyMat4BatchStrided(h->worlds + parent, 0, h->locals + s, sizeof(zmlMat4), h->worlds + s, sizeof(zmlMat4), runEnd - s);
+		}
+
+		// the children of the run are contiguous too
+		const unsigned int childBegin = h->children[s], childEnd = h->children[runEnd];
+		if (childEnd > childBegin) {
+			memset(h->dirty + childBegin, 1, childEnd - childBegin);
+			dirtied = 1;
+		}
+		memset(h->dirty + s, 0, runEnd - s);
+
+		updated += runEnd - s;
+		s = runEnd;
+	}
+
+	__atomic_add_fetch(&args->updated, updated, __ATOMIC_RELAXED);
+	if (dirtied) {
+		__atomic_store_n(&args->dirtied, 1, __ATOMIC_RELAXED);
+	}
+}
+
+/**
+ * @brief recalculate the world transforms of every node in a transform hierarchy whose local transform, or that of any node
+ * above it, has changed since the last update (and of nodes that have been added). Large updates are split across threads.
+ * Returns the number of nodes whose world transforms were recalculated.
+ * 
+ * @param h the hierarchy to update.
+ */
+unsigned int zmlUpdateHierarchy(zmlHierarchy *h) {
+	if (!h->ordered && !_zml_orderHierarchy(h)) {
+		printf("zetaml: zmlUpdateHierarchy(): out of memory!\n");
+		return 0;
+	}
+	if (h->firstDirtyDepth == UINT_MAX) {
+		return 0;
+	}
+
+	unsigned int updated = 0;
+	unsigned char dirtied = 0;
+
+	for (unsigned int d = h->firstDirtyDepth; d < h->depthCount; d++) {
+		// past the deepest node marked dirty, there's nothing more to do once a depth has no dirty children
+		if (d > h->lastDirtyDepth && !dirtied) {
+			break;
+		}
+
+		_zml_hierarchyArgs args = { h, h->depths[d], 0, 0 };
+		const size_t count = h->depths[d + 1] - h->depths[d];
+		if (count < ZML_PARALLEL_THRESHOLD / 4) {
+			_zml_updateHierarchyRange(&args, 0, count);
+		} else {
+			_zml_parallelFor(count, ZML_PARALLEL_THRESHOLD / 16, _zml_updateHierarchyRange, &args);
+		}
+
+		updated += args.updated;
+		dirtied = args.dirtied;
+	}
+
+	h->firstDirtyDepth = UINT_MAX;
+	h->lastDirtyDepth = 0;
+	return updated;
+}
@@ -23,16 +23,114 @@
 #include <stdarg.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
 
-// get amount of digits in an unsigned integer.
-static unsigned int _zml_getDigitsi(unsigned int val) {
-	unsigned int count = 0;
-	do {
-		count++;
-		val /= 10;
-	} while (val);
+// alignment (in bytes) of the element storage of matrices.
+#define ZML_ALIGNMENT 64
 
-	return count;
-}
+// access element (r, c) of a matrix through its contiguous storage.
+#define _zml_at(m, r, c) ((m).data[(size_t) (r) * (m).stride + (c)])
+
+// SIMD code paths are written with GCC/Clang intrinsics and function-level target attributes,
+// so they are compiled into every x86 build regardless of the flags the library is built with.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#	define ZML_X86_SIMD
+#endif
+
+// CPU features that SIMD code paths are selected by at runtime (see _zml_cpuFeatures()).
+#define ZML_CPU_SSE2	0x1
+#define ZML_CPU_AVX2	0x2 // AVX2 and FMA
+#define ZML_CPU_AVX512	0x4 // AVX-512F
+
+// get the SIMD features supported by the CPU that zetaml is running on (detected once, on first use).
+unsigned int _zml_cpuFeatures(void);
+
+// thread-local storage specifier.
+#ifdef _MSC_VER
+#	define _zml_threadLocal __declspec(thread)
+#else
+#	define _zml_threadLocal __thread
+#endif
+
+// allocate size bytes aligned to alignment (a power of 2) through the calling thread's allocator (see memory.c).
+// Must be freed with _zml_free().
+void *_zml_alloc(size_t size, size_t alignment);
+// free memory allocated by _zml_alloc().
+void _zml_free(void *ptr);
+
+// maths functions of the same precision as __zml_floating, so that float builds don't go through double.
+#ifdef ZML_USING_FLOATS
+#	define _zml_sin sinf
+#	define _zml_cos cosf
+#	define _zml_sqrt sqrtf
+#else
+#	define _zml_sin sin
+#	define _zml_cos cos
+#	define _zml_sqrt sqrt
+#endif
+
+// write the rotation by angle about the axis (x, y, z) (which needn't be normalised) into r.
+// Returns 0, leaving r unset, if there is no rotation.
+unsigned char _zml_axisAngleRotation(__zml_floating r[3][3], __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z);
+// write the rotation by the Euler angles x, y and z, applied in the given order, into r.
+void _zml_eulerRotation(__zml_floating r[3][3], zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z);
+// m = m * r, where m is a row-major 4x4 matrix whose rows are stride elements apart and r is a rotation that only affects the first three columns.
+void _zml_rotateRows(__zml_floating *m, size_t stride, const __zml_floating r[3][3]);
+
+// operations applied element-wise by _zml_applyElementwise() and the matrix/vector operators built on it.
+typedef enum {
+	_ZML_OP_ADD,
+	_ZML_OP_SUBTRACT,
+	_ZML_OP_MULTIPLY,
+	_ZML_OP_DIVIDE,
+	_ZML_OP_ADD_SCALAR,
+	_ZML_OP_SUBTRACT_SCALAR,
+	_ZML_OP_MULTIPLY_SCALAR,
+	_ZML_OP_DIVIDE_SCALAR
+} _zml_elementwiseOp;
+
+// dst[i] = a[i] (op) b[i] (or a[i] (op) scalar) for i in [0, n). dst may be the same array as a or b.
+void _zml_applyElementwise(_zml_elementwiseOp op, __zml_floating *dst, const __zml_floating *a, const __zml_floating *b, __zml_floating scalar, size_t n);
+
+// comparisons done by _zml_kernels()->compare; each checks that every a[i] (op) b[i] (or a[i] (op) scalar) is true.
+typedef enum {
+	_ZML_CMP_EQ,
+	_ZML_CMP_GT,
+	_ZML_CMP_GTE,
+	_ZML_CMP_LT,
+	_ZML_CMP_LTE
+} _zml_compareOp;
+
+// kernels for one instruction set (see kernels.c).
+typedef struct {
+	const char *name;
+
+	// sum of a[i] * b[i]
+	__zml_floating (*dot)(const __zml_floating *a, const __zml_floating *b, size_t n);
+	// sum of a[i] * a[i]
+	__zml_floating (*sumSquares)(const __zml_floating *a, size_t n);
+	// dst[i] = a[i] (op) b[i] (or a[i] (op) s); dst may be the same array as a or b
+	void (*elementwise)(_zml_elementwiseOp op, __zml_floating *dst, const __zml_floating *a, const __zml_floating *b, __zml_floating s, size_t n);
+	// 1 if a[i] (op) b[i] (or a[i] (op) s, if b is NULL) for every i, otherwise 0
+	unsigned char (*compare)(_zml_compareOp op, const __zml_floating *a, const __zml_floating *b, __zml_floating s, size_t n);
+	// inverse of the row-major 4x4 matrix m, written into out (16 elements) unless m is singular; returns the determinant
+	__zml_floating (*inverse4)(const __zml_floating *m, __zml_floating *out);
+} _zml_kernelTable;
+
+// get the kernels for the best instruction set the CPU supports (chosen on first use).
+const _zml_kernelTable *_zml_kernels(void);
+
+// LU decomposition of the square matrix mat in place, as zmlLUDecompose() but without reporting singular matrices (see decompose.c).
+unsigned char _zml_luFactor(zmlMatrix *mat, unsigned int *pivots);
+
+// operations with fewer than this many elements (or multiply-adds) are not worth splitting across threads.
+#define ZML_PARALLEL_THRESHOLD (1 << 15)
+
+// a function that processes the items [begin, end) of a parallel loop.
+typedef void (*_zml_parallelFunc)(void *ctx, size_t begin, size_t end);
+
+// call func over [0, count) in chunks of at least grain items, spread across the thread pool (see threads.c).
+// Runs serially if there's only one thread, or if called from inside another parallel loop.
+void _zml_parallelFor(size_t count, size_t grain, _zml_parallelFunc func, void *ctx);
 
 #endif
\ No newline at end of file
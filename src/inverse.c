@@ -0,0 +1,329 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+// the 3x3 inverse of the rows of m (stride elements apart), written into out; returns the determinant (out is unset if it is 0).
+static __zml_floating _zml_inverse3(const __zml_floating *m, size_t stride, __zml_floating out[3][3]) {
+	#define _m(r, c) m[(r) * stride + (c)]
+
+	// cofactors of the first row
+	const __zml_floating c00 = _m(1, 1) * _m(2, 2) - _m(1, 2) * _m(2, 1);
+	const __zml_floating c01 = _m(1, 2) * _m(2, 0) - _m(1, 0) * _m(2, 2);
+	const __zml_floating c02 = _m(1, 0) * _m(2, 1) - _m(1, 1) * _m(2, 0);
+
+	const __zml_floating det = _m(0, 0) * c00 + _m(0, 1) * c01 + _m(0, 2) * c02;
+	if (det == (__zml_floating) 0.0) {
+		return det;
+	}
+
+	// the inverse is the transpose of the matrix of cofactors, over the determinant
+	const __zml_floating inv = (__zml_floating) 1.0 / det;
+	out[0][0] = c00 * inv;
+	out[1][0] = c01 * inv;
+	out[2][0] = c02 * inv;
+	out[0][1] = (_m(0, 2) * _m(2, 1) - _m(0, 1) * _m(2, 2)) * inv;
+	out[1][1] = (_m(0, 0) * _m(2, 2) - _m(0, 2) * _m(2, 0)) * inv;
+	out[2][1] = (_m(0, 1) * _m(2, 0) - _m(0, 0) * _m(2, 1)) * inv;
+	out[0][2] = (_m(0, 1) * _m(1, 2) - _m(0, 2) * _m(1, 1)) * inv;
+	out[1][2] = (_m(0, 2) * _m(1, 0) - _m(0, 0) * _m(1, 2)) * inv;
+	out[2][2] = (_m(0, 0) * _m(1, 1) - _m(0, 1) * _m(1, 0)) * inv;
+
+	#undef _m
+	return det;
+}
+
+// the inverse of an affine 4x4 matrix (whose fourth row is [ 0, 0, 0, 1 ]) with rows stride elements apart, written into out.
+// The upper-left 3x3 block is inverted and the translation t becomes -inverse * t. Returns 0 if the matrix is singular.
+static unsigned char _zml_inverseAffine(const __zml_floating *m, size_t stride, __zml_floating out[4][4]) {
+	__zml_floating r[3][3];
+	if (_zml_inverse3(m, stride, r) == (__zml_floating) 0.0) {
+		return 0;
+	}
+
+	for (unsigned int row = 0; row < 3; row++) {
+		out[row][0] = r[row][0];
+		out[row][1] = r[row][1];
+		out[row][2] = r[row][2];
+		out[row][3] = -(r[row][0] * m[3] + r[row][1] * m[stride + 3] + r[row][2] * m[2 * stride + 3]);
+	}
+	out[3][0] = out[3][1] = out[3][2] = (__zml_floating) 0.0;
+	out[3][3] = (__zml_floating) 1.0;
+
+	return 1;
+}
+
+// invert an n x n matrix (n > 4) by LU decomposition, writing the result into dst (already n x n, and may be mat).
+// Returns 0, leaving dst unchanged, if it is singular.
+static unsigned char _zml_inverseLU(zmlMatrix *mat, zmlMatrix *dst) {
+	const unsigned int n = mat->rows;
+	zmlMatrix lu = zmlCopyMatrix(mat);
+	unsigned int *pivots = (unsigned int *) _zml_alloc(n * sizeof(unsigned int), sizeof(unsigned int));
+	unsigned char ok = 0;
+
+	if (!lu.data || !pivots) {
+		printf("zetaml: zmlInvertedInto(): out of memory!\n");
+	} else if (_zml_luFactor(&lu, pivots)) {
+		// solve A X = I
+		for (unsigned int i = 0; i < n; i++) {
+			memset(&_zml_at(*dst, i, 0), 0, n * sizeof(__zml_floating));
+			_zml_at(*dst, i, i) = (__zml_floating) 1.0;
+		}
+		zmlLUSolve(lu, pivots, dst);
+		ok = 1;
+	}
+
+	_zml_free(pivots);
+	zmlFreeMatrix(&lu);
+	return ok;
+}
+
+/**
+ * @brief allocate the inverse of a square matrix. 4x4 matrices whose fourth row is [ 0, 0, 0, 1 ] (such as the transformation
+ * and view matrices zetaml constructs) take a faster path that only inverts the upper-left 3x3 block.
+ * 
+ * @param mat the matrix to invert.
+ */
+zmlMatrix zmlInverted(zmlMatrix mat) {
+	if (mat.rows != mat.cols) {
+		printf("zetaml: zmlInverted(): given matrix is not square! null matrix returned!\n");
+		return ZML_NULL_MATRIX;
+	}
+
+	zmlMatrix r = zmlAllocMatrix(mat.rows, mat.cols);
+	if (!zmlInvertedInto(&r, mat)) {
+		zmlFreeMatrix(&r);
+		return ZML_NULL_MATRIX;
+	}
+	return r;
+}
+
+/**
+ * @brief alternative to zmlInverted() that writes the inverse into an existing matrix of the same size.
+ * Returns 1 on success, or 0 (leaving dst unchanged) if mat is singular.
+ * 
+ * @param dst the matrix to write the inverse into. May be the same matrix as mat.
+ * @param mat the matrix to invert.
+ */
+unsigned char zmlInvertedInto(zmlMatrix *dst, zmlMatrix mat) {
+	if (mat.rows != mat.cols) {
+		printf("zetaml: zmlInvertedInto(): given matrix is not square! no inverse calculated!\n");
+		return 0;
+	}
+	if (dst->rows != mat.rows || dst->cols != mat.cols) {
+		printf("zetaml: zmlInvertedInto(): the destination matrix is not the same size as the given matrix! no inverse calculated!\n");
+		return 0;
+	}
+
+	const unsigned int n = mat.rows;
+	unsigned char ok = 1;
+
+	if (n <= 4) {
+		// small matrices are inverted on the stack, so that dst may be mat
+		__zml_floating out[4][4];
+
+		if (n == 4) {
+			const __zml_floating *row3 = &_zml_at(mat, 3, 0);
+			if (row3[0] == (__zml_floating) 0.0 && row3[1] == (__zml_floating) 0.0 && row3[2] == (__zml_floating) 0.0 && row3[3] == (__zml_floating) 1.0) {
+				ok = _zml_inverseAffine(mat.data, mat.stride, out);
+			} else {
+				__zml_floating m[16];
+				for (unsigned int r = 0; r < 4; r++) {
+					memcpy(m + 4 * r, &_zml_at(mat, r, 0), 4 * sizeof(__zml_floating));
+				}
+				ok = _zml_kernels()->inverse4(m, &out[0][0]) != (__zml_floating) 0.0;
+			}
+		} else if (n == 3) {
+			__zml_floating r3[3][3];
+			ok = _zml_inverse3(mat.data, mat.stride, r3) != (__zml_floating) 0.0;
+			for (unsigned int r = 0; r < 3 && ok; r++) {
+				memcpy(out[r], r3[r], 3 * sizeof(__zml_floating));
+			}
+		} else if (n == 2) {
+			const __zml_floating a = _zml_at(mat, 0, 0), b = _zml_at(mat, 0, 1), c = _zml_at(mat, 1, 0), d = _zml_at(mat, 1, 1);
+			const __zml_floating det = a * d - b * c;
+			ok = det != (__zml_floating) 0.0;
+			if (ok) {
+				out[0][0] = d / det;
+				out[0][1] = -b / det;
+				out[1][0] = -c / det;
+				out[1][1] = a / det;
+			}
+		} else if (n == 1) {
+			ok = _zml_at(mat, 0, 0) != (__zml_floating) 0.0;
+			out[0][0] = (__zml_floating) 1.0 / _zml_at(mat, 0, 0);
+		}
+
+		for (unsigned int r = 0; r < n && ok; r++) {
+			memcpy(&_zml_at(*dst, r, 0), out[r], n * sizeof(__zml_floating));
+		}
+	} else {
+		ok = _zml_inverseLU(&mat, dst);
+	}
+
+	if (!ok) {
+		printf("zetaml: zmlInvertedInto(): given matrix is singular! no inverse calculated!\n");
+	}
+	return ok;
+}
+
+/**
+ * @brief alternative to zmlInverted() that replaces mat with its inverse.
+ * Returns 1 on success, or 0 (leaving mat unchanged) if it is singular.
+ * 
+ * @param mat the matrix to invert.
+ */
+unsigned char zmlInvert(zmlMatrix *mat) {
+	return zmlInvertedInto(mat, *mat);
+}
+
+/**
+ * @brief get the determinant of a square matrix.
+ * 
+ * @param mat the specified matrix.
+ */
+__zml_floating zmlDeterminant(zmlMatrix mat) {
+	if (mat.rows != mat.cols) {
+		printf("zetaml: zmlDeterminant(): given matrix is not square! 0 returned!\n");
+		return (__zml_floating) 0.0;
+	}
+
+	const unsigned int n = mat.rows;
+	switch (n) {
+		case 0:
+			return (__zml_floating) 1.0;
+		case 1:
+			return _zml_at(mat, 0, 0);
+		case 2:
+			return _zml_at(mat, 0, 0) * _zml_at(mat, 1, 1) - _zml_at(mat, 0, 1) * _zml_at(mat, 1, 0);
+		case 3:
+			return zmlDeterminantMat3(zmlMatrixToMat3(mat));
+		case 4:
+			return zmlDeterminantMat4(zmlMatrixToMat4(mat));
+	}
+
+	zmlMatrix lu = zmlCopyMatrix(&mat);
+	unsigned int *pivots = (unsigned int *) _zml_alloc(n * sizeof(unsigned int), sizeof(unsigned int));
+	__zml_floating det = (__zml_floating) 0.0;
+
+	if (!lu.data || !pivots) {
+		printf("zetaml: zmlDeterminant(): out of memory! 0 returned!\n");
+	} else if (_zml_luFactor(&lu, pivots)) {
+		// the product of the diagonal of U, negated for every row swap
+		det = (__zml_floating) 1.0;
+		for (unsigned int i = 0; i < n; i++) {
+			det *= (pivots[i] != i) ? -_zml_at(lu, i, i) : _zml_at(lu, i, i);
+		}
+	}
+
+	_zml_free(pivots);
+	zmlFreeMatrix(&lu);
+	return det;
+}
+
+/**
+ * @brief get the inverse of a 3x3 matrix. If it is singular, a zero matrix is returned.
+ * 
+ * @param mat the matrix to invert.
+ */
+zmlMat3 zmlInvertedMat3(zmlMat3 mat) {
+	zmlMat3 r;
+	if (_zml_inverse3(&mat.elements[0][0], 3, r.elements) == (__zml_floating) 0.0) {
+		printf("zetaml: zmlInvertedMat3(): given matrix is singular! zero matrix returned!\n");
+		memset(&r, 0, sizeof(r));
+	}
+	return r;
+}
+/**
+ * @brief get the inverse of a 4x4 matrix. If it is singular, a zero matrix is returned.
+ * See zmlInvertedAffineMat4() and zmlInvertedRigidMat4() for faster versions for transformation matrices.
+ * 
+ * @param mat the matrix to invert.
+ */
+zmlMat4 zmlInvertedMat4(zmlMat4 mat) {
+	zmlMat4 r;
+	if (_zml_kernels()->inverse4(&mat.elements[0][0], &r.elements[0][0]) == (__zml_floating) 0.0) {
+		printf("zetaml: zmlInvertedMat4(): given matrix is singular! zero matrix returned!\n");
+		memset(&r, 0, sizeof(r));
+	}
+	return r;
+}
+/**
+ * @brief get the inverse of an affine 4x4 matrix, i.e. one whose fourth row is [ 0, 0, 0, 1 ], such as any combination of
+ * translations, rotations and scales. If it is singular, a zero matrix is returned.
+ * 
+ * @param mat the matrix to invert.
+ */
+zmlMat4 zmlInvertedAffineMat4(zmlMat4 mat) {
+	zmlMat4 r;
+	if (!_zml_inverseAffine(&mat.elements[0][0], 4, r.elements)) {
+		printf("zetaml: zmlInvertedAffineMat4(): given matrix is singular! zero matrix returned!\n");
+		memset(&r, 0, sizeof(r));
+	}
+	return r;
+}
+/**
+ * @brief get the inverse of a rigid 4x4 transformation (rotations and translations only, such as a view matrix from
+ * zmlConstructLookAtMat4RH()), by transposing the rotation and rotating the negated translation.
+ * The result is wrong if the matrix contains any scale.
+ * 
+ * @param mat the matrix to invert.
+ */
+zmlMat4 zmlInvertedRigidMat4(zmlMat4 mat) {
+	zmlMat4 r;
+
+	for (unsigned int row = 0; row < 3; row++) {
+		r.elements[row][0] = mat.elements[0][row];
+		r.elements[row][1] = mat.elements[1][row];
+		r.elements[row][2] = mat.elements[2][row];
+		r.elements[row][3] = -(mat.elements[0][row] * mat.elements[0][3] + mat.elements[1][row] * mat.elements[1][3] + mat.elements[2][row] * mat.elements[2][3]);
+	}
+	r.elements[3][0] = r.elements[3][1] = r.elements[3][2] = (__zml_floating) 0.0;
+	r.elements[3][3] = (__zml_floating) 1.0;
+
+	return r;
+}
+
+/**
+ * @brief get the determinant of a 3x3 matrix.
+ * 
+ * @param mat the specified matrix.
+ */
+__zml_floating zmlDeterminantMat3(zmlMat3 mat) {
+	const __zml_floating (*m)[3] = mat.elements;
+	return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+		+ m[0][1] * (m[1][2] * m[2][0] - m[1][0] * m[2][2])
+		+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+/**
+ * @brief get the determinant of a 4x4 matrix.
+ * 
+ * @param mat the specified matrix.
+ */
+__zml_floating zmlDeterminantMat4(zmlMat4 mat) {
+	const __zml_floating (*m)[4] = mat.elements;
+
+	// Laplace expansion along the first row, sharing the 2x2 determinants of the last two rows
+	const __zml_floating s01 = m[2][0] * m[3][1] - m[2][1] * m[3][0];
+	const __zml_floating s02 = m[2][0] * m[3][2] - m[2][2] * m[3][0];
+	const __zml_floating s03 = m[2][0] * m[3][3] - m[2][3] * m[3][0];
+	const __zml_floating s12 = m[2][1] * m[3][2] - m[2][2] * m[3][1];
+	const __zml_floating s13 = m[2][1] * m[3][3] - m[2][3] * m[3][1];
+	const __zml_floating s23 = m[2][2] * m[3][3] - m[2][3] * m[3][2];
+
+	return m[0][0] * (m[1][1] * s23 - m[1][2] * s13 + m[1][3] * s12)
+		- m[0][1] * (m[1][0] * s23 - m[1][2] * s03 + m[1][3] * s02)
+		+ m[0][2] * (m[1][0] * s13 - m[1][1] * s03 + m[1][3] * s01)
+		- m[0][3] * (m[1][0] * s12 - m[1][1] * s02 + m[1][2] * s01);
+}
@@ -0,0 +1,406 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// (large files need 64-bit offsets on 32-bit systems too)
+#define _FILE_OFFSET_BITS 64
+
+#include "internal.h"
+
+// ==============================================================================
+// Matrices are saved as a 64-byte header followed by the elements in row-major order. The header records the
+// dimensions, the size of an element (4 for float, 8 for double), the row stride and where the elements start;
+// the elements are aligned in the file so that a memory-mapped file can be used as a matrix without copying.
+// Files are written in the byte order of the machine writing them, which is checked when they are read.
+// ==============================================================================
+
+#if defined(__unix__) || defined(__APPLE__)
+#	define ZML_HAS_MMAP
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+#define _ZML_FILE_VERSION 1
+#define _ZML_BYTE_ORDER 0x01020304u
+
+typedef struct {
+	char magic[4]; // "ZMLM"
+	uint32_t byteOrder; // _ZML_BYTE_ORDER as stored by the machine that wrote the file
+	uint32_t version;
+	uint32_t elementSize; // sizeof(float) or sizeof(double)
+	uint32_t rows;
+	uint32_t cols;
+	uint32_t stride; // distance, in elements, between the start of each row
+	uint32_t alignment; // alignment, in bytes, of offset
+	uint64_t offset; // where the elements start, in bytes from the start of the file
+	uint64_t size; // size of the elements, in bytes
+	unsigned char reserved[16];
+} _zml_fileHeader;
+
+// (fails to compile if the header isn't exactly 64 bytes)
+typedef char _zml_fileHeaderSizeCheck[(sizeof(_zml_fileHeader) == 64) ? 1 : -1];
+
+// stored in front of the row pointers of a matrix returned by zmlMapMatrix(), so that zmlUnmapMatrix() can release it.
+typedef struct {
+	void *base; // start of the mapping (or of the copy, if the file couldn't be mapped)
+	size_t length; // length of the mapping (0 if base is a copy allocated with _zml_alloc())
+} _zml_mapping;
+
+struct zmlMatrixWriter {
+	FILE *file;
+	unsigned int rows;
+	unsigned int cols;
+	unsigned int written; // rows written so far
+	unsigned char failed;
+};
+
+static _zml_fileHeader _zml_makeHeader(unsigned int rows, unsigned int cols) {
+	_zml_fileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, "ZMLM", 4);
+	h.byteOrder = _ZML_BYTE_ORDER;
+	h.version = _ZML_FILE_VERSION;
+	h.elementSize = sizeof(__zml_floating);
+	h.rows = rows;
+	h.cols = cols;
+	h.stride = cols;
+	h.alignment = ZML_ALIGNMENT;
+	h.offset = (sizeof(_zml_fileHeader) + ZML_ALIGNMENT - 1) & ~((uint64_t) ZML_ALIGNMENT - 1);
+	h.size = (uint64_t) rows * cols * sizeof(__zml_floating);
+	return h;
+}
+
+// check that a header read from a file describes a matrix this library can read; filesize is the size of the whole
+// file (if known - otherwise UINT64_MAX). Prints the problem on behalf of func if not.
+static unsigned char _zml_checkHeader(const _zml_fileHeader *h, uint64_t filesize, const char *path, const char *func) {
+	if (memcmp(h->magic, "ZMLM", 4) != 0) {
+		printf("zetaml: %s(): '%s' is not a zetaml matrix file!\n", func, path);
+		return 0;
+	}
+	if (h->byteOrder != _ZML_BYTE_ORDER) {
+		printf("zetaml: %s(): '%s' was written on a machine with a different byte order!\n", func, path);
+		return 0;
+	}
+	if (h->version != _ZML_FILE_VERSION) {
+		printf("zetaml: %s(): '%s' has an unsupported version (%u)!\n", func, path, h->version);
+		return 0;
+	}
+	if ((h->elementSize != sizeof(float) && h->elementSize != sizeof(double)) || h->stride < h->cols ||
+		h->offset < sizeof(_zml_fileHeader) || (h->stride && h->size / h->elementSize / h->stride < h->rows) ||
+		h->size > filesize || h->offset > filesize - h->size) {
+		printf("zetaml: %s(): '%s' is damaged or truncated!\n", func, path);
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief start writing a matrix with the given dimensions to the file at path, a group of rows at a time, so that
+ * large matrices can be saved without ever being held in memory all at once.
+ * Write the rows with zmlWriteMatrixRows(), then finish with zmlCloseMatrixWriter(). Returns NULL if the file
+ * couldn't be opened.
+ * 
+ * @param path the file to write (replaced if it exists).
+ * @param rows the number of rows in the matrix.
+ * @param cols the number of columns in the matrix.
+ */
+zmlMatrixWriter *zmlOpenMatrixWriter(const char *path, unsigned int rows, unsigned int cols) {
+	FILE *file = fopen(path, "wb");
+	if (!file) {
+		printf("zetaml: zmlOpenMatrixWriter(): couldn't open '%s' for writing!\n", path);
+		return NULL;
+	}
+
+	zmlMatrixWriter *writer = (zmlMatrixWriter *) _zml_alloc(sizeof(zmlMatrixWriter), sizeof(void *));
+	if (!writer) {
+		fclose(file);
+		return NULL;
+	}
+	writer->file = file;
+	writer->rows = rows;
+	writer->cols = cols;
+	writer->written = 0;
+	writer->failed = 0;
+
+	// the header, then padding up to the start of the elements
+	const _zml_fileHeader h = _zml_makeHeader(rows, cols);
+	static const unsigned char padding[ZML_ALIGNMENT] = { 0 };
+	if (fwrite(&h, sizeof(h), 1, file) != 1 || fwrite(padding, 1, (size_t) h.offset - sizeof(h), file) != h.offset - sizeof(h)) {
+		writer->failed = 1;
+	}
+
+	return writer;
+}
+
+/**
+ * @brief write the next count rows of the matrix being written by writer.
+ * Returns 1 if they were written, or 0 if they would go past the last row or the file couldn't be written.
+ * 
+ * @param writer the writer, from zmlOpenMatrixWriter().
+ * @param rows the rows to write: count * cols contiguous elements, in row-major order.
+ * @param count the number of rows to write.
+ */
+unsigned char zmlWriteMatrixRows(zmlMatrixWriter *writer, const __zml_floating *rows, unsigned int count) {
+	if (count > writer->rows - writer->written) {
+		printf("zetaml: zmlWriteMatrixRows(): can't write %u more rows to a matrix with %u rows (%u already written)!\n", count, writer->rows, writer->written);
+		return 0;
+	}
+
+	const size_t n = (size_t) count * writer->cols;
+	if (fwrite(rows, sizeof(__zml_floating), n, writer->file) != n) {
+		writer->failed = 1;
+		return 0;
+	}
+	writer->written += count;
+
+	return 1;
+}
+
+/**
+ * @brief finish writing a matrix and free the writer.
+ * Returns 1 if the whole matrix was written successfully, or 0 if any writes failed or not every row was written.
+ * 
+ * @param writer the writer, from zmlOpenMatrixWriter().
+ */
+unsigned char zmlCloseMatrixWriter(zmlMatrixWriter *writer) {
+	unsigned char ok = !writer->failed;
+	if (writer->written != writer->rows) {
+		printf("zetaml: zmlCloseMatrixWriter(): only %u of the matrix's %u rows were written!\n", writer->written, writer->rows);
+		ok = 0;
+	}
+	if (fclose(writer->file) != 0) {
+		ok = 0;
+	}
+	if (writer->failed) {
+		printf("zetaml: zmlCloseMatrixWriter(): writing the matrix file failed!\n");
+	}
+
+	_zml_free(writer);
+	return ok;
+}
+
+/**
+ * @brief save a matrix to the file at path, in zetaml's binary format (see zmlLoadMatrix() and zmlMapMatrix()).
+ * Returns 1 if the file was written, or 0 if not.
+ * 
+ * @param mat the matrix to save.
+ * @param path the file to write (replaced if it exists).
+ */
+unsigned char zmlSaveMatrix(zmlMatrix mat, const char *path) {
+	zmlMatrixWriter *writer = zmlOpenMatrixWriter(path, mat.rows, mat.cols);
+	if (!writer) {
+		return 0;
+	}
+
+	if (mat.stride == mat.cols) {
+		zmlWriteMatrixRows(writer, mat.data, mat.rows);
+	} else {
+		for (unsigned int r = 0; r < mat.rows; r++) {
+			zmlWriteMatrixRows(writer, &_zml_at(mat, r, 0), 1);
+		}
+	}
+
+	return zmlCloseMatrixWriter(writer);
+}
+
+/**
+ * @brief read a matrix from a file written by zmlSaveMatrix() or a zmlMatrixWriter into a new matrix, which must be freed with
+ * zmlFreeMatrix(). Files of floats can be read by builds using doubles and vice versa (the elements are converted).
+ * Returns ZML_NULL_MATRIX if the file couldn't be read.
+ * 
+ * @param path the file to read.
+ */
+zmlMatrix zmlLoadMatrix(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		printf("zetaml: zmlLoadMatrix(): couldn't open '%s'!\n", path);
+		return ZML_NULL_MATRIX;
+	}
+
+	// (if the size of the file can't be found, a truncated file is noticed when reading it instead)
+	long end = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+	const uint64_t filesize = (end >= 0) ? (uint64_t) end : UINT64_MAX;
+	rewind(file);
+
+	_zml_fileHeader h;
+	if (fread(&h, sizeof(h), 1, file) != 1) {
+		printf("zetaml: zmlLoadMatrix(): '%s' is not a zetaml matrix file!\n", path);
+		fclose(file);
+		return ZML_NULL_MATRIX;
+	}
+	if (!_zml_checkHeader(&h, filesize, path, "zmlLoadMatrix") || fseek(file, (long) h.offset, SEEK_SET) != 0) {
+		fclose(file);
+		return ZML_NULL_MATRIX;
+	}
+
+	zmlMatrix r = zmlAllocMatrix(h.rows, h.cols);
+	unsigned char ok = 1;
+
+	if (h.elementSize == sizeof(__zml_floating) && h.stride == h.cols) {
+		// stored exactly as it is in memory, so it can be read in one go
+		const size_t n = (size_t) h.rows * h.cols;
+		ok = (fread(r.data, sizeof(__zml_floating), n, file) == n);
+	} else {
+		// read a row at a time, skipping any padding and converting the elements if necessary
+		void *row = _zml_alloc((size_t) h.stride * h.elementSize, ZML_ALIGNMENT);
+		for (unsigned int i = 0; i < h.rows && ok; i++) {
+			if (!row || fread(row, h.elementSize, h.stride, file) != h.stride) {
+				ok = 0;
+				break;
+			}
+			for (unsigned int c = 0; c < h.cols; c++) {
+				_zml_at(r, i, c) = (h.elementSize == sizeof(float)) ? (__zml_floating) ((float *) row)[c] : (__zml_floating) ((double *) row)[c];
+			}
+		}
+		_zml_free(row);
+	}
+
+	fclose(file);
+	if (!ok) {
+		printf("zetaml: zmlLoadMatrix(): couldn't read the elements of '%s'!\n", path);
+		zmlFreeMatrix(&r);
+		return ZML_NULL_MATRIX;
+	}
+
+	return r;
+}
+
+/**
+ * @brief map a file written by zmlSaveMatrix() or a zmlMatrixWriter into memory and return a read-only matrix whose elements
+ * are read straight from it, without copying them: pages are only read from disk as they are first used, so this is
+ * practically instant whatever the size of the file. The elements must not be modified, and the matrix must be
+ * released with zmlUnmapMatrix() (not zmlFreeMatrix()). The file's elements must be of the type zetaml was built with.
+ * Returns ZML_NULL_MATRIX if the file couldn't be mapped.
+ * 
+ * @param path the file to map.
+ */
+zmlMatrix zmlMapMatrix(const char *path) {
+	void *base;
+	size_t length;
+
+#ifdef ZML_HAS_MMAP
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("zetaml: zmlMapMatrix(): couldn't open '%s'!\n", path);
+		return ZML_NULL_MATRIX;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (uint64_t) st.st_size < sizeof(_zml_fileHeader) || (uint64_t) st.st_size > SIZE_MAX) {
+		printf("zetaml: zmlMapMatrix(): '%s' is not a zetaml matrix file!\n", path);
+		close(fd);
+		return ZML_NULL_MATRIX;
+	}
+	length = (size_t) st.st_size;
+
+	base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // (the mapping keeps the file open)
+	if (base == MAP_FAILED) {
+		printf("zetaml: zmlMapMatrix(): couldn't map '%s' into memory!\n", path);
+		return ZML_NULL_MATRIX;
+	}
+#else
+	// without mmap(), read the whole file into memory instead.
+	FILE *file = fopen(path, "rb");
+	long end = -1;
+	if (!file || fseek(file, 0, SEEK_END) != 0 || (end = ftell(file)) < (long) sizeof(_zml_fileHeader) || fseek(file, 0, SEEK_SET) != 0) {
+		printf("zetaml: zmlMapMatrix(): couldn't read '%s'!\n", path);
+		if (file) fclose(file);
+		return ZML_NULL_MATRIX;
+	}
+
+	base = _zml_alloc((size_t) end, ZML_ALIGNMENT);
+	if (!base || fread(base, 1, (size_t) end, file) != (size_t) end) {
+		printf("zetaml: zmlMapMatrix(): couldn't read '%s'!\n", path);
+		_zml_free(base);
+		fclose(file);
+		return ZML_NULL_MATRIX;
+	}
+	fclose(file);
+
+	length = (size_t) end;
+#endif
+
+	_zml_fileHeader h;
+	memcpy(&h, base, sizeof(h));
+
+	unsigned char ok = _zml_checkHeader(&h, length, path, "zmlMapMatrix");
+	if (ok && h.elementSize != sizeof(__zml_floating)) {
+		printf("zetaml: zmlMapMatrix(): '%s' holds %s but zetaml was built with %s; read it with zmlLoadMatrix() instead!\n", path,
+			(h.elementSize == sizeof(float)) ? "floats" : "doubles", (sizeof(__zml_floating) == sizeof(float)) ? "floats" : "doubles");
+		ok = 0;
+	}
+	if (ok && h.offset % sizeof(__zml_floating) != 0) {
+		printf("zetaml: zmlMapMatrix(): the elements of '%s' are misaligned!\n", path);
+		ok = 0;
+	}
+
+	// the row pointers go in a block of their own, after a record of the mapping
+	_zml_mapping *mapping = NULL;
+	if (ok) {
+		mapping = (_zml_mapping *) _zml_alloc(sizeof(_zml_mapping) + (size_t) h.rows * sizeof(__zml_floating *), sizeof(void *));
+		ok = (mapping != NULL);
+	}
+
+	if (!ok) {
+#ifdef ZML_HAS_MMAP
+		munmap(base, length);
+#else
+		_zml_free(base);
+#endif
+		return ZML_NULL_MATRIX;
+	}
+
+	mapping->base = base;
+#ifdef ZML_HAS_MMAP
+	mapping->length = length;
+#else
+	mapping->length = 0;
+#endif
+
+	zmlMatrix r;
+	r.rows = h.rows;
+	r.cols = h.cols;
+	r.stride = h.stride;
+	r.data = (__zml_floating *) ((unsigned char *) base + h.offset);
+	r.elements = (__zml_floating **) (mapping + 1);
+
+	for (unsigned int i = 0; i < r.rows; i++) {
+		r.elements[i] = r.data + (size_t) i * r.stride;
+	}
+
+	return r;
+}
+
+/**
+ * @brief release a matrix returned by zmlMapMatrix().
+ * 
+ * @param mat the matrix to release.
+ */
+void zmlUnmapMatrix(zmlMatrix *mat) {
+	if (mat->elements) {
+		_zml_mapping *mapping = (_zml_mapping *) mat->elements - 1;
+
+#ifdef ZML_HAS_MMAP
+		munmap(mapping->base, mapping->length);
+#else
+		_zml_free(mapping->base);
+#endif
+		_zml_free(mapping);
+	}
+
+	*mat = ZML_NULL_MATRIX;
+}
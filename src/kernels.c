@@ -0,0 +1,427 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+#ifdef ZML_X86_SIMD
+#	include <immintrin.h>
+#endif
+
+// ==============================================================================
+// The kernels behind the vector and matrix operators (dot products, element-wise arithmetic and comparisons) are
+// built for every instruction set zetaml supports. The best set for the CPU is chosen the first time they're needed
+// (see _zml_kernels()), so one build runs well on any x86 CPU.
+// ==============================================================================
+
+// reductions shorter than this always use the scalar kernels, which sum in order; this keeps the results for
+// small vectors identical no matter which instruction set is in use.
+#define _ZML_SIMD_MIN_REDUCTION 16
+
+// -------------------------------------------
+// scalar kernels
+// -------------------------------------------
+
+static __zml_floating _zml_dotScalar(const __zml_floating *a, const __zml_floating *b, size_t n) {
+	__zml_floating r = (__zml_floating) 0.0;
+	for (size_t i = 0; i < n; i++) {
+		r += a[i] * b[i];
+	}
+	return r;
+}
+
+static __zml_floating _zml_sumSquaresScalar(const __zml_floating *a, size_t n) {
+	return _zml_dotScalar(a, a, n);
+}
+
+static void _zml_elementwiseScalar(_zml_elementwiseOp op, __zml_floating *dst, const __zml_floating *a, const __zml_floating *b, __zml_floating s, size_t n) {
+	switch (op) {
+		case _ZML_OP_ADD:				for (size_t i = 0; i < n; i++) dst[i] = a[i] + b[i]; break;
+		case _ZML_OP_SUBTRACT:			for (size_t i = 0; i < n; i++) dst[i] = a[i] - b[i]; break;
+		case _ZML_OP_MULTIPLY:			for (size_t i = 0; i < n; i++) dst[i] = a[i] * b[i]; break;
+		case _ZML_OP_DIVIDE:			for (size_t i = 0; i < n; i++) dst[i] = a[i] / b[i]; break;
+		case _ZML_OP_ADD_SCALAR:		for (size_t i = 0; i < n; i++) dst[i] = a[i] + s; break;
+		case _ZML_OP_SUBTRACT_SCALAR:	for (size_t i = 0; i < n; i++) dst[i] = a[i] - s; break;
+		case _ZML_OP_MULTIPLY_SCALAR:	for (size_t i = 0; i < n; i++) dst[i] = a[i] * s; break;
+		case _ZML_OP_DIVIDE_SCALAR:		for (size_t i = 0; i < n; i++) dst[i] = a[i] / s; break;
+	}
+}
+
+// (each comparison fails on the opposite condition, exactly as written here, so NaNs are treated the same on every path)
+#define _ZML_COMPARE_LOOP(fails) {\
+	for (size_t i = 0; i < n; i++) {\
+		const __zml_floating x = a[i], y = b ? b[i] : s;\
+		if (fails)\
+			return 0;\
+	}\
+	return 1;\
+}
+
+static unsigned char _zml_compareScalar(_zml_compareOp op, const __zml_floating *a, const __zml_floating *b, __zml_floating s, size_t n) {
+	switch (op) {
+		case _ZML_CMP_EQ:	_ZML_COMPARE_LOOP(x != y)
+		case _ZML_CMP_GT:	_ZML_COMPARE_LOOP(x <= y)
+		case _ZML_CMP_GTE:	_ZML_COMPARE_LOOP(x < y)
+		case _ZML_CMP_LT:	_ZML_COMPARE_LOOP(x >= y)
+		case _ZML_CMP_LTE:	_ZML_COMPARE_LOOP(x > y)
+	}
+	return 1;
+}
+
+// 4x4 inverse by cofactors, worked out for the transpose of m (whose columns are m's rows): lane i of each step
+// uses the rows i + 1, i + 2 and i + 3 (mod 4) of the transpose, which are in an even (cyclic) order, so each lane
+// gets the same minor as the rows taken in order would. The cofactors of the transpose's columns are then the
+// columns of m's inverse, scaled by the determinant. The SIMD versions below do the same steps on whole rows.
+static __zml_floating _zml_inverse4Scalar(const __zml_floating *m, __zml_floating *out) {
+	const __zml_floating *a = m, *b = m + 4, *c = m + 8, *d = m + 12;
+	__zml_floating cof[4][4]; // cof[j][i] is the cofactor of element (i, j) of the transpose
+
+	for (unsigned int i = 0; i < 4; i++) {
+		const unsigned int i1 = (i + 1) & 3, i2 = (i + 2) & 3, i3 = (i + 3) & 3;
+		const __zml_floating sign = (i & 1) ? (__zml_floating) -1.0 : (__zml_floating) 1.0;
+
+		// 2x2 determinants of the pairs of columns (c, d), (b, d) and (b, c) in rows (2, 3), (1, 3) and (1, 2)
+		const __zml_floating cd23 = c[i2] * d[i3] - c[i3] * d[i2], cd13 = c[i1] * d[i3] - c[i3] * d[i1], cd12 = c[i1] * d[i2] - c[i2] * d[i1];
+		const __zml_floating bd23 = b[i2] * d[i3] - b[i3] * d[i2], bd13 = b[i1] * d[i3] - b[i3] * d[i1], bd12 = b[i1] * d[i2] - b[i2] * d[i1];
+		const __zml_floating bc23 = b[i2] * c[i3] - b[i3] * c[i2], bc13 = b[i1] * c[i3] - b[i3] * c[i1], bc12 = b[i1] * c[i2] - b[i2] * c[i1];
+
+		cof[0][i] = ((b[i1] * cd23 - b[i2] * cd13) + b[i3] * cd12) * sign;
+		cof[1][i] = ((a[i1] * cd23 - a[i2] * cd13) + a[i3] * cd12) * -sign;
+		cof[2][i] = ((a[i1] * bd23 - a[i2] * bd13) + a[i3] * bd12) * sign;
+		cof[3][i] = ((a[i1] * bc23 - a[i2] * bc13) + a[i3] * bc12) * -sign;
+	}
+
+	const __zml_floating det = ((a[0] * cof[0][0] + a[1] * cof[0][1]) + a[2] * cof[0][2]) + a[3] * cof[0][3];
+	if (det == (__zml_floating) 0.0) {
+		return det;
+	}
+
+	const __zml_floating inv = (__zml_floating) 1.0 / det;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int col = 0; col < 4; col++) {
+			out[r * 4 + col] = cof[col][r] * inv;
+		}
+	}
+	return det;
+}
+
+#ifdef ZML_X86_SIMD
+
+// -------------------------------------------
+// SIMD kernels. They're written once in terms of the _ZML_V* macros, which are redefined for each instruction set.
+// Leftover elements at the end of an array are handled by the scalar kernels.
+// -------------------------------------------
+
+#define _ZML_ELEMENTWISE_LOOP(vexpr) {\
+	size_t i = 0;\
+	for (; i + _ZML_VLANES <= n; i += _ZML_VLANES) {\
+		const _ZML_VT va = _ZML_VLOADU(a + i);\
+		_ZML_VSTOREU(dst + i, vexpr);\
+	}\
+	_zml_elementwiseScalar(op, dst + i, a + i, b ? b + i : NULL, s, n - i);\
+	return;\
+}
+
+// vfails(x, y) is nonzero if any lane of x fails the comparison against y.
+#define _ZML_COMPARE_VLOOP(vfails) {\
+	size_t i = 0;\
+	if (b) {\
+		for (; i + _ZML_VLANES <= n; i += _ZML_VLANES) {\
+			if (vfails(_ZML_VLOADU(a + i), _ZML_VLOADU(b + i)))\
+				return 0;\
+		}\
+	} else {\
+		for (; i + _ZML_VLANES <= n; i += _ZML_VLANES) {\
+			if (vfails(_ZML_VLOADU(a + i), vs))\
+				return 0;\
+		}\
+	}\
+	return _zml_compareScalar(op, a + i, b ? b + i : NULL, s, n - i);\
+}
+
+#define _ZML_DEFINE_KERNELS(sfx, isa) \
+	__attribute__((target(isa)))\
+	static __zml_floating _zml_dot##sfx(const __zml_floating *a, const __zml_floating *b, size_t n) {\
+		if (n < _ZML_SIMD_MIN_REDUCTION) {\
+			return _zml_dotScalar(a, b, n);\
+		}\
+		_ZML_VT acc0 = _ZML_VZERO(), acc1 = _ZML_VZERO();\
+		size_t i = 0;\
+		for (; i + 2 * _ZML_VLANES <= n; i += 2 * _ZML_VLANES) {\
+			acc0 = _ZML_VFMA(_ZML_VLOADU(a + i), _ZML_VLOADU(b + i), acc0);\
+			acc1 = _ZML_VFMA(_ZML_VLOADU(a + i + _ZML_VLANES), _ZML_VLOADU(b + i + _ZML_VLANES), acc1);\
+		}\
+		__zml_floating lanes[_ZML_VLANES];\
+		_ZML_VSTOREU(lanes, _ZML_VOP(add)(acc0, acc1));\
+		__zml_floating r = _zml_dotScalar(a + i, b + i, n - i);\
+		for (unsigned int l = 0; l < _ZML_VLANES; l++) {\
+			r += lanes[l];\
+		}\
+		return r;\
+	}\
+	__attribute__((target(isa)))\
+	static __zml_floating _zml_sumSquares##sfx(const __zml_floating *a, size_t n) {\
+		return _zml_dot##sfx(a, a, n);\
+	}\
+	__attribute__((target(isa)))\
+	static void _zml_elementwise##sfx(_zml_elementwiseOp op, __zml_floating *dst, const __zml_floating *a, const __zml_floating *b, __zml_floating s, size_t n) {\
+		const _ZML_VT vs = _ZML_VSET1(s);\
+		switch (op) {\
+			case _ZML_OP_ADD:				_ZML_ELEMENTWISE_LOOP(_ZML_VOP(add)(va, _ZML_VLOADU(b + i)))\
+			case _ZML_OP_SUBTRACT:			_ZML_ELEMENTWISE_LOOP(_ZML_VOP(sub)(va, _ZML_VLOADU(b + i)))\
+			case _ZML_OP_MULTIPLY:			_ZML_ELEMENTWISE_LOOP(_ZML_VOP(mul)(va, _ZML_VLOADU(b + i)))\
+			case _ZML_OP_DIVIDE:			_ZML_ELEMENTWISE_LOOP(_ZML_VOP(div)(va, _ZML_VLOADU(b + i)))\
+			case _ZML_OP_ADD_SCALAR:		_ZML_ELEMENTWISE_LOOP(_ZML_VOP(add)(va, vs))\
+			case _ZML_OP_SUBTRACT_SCALAR:	_ZML_ELEMENTWISE_LOOP(_ZML_VOP(sub)(va, vs))\
+			case _ZML_OP_MULTIPLY_SCALAR:	_ZML_ELEMENTWISE_LOOP(_ZML_VOP(mul)(va, vs))\
+			case _ZML_OP_DIVIDE_SCALAR:		_ZML_ELEMENTWISE_LOOP(_ZML_VOP(div)(va, vs))\
+		}\
+	}\
+	__attribute__((target(isa)))\
+	static unsigned char _zml_compare##sfx(_zml_compareOp op, const __zml_floating *a, const __zml_floating *b, __zml_floating s, size_t n) {\
+		const _ZML_VT vs = _ZML_VSET1(s);\
+		switch (op) {\
+			case _ZML_CMP_EQ:	_ZML_COMPARE_VLOOP(_ZML_VANY_NEQ)\
+			case _ZML_CMP_GT:	_ZML_COMPARE_VLOOP(_ZML_VANY_LE)\
+			case _ZML_CMP_GTE:	_ZML_COMPARE_VLOOP(_ZML_VANY_LT)\
+			case _ZML_CMP_LT:	_ZML_COMPARE_VLOOP(_ZML_VANY_GE)\
+			case _ZML_CMP_LTE:	_ZML_COMPARE_VLOOP(_ZML_VANY_GT)\
+		}\
+		return 1;\
+	}
+
+// SSE2 (the unordered not-equal and ordered comparisons match the scalar operators' handling of NaNs)
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m128
+#	define _ZML_VOP(op) _mm_##op##_ps
+#else
+#	define _ZML_VT __m128d
+#	define _ZML_VOP(op) _mm_##op##_pd
+#endif
+#define _ZML_VLANES (16 / sizeof(__zml_floating))
+#define _ZML_VZERO _ZML_VOP(setzero)
+#define _ZML_VSET1 _ZML_VOP(set1)
+#define _ZML_VLOADU _ZML_VOP(loadu)
+#define _ZML_VSTOREU _ZML_VOP(storeu)
+#define _ZML_VFMA(x, y, z) _ZML_VOP(add)(_ZML_VOP(mul)(x, y), z)
+#define _ZML_VANY(cmp, x, y) _ZML_VOP(movemask)(_ZML_VOP(cmp)(x, y))
+#define _ZML_VANY_NEQ(x, y) _ZML_VANY(cmpneq, x, y)
+#define _ZML_VANY_LE(x, y) _ZML_VANY(cmple, x, y)
+#define _ZML_VANY_LT(x, y) _ZML_VANY(cmplt, x, y)
+#define _ZML_VANY_GE(x, y) _ZML_VANY(cmpge, x, y)
+#define _ZML_VANY_GT(x, y) _ZML_VANY(cmpgt, x, y)
+
+_ZML_DEFINE_KERNELS(SSE2, "sse2")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VANY
+
+// AVX2 + FMA
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m256
+#	define _ZML_VOP(op) _mm256_##op##_ps
+#else
+#	define _ZML_VT __m256d
+#	define _ZML_VOP(op) _mm256_##op##_pd
+#endif
+#define _ZML_VLANES (32 / sizeof(__zml_floating))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+#define _ZML_VANY(pred, x, y) _ZML_VOP(movemask)(_ZML_VOP(cmp)(x, y, pred))
+#undef _ZML_VANY_NEQ
+#undef _ZML_VANY_LE
+#undef _ZML_VANY_LT
+#undef _ZML_VANY_GE
+#undef _ZML_VANY_GT
+#define _ZML_VANY_NEQ(x, y) _ZML_VANY(_CMP_NEQ_UQ, x, y)
+#define _ZML_VANY_LE(x, y) _ZML_VANY(_CMP_LE_OQ, x, y)
+#define _ZML_VANY_LT(x, y) _ZML_VANY(_CMP_LT_OQ, x, y)
+#define _ZML_VANY_GE(x, y) _ZML_VANY(_CMP_GE_OQ, x, y)
+#define _ZML_VANY_GT(x, y) _ZML_VANY(_CMP_GT_OQ, x, y)
+
+_ZML_DEFINE_KERNELS(AVX2, "avx2,fma")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VANY
+
+// AVX-512 (comparisons produce a mask register rather than a vector)
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m512
+#	define _ZML_VOP(op) _mm512_##op##_ps
+#else
+#	define _ZML_VT __m512d
+#	define _ZML_VOP(op) _mm512_##op##_pd
+#endif
+#define _ZML_VLANES (64 / sizeof(__zml_floating))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VANY(pred, x, y) _mm512_cmp_ps_mask(x, y, pred)
+#else
+#	define _ZML_VANY(pred, x, y) _mm512_cmp_pd_mask(x, y, pred)
+#endif
+
+_ZML_DEFINE_KERNELS(AVX512, "avx512f")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VANY
+#undef _ZML_VANY_NEQ
+#undef _ZML_VANY_LE
+#undef _ZML_VANY_LT
+#undef _ZML_VANY_GE
+#undef _ZML_VANY_GT
+#undef _ZML_VZERO
+#undef _ZML_VSET1
+#undef _ZML_VLOADU
+#undef _ZML_VSTOREU
+
+// 4x4 inverse (see _zml_inverse4Scalar()), with each row of m in one vector: 128-bit SSE for floats and 256-bit
+// AVX2 for doubles. _ZML_4ROT(x, k) gives the vector whose lane i is lane i + k (mod 4) of x.
+#ifdef ZML_USING_FLOATS
+#	define _ZML_4ISA "sse2"
+#	define _ZML_4T __m128
+#	define _ZML_4OP(op) _mm_##op##_ps
+#	define _ZML_4ROT(x, k) _mm_shuffle_ps(x, x, _MM_SHUFFLE(((k) + 3) & 3, ((k) + 2) & 3, ((k) + 1) & 3, (k)))
+#	define _ZML_4TRANSPOSE _MM_TRANSPOSE4_PS
+#else
+#	define _ZML_4ISA "avx2"
+#	define _ZML_4T __m256d
+#	define _ZML_4OP(op) _mm256_##op##_pd
+#	define _ZML_4ROT(x, k) _mm256_permute4x64_pd(x, _MM_SHUFFLE(((k) + 3) & 3, ((k) + 2) & 3, ((k) + 1) & 3, (k)))
+#	define _ZML_4TRANSPOSE(r0, r1, r2, r3) {\
+		const __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);\
+		const __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);\
+		r0 = _mm256_permute2f128_pd(t0, t2, 0x20);\
+		r1 = _mm256_permute2f128_pd(t1, t3, 0x20);\
+		r2 = _mm256_permute2f128_pd(t0, t2, 0x31);\
+		r3 = _mm256_permute2f128_pd(t1, t3, 0x31);\
+	}
+#endif
+#define _ZML_4MUL _ZML_4OP(mul)
+#define _ZML_4SUB _ZML_4OP(sub)
+#define _ZML_4ADD _ZML_4OP(add)
+#define _ZML_4ROTS(x) const _ZML_4T x##1 = _ZML_4ROT(x, 1), x##2 = _ZML_4ROT(x, 2), x##3 = _ZML_4ROT(x, 3);
+#define _ZML_4DET2(p, q, i, j) _ZML_4SUB(_ZML_4MUL(p##i, q##j), _ZML_4MUL(p##j, q##i))
+#define _ZML_4DET3(p, q, r) _ZML_4ADD(_ZML_4SUB(_ZML_4MUL(p##1, q##r##23), _ZML_4MUL(p##2, q##r##13)), _ZML_4MUL(p##3, q##r##12))
+
+__attribute__((target(_ZML_4ISA)))
+static __zml_floating _zml_inverse4SIMD(const __zml_floating *m, __zml_floating *out) {
+	const _ZML_4T a = _ZML_4OP(loadu)(m), b = _ZML_4OP(loadu)(m + 4), c = _ZML_4OP(loadu)(m + 8), d = _ZML_4OP(loadu)(m + 12);
+	_ZML_4ROTS(a) _ZML_4ROTS(b) _ZML_4ROTS(c) _ZML_4ROTS(d)
+
+	const _ZML_4T cd23 = _ZML_4DET2(c, d, 2, 3), cd13 = _ZML_4DET2(c, d, 1, 3), cd12 = _ZML_4DET2(c, d, 1, 2);
+	const _ZML_4T bd23 = _ZML_4DET2(b, d, 2, 3), bd13 = _ZML_4DET2(b, d, 1, 3), bd12 = _ZML_4DET2(b, d, 1, 2);
+	const _ZML_4T bc23 = _ZML_4DET2(b, c, 2, 3), bc13 = _ZML_4DET2(b, c, 1, 3), bc12 = _ZML_4DET2(b, c, 1, 2);
+
+	const _ZML_4T even = _ZML_4OP(setr)(1, -1, 1, -1), odd = _ZML_4OP(setr)(-1, 1, -1, 1);
+	_ZML_4T cof0 = _ZML_4MUL(_ZML_4DET3(b, c, d), even);
+	_ZML_4T cof1 = _ZML_4MUL(_ZML_4DET3(a, c, d), odd);
+	_ZML_4T cof2 = _ZML_4MUL(_ZML_4DET3(a, b, d), even);
+	_ZML_4T cof3 = _ZML_4MUL(_ZML_4DET3(a, b, c), odd);
+
+	__zml_floating terms[4];
+	_ZML_4OP(storeu)(terms, _ZML_4MUL(a, cof0));
+	const __zml_floating det = ((terms[0] + terms[1]) + terms[2]) + terms[3];
+	if (det == (__zml_floating) 0.0) {
+		return det;
+	}
+
+	// the cofactor vectors are the columns of the inverse
+	const _ZML_4T inv = _ZML_4OP(set1)((__zml_floating) 1.0 / det);
+	cof0 = _ZML_4MUL(cof0, inv);
+	cof1 = _ZML_4MUL(cof1, inv);
+	cof2 = _ZML_4MUL(cof2, inv);
+	cof3 = _ZML_4MUL(cof3, inv);
+	_ZML_4TRANSPOSE(cof0, cof1, cof2, cof3);
+
+	_ZML_4OP(storeu)(out, cof0);
+	_ZML_4OP(storeu)(out + 4, cof1);
+	_ZML_4OP(storeu)(out + 8, cof2);
+	_ZML_4OP(storeu)(out + 12, cof3);
+	return det;
+}
+
+#undef _ZML_4ISA
+#undef _ZML_4T
+#undef _ZML_4OP
+#undef _ZML_4ROT
+#undef _ZML_4TRANSPOSE
+#undef _ZML_4MUL
+#undef _ZML_4SUB
+#undef _ZML_4ADD
+#undef _ZML_4ROTS
+#undef _ZML_4DET2
+#undef _ZML_4DET3
+
+// SSE2 can only hold two doubles, so double builds use the AVX2 version of the 4x4 inverse or none at all.
+#ifdef ZML_USING_FLOATS
+#	define _zml_inverse4SSE2 _zml_inverse4SIMD
+#else
+#	define _zml_inverse4SSE2 _zml_inverse4Scalar
+#endif
+
+#endif
+
+// -------------------------------------------
+// dispatch
+// -------------------------------------------
+
+static const _zml_kernelTable _zml_scalarKernels = {
+	"scalar", _zml_dotScalar, _zml_sumSquaresScalar, _zml_elementwiseScalar, _zml_compareScalar, _zml_inverse4Scalar
+};
+#ifdef ZML_X86_SIMD
+static const _zml_kernelTable _zml_sse2Kernels = {
+	"sse2", _zml_dotSSE2, _zml_sumSquaresSSE2, _zml_elementwiseSSE2, _zml_compareSSE2, _zml_inverse4SSE2
+};
+static const _zml_kernelTable _zml_avx2Kernels = {
+	"avx2", _zml_dotAVX2, _zml_sumSquaresAVX2, _zml_elementwiseAVX2, _zml_compareAVX2, _zml_inverse4SIMD
+};
+static const _zml_kernelTable _zml_avx512Kernels = {
+	"avx512", _zml_dotAVX512, _zml_sumSquaresAVX512, _zml_elementwiseAVX512, _zml_compareAVX512, _zml_inverse4SIMD
+};
+#endif
+
+// the table is picked once; if two threads race to pick it they pick the same one, so no locking is needed.
+static const _zml_kernelTable *_zml_selectedKernels = NULL;
+
+/**
+ * @brief get the table of kernels for the best instruction set the CPU supports (chosen on first use, see _zml_cpuFeatures()).
+ * 
+ */
+const _zml_kernelTable *_zml_kernels(void) {
+	const _zml_kernelTable *table = __atomic_load_n(&_zml_selectedKernels, __ATOMIC_ACQUIRE);
+	if (table) {
+		return table;
+	}
+
+	table = &_zml_scalarKernels;
+#ifdef ZML_X86_SIMD
+	const unsigned int features = _zml_cpuFeatures();
+	if (features & ZML_CPU_AVX512) {
+		table = &_zml_avx512Kernels;
+	} else if (features & ZML_CPU_AVX2) {
+		table = &_zml_avx2Kernels;
+	} else if (features & ZML_CPU_SSE2) {
+		table = &_zml_sse2Kernels;
+	}
+#endif
+
+	__atomic_store_n(&_zml_selectedKernels, table, __ATOMIC_RELEASE);
+	return table;
+}
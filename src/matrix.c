@@ -17,7 +17,12 @@
  * @brief An undefined matrix; no elements.
  * 
  */
-const zmlMatrix ZML_NULL_MATRIX = { 0, 0, NULL };
+const zmlMatrix ZML_NULL_MATRIX = { 0, 0, NULL, NULL, 0 };
+
+// offset, in bytes, of the row pointers from the start of the block allocated by zmlAllocMatrix() for a matrix of count elements.
+static size_t _zml_rowPointerOffset(size_t count) {
+	return (count * sizeof(__zml_floating) + sizeof(__zml_floating *) - 1) & ~(sizeof(__zml_floating *) - 1);
+}
 
 /**
  * @brief Allocate memory for a matrix
@@ -28,12 +33,19 @@ zmlMatrix zmlAllocMatrix(unsigned int rows, unsigned int cols) {
 	zmlMatrix r;
 	r.rows = rows;
 	r.cols = cols;
+	r.stride = cols;
+
+	// the elements and the array of row pointers are allocated as one block: the elements come first, so that they
+	// start on a ZML_ALIGNMENT boundary, and the row pointers follow them.
+	const size_t offset = _zml_rowPointerOffset((size_t) rows * cols);
+	unsigned char *block = (unsigned char *) _zml_alloc(offset + (size_t) rows * sizeof(__zml_floating *), ZML_ALIGNMENT);
 
-	// allocate array of rows
-	r.elements = (__zml_floating **) malloc(rows * sizeof(__zml_floating *));
-	// allocate each row's memory
+	r.data = (__zml_floating *) block;
+	r.elements = (__zml_floating **) (block + offset);
+
+	// point each row into the contiguous storage
 	for (unsigned int i = 0; i < rows; i++) {
-		r.elements[i] = (__zml_floating *) malloc(cols * sizeof(__zml_floating));
+		r.elements[i] = r.data + (size_t) i * r.stride;
 	}
 
 	return r;
@@ -44,16 +56,30 @@ zmlMatrix zmlAllocMatrix(unsigned int rows, unsigned int cols) {
  * @param mat the matrix to free.
  */
 void zmlFreeMatrix(zmlMatrix *mat) {
-	// free each row
-	for (unsigned int i = 0; i < mat->rows; i++) {
-		free(mat->elements[i]);
+	// row pointers are in the same block as the elements, unless zmlTranspose() had to give the matrix a bigger array of them
+	if (mat->data && mat->elements != (__zml_floating **) ((unsigned char *) mat->data + _zml_rowPointerOffset((size_t) mat->rows * mat->cols))) {
+		_zml_free(mat->elements);
 	}
-	// free array of rows
-	free(mat->elements);
+	_zml_free(mat->data);
 
 	mat->elements = NULL;
+	mat->data = NULL;
 	mat->rows = 0;
 	mat->cols = 0;
+	mat->stride = 0;
+}
+
+// copy the elements of src into dst; both matrices must be the same size.
+static void _zml_copyMatrixData(zmlMatrix *dst, zmlMatrix *src) {
+	if (dst->stride == src->stride && src->stride == src->cols) {
+		// both are fully contiguous so the whole thing can be copied at once
+		memcpy(dst->data, src->data, (size_t) src->rows * src->cols * sizeof(__zml_floating));
+		return;
+	}
+
+	for (unsigned int row = 0; row < src->rows; row++) {
+		memcpy(&_zml_at(*dst, row, 0), &_zml_at(*src, row, 0), src->cols * sizeof(__zml_floating));
+	}
 }
 
 /**
@@ -62,14 +88,11 @@ void zmlFreeMatrix(zmlMatrix *mat) {
  * @param size the size (rows and columns) of the matrix.
  */
 zmlMatrix zmlIdentityMatrix(unsigned int rows, unsigned int cols) {
-	zmlMatrix r = zmlAllocMatrix(rows, cols);
+	zmlMatrix r = zmlZeroMatrix(rows, cols);
 
-	for (unsigned int row = 0; row < rows; row++) {
-		for (unsigned int col = 0; col < cols; col++) {
-			// set to 1 if on the main diagonal
-			// initialise all other values to 0.
-			r.elements[row][col] = (row == col) ? (__zml_floating) 1.0 : (__zml_floating) 0.0;
-		}
+	// set the main diagonal to 1
+	for (unsigned int i = 0; i < rows && i < cols; i++) {
+		_zml_at(r, i, i) = (__zml_floating) 1.0;
 	}
 
 	return r;
@@ -83,11 +106,9 @@ zmlMatrix zmlIdentityMatrix(unsigned int rows, unsigned int cols) {
 zmlMatrix zmlZeroMatrix(unsigned int rows, unsigned int cols) {
 	zmlMatrix r = zmlAllocMatrix(rows, cols);
 
-	for (unsigned int row = 0; row < rows; row++) {
-		for (unsigned int col = 0; col < cols; col++) {
-			// init all values to 0.
-			r.elements[row][col] = (__zml_floating) 0.0;
-		}
+	// init all values to 0.
+	for (size_t i = 0; i < (size_t) rows * cols; i++) {
+		r.data[i] = (__zml_floating) 0.0;
 	}
 
 	return r;
@@ -100,12 +121,7 @@ zmlMatrix zmlZeroMatrix(unsigned int rows, unsigned int cols) {
  */
 zmlMatrix zmlCopyMatrix(zmlMatrix *val) {
 	zmlMatrix r = zmlAllocMatrix(val->rows, val->cols);
-
-	for (unsigned int row = 0; row < val->rows; row++) {
-		for (unsigned int col = 0; col < val->cols; col++) {
-			r.elements[row][col] = val->elements[row][col];
-		}
-	}
+	_zml_copyMatrixData(&r, val);
 
 	return r;
 }
@@ -118,9 +134,7 @@ zmlMatrix zmlCopyMatrix(zmlMatrix *val) {
  */
 zmlVector zmlGetMatrixRow(zmlMatrix val, unsigned int index) {
 	zmlVector r = zmlAllocVector(val.cols);
-	for (unsigned int i = 0; i < val.cols; i++) {
-		r.elements[i] = val.elements[index][i];
-	}
+	memcpy(r.elements, &_zml_at(val, index, 0), val.cols * sizeof(__zml_floating));
 	return r;
 }
 /**
@@ -136,9 +150,7 @@ void zmlSetMatrixRow(zmlMatrix *mat, unsigned int index, zmlVector vec) {
 		return;
 	}
 
-	for (unsigned int i = 0; i < vec.size; i++) {
-		mat->elements[index][i] = vec.elements[i];
-	}
+	memcpy(&_zml_at(*mat, index, 0), vec.elements, vec.size * sizeof(__zml_floating));
 }
 
 /**
@@ -150,7 +162,7 @@ void zmlSetMatrixRow(zmlMatrix *mat, unsigned int index, zmlVector vec) {
 zmlVector zmlGetMatrixCol(zmlMatrix val, unsigned int index) {
 	zmlVector r = zmlAllocVector(val.rows);
 	for (unsigned int i = 0; i < val.rows; i++) {
-		r.elements[i] = val.elements[i][index];
+		r.elements[i] = _zml_at(val, i, index);
 	}
 	return r;
 }
@@ -168,35 +180,226 @@ void zmlSetMatrixCol(zmlMatrix *mat, unsigned int index, zmlVector vec) {
 	}
 
 	for (unsigned int i = 0; i < vec.size; i++) {
-		mat->elements[i][index] = vec.elements[i];
+		_zml_at(*mat, i, index) = vec.elements[i];
+	}
+}
+
+// matrices are transposed in square tiles of this many rows and columns, so that the rows of the source and
+// destination tiles all stay in cache (and their pages in the TLB) while each tile is done.
+#define _ZML_TRANSPOSE_TILE 32
+
+// within a tile, elements are moved in blocks of this many rows and columns. Rows of power-of-2 sized matrices all map to the
+// same few cache sets, so only a handful of them can be worked on at once without evicting each other.
+#define _ZML_TRANSPOSE_BLOCK 8
+
+// dst[c * lddst + r] = src[r * ldsrc + c] for the rows x cols tile src.
+static void _zml_transposeTile(__zml_floating *dst, size_t lddst, const __zml_floating *src, size_t ldsrc, size_t rows, size_t cols) {
+	for (size_t r0 = 0; r0 < rows; r0 += _ZML_TRANSPOSE_BLOCK) {
+		const size_t r1 = (rows - r0 < _ZML_TRANSPOSE_BLOCK) ? rows : r0 + _ZML_TRANSPOSE_BLOCK;
+		for (size_t c0 = 0; c0 < cols; c0 += _ZML_TRANSPOSE_BLOCK) {
+			const size_t c1 = (cols - c0 < _ZML_TRANSPOSE_BLOCK) ? cols : c0 + _ZML_TRANSPOSE_BLOCK;
+			for (size_t r = r0; r < r1; r++) {
+				for (size_t c = c0; c < c1; c++) {
+					dst[c * lddst + r] = src[r * ldsrc + c];
+				}
+			}
+		}
+	}
+}
+
+// swap a[r * ld + c] with b[c * ld + r] for the rows x cols tile a (which must not overlap b).
+static void _zml_swapTransposedTiles(__zml_floating *a, __zml_floating *b, size_t ld, size_t rows, size_t cols) {
+	for (size_t r0 = 0; r0 < rows; r0 += _ZML_TRANSPOSE_BLOCK) {
+		const size_t r1 = (rows - r0 < _ZML_TRANSPOSE_BLOCK) ? rows : r0 + _ZML_TRANSPOSE_BLOCK;
+		for (size_t c0 = 0; c0 < cols; c0 += _ZML_TRANSPOSE_BLOCK) {
+			const size_t c1 = (cols - c0 < _ZML_TRANSPOSE_BLOCK) ? cols : c0 + _ZML_TRANSPOSE_BLOCK;
+			for (size_t r = r0; r < r1; r++) {
+				for (size_t c = c0; c < c1; c++) {
+					const __zml_floating tmp = a[r * ld + c];
+					a[r * ld + c] = b[c * ld + r];
+					b[c * ld + r] = tmp;
+				}
+			}
+		}
+	}
+}
+
+typedef struct {
+	zmlMatrix *dst;
+	const zmlMatrix *src;
+} _zml_transposeArgs;
+
+// transpose the tile rows [begin, end) of src (each _ZML_TRANSPOSE_TILE rows tall) into the corresponding tile columns of dst.
+static void _zml_transposeTileRows(void *ctx, size_t begin, size_t end) {
+	_zml_transposeArgs *args = (_zml_transposeArgs *) ctx;
+	const zmlMatrix *src = args->src;
+	zmlMatrix *dst = args->dst;
+
+	for (size_t tr = begin; tr < end; tr++) {
+		const size_t r0 = tr * _ZML_TRANSPOSE_TILE;
+		const size_t rows = (src->rows - r0 < _ZML_TRANSPOSE_TILE) ? src->rows - r0 : _ZML_TRANSPOSE_TILE;
+
+		for (size_t c0 = 0; c0 < src->cols; c0 += _ZML_TRANSPOSE_TILE) {
+			const size_t cols = (src->cols - c0 < _ZML_TRANSPOSE_TILE) ? src->cols - c0 : _ZML_TRANSPOSE_TILE;
+			_zml_transposeTile(&_zml_at(*dst, c0, r0), dst->stride, &_zml_at(*src, r0, c0), src->stride, rows, cols);
+		}
+	}
+}
+
+// transpose the tile rows [begin, end) of the square matrix ctx in place: each tile above the diagonal is swapped with its mirror
+// below it, and each tile on the diagonal is transposed within itself.
+static void _zml_transposeSquareTileRows(void *ctx, size_t begin, size_t end) {
+	zmlMatrix *mat = (zmlMatrix *) ctx;
+	const size_t n = mat->rows;
+
+	for (size_t tr = begin; tr < end; tr++) {
+		const size_t r0 = tr * _ZML_TRANSPOSE_TILE;
+		const size_t rows = (n - r0 < _ZML_TRANSPOSE_TILE) ? n - r0 : _ZML_TRANSPOSE_TILE;
+
+		for (size_t r = 0; r < rows; r++) {
+			for (size_t c = r + 1; c < rows; c++) {
+				const __zml_floating tmp = _zml_at(*mat, r0 + r, r0 + c);
+				_zml_at(*mat, r0 + r, r0 + c) = _zml_at(*mat, r0 + c, r0 + r);
+				_zml_at(*mat, r0 + c, r0 + r) = tmp;
+			}
+		}
+
+		for (size_t c0 = r0 + rows; c0 < n; c0 += _ZML_TRANSPOSE_TILE) {
+			const size_t cols = (n - c0 < _ZML_TRANSPOSE_TILE) ? n - c0 : _ZML_TRANSPOSE_TILE;
+			_zml_swapTransposedTiles(&_zml_at(*mat, r0, c0), &_zml_at(*mat, c0, r0), mat->stride, rows, cols);
+		}
+	}
+}
+
+// transpose the rows x cols elements of data in place. Element i belongs at (i * rows) mod (rows * cols - 1) (apart from the first
+// and last, which stay put), so each cycle of that permutation is followed, carrying one element along at a time.
+// done must have a bit for every element, all clear, to mark those that have already been moved.
+static void _zml_transposeCycles(__zml_floating *data, size_t rows, size_t cols, unsigned char *done) {
+	const size_t last = rows * cols - 1;
+
+	for (size_t start = 1; start < last; start++) {
+		if (done[start >> 3] & (1u << (start & 7))) {
+			continue;
+		}
+
+		__zml_floating carry = data[start];
+		size_t i = start;
+		do {
+			const size_t next = (size_t) (((unsigned long long) i * rows) % last);
+			const __zml_floating tmp = data[next];
+			data[next] = carry;
+			carry = tmp;
+			done[next >> 3] |= (unsigned char) (1u << (next & 7));
+			i = next;
+		} while (i != start);
 	}
 }
 
 /**
- * @brief allocate and return the given matrix in its transposed state - that is to say, the rows and columns of the matrix are swapped. 
+ * @brief allocate and return the given matrix in its transposed state - that is to say, the rows and columns of the matrix are swapped.
  * 
  * @param mat the matrix to transpose
  */
 zmlMatrix zmlTransposed(zmlMatrix mat) {
-	zmlMatrix r = zmlCopyMatrix(&mat);
-	zmlTranspose(&r);
+	zmlMatrix r = zmlAllocMatrix(mat.cols, mat.rows);
+	zmlTransposedInto(&r, mat);
 	return r;
 }
 /**
- * @brief transpose the given matrix by modifying it directly. 
+ * @brief write the given matrix in its transposed state into dst, which must already be allocated with mat's rows and columns swapped.
+ * dst may be mat.
+ * 
+ * @param dst the matrix to write the result into.
+ * @param mat the matrix to transpose
+ */
+void zmlTransposedInto(zmlMatrix *dst, zmlMatrix mat) {
+	if (dst->rows != mat.cols || dst->cols != mat.rows) {
+		printf("zetaml: zmlTransposedInto(): dst must have as many rows as mat has columns, and vice versa!\n");
+		return;
+	}
+
+	if (dst->data == mat.data) {
+		// (dst can only be mat if it's square, which can be done in place)
+		zmlTranspose(dst);
+		return;
+	}
+
+	_zml_transposeArgs args = { dst, &mat };
+	const size_t tilerows = (mat.rows + _ZML_TRANSPOSE_TILE - 1) / _ZML_TRANSPOSE_TILE;
+
+	// tile rows of the source are independent of each other, so big matrices are split across threads by tile row
+	if ((size_t) mat.rows * mat.cols < ZML_PARALLEL_THRESHOLD) {
+		_zml_transposeTileRows(&args, 0, tilerows);
+	} else {
+		_zml_parallelFor(tilerows, 1 + ZML_PARALLEL_THRESHOLD / ((size_t) _ZML_TRANSPOSE_TILE * mat.cols + 1), _zml_transposeTileRows, &args);
+	}
+}
+/**
+ * @brief transpose the given matrix by modifying it directly. This is done in place, without a copy of the matrix: square matrices
+ * swap tiles across the main diagonal, and other shapes move their elements along the cycles of the transposition (which is slower,
+ * but only needs one bit of extra memory per element).
  * 
  * @param mat the matrix to transpose
  */
 void zmlTranspose(zmlMatrix *mat) {
-	zmlMatrix buf = zmlCopyMatrix(mat);
+	if (mat->rows == mat->cols) {
+		const size_t tilerows = (mat->rows + _ZML_TRANSPOSE_TILE - 1) / _ZML_TRANSPOSE_TILE;
+
+		// (tile rows near the bottom have less to swap, so they're split up in small chunks to even out the work)
+		if ((size_t) mat->rows * mat->cols < ZML_PARALLEL_THRESHOLD) {
+			_zml_transposeSquareTileRows(mat, 0, tilerows);
+		} else {
+			_zml_parallelFor(tilerows, 1, _zml_transposeSquareTileRows, mat);
+		}
+		return;
+	}
 
-	for (unsigned int r = 0; r < mat->rows; r++) {
-		for (unsigned int c = 0; c < mat->cols; c++) {
-			mat->elements[r][c] = buf.elements[c][r];
+	const size_t count = (size_t) mat->rows * mat->cols;
+	if (mat->stride != mat->cols) {
+		// the elements aren't contiguous, so the result is built in new storage
+		zmlMatrix buf = zmlTransposed(*mat);
+		zmlFreeMatrix(mat);
+		*mat = buf;
+		return;
+	}
+
+	// (an empty matrix has no elements to move, only its shape and row pointers to change)
+	unsigned char *done = count ? (unsigned char *) _zml_alloc((count + 7) / 8, 1) : NULL;
+	__zml_floating **rowptrs = mat->elements;
+	if (mat->cols > mat->rows) {
+		// there'll be more rows than there are row pointers
+		rowptrs = (__zml_floating **) _zml_alloc((size_t) mat->cols * sizeof(__zml_floating *), sizeof(__zml_floating *));
+	}
+	if ((count && !done) || !rowptrs) {
+		printf("zetaml: zmlTranspose(): out of memory! matrix left untransposed!\n");
+		_zml_free(done);
+		if (rowptrs != mat->elements) {
+			_zml_free(rowptrs);
+		}
+		return;
+	}
+
+	if (count) {
+		memset(done, 0, (count + 7) / 8);
+		_zml_transposeCycles(mat->data, mat->rows, mat->cols, done);
+		_zml_free(done);
+	}
+
+	// replace the row pointers (freeing the old ones, unless they're in the same block as the elements)
+	if (rowptrs != mat->elements) {
+		if (mat->elements != (__zml_floating **) ((unsigned char *) mat->data + _zml_rowPointerOffset(count))) {
+			_zml_free(mat->elements);
 		}
+		mat->elements = rowptrs;
 	}
 
-	zmlFreeMatrix(&buf);
+	const unsigned int rows = mat->cols;
+	mat->cols = mat->rows;
+	mat->rows = rows;
+	mat->stride = mat->cols;
+	for (unsigned int i = 0; i < mat->rows; i++) {
+		mat->elements[i] = mat->data + (size_t) i * mat->stride;
+	}
 }
 
 /**
@@ -213,25 +416,18 @@ void zmlAugmentVec(zmlMatrix *mat, zmlVector vec) {
 
 	// increase height by 1
 	zmlMatrix buf = zmlAllocMatrix(mat->rows + 1, mat->cols);
-	
+
 	// copy mat's values into buf.
 	for (unsigned int r = 0; r < mat->rows; r++) {
-		for (unsigned int c = 0; c < mat->cols; c++) {
-			buf.elements[r][c] = mat->elements[r][c];
-		}
+		memcpy(&_zml_at(buf, r, 0), &_zml_at(*mat, r, 0), mat->cols * sizeof(__zml_floating));
 	}
 
 	// copy vec's values into the new row in buf.
-	for (unsigned int i = 0; i < buf.cols; i++) {
-		buf.elements[buf.rows - 1][i] = vec.elements[i];
-	}
+	memcpy(&_zml_at(buf, buf.rows - 1, 0), vec.elements, buf.cols * sizeof(__zml_floating));
 
-	// replace mat with allocated buffer
+	// replace mat with the augmented buffer
 	zmlFreeMatrix(mat);
-	*mat = zmlCopyMatrix(&buf);
-
-	// deallocate now-unnecessary buffer
-	zmlFreeMatrix(&buf);
+	*mat = buf;
 }
 
 /**
@@ -251,24 +447,17 @@ void zmlAugmentMat(zmlMatrix *mat, zmlMatrix val) {
 
 	// copy mat's values into buf.
 	for (unsigned int r = 0; r < mat->rows; r++) {
-		for (unsigned int c = 0; c < mat->cols; c++) {
-			buf.elements[r][c] = mat->elements[r][c];
-		}
+		memcpy(&_zml_at(buf, r, 0), &_zml_at(*mat, r, 0), mat->cols * sizeof(__zml_floating));
 	}
 
 	// copy val's values into buf, offset by the amount of rows in mat.
-	for (unsigned int r = mat->rows; r < buf.rows; r++) {
-		for (unsigned int c = 0; c < mat->cols; c++) {
-			buf.elements[r][c] = val.elements[r - mat->rows][c];
-		}
+	for (unsigned int r = 0; r < val.rows; r++) {
+		memcpy(&_zml_at(buf, mat->rows + r, 0), &_zml_at(val, r, 0), mat->cols * sizeof(__zml_floating));
 	}
 
-	// replace mat with allocated buffer
+	// replace mat with the augmented buffer
 	zmlFreeMatrix(mat);
-	*mat = zmlCopyMatrix(&buf);
-
-	// deallocate now-unnecessary buffer
-	zmlFreeMatrix(&buf);
+	*mat = buf;
 }
 
 /**
@@ -278,10 +467,13 @@ void zmlAugmentMat(zmlMatrix *mat, zmlMatrix val) {
  * @param arr the array buffer to copy into.
  */
 void zmlCopyMatrixElements(zmlMatrix mat, __zml_floating arr[mat.rows][mat.cols]) {
+	if (mat.stride == mat.cols) {
+		memcpy(arr, mat.data, (size_t) mat.rows * mat.cols * sizeof(__zml_floating));
+		return;
+	}
+
 	for (unsigned int r = 0; r < mat.rows; r++) {
-		for (unsigned int c = 0; c < mat.cols; c++) {
-			arr[r][c] = mat.elements[r][c];
-		}
+		memcpy(arr[r], &_zml_at(mat, r, 0), mat.cols * sizeof(__zml_floating));
 	}
 }
 
@@ -292,168 +484,137 @@ void zmlCopyMatrixElements(zmlMatrix mat, __zml_floating arr[mat.rows][mat.cols]
 	}\
 }
 
-zmlMatrix zmlAddMats_r(zmlMatrix v1, zmlMatrix v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_MATRIX);
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlAddMats(&r, v2);
-	return r;
-}
-void zmlAddMats(zmlMatrix *v1, zmlMatrix v2) {
-	_zml_assertSameSize((*v1), v2,);
-	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			v1->elements[row][col] += v2.elements[row][col];
-		}
+// dst = v1 (op) v2, or v1 (op) scalar if v2 is NULL. All matrices must be the same size; dst may be v1 or v2.
+static void _zml_matElementwise(_zml_elementwiseOp op, zmlMatrix *dst, const zmlMatrix *v1, const zmlMatrix *v2, __zml_floating scalar) {
+	if (dst->stride == dst->cols && v1->stride == v1->cols && (!v2 || v2->stride == v2->cols)) {
+		// contiguous, so the whole matrix can be treated as one array
+		_zml_applyElementwise(op, dst->data, v1->data, v2 ? v2->data : NULL, scalar, (size_t) dst->rows * dst->cols);
+		return;
 	}
-}
-zmlMatrix zmlSubtractMats_r(zmlMatrix v1, zmlMatrix v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_MATRIX);
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlSubtractMats(&r, v2);
-	return r;
-}
-void zmlSubtractMats(zmlMatrix *v1, zmlMatrix v2) {
-	_zml_assertSameSize((*v1), v2,);
-	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			v1->elements[row][col] -= v2.elements[row][col];
-		}
+
+	for (unsigned int row = 0; row < dst->rows; row++) {
+		_zml_applyElementwise(op, &_zml_at(*dst, row, 0), &_zml_at(*v1, row, 0), v2 ? &_zml_at(*v2, row, 0) : NULL, scalar, dst->cols);
 	}
 }
-zmlMatrix zmlMultiplyMats_r(zmlMatrix v1, zmlMatrix v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_MATRIX);
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlMultiplyMats(&r, v2);
-	return r;
-}
-void zmlMultiplyMats(zmlMatrix *v1, zmlMatrix v2) {
-	_zml_assertSameSize((*v1), v2,);
-
-	// copy v1 into buffer so it isn't changed in the middle of the calculation
-	zmlMatrix buf = zmlCopyMatrix(v1);
-
-	// convert rows of v1 to an array of vectors
-	zmlVector v1_rows[v1->rows];
-	for (unsigned int i = 0; i < v1->rows; i++)	v1_rows[i] = zmlGetMatrixRow(*v1, i);
 
-	// convert columns of v2 to array of vectors
-	zmlVector v2_cols[v2.cols];
-	for (unsigned int i = 0; i < v2.cols; i++) v2_cols[i] = zmlGetMatrixCol(v2, i);
+// define the Into, _r and in-place versions of an element-wise operator between two matrices.
+// the Into version does all of the work; dst may be the same matrix as either operand.
+#define _zml_defineMatOperators(name, op) \
+	void zml##name##MatsInto(zmlMatrix *dst, zmlMatrix v1, zmlMatrix v2) {\
+		_zml_assertSameSize(v1, v2,);\
+		_zml_assertSameSize((*dst), v1,);\
+		_zml_matElementwise(op, dst, &v1, &v2, 0);\
+	}\
+	zmlMatrix zml##name##Mats_r(zmlMatrix v1, zmlMatrix v2) {\
+		_zml_assertSameSize(v1, v2, ZML_NULL_MATRIX);\
+		zmlMatrix r = zmlAllocMatrix(v1.rows, v1.cols);\
+		zml##name##MatsInto(&r, v1, v2);\
+		return r;\
+	}\
+	void zml##name##Mats(zmlMatrix *v1, zmlMatrix v2) {\
+		zml##name##MatsInto(v1, *v1, v2);\
+	}
 
-	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			buf.elements[row][col] = zmlDot(v1_rows[row], v2_cols[col]);
-		}
+// the same, for an operator between a matrix and a scalar.
+#define _zml_defineMatScalarOperators(name, op) \
+	void zml##name##MatScalarInto(zmlMatrix *dst, zmlMatrix v1, __zml_floating v2) {\
+		_zml_assertSameSize((*dst), v1,);\
+		_zml_matElementwise(op, dst, &v1, NULL, v2);\
+	}\
+	zmlMatrix zml##name##MatScalar_r(zmlMatrix v1, __zml_floating v2) {\
+		zmlMatrix r = zmlAllocMatrix(v1.rows, v1.cols);\
+		zml##name##MatScalarInto(&r, v1, v2);\
+		return r;\
+	}\
+	void zml##name##MatScalar(zmlMatrix *v1, __zml_floating v2) {\
+		zml##name##MatScalarInto(v1, *v1, v2);\
 	}
 
-	// set v1 to buf
-	zmlFreeMatrix(v1);
-	*v1 = zmlCopyMatrix(&buf);
+_zml_defineMatOperators(Add, _ZML_OP_ADD)
+_zml_defineMatOperators(Subtract, _ZML_OP_SUBTRACT)
 
-	// free vectors
-	for (unsigned int i = 0; i < v1->rows; i++)	zmlFreeVector(&v1_rows[i]);
-	for (unsigned int i = 0; i < v2.cols; i++)	zmlFreeVector(&v2_cols[i]);
+void zmlMultiplyMatsInto(zmlMatrix *dst, zmlMatrix v1, zmlMatrix v2) {
+	if (v1.cols != v2.rows) {
+		printf("zetaml: zmlMultiplyMats(): the number of columns in v1 must match the number of rows in v2!\n");
+		return;
+	}
+	if (dst->rows != v1.rows || dst->cols != v2.cols) {
+		printf("zetaml: zmlMultiplyMatsInto(): dst must be allocated with as many rows as v1 and as many columns as v2!\n");
+		return;
+	}
 
-	// free matrix buffer
-	zmlFreeMatrix(&buf);
-}
+	// zmlGemm() can't write over its inputs as it reads them, so if dst is v1 or v2 the product is built separately first
+	if (dst->data == v1.data || dst->data == v2.data) {
+		zmlMatrix buf = zmlAllocMatrix(dst->rows, dst->cols);
+		zmlGemm(ZML_NO_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) 1.0, v1, v2, (__zml_floating) 0.0, &buf);
+		_zml_copyMatrixData(dst, &buf);
+		zmlFreeMatrix(&buf);
+		return;
+	}
 
-zmlMatrix zmlAddMatScalar_r(zmlMatrix v1, __zml_floating v2) {
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlAddMatScalar(&r, v2);
-	return r;
+	zmlGemm(ZML_NO_TRANSPOSE, ZML_NO_TRANSPOSE, (__zml_floating) 1.0, v1, v2, (__zml_floating) 0.0, dst);
 }
-void zmlAddMatScalar(zmlMatrix *v1, __zml_floating v2) {
-	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			v1->elements[row][col] += v2;
-		}
+zmlMatrix zmlMultiplyMats_r(zmlMatrix v1, zmlMatrix v2) {
+	if (v1.cols != v2.rows) {
+		printf("zetaml: zmlMultiplyMats(): the number of columns in v1 must match the number of rows in v2!\n");
+		return ZML_NULL_MATRIX;
 	}
-}
-zmlMatrix zmlSubtractMatScalar_r(zmlMatrix v1, __zml_floating v2) {
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlSubtractMatScalar(&r, v2);
+
+	zmlMatrix r = zmlAllocMatrix(v1.rows, v2.cols);
+	zmlMultiplyMatsInto(&r, v1, v2);
 	return r;
 }
-void zmlSubtractMatScalar(zmlMatrix *v1, __zml_floating v2) {
-	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			v1->elements[row][col] -= v2;
-		}
+void zmlMultiplyMats(zmlMatrix *v1, zmlMatrix v2) {
+	if (v1->cols != v2.rows) {
+		printf("zetaml: zmlMultiplyMats(): the number of columns in v1 must match the number of rows in v2!\n");
+		return;
 	}
+
+	// v1 can't be changed in the middle of the calculation (and may change shape), so the product is built in a new matrix
+	zmlMatrix buf = zmlMultiplyMats_r(*v1, v2);
+
+	// set v1 to buf
+	zmlFreeMatrix(v1);
+	*v1 = buf;
 }
-zmlMatrix zmlMultiplyMatScalar_r(zmlMatrix v1, __zml_floating v2) {
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlMultiplyMatScalar(&r, v2);
-	return r;
-}
-void zmlMultiplyMatScalar(zmlMatrix *v1, __zml_floating v2) {
-	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			v1->elements[row][col] *= v2;
-		}
+
+_zml_defineMatScalarOperators(Add, _ZML_OP_ADD_SCALAR)
+_zml_defineMatScalarOperators(Subtract, _ZML_OP_SUBTRACT_SCALAR)
+_zml_defineMatScalarOperators(Multiply, _ZML_OP_MULTIPLY_SCALAR)
+_zml_defineMatScalarOperators(Divide, _ZML_OP_DIVIDE_SCALAR)
+
+// 1 if every element of v1 (op) the matching element of v2; the matrices must be the same size.
+static unsigned char _zml_matCompare(_zml_compareOp op, const zmlMatrix *v1, const zmlMatrix *v2) {
+	const _zml_kernelTable *kernels = _zml_kernels();
+
+	if (v1->stride == v1->cols && v2->stride == v2->cols) {
+		return kernels->compare(op, v1->data, v2->data, 0, (size_t) v1->rows * v1->cols);
 	}
-}
-zmlMatrix zmlDivideMatScalar_r(zmlMatrix v1, __zml_floating v2) {
-	zmlMatrix r = zmlCopyMatrix(&v1);
-	zmlDivideMatScalar(&r, v2);
-	return r;
-}
-void zmlDivideMatScalar(zmlMatrix *v1, __zml_floating v2) {
+
 	for (unsigned int row = 0; row < v1->rows; row++) {
-		for (unsigned int col = 0; col < v1->cols; col++) {
-			v1->elements[row][col] /= v2;
-		}
+		if (!kernels->compare(op, &_zml_at(*v1, row, 0), &_zml_at(*v2, row, 0), 0, v1->cols))
+			return 0;
 	}
+	return 1;
 }
 
 unsigned char zmlMatEquals(zmlMatrix v1, zmlMatrix v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int row = 0; row < v1.rows; row++) {
-		for (unsigned int col = 0; col < v1.cols; col++) {
-			if (v1.elements[row][col] != v2.elements[row][col])
-				return 0;
-		}
-	}
-	return 1;
+	return _zml_matCompare(_ZML_CMP_EQ, &v1, &v2);
 }
 unsigned char zmlMatGT(zmlMatrix v1, zmlMatrix v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int row = 0; row < v1.rows; row++) {
-		for (unsigned int col = 0; col < v1.cols; col++) {
-			if (v1.elements[row][col] <= v2.elements[row][col])
-				return 0;
-		}
-	}
-	return 1;
+	return _zml_matCompare(_ZML_CMP_GT, &v1, &v2);
 }
 unsigned char zmlMatGTE(zmlMatrix v1, zmlMatrix v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int row = 0; row < v1.rows; row++) {
-		for (unsigned int col = 0; col < v1.cols; col++) {
-			if (v1.elements[row][col] < v2.elements[row][col])
-				return 0;
-		}
-	}
-	return 1;
+	return _zml_matCompare(_ZML_CMP_GTE, &v1, &v2);
 }
 unsigned char zmlMatLT(zmlMatrix v1, zmlMatrix v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int row = 0; row < v1.rows; row++) {
-		for (unsigned int col = 0; col < v1.cols; col++) {
-			if (v1.elements[row][col] >= v2.elements[row][col])
-				return 0;
-		}
-	}
-	return 1;
+	return _zml_matCompare(_ZML_CMP_LT, &v1, &v2);
 }
 unsigned char zmlMatLTE(zmlMatrix v1, zmlMatrix v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int row = 0; row < v1.rows; row++) {
-		for (unsigned int col = 0; col < v1.cols; col++) {
-			if (v1.elements[row][col] > v2.elements[row][col])
-				return 0;
-		}
-	}
-	return 1;
+	return _zml_matCompare(_ZML_CMP_LTE, &v1, &v2);
 }
\ No newline at end of file
@@ -0,0 +1,275 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+// ==============================================================================
+// Every allocation zetaml makes goes through _zml_alloc(), which uses the allocator for the calling thread.
+// The allocator's free function is stored in a small header just before each allocation, so memory is always
+// released by the allocator that provided it, even if a different allocator has been set since.
+// ==============================================================================
+
+// stored immediately before every pointer returned by _zml_alloc(). For allocators other than the default one, the
+// pointer returned by the allocator is stored just before the header.
+typedef struct {
+	void (*free)(void *context, void *ptr);
+	void *context;
+} _zml_allocHeader;
+
+// the default allocator uses malloc(); the pointer it returned is stored just before the aligned block.
+static void *_zml_defaultAlloc(void *context, size_t size, size_t alignment) {
+	(void) context;
+
+	unsigned char *block = (unsigned char *) malloc(size + alignment - 1 + sizeof(void *));
+	if (!block) {
+		return NULL;
+	}
+
+	unsigned char *aligned = (unsigned char *) (((uintptr_t) (block + sizeof(void *)) + alignment - 1) & ~((uintptr_t) alignment - 1));
+	((void **) aligned)[-1] = block;
+
+	return aligned;
+}
+static void _zml_defaultFree(void *context, void *ptr) {
+	(void) context;
+	free(((void **) ptr)[-1]);
+}
+
+/**
+ * @brief The default allocator, which uses malloc() and free().
+ * 
+ */
+const zmlAllocator ZML_DEFAULT_ALLOCATOR = { _zml_defaultAlloc, _zml_defaultFree, NULL };
+
+static zmlAllocator _zml_globalAllocator = { _zml_defaultAlloc, _zml_defaultFree, NULL };
+
+// the calling thread's allocator, if one has been set with zmlSetThreadAllocator().
+static _zml_threadLocal zmlAllocator _zml_threadAllocator;
+static _zml_threadLocal unsigned char _zml_hasThreadAllocator = 0;
+
+/**
+ * @brief set the allocator used by every thread that hasn't set its own with zmlSetThreadAllocator().
+ * Must not be called while other zetaml functions are running.
+ * 
+ * @param allocator the allocator to use (it is copied), or NULL to go back to ZML_DEFAULT_ALLOCATOR.
+ */
+void zmlSetAllocator(const zmlAllocator *allocator) {
+	_zml_globalAllocator = allocator ? *allocator : ZML_DEFAULT_ALLOCATOR;
+}
+
+/**
+ * @brief set the allocator used by the calling thread only, overriding the one set with zmlSetAllocator().
+ * 
+ * @param allocator the allocator to use (it is copied), or NULL to go back to the global allocator.
+ */
+void zmlSetThreadAllocator(const zmlAllocator *allocator) {
+	if (allocator) {
+		_zml_threadAllocator = *allocator;
+	}
+	_zml_hasThreadAllocator = (allocator != NULL);
+}
+
+/**
+ * @brief get the allocator that zetaml uses on the calling thread.
+ * 
+ */
+zmlAllocator zmlGetAllocator(void) {
+	return _zml_hasThreadAllocator ? _zml_threadAllocator : _zml_globalAllocator;
+}
+
+// allocate size bytes aligned to alignment (a power of 2) through the calling thread's allocator.
+void *_zml_alloc(size_t size, size_t alignment) {
+	const zmlAllocator allocator = zmlGetAllocator();
+
+	if (alignment < sizeof(void *)) {
+		alignment = sizeof(void *);
+	}
+
+	unsigned char *ptr;
+	_zml_allocHeader *header;
+
+	if (allocator.alloc == _zml_defaultAlloc) {
+		// with the default allocator, malloc() is called directly so that the header is all the overhead there is
+		// (malloc() already aligns to at least two pointers, so smaller alignments need no extra space)
+		const size_t extra = (alignment > 2 * sizeof(void *)) ? alignment - 1 : 0;
+		unsigned char *base = (unsigned char *) malloc(sizeof(_zml_allocHeader) + extra + size);
+		if (!base) {
+			printf("zetaml: _zml_alloc(): allocation of %lu bytes failed!\n", (unsigned long) size);
+			return NULL;
+		}
+
+		ptr = (unsigned char *) (((uintptr_t) (base + sizeof(_zml_allocHeader)) + alignment - 1) & ~((uintptr_t) alignment - 1));
+		header = (_zml_allocHeader *) ptr - 1;
+		header->free = _zml_defaultFree;
+		header->context = base;
+
+		return ptr;
+	}
+
+	// the header (and the base pointer before it) go in front of the returned pointer, padded so that it stays aligned
+	const size_t pad = (sizeof(_zml_allocHeader) + sizeof(void *) + alignment - 1) & ~(alignment - 1);
+
+	unsigned char *base = (unsigned char *) allocator.alloc(allocator.context, pad + size, alignment);
+	if (!base) {
+		printf("zetaml: _zml_alloc(): allocation of %lu bytes failed!\n", (unsigned long) size);
+		return NULL;
+	}
+
+	ptr = base + pad;
+	header = (_zml_allocHeader *) ptr - 1;
+	header->free = allocator.free;
+	header->context = allocator.context;
+	((void **) header)[-1] = base;
+
+	return ptr;
+}
+
+// free memory allocated by _zml_alloc(), using the allocator it came from.
+void _zml_free(void *ptr) {
+	if (!ptr) {
+		return;
+	}
+
+	_zml_allocHeader *header = (_zml_allocHeader *) ptr - 1;
+	if (header->free == _zml_defaultFree) {
+		// (allocated straight from malloc(), which returned the pointer stored as the context)
+		free(header->context);
+	} else if (header->free) {
+		header->free(header->context, ((void **) header)[-1]);
+	}
+}
+
+// ==============================================================================
+// Arenas hand out memory by bumping an offset through a list of large blocks, and free everything at once when they are
+// reset. Blocks are kept when an arena is reset, so an arena that is reset every frame stops calling malloc() once it
+// has grown to fit a frame's worth of allocations.
+// ==============================================================================
+
+typedef struct _zml_arenaBlock {
+	struct _zml_arenaBlock *next;
+	size_t size;
+	size_t used;
+	unsigned char data[];
+} _zml_arenaBlock;
+
+struct zmlArena {
+	_zml_arenaBlock *first;
+	_zml_arenaBlock *current;
+	size_t blocksize;
+};
+
+#define _ZML_DEFAULT_ARENA_BLOCK_SIZE (64 * 1024)
+
+static _zml_arenaBlock *_zml_allocArenaBlock(size_t size) {
+	_zml_arenaBlock *block = (_zml_arenaBlock *) malloc(sizeof(_zml_arenaBlock) + size);
+	if (block) {
+		block->next = NULL;
+		block->size = size;
+		block->used = 0;
+	}
+	return block;
+}
+
+static void *_zml_arenaAlloc(void *context, size_t size, size_t alignment) {
+	zmlArena *arena = (zmlArena *) context;
+	_zml_arenaBlock *block = arena->current;
+
+	for (;;) {
+		uintptr_t start = (uintptr_t) (block->data + block->used);
+		size_t offset = block->used + ((((start + alignment - 1) & ~((uintptr_t) alignment - 1))) - start);
+
+		if (offset + size <= block->size) {
+			block->used = offset + size;
+			arena->current = block;
+			return block->data + offset;
+		}
+
+		// move on to the next block, adding one if this is the last (blocks after the current one are always empty)
+		if (!block->next || block->next->size < size + alignment) {
+			size_t blocksize = (size + alignment > arena->blocksize) ? size + alignment : arena->blocksize;
+			_zml_arenaBlock *next = _zml_allocArenaBlock(blocksize);
+			if (!next) {
+				return NULL;
+			}
+			next->next = block->next;
+			block->next = next;
+		}
+		block = block->next;
+	}
+}
+
+/**
+ * @brief create an arena: a bump-pointer allocator whose memory is all released at once by zmlResetArena().
+ * Arenas are not thread-safe, so use a separate one on each thread (see zmlSetThreadAllocator()).
+ * 
+ * @param blocksize the size, in bytes, of the blocks the arena takes from malloc(). 0 uses a default of 64 KiB.
+ */
+zmlArena *zmlCreateArena(size_t blocksize) {
+	zmlArena *arena = (zmlArena *) malloc(sizeof(zmlArena));
+	if (!arena) {
+		return NULL;
+	}
+
+	arena->blocksize = blocksize ? blocksize : _ZML_DEFAULT_ARENA_BLOCK_SIZE;
+	arena->first = _zml_allocArenaBlock(arena->blocksize);
+	arena->current = arena->first;
+	if (!arena->first) {
+		free(arena);
+		return NULL;
+	}
+
+	return arena;
+}
+
+/**
+ * @brief get an allocator that allocates from the given arena. Freeing memory from it does nothing.
+ * 
+ * @param arena the arena to allocate from.
+ */
+zmlAllocator zmlArenaAllocator(zmlArena *arena) {
+	zmlAllocator r = { _zml_arenaAlloc, NULL, arena };
+	return r;
+}
+
+/**
+ * @brief release everything allocated from an arena, so that its memory can be used again.
+ * Any vectors or matrices allocated from it must no longer be used.
+ * 
+ * @param arena the arena to reset.
+ */
+void zmlResetArena(zmlArena *arena) {
+	for (_zml_arenaBlock *block = arena->first; block; block = block->next) {
+		block->used = 0;
+	}
+	arena->current = arena->first;
+}
+
+/**
+ * @brief free an arena and all of the memory it holds.
+ * 
+ * @param arena the arena to destroy.
+ */
+void zmlDestroyArena(zmlArena *arena) {
+	if (!arena) {
+		return;
+	}
+
+	_zml_arenaBlock *block = arena->first;
+	while (block) {
+		_zml_arenaBlock *next = block->next;
+		free(block);
+		block = next;
+	}
+
+	free(arena);
+}
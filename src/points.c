@@ -0,0 +1,285 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+#ifdef ZML_X86_SIMD
+#	include <immintrin.h>
+#endif
+
+// ==============================================================================
+// Point arrays are transformed by kernels that work on Structure-of-Arrays data, so that every SIMD lane holds a
+// different point. Interleaved (xyz or xyzw) arrays are split into small SoA blocks on the stack, transformed,
+// and interleaved again, so every layout runs through the same kernels.
+// ==============================================================================
+
+// points per SoA block when transforming interleaved arrays.
+#define _ZML_POINT_BLOCK 256
+
+// transform count points: out[r][i] = m[r][0] * x[i] + m[r][1] * y[i] + m[r][2] * z[i] + m[r][3] * w[i] for r < nout.
+// w may be NULL, in which case it is taken to be 1. out[r] may be the same array as any input.
+typedef void (*_zml_pointKernel)(const zmlMat4 *m, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	const __zml_floating *w, __zml_floating *const *out, unsigned int nout, size_t count);
+
+static void _zml_transformPointsScalar(const zmlMat4 *m, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	const __zml_floating *w, __zml_floating *const *out, unsigned int nout, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const __zml_floating px = x[i], py = y[i], pz = z[i], pw = w ? w[i] : (__zml_floating) 1.0;
+		for (unsigned int r = 0; r < nout; r++) {
+			out[r][i] = m->elements[r][0] * px + m->elements[r][1] * py + m->elements[r][2] * pz + m->elements[r][3] * pw;
+		}
+	}
+}
+
+#ifdef ZML_X86_SIMD
+
+// the kernel is written once in terms of the _ZML_V* macros, which are redefined for each instruction set.
+#define _ZML_DEFINE_POINT_KERNEL(name, isa) \
+	__attribute__((target(isa)))\
+	static void name(const zmlMat4 *m, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,\
+		const __zml_floating *w, __zml_floating *const *out, unsigned int nout, size_t count) {\
+		_ZML_VT mv[4][4];\
+		for (unsigned int r = 0; r < 4; r++) {\
+			for (unsigned int c = 0; c < 4; c++) {\
+				mv[r][c] = _ZML_VSET1(m->elements[r][c]);\
+			}\
+		}\
+		const _ZML_VT one = _ZML_VSET1((__zml_floating) 1.0);\
+		size_t i = 0;\
+		for (; i + _ZML_VLANES <= count; i += _ZML_VLANES) {\
+			const _ZML_VT vx = _ZML_VLOADU(x + i);\
+			const _ZML_VT vy = _ZML_VLOADU(y + i);\
+			const _ZML_VT vz = _ZML_VLOADU(z + i);\
+			const _ZML_VT vw = w ? _ZML_VLOADU(w + i) : one;\
+			_ZML_VT res[4];\
+			for (unsigned int r = 0; r < nout; r++) {\
+				res[r] = _ZML_VFMA(mv[r][0], vx, _ZML_VFMA(mv[r][1], vy, _ZML_VFMA(mv[r][2], vz, _ZML_VMUL(mv[r][3], vw))));\
+			}\
+			/* (stored after every row is computed, in case the output overwrites the input) */\
+			for (unsigned int r = 0; r < nout; r++) {\
+				_ZML_VSTOREU(out[r] + i, res[r]);\
+			}\
+		}\
+		if (i < count) {\
+			__zml_floating *const tail[4] = { out[0] + i, out[1] + i, out[2] + i, (nout > 3) ? out[3] + i : NULL };\
+			_zml_transformPointsScalar(m, x + i, y + i, z + i, w ? w + i : NULL, tail, nout, count - i);\
+		}\
+	}
+
+// SSE2
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m128
+#	define _ZML_VOP(op) _mm_##op##_ps
+#else
+#	define _ZML_VT __m128d
+#	define _ZML_VOP(op) _mm_##op##_pd
+#endif
+#define _ZML_VLANES (16 / sizeof(__zml_floating))
+#define _ZML_VSET1 _ZML_VOP(set1)
+#define _ZML_VLOADU _ZML_VOP(loadu)
+#define _ZML_VSTOREU _ZML_VOP(storeu)
+#define _ZML_VMUL _ZML_VOP(mul)
+#define _ZML_VFMA(x, y, z) _ZML_VOP(add)(_ZML_VOP(mul)(x, y), z)
+
+_ZML_DEFINE_POINT_KERNEL(_zml_transformPointsSSE2, "sse2")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+
+// AVX2 + FMA
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m256
+#	define _ZML_VOP(op) _mm256_##op##_ps
+#else
+#	define _ZML_VT __m256d
+#	define _ZML_VOP(op) _mm256_##op##_pd
+#endif
+#define _ZML_VLANES (32 / sizeof(__zml_floating))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+
+_ZML_DEFINE_POINT_KERNEL(_zml_transformPointsAVX2, "avx2,fma")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+
+// AVX-512
+#ifdef ZML_USING_FLOATS
+#	define _ZML_VT __m512
+#	define _ZML_VOP(op) _mm512_##op##_ps
+#else
+#	define _ZML_VT __m512d
+#	define _ZML_VOP(op) _mm512_##op##_pd
+#endif
+#define _ZML_VLANES (64 / sizeof(__zml_floating))
+#define _ZML_VFMA _ZML_VOP(fmadd)
+
+_ZML_DEFINE_POINT_KERNEL(_zml_transformPointsAVX512, "avx512f")
+
+#undef _ZML_VT
+#undef _ZML_VOP
+#undef _ZML_VLANES
+#undef _ZML_VFMA
+#undef _ZML_VSET1
+#undef _ZML_VLOADU
+#undef _ZML_VSTOREU
+#undef _ZML_VMUL
+
+#endif
+
+// select the best kernel for the CPU.
+static _zml_pointKernel _zml_selectPointKernel(void) {
+#ifdef ZML_X86_SIMD
+	const unsigned int features = _zml_cpuFeatures();
+	if (features & ZML_CPU_AVX512) return _zml_transformPointsAVX512;
+	if (features & ZML_CPU_AVX2) return _zml_transformPointsAVX2;
+	if (features & ZML_CPU_SSE2) return _zml_transformPointsSSE2;
+#endif
+	return _zml_transformPointsScalar;
+}
+
+// -------------------------------------------
+// splitting the work across threads
+// -------------------------------------------
+
+// which layout a call is transforming.
+typedef enum {
+	_ZML_POINTS_XYZ,
+	_ZML_POINTS_XYZW,
+	_ZML_POINTS_SOA
+} _zml_pointLayout;
+
+typedef struct {
+	_zml_pointKernel kernel;
+	_zml_pointLayout layout;
+	const zmlMat4 *mat;
+
+	// interleaved layouts
+	const __zml_floating *in;
+	__zml_floating *out;
+
+	// SoA layout
+	const __zml_floating *x, *y, *z;
+	__zml_floating *outx, *outy, *outz;
+} _zml_pointArgs;
+
+// transform points [begin, end).
+static void _zml_transformPointRange(void *ctx, size_t begin, size_t end) {
+	_zml_pointArgs *args = (_zml_pointArgs *) ctx;
+
+	if (args->layout == _ZML_POINTS_SOA) {
+		__zml_floating *const out[3] = { args->outx + begin, args->outy + begin, args->outz + begin };
+		args->kernel(args->mat, args->x + begin, args->y + begin, args->z + begin, NULL, out, 3, end - begin);
+		return;
+	}
+
+	// interleaved: split each block into SoA, transform it, then interleave the result back into out
+	const unsigned int n = (args->layout == _ZML_POINTS_XYZW) ? 4 : 3;
+	__zml_floating soa[4][_ZML_POINT_BLOCK];
+	__zml_floating *const rows[4] = { soa[0], soa[1], soa[2], soa[3] };
+
+	for (size_t b = begin; b < end; b += _ZML_POINT_BLOCK) {
+		const size_t count = (end - b < _ZML_POINT_BLOCK) ? end - b : _ZML_POINT_BLOCK;
+		const __zml_floating *in = args->in + b * n;
+		__zml_floating *out = args->out + b * n;
+
+		for (size_t i = 0; i < count; i++) {
+			for (unsigned int c = 0; c < n; c++) {
+				soa[c][i] = in[i * n + c];
+			}
+		}
+
+		args->kernel(args->mat, soa[0], soa[1], soa[2], (n == 4) ? soa[3] : NULL, rows, n, count);
+
+		for (size_t i = 0; i < count; i++) {
+			for (unsigned int c = 0; c < n; c++) {
+				out[i * n + c] = soa[c][i];
+			}
+		}
+	}
+}
+
+static void _zml_transformPoints(_zml_pointArgs *args, size_t count) {
+	args->kernel = _zml_selectPointKernel();
+
+	if (count < ZML_PARALLEL_THRESHOLD) {
+		_zml_transformPointRange(args, 0, count);
+		return;
+	}
+
+	_zml_parallelFor(count, ZML_PARALLEL_THRESHOLD / 4, _zml_transformPointRange, args);
+}
+
+/**
+ * @brief transform an array of points, stored as interleaved x, y, z triples, by a matrix (as with zmlMultiplyVec4Mat4_r()).
+ * Every point's w is taken to be 1, and the w of the result is discarded (no perspective divide is done).
+ * 
+ * @param mat the transformation matrix.
+ * @param in the points to transform (3 * count values).
+ * @param out the array to write the transformed points into (3 * count values). May be the same array as in.
+ * @param count the number of points.
+ */
+void zmlTransformPoints(const zmlMat4 *mat, const __zml_floating *in, __zml_floating *out, size_t count) {
+	_zml_pointArgs args = { 0 };
+	args.layout = _ZML_POINTS_XYZ;
+	args.mat = mat;
+	args.in = in;
+	args.out = out;
+
+	_zml_transformPoints(&args, count);
+}
+
+/**
+ * @brief transform an array of points, stored as interleaved x, y, z, w quadruples, by a matrix (as with zmlMultiplyVec4Mat4_r()).
+ * 
+ * @param mat the transformation matrix.
+ * @param in the points to transform (4 * count values).
+ * @param out the array to write the transformed points into (4 * count values). May be the same array as in.
+ * @param count the number of points.
+ */
+void zmlTransformPoints4(const zmlMat4 *mat, const __zml_floating *in, __zml_floating *out, size_t count) {
+	_zml_pointArgs args = { 0 };
+	args.layout = _ZML_POINTS_XYZW;
+	args.mat = mat;
+	args.in = in;
+	args.out = out;
+
+	_zml_transformPoints(&args, count);
+}
+
+/**
+ * @brief transform an array of points stored as separate arrays of x, y and z coordinates (Structure-of-Arrays) by a matrix.
+ * Every point's w is taken to be 1, and the w of the result is discarded (no perspective divide is done).
+ * 
+ * @param mat the transformation matrix.
+ * @param x, y, z the coordinates of the points to transform (count values each).
+ * @param outx, outy, outz the arrays to write the coordinates of the transformed points into. Each may be the same array as any input.
+ * @param count the number of points.
+ */
+void zmlTransformPointsSoA(const zmlMat4 *mat, const __zml_floating *x, const __zml_floating *y, const __zml_floating *z,
+	__zml_floating *outx, __zml_floating *outy, __zml_floating *outz, size_t count) {
+	_zml_pointArgs args = { 0 };
+	args.layout = _ZML_POINTS_SOA;
+	args.mat = mat;
+	args.x = x;
+	args.y = y;
+	args.z = z;
+	args.outx = outx;
+	args.outy = outy;
+	args.outz = outz;
+
+	_zml_transformPoints(&args, count);
+}
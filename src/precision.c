@@ -0,0 +1,801 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+#ifdef ZML_X86_SIMD
+#	include <immintrin.h>
+#endif
+
+// ==============================================================================
+// The f- and d-suffixed array functions work on plain arrays of floats and doubles, and are built into the library
+// whichever type __zml_floating is, so one build can keep big arrays in floats (for half the memory traffic) and
+// accumulate in doubles. Like the kernels in kernels.c, they're compiled for more than one instruction set and the
+// best one for the CPU is chosen the first time they're needed, and like the operations on zmlMatrix, big arrays are
+// split across the thread pool. The vectors and matrices of floats and doubles at the end are built on them.
+// ==============================================================================
+
+// -------------------------------------------
+// kernels
+// -------------------------------------------
+
+// the element-wise loops and conversions are simple enough for the compiler to vectorise by itself, so they're written
+// once and compiled again for each instruction set.
+#define _ZML_DEFINE_ARRAY_LOOPS(type, suffix, isa, attr) \
+	attr\
+	static void _zml_arrayElementwise##suffix##isa(_zml_elementwiseOp op, type *dst, const type *a, const type *b, type s, size_t n) {\
+		switch (op) {\
+			case _ZML_OP_ADD:				for (size_t i = 0; i < n; i++) dst[i] = a[i] + b[i]; break;\
+			case _ZML_OP_SUBTRACT:			for (size_t i = 0; i < n; i++) dst[i] = a[i] - b[i]; break;\
+			case _ZML_OP_MULTIPLY:			for (size_t i = 0; i < n; i++) dst[i] = a[i] * b[i]; break;\
+			case _ZML_OP_DIVIDE:			for (size_t i = 0; i < n; i++) dst[i] = a[i] / b[i]; break;\
+			case _ZML_OP_ADD_SCALAR:		for (size_t i = 0; i < n; i++) dst[i] = a[i] + s; break;\
+			case _ZML_OP_SUBTRACT_SCALAR:	for (size_t i = 0; i < n; i++) dst[i] = a[i] - s; break;\
+			case _ZML_OP_MULTIPLY_SCALAR:	for (size_t i = 0; i < n; i++) dst[i] = a[i] * s; break;\
+			case _ZML_OP_DIVIDE_SCALAR:		for (size_t i = 0; i < n; i++) dst[i] = a[i] / s; break;\
+		}\
+	}\
+	attr\
+	static void _zml_arrayAxpy##suffix##isa(type *y, type alpha, const type *x, size_t n) {\
+		for (size_t i = 0; i < n; i++) y[i] += alpha * x[i];\
+	}
+
+#define _ZML_DEFINE_CONVERSION_LOOPS(isa, attr) \
+	attr\
+	static void _zml_floatsToDoubles##isa(double *dst, const float *src, size_t n) {\
+		for (size_t i = 0; i < n; i++) dst[i] = (double) src[i];\
+	}\
+	attr\
+	static void _zml_doublesToFloats##isa(float *dst, const double *src, size_t n) {\
+		for (size_t i = 0; i < n; i++) dst[i] = (float) src[i];\
+	}
+
+_ZML_DEFINE_ARRAY_LOOPS(float, f, Scalar, )
+_ZML_DEFINE_ARRAY_LOOPS(double, d, Scalar, )
+_ZML_DEFINE_CONVERSION_LOOPS(Scalar, )
+
+// sums are accumulated in double (in four separate sums, so that the additions don't all wait on each other).
+#define _ZML_DEFINE_SCALAR_REDUCTIONS(type, suffix) \
+	static double _zml_arrayDot##suffix##Scalar(const type *a, const type *b, size_t n) {\
+		double r[4] = { 0.0, 0.0, 0.0, 0.0 };\
+		size_t i = 0;\
+		for (; i + 4 <= n; i += 4) {\
+			for (unsigned int j = 0; j < 4; j++) r[j] += (double) a[i + j] * (double) b[i + j];\
+		}\
+		for (; i < n; i++) r[0] += (double) a[i] * (double) b[i];\
+		return (r[0] + r[1]) + (r[2] + r[3]);\
+	}\
+	static double _zml_arraySum##suffix##Scalar(const type *a, size_t n) {\
+		double r[4] = { 0.0, 0.0, 0.0, 0.0 };\
+		size_t i = 0;\
+		for (; i + 4 <= n; i += 4) {\
+			for (unsigned int j = 0; j < 4; j++) r[j] += (double) a[i + j];\
+		}\
+		for (; i < n; i++) r[0] += (double) a[i];\
+		return (r[0] + r[1]) + (r[2] + r[3]);\
+	}
+
+_ZML_DEFINE_SCALAR_REDUCTIONS(float, f)
+_ZML_DEFINE_SCALAR_REDUCTIONS(double, d)
+
+#ifdef ZML_X86_SIMD
+
+_ZML_DEFINE_ARRAY_LOOPS(float, f, AVX2, __attribute__((target("avx2,fma"))))
+_ZML_DEFINE_ARRAY_LOOPS(double, d, AVX2, __attribute__((target("avx2,fma"))))
+_ZML_DEFINE_CONVERSION_LOOPS(AVX2, __attribute__((target("avx2,fma"))))
+
+// sum of the four lanes of v.
+__attribute__((target("avx2,fma")))
+static double _zml_hsum256(__m256d v) {
+	const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+// the reductions are written out by hand, since compilers won't reorder floating-point sums by themselves.
+// Floats are widened to doubles four at a time, so the sums are as accurate as they are for doubles.
+__attribute__((target("avx2,fma")))
+static double _zml_arrayDotfAVX2(const float *a, const float *b, size_t n) {
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m256 va = _mm256_loadu_ps(a + i), vb = _mm256_loadu_ps(b + i);
+		acc0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(va)), _mm256_cvtps_pd(_mm256_castps256_ps128(vb)), acc0);
+		acc1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(va, 1)), _mm256_cvtps_pd(_mm256_extractf128_ps(vb, 1)), acc1);
+	}
+	return _zml_hsum256(_mm256_add_pd(acc0, acc1)) + _zml_arrayDotfScalar(a + i, b + i, n - i);
+}
+__attribute__((target("avx2,fma")))
+static double _zml_arrayDotdAVX2(const double *a, const double *b, size_t n) {
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+		acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+	}
+	return _zml_hsum256(_mm256_add_pd(acc0, acc1)) + _zml_arrayDotdScalar(a + i, b + i, n - i);
+}
+__attribute__((target("avx2,fma")))
+static double _zml_arraySumfAVX2(const float *a, size_t n) {
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		const __m256 va = _mm256_loadu_ps(a + i);
+		acc0 = _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(va)), acc0);
+		acc1 = _mm256_add_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(va, 1)), acc1);
+	}
+	return _zml_hsum256(_mm256_add_pd(acc0, acc1)) + _zml_arraySumfScalar(a + i, n - i);
+}
+__attribute__((target("avx2,fma")))
+static double _zml_arraySumdAVX2(const double *a, size_t n) {
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm256_add_pd(_mm256_loadu_pd(a + i), acc0);
+		acc1 = _mm256_add_pd(_mm256_loadu_pd(a + i + 4), acc1);
+	}
+	return _zml_hsum256(_mm256_add_pd(acc0, acc1)) + _zml_arraySumdScalar(a + i, n - i);
+}
+
+#endif
+
+// kernels for one instruction set.
+typedef struct {
+	void (*elementwisef)(_zml_elementwiseOp op, float *dst, const float *a, const float *b, float s, size_t n);
+	void (*elementwised)(_zml_elementwiseOp op, double *dst, const double *a, const double *b, double s, size_t n);
+	void (*axpyf)(float *y, float alpha, const float *x, size_t n);
+	void (*axpyd)(double *y, double alpha, const double *x, size_t n);
+	double (*dotf)(const float *a, const float *b, size_t n);
+	double (*dotd)(const double *a, const double *b, size_t n);
+	double (*sumf)(const float *a, size_t n);
+	double (*sumd)(const double *a, size_t n);
+	void (*floatsToDoubles)(double *dst, const float *src, size_t n);
+	void (*doublesToFloats)(float *dst, const double *src, size_t n);
+} _zml_arrayKernelTable;
+
+static const _zml_arrayKernelTable _zml_scalarArrayKernels = {
+	_zml_arrayElementwisefScalar, _zml_arrayElementwisedScalar, _zml_arrayAxpyfScalar, _zml_arrayAxpydScalar,
+	_zml_arrayDotfScalar, _zml_arrayDotdScalar, _zml_arraySumfScalar, _zml_arraySumdScalar,
+	_zml_floatsToDoublesScalar, _zml_doublesToFloatsScalar
+};
+
+#ifdef ZML_X86_SIMD
+static const _zml_arrayKernelTable _zml_avx2ArrayKernels = {
+	_zml_arrayElementwisefAVX2, _zml_arrayElementwisedAVX2, _zml_arrayAxpyfAVX2, _zml_arrayAxpydAVX2,
+	_zml_arrayDotfAVX2, _zml_arrayDotdAVX2, _zml_arraySumfAVX2, _zml_arraySumdAVX2,
+	_zml_floatsToDoublesAVX2, _zml_doublesToFloatsAVX2
+};
+#endif
+
+static const _zml_arrayKernelTable *_zml_selectedArrayKernels = NULL;
+
+// get the kernels for the best instruction set the CPU supports (chosen on first use). (The scalar kernels are built
+// for the baseline of the target, which is SSE2 on x86-64, so there's no separate SSE2 table.)
+static const _zml_arrayKernelTable *_zml_arrayKernels(void) {
+	const _zml_arrayKernelTable *table = __atomic_load_n(&_zml_selectedArrayKernels, __ATOMIC_ACQUIRE);
+	if (table) {
+		return table;
+	}
+
+	table = &_zml_scalarArrayKernels;
+#ifdef ZML_X86_SIMD
+	if (_zml_cpuFeatures() & ZML_CPU_AVX2) {
+		table = &_zml_avx2ArrayKernels;
+	}
+#endif
+
+	__atomic_store_n(&_zml_selectedArrayKernels, table, __ATOMIC_RELEASE);
+	return table;
+}
+
+// -------------------------------------------
+// splitting the work across threads
+// -------------------------------------------
+
+typedef struct {
+	_zml_elementwiseOp op;
+	// exactly one of the float and double sets of arrays is used
+	float *dstf;
+	const float *af, *bf;
+	double *dstd;
+	const double *ad, *bd;
+	double s;
+} _zml_arrayArgs;
+
+static void _zml_arrayRange(void *ctx, size_t begin, size_t end) {
+	_zml_arrayArgs *args = (_zml_arrayArgs *) ctx;
+	const _zml_arrayKernelTable *kernels = _zml_arrayKernels();
+
+	if (args->dstf) {
+		kernels->elementwisef(args->op, args->dstf + begin, args->af + begin, args->bf ? args->bf + begin : NULL, (float) args->s, end - begin);
+	} else {
+		kernels->elementwised(args->op, args->dstd + begin, args->ad + begin, args->bd ? args->bd + begin : NULL, args->s, end - begin);
+	}
+}
+
+// call func over [0, n) on the calling thread, or split across threads if the arrays are big.
+static void _zml_splitArray(_zml_parallelFunc func, void *args, size_t n) {
+	// these are memory-bound, so only really big arrays gain anything from extra threads
+	if (n < ZML_PARALLEL_THRESHOLD * 4) {
+		func(args, 0, n);
+		return;
+	}
+
+	_zml_parallelFor(n, ZML_PARALLEL_THRESHOLD, func, args);
+}
+
+static void _zml_applyArrayOp(_zml_arrayArgs *args, size_t n) {
+	_zml_splitArray(_zml_arrayRange, args, n);
+}
+
+// axpy and the conversions: y (or dst) and x (or src) are arrays of the type that the range function works on.
+typedef struct {
+	void *dst;
+	const void *src;
+	double alpha;
+} _zml_streamArgs;
+
+static void _zml_axpyfRange(void *ctx, size_t begin, size_t end) {
+	const _zml_streamArgs *args = (const _zml_streamArgs *) ctx;
+	_zml_arrayKernels()->axpyf((float *) args->dst + begin, (float) args->alpha, (const float *) args->src + begin, end - begin);
+}
+static void _zml_axpydRange(void *ctx, size_t begin, size_t end) {
+	const _zml_streamArgs *args = (const _zml_streamArgs *) ctx;
+	_zml_arrayKernels()->axpyd((double *) args->dst + begin, args->alpha, (const double *) args->src + begin, end - begin);
+}
+static void _zml_floatsToDoublesRange(void *ctx, size_t begin, size_t end) {
+	const _zml_streamArgs *args = (const _zml_streamArgs *) ctx;
+	_zml_arrayKernels()->floatsToDoubles((double *) args->dst + begin, (const float *) args->src + begin, end - begin);
+}
+static void _zml_doublesToFloatsRange(void *ctx, size_t begin, size_t end) {
+	const _zml_streamArgs *args = (const _zml_streamArgs *) ctx;
+	_zml_arrayKernels()->doublesToFloats((float *) args->dst + begin, (const double *) args->src + begin, end - begin);
+}
+
+// the dot products and sums of big arrays are split into blocks of this many values, whose sums are added up in order
+// at the end (so that the result doesn't depend on how many threads there are).
+#define _ZML_REDUCTION_BLOCK (ZML_PARALLEL_THRESHOLD * 4)
+
+// sum of a[i] * b[i] (or of a[i], for the sums) over [begin, end).
+typedef double (*_zml_reductionFunc)(const void *a, const void *b, size_t begin, size_t end);
+
+static double _zml_dotfBlock(const void *a, const void *b, size_t begin, size_t end) {
+	return _zml_arrayKernels()->dotf((const float *) a + begin, (const float *) b + begin, end - begin);
+}
+static double _zml_dotdBlock(const void *a, const void *b, size_t begin, size_t end) {
+	return _zml_arrayKernels()->dotd((const double *) a + begin, (const double *) b + begin, end - begin);
+}
+static double _zml_sumfBlock(const void *a, const void *b, size_t begin, size_t end) {
+	(void) b;
+	return _zml_arrayKernels()->sumf((const float *) a + begin, end - begin);
+}
+static double _zml_sumdBlock(const void *a, const void *b, size_t begin, size_t end) {
+	(void) b;
+	return _zml_arrayKernels()->sumd((const double *) a + begin, end - begin);
+}
+
+typedef struct {
+	_zml_reductionFunc func;
+	const void *a;
+	const void *b;
+	size_t n;
+	double *partials; // one sum per block
+} _zml_reductionArgs;
+
+static void _zml_reductionBlocks(void *ctx, size_t begin, size_t end) {
+	const _zml_reductionArgs *args = (const _zml_reductionArgs *) ctx;
+	for (size_t block = begin; block < end; block++) {
+		const size_t last = (block + 1) * _ZML_REDUCTION_BLOCK;
+		args->partials[block] = args->func(args->a, args->b, block * _ZML_REDUCTION_BLOCK, (last < args->n) ? last : args->n);
+	}
+}
+
+static double _zml_reduce(_zml_reductionFunc func, const void *a, const void *b, size_t n) {
+	const size_t blocks = (n + _ZML_REDUCTION_BLOCK - 1) / _ZML_REDUCTION_BLOCK;
+	double *partials = (blocks > 1) ? (double *) _zml_alloc(blocks * sizeof(double), ZML_ALIGNMENT) : NULL;
+	if (!partials) {
+		return func(a, b, 0, n);
+	}
+
+	_zml_reductionArgs args = { func, a, b, n, partials };
+	_zml_parallelFor(blocks, 1, _zml_reductionBlocks, &args);
+
+	double sum = 0.0;
+	for (size_t block = 0; block < blocks; block++) {
+		sum += partials[block];
+	}
+	_zml_free(partials);
+	return sum;
+}
+
+// -------------------------------------------
+// public functions
+// -------------------------------------------
+
+// define the element-wise operators on two arrays, and on an array and a scalar, for one type.
+#define _zml_defineArrayOperators(type, suffix, name, op, scalarop) \
+	void zml##name##Arrays##suffix(type *dst, const type *a, const type *b, size_t n) {\
+		_zml_arrayArgs args = { op, NULL, NULL, NULL, NULL, NULL, NULL, 0.0 };\
+		args.dst##suffix = dst;\
+		args.a##suffix = a;\
+		args.b##suffix = b;\
+		_zml_applyArrayOp(&args, n);\
+	}\
+	void zml##name##ArrayScalar##suffix(type *dst, const type *a, type s, size_t n) {\
+		_zml_arrayArgs args = { scalarop, NULL, NULL, NULL, NULL, NULL, NULL, (double) s };\
+		args.dst##suffix = dst;\
+		args.a##suffix = a;\
+		_zml_applyArrayOp(&args, n);\
+	}
+
+_zml_defineArrayOperators(float, f, Add, _ZML_OP_ADD, _ZML_OP_ADD_SCALAR)
+_zml_defineArrayOperators(float, f, Subtract, _ZML_OP_SUBTRACT, _ZML_OP_SUBTRACT_SCALAR)
+_zml_defineArrayOperators(float, f, Multiply, _ZML_OP_MULTIPLY, _ZML_OP_MULTIPLY_SCALAR)
+_zml_defineArrayOperators(float, f, Divide, _ZML_OP_DIVIDE, _ZML_OP_DIVIDE_SCALAR)
+_zml_defineArrayOperators(double, d, Add, _ZML_OP_ADD, _ZML_OP_ADD_SCALAR)
+_zml_defineArrayOperators(double, d, Subtract, _ZML_OP_SUBTRACT, _ZML_OP_SUBTRACT_SCALAR)
+_zml_defineArrayOperators(double, d, Multiply, _ZML_OP_MULTIPLY, _ZML_OP_MULTIPLY_SCALAR)
+_zml_defineArrayOperators(double, d, Divide, _ZML_OP_DIVIDE, _ZML_OP_DIVIDE_SCALAR)
+
+/**
+ * @brief y += alpha * x, for arrays of floats.
+ * 
+ * @param y the array to add onto (n values).
+ * @param alpha the factor to multiply x by.
+ * @param x the array to add (n values).
+ * @param n the number of values in each array.
+ */
+void zmlAxpyf(float *y, float alpha, const float *x, size_t n) {
+	_zml_streamArgs args = { y, x, (double) alpha };
+	_zml_splitArray(_zml_axpyfRange, &args, n);
+}
+/**
+ * @brief y += alpha * x, for arrays of doubles.
+ * 
+ * @param y the array to add onto (n values).
+ * @param alpha the factor to multiply x by.
+ * @param x the array to add (n values).
+ * @param n the number of values in each array.
+ */
+void zmlAxpyd(double *y, double alpha, const double *x, size_t n) {
+	_zml_streamArgs args = { y, x, alpha };
+	_zml_splitArray(_zml_axpydRange, &args, n);
+}
+
+/**
+ * @brief return the dot product of two arrays of floats, accumulated in double.
+ * 
+ * @param a the first array (n values).
+ * @param b the second array (n values).
+ * @param n the number of values in each array.
+ */
+double zmlDotf(const float *a, const float *b, size_t n) {
+	return _zml_reduce(_zml_dotfBlock, a, b, n);
+}
+/**
+ * @brief return the dot product of two arrays of doubles.
+ * 
+ * @param a the first array (n values).
+ * @param b the second array (n values).
+ * @param n the number of values in each array.
+ */
+double zmlDotd(const double *a, const double *b, size_t n) {
+	return _zml_reduce(_zml_dotdBlock, a, b, n);
+}
+
+/**
+ * @brief return the sum of an array of floats, accumulated in double.
+ * 
+ * @param a the array (n values).
+ * @param n the number of values in the array.
+ */
+double zmlSumf(const float *a, size_t n) {
+	return _zml_reduce(_zml_sumfBlock, a, NULL, n);
+}
+/**
+ * @brief return the sum of an array of doubles.
+ * 
+ * @param a the array (n values).
+ * @param n the number of values in the array.
+ */
+double zmlSumd(const double *a, size_t n) {
+	return _zml_reduce(_zml_sumdBlock, a, NULL, n);
+}
+
+/**
+ * @brief convert an array of floats to doubles.
+ * 
+ * @param dst the array to write the doubles into (n values).
+ * @param src the floats to convert (n values).
+ * @param n the number of values.
+ */
+void zmlFloatsToDoubles(double *dst, const float *src, size_t n) {
+	_zml_streamArgs args = { dst, src, 0.0 };
+	_zml_splitArray(_zml_floatsToDoublesRange, &args, n);
+}
+/**
+ * @brief convert an array of doubles to floats (rounding each to the nearest float).
+ * 
+ * @param dst the array to write the floats into (n values).
+ * @param src the doubles to convert (n values).
+ * @param n the number of values.
+ */
+void zmlDoublesToFloats(float *dst, const double *src, size_t n) {
+	_zml_streamArgs args = { dst, src, 0.0 };
+	_zml_splitArray(_zml_doublesToFloatsRange, &args, n);
+}
+
+// copy between the __zml_floating elements of a vector and an array of another type, without going through a conversion
+// if the types are the same.
+#ifdef ZML_USING_FLOATS
+#	define _zml_copyToFloats(dst, src, n) memcpy(dst, src, (n) * sizeof(float))
+#	define _zml_copyFromFloats(dst, src, n) memcpy(dst, src, (n) * sizeof(float))
+#	define _zml_copyToDoubles zmlFloatsToDoubles
+#	define _zml_copyFromDoubles zmlDoublesToFloats
+#else
+#	define _zml_copyToFloats zmlDoublesToFloats
+#	define _zml_copyFromFloats zmlFloatsToDoubles
+#	define _zml_copyToDoubles(dst, src, n) memcpy(dst, src, (n) * sizeof(double))
+#	define _zml_copyFromDoubles(dst, src, n) memcpy(dst, src, (n) * sizeof(double))
+#endif
+
+/**
+ * @brief allocate a vector holding the values of an array of floats (converted to __zml_floating).
+ * 
+ * @param arr the values of the vector.
+ * @param size the number of values.
+ */
+zmlVector zmlVectorFromArrayf(const float *arr, unsigned int size) {
+	zmlVector r = zmlAllocVector(size);
+	_zml_copyFromFloats(r.elements, arr, size);
+	return r;
+}
+/**
+ * @brief allocate a vector holding the values of an array of doubles (converted to __zml_floating).
+ * 
+ * @param arr the values of the vector.
+ * @param size the number of values.
+ */
+zmlVector zmlVectorFromArrayd(const double *arr, unsigned int size) {
+	zmlVector r = zmlAllocVector(size);
+	_zml_copyFromDoubles(r.elements, arr, size);
+	return r;
+}
+
+/**
+ * @brief copy the elements of a vector into an array of floats.
+ * 
+ * @param vec the vector to copy from.
+ * @param arr the array to copy into (vec.size values).
+ */
+void zmlCopyVectorElementsf(zmlVector vec, float *arr) {
+	_zml_copyToFloats(arr, vec.elements, vec.size);
+}
+/**
+ * @brief copy the elements of a vector into an array of doubles.
+ * 
+ * @param vec the vector to copy from.
+ * @param arr the array to copy into (vec.size values).
+ */
+void zmlCopyVectorElementsd(zmlVector vec, double *arr) {
+	_zml_copyToDoubles(arr, vec.elements, vec.size);
+}
+
+// -------------------------------------------
+// vectors and matrices of floats and doubles
+// -------------------------------------------
+
+/**
+ * @brief allocate a vector of floats. Elements are NOT initialised!
+ * 
+ * @param size the number of elements.
+ */
+zmlVectorf zmlAllocVectorf(unsigned int size) {
+	zmlVectorf r;
+	r.size = size;
+	r.elements = (float *) _zml_alloc((size_t) size * sizeof(float), ZML_ALIGNMENT);
+	return r;
+}
+/**
+ * @brief allocate a vector of doubles. Elements are NOT initialised!
+ * 
+ * @param size the number of elements.
+ */
+zmlVectord zmlAllocVectord(unsigned int size) {
+	zmlVectord r;
+	r.size = size;
+	r.elements = (double *) _zml_alloc((size_t) size * sizeof(double), ZML_ALIGNMENT);
+	return r;
+}
+/**
+ * @brief free a vector of floats.
+ * 
+ * @param vec the vector to free.
+ */
+void zmlFreeVectorf(zmlVectorf *vec) {
+	_zml_free(vec->elements);
+	vec->elements = NULL;
+	vec->size = 0;
+}
+/**
+ * @brief free a vector of doubles.
+ * 
+ * @param vec the vector to free.
+ */
+void zmlFreeVectord(zmlVectord *vec) {
+	_zml_free(vec->elements);
+	vec->elements = NULL;
+	vec->size = 0;
+}
+
+/**
+ * @brief allocate a matrix of floats. Elements are NOT initialised!
+ * 
+ * @param rows the number of rows.
+ * @param cols the number of columns.
+ */
+zmlMatrixf zmlAllocMatrixf(unsigned int rows, unsigned int cols) {
+	zmlMatrixf r;
+	r.rows = rows;
+	r.cols = cols;
+	r.stride = cols;
+	r.data = (float *) _zml_alloc((size_t) rows * cols * sizeof(float), ZML_ALIGNMENT);
+	return r;
+}
+/**
+ * @brief allocate a matrix of doubles. Elements are NOT initialised!
+ * 
+ * @param rows the number of rows.
+ * @param cols the number of columns.
+ */
+zmlMatrixd zmlAllocMatrixd(unsigned int rows, unsigned int cols) {
+	zmlMatrixd r;
+	r.rows = rows;
+	r.cols = cols;
+	r.stride = cols;
+	r.data = (double *) _zml_alloc((size_t) rows * cols * sizeof(double), ZML_ALIGNMENT);
+	return r;
+}
+/**
+ * @brief free a matrix of floats.
+ * 
+ * @param mat the matrix to free.
+ */
+void zmlFreeMatrixf(zmlMatrixf *mat) {
+	_zml_free(mat->data);
+	mat->data = NULL;
+	mat->rows = 0;
+	mat->cols = 0;
+	mat->stride = 0;
+}
+/**
+ * @brief free a matrix of doubles.
+ * 
+ * @param mat the matrix to free.
+ */
+void zmlFreeMatrixd(zmlMatrixd *mat) {
+	_zml_free(mat->data);
+	mat->data = NULL;
+	mat->rows = 0;
+	mat->cols = 0;
+	mat->stride = 0;
+}
+
+/**
+ * @brief allocate a vector of floats holding the values of vec.
+ * 
+ * @param vec the vector to convert.
+ */
+zmlVectorf zmlVectorToFloats(zmlVector vec) {
+	zmlVectorf r = zmlAllocVectorf(vec.size);
+	_zml_copyToFloats(r.elements, vec.elements, vec.size);
+	return r;
+}
+/**
+ * @brief allocate a vector of doubles holding the values of vec.
+ * 
+ * @param vec the vector to convert.
+ */
+zmlVectord zmlVectorToDoubles(zmlVector vec) {
+	zmlVectord r = zmlAllocVectord(vec.size);
+	_zml_copyToDoubles(r.elements, vec.elements, vec.size);
+	return r;
+}
+/**
+ * @brief allocate a vector holding the values of a vector of floats (converted to __zml_floating).
+ * 
+ * @param vec the vector to convert.
+ */
+zmlVector zmlVectorFromFloats(zmlVectorf vec) {
+	return zmlVectorFromArrayf(vec.elements, vec.size);
+}
+/**
+ * @brief allocate a vector holding the values of a vector of doubles (converted to __zml_floating).
+ * 
+ * @param vec the vector to convert.
+ */
+zmlVector zmlVectorFromDoubles(zmlVectord vec) {
+	return zmlVectorFromArrayd(vec.elements, vec.size);
+}
+
+/**
+ * @brief allocate a matrix of floats holding the values of mat.
+ * 
+ * @param mat the matrix to convert.
+ */
+zmlMatrixf zmlMatrixToFloats(zmlMatrix mat) {
+	// (rows can be further apart than they are wide, so they're converted one at a time)
+	zmlMatrixf r = zmlAllocMatrixf(mat.rows, mat.cols);
+	for (unsigned int i = 0; i < mat.rows; i++) {
+		_zml_copyToFloats(&_zml_at(r, i, 0), &_zml_at(mat, i, 0), mat.cols);
+	}
+	return r;
+}
+/**
+ * @brief allocate a matrix of doubles holding the values of mat.
+ * 
+ * @param mat the matrix to convert.
+ */
+zmlMatrixd zmlMatrixToDoubles(zmlMatrix mat) {
+	zmlMatrixd r = zmlAllocMatrixd(mat.rows, mat.cols);
+	for (unsigned int i = 0; i < mat.rows; i++) {
+		_zml_copyToDoubles(&_zml_at(r, i, 0), &_zml_at(mat, i, 0), mat.cols);
+	}
+	return r;
+}
+/**
+ * @brief allocate a matrix holding the values of a matrix of floats (converted to __zml_floating).
+ * 
+ * @param mat the matrix to convert.
+ */
+zmlMatrix zmlMatrixFromFloats(zmlMatrixf mat) {
+	zmlMatrix r = zmlAllocMatrix(mat.rows, mat.cols);
+	for (unsigned int i = 0; i < mat.rows; i++) {
+		_zml_copyFromFloats(&_zml_at(r, i, 0), &_zml_at(mat, i, 0), mat.cols);
+	}
+	return r;
+}
+/**
+ * @brief allocate a matrix holding the values of a matrix of doubles (converted to __zml_floating).
+ * 
+ * @param mat the matrix to convert.
+ */
+zmlMatrix zmlMatrixFromDoubles(zmlMatrixd mat) {
+	zmlMatrix r = zmlAllocMatrix(mat.rows, mat.cols);
+	for (unsigned int i = 0; i < mat.rows; i++) {
+		_zml_copyFromDoubles(&_zml_at(r, i, 0), &_zml_at(mat, i, 0), mat.cols);
+	}
+	return r;
+}
+
+/**
+ * @brief return the dot product of two vectors of floats, accumulated in double (0 if they are different sizes).
+ * 
+ * @param v1 the first vector.
+ * @param v2 the second vector.
+ */
+double zmlDotVecsf(zmlVectorf v1, zmlVectorf v2) {
+	if (v1.size != v2.size) {
+		printf("zetaml: zmlDotVecsf(): the given vectors are of different sizes! 0 returned!\n");
+		return 0.0;
+	}
+	return zmlDotf(v1.elements, v2.elements, v1.size);
+}
+/**
+ * @brief return the dot product of two vectors of doubles (0 if they are different sizes).
+ * 
+ * @param v1 the first vector.
+ * @param v2 the second vector.
+ */
+double zmlDotVecsd(zmlVectord v1, zmlVectord v2) {
+	if (v1.size != v2.size) {
+		printf("zetaml: zmlDotVecsd(): the given vectors are of different sizes! 0 returned!\n");
+		return 0.0;
+	}
+	return zmlDotd(v1.elements, v2.elements, v1.size);
+}
+
+/**
+ * @brief y += alpha * x, for vectors of floats of the same size.
+ * 
+ * @param y the vector to add onto.
+ * @param alpha the factor to multiply x by.
+ * @param x the vector to add.
+ */
+void zmlAxpyVecf(zmlVectorf *y, float alpha, zmlVectorf x) {
+	if (y->size != x.size) {
+		printf("zetaml: zmlAxpyVecf(): the given vectors are of different sizes!\n");
+		return;
+	}
+	zmlAxpyf(y->elements, alpha, x.elements, x.size);
+}
+/**
+ * @brief y += alpha * x, for vectors of doubles of the same size.
+ * 
+ * @param y the vector to add onto.
+ * @param alpha the factor to multiply x by.
+ * @param x the vector to add.
+ */
+void zmlAxpyVecd(zmlVectord *y, double alpha, zmlVectord x) {
+	if (y->size != x.size) {
+		printf("zetaml: zmlAxpyVecd(): the given vectors are of different sizes!\n");
+		return;
+	}
+	zmlAxpyd(y->elements, alpha, x.elements, x.size);
+}
+
+// matrix-vector products: each element of the result is the dot product of a row with the vector, and big products
+// are split across threads by rows (exactly one of the float and double sets of pointers is used).
+typedef struct {
+	const zmlMatrixf *matf;
+	const float *vecf;
+	float *dstf;
+	const zmlMatrixd *matd;
+	const double *vecd;
+	double *dstd;
+} _zml_matVecArgs;
+
+static void _zml_matVecRows(void *ctx, size_t begin, size_t end) {
+	const _zml_matVecArgs *args = (const _zml_matVecArgs *) ctx;
+	const _zml_arrayKernelTable *kernels = _zml_arrayKernels();
+
+	for (size_t r = begin; r < end; r++) {
+		if (args->matf) {
+			args->dstf[r] = (float) kernels->dotf(&_zml_at(*args->matf, r, 0), args->vecf, args->matf->cols);
+		} else {
+			args->dstd[r] = kernels->dotd(&_zml_at(*args->matd, r, 0), args->vecd, args->matd->cols);
+		}
+	}
+}
+
+static void _zml_multiplyMatVec(_zml_matVecArgs *args, size_t rows, size_t cols) {
+	if (rows * cols < ZML_PARALLEL_THRESHOLD) {
+		_zml_matVecRows(args, 0, rows);
+		return;
+	}
+	_zml_parallelFor(rows, 1 + ZML_PARALLEL_THRESHOLD / (cols + 1), _zml_matVecRows, args);
+}
+
+/**
+ * @brief dst = mat * vec, for a matrix and vector of floats, with each element accumulated in double.
+ * dst must already be allocated with as many elements as mat has rows, and must not be vec.
+ * 
+ * @param dst the vector to store the result in.
+ * @param mat the matrix.
+ * @param vec the vector (as many elements as mat has columns).
+ */
+void zmlMultiplyMatVecIntof(zmlVectorf *dst, zmlMatrixf mat, zmlVectorf vec) {
+	if (mat.cols != vec.size || dst->size != mat.rows) {
+		printf("zetaml: zmlMultiplyMatVecIntof(): a %ux%u matrix needs a vector of %u elements (and gives one of %u)!\n", mat.rows, mat.cols, mat.cols, mat.rows);
+		return;
+	}
+
+	_zml_matVecArgs args = { &mat, vec.elements, dst->elements, NULL, NULL, NULL };
+	_zml_multiplyMatVec(&args, mat.rows, mat.cols);
+}
+/**
+ * @brief dst = mat * vec, for a matrix and vector of doubles.
+ * dst must already be allocated with as many elements as mat has rows, and must not be vec.
+ * 
+ * @param dst the vector to store the result in.
+ * @param mat the matrix.
+ * @param vec the vector (as many elements as mat has columns).
+ */
+void zmlMultiplyMatVecIntod(zmlVectord *dst, zmlMatrixd mat, zmlVectord vec) {
+	if (mat.cols != vec.size || dst->size != mat.rows) {
+		printf("zetaml: zmlMultiplyMatVecIntod(): a %ux%u matrix needs a vector of %u elements (and gives one of %u)!\n", mat.rows, mat.cols, mat.cols, mat.rows);
+		return;
+	}
+
+	_zml_matVecArgs args = { NULL, NULL, NULL, &mat, vec.elements, dst->elements };
+	_zml_multiplyMatVec(&args, mat.rows, mat.cols);
+}
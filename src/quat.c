@@ -0,0 +1,488 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+// below this cosine of the angle between two quaternions, slerp falls back to nlerp (the angle is too small for sin() to be accurate).
+#define _ZML_SLERP_THRESHOLD ((__zml_floating) 0.9995)
+
+// below this cosine of the middle Euler angle, the first and last rotations are treated as being about the same axis (gimbal lock).
+#ifdef ZML_USING_FLOATS
+#	define _ZML_GIMBAL_LOCK_THRESHOLD ((__zml_floating) 1e-6)
+#else
+#	define _ZML_GIMBAL_LOCK_THRESHOLD ((__zml_floating) 1e-12)
+#endif
+
+// write the rotation matrix of a unit quaternion into r.
+static void _zml_quatRotation(__zml_floating r[3][3], zmlQuat q) {
+	const __zml_floating x = q.elements[0], y = q.elements[1], z = q.elements[2], w = q.elements[3];
+	const __zml_floating x2 = x + x, y2 = y + y, z2 = z + z;
+	const __zml_floating xx = x * x2, yy = y * y2, zz = z * z2;
+	const __zml_floating xy = x * y2, xz = x * z2, yz = y * z2;
+	const __zml_floating wx = w * x2, wy = w * y2, wz = w * z2;
+
+	r[0][0] = (__zml_floating) 1.0 - (yy + zz);	r[0][1] = xy - wz;							r[0][2] = xz + wy;
+	r[1][0] = xy + wz;							r[1][1] = (__zml_floating) 1.0 - (xx + zz);	r[1][2] = yz - wx;
+	r[2][0] = xz - wy;							r[2][1] = yz + wx;							r[2][2] = (__zml_floating) 1.0 - (xx + yy);
+}
+
+// get the quaternion of a rotation matrix (whose rows are stride elements apart).
+static zmlQuat _zml_rotationQuat(const __zml_floating *m, size_t stride) {
+	#define _m(r, c) m[(r) * stride + (c)]
+
+	zmlQuat q;
+	const __zml_floating trace = _m(0, 0) + _m(1, 1) + _m(2, 2);
+
+	// use the largest of w, x, y and z to divide by, so that the result stays accurate
+	if (trace > (__zml_floating) 0.0) {
+		const __zml_floating s = (__zml_floating) 0.5 / _zml_sqrt(trace + (__zml_floating) 1.0);
+		q.elements[0] = (_m(2, 1) - _m(1, 2)) * s;
+		q.elements[1] = (_m(0, 2) - _m(2, 0)) * s;
+		q.elements[2] = (_m(1, 0) - _m(0, 1)) * s;
+		q.elements[3] = (__zml_floating) 0.25 / s;
+	} else if (_m(0, 0) > _m(1, 1) && _m(0, 0) > _m(2, 2)) {
+		const __zml_floating s = (__zml_floating) 2.0 * _zml_sqrt((__zml_floating) 1.0 + _m(0, 0) - _m(1, 1) - _m(2, 2));
+		q.elements[0] = (__zml_floating) 0.25 * s;
+		q.elements[1] = (_m(0, 1) + _m(1, 0)) / s;
+		q.elements[2] = (_m(0, 2) + _m(2, 0)) / s;
+		q.elements[3] = (_m(2, 1) - _m(1, 2)) / s;
+	} else if (_m(1, 1) > _m(2, 2)) {
+		const __zml_floating s = (__zml_floating) 2.0 * _zml_sqrt((__zml_floating) 1.0 + _m(1, 1) - _m(0, 0) - _m(2, 2));
+		q.elements[0] = (_m(0, 1) + _m(1, 0)) / s;
+		q.elements[1] = (__zml_floating) 0.25 * s;
+		q.elements[2] = (_m(1, 2) + _m(2, 1)) / s;
+		q.elements[3] = (_m(0, 2) - _m(2, 0)) / s;
+	} else {
+		const __zml_floating s = (__zml_floating) 2.0 * _zml_sqrt((__zml_floating) 1.0 + _m(2, 2) - _m(0, 0) - _m(1, 1));
+		q.elements[0] = (_m(0, 2) + _m(2, 0)) / s;
+		q.elements[1] = (_m(1, 2) + _m(2, 1)) / s;
+		q.elements[2] = (__zml_floating) 0.25 * s;
+		q.elements[3] = (_m(1, 0) - _m(0, 1)) / s;
+	}
+
+	#undef _m
+	return zmlNormalisedQuat(q);
+}
+
+/**
+ * @brief get the identity quaternion (no rotation).
+ * 
+ */
+zmlQuat zmlIdentityQuat(void) {
+	zmlQuat r = { { 0, 0, 0, 1 } };
+	return r;
+}
+
+/**
+ * @brief multiply two quaternions (the Hamilton product). The result rotates by v2, then by v1.
+ * 
+ * @param v1 the first quaternion to operate on.
+ * @param v2 the second quaternion to operate on.
+ */
+zmlQuat zmlMultiplyQuats_r(zmlQuat v1, zmlQuat v2) {
+	const __zml_floating x1 = v1.elements[0], y1 = v1.elements[1], z1 = v1.elements[2], w1 = v1.elements[3];
+	const __zml_floating x2 = v2.elements[0], y2 = v2.elements[1], z2 = v2.elements[2], w2 = v2.elements[3];
+
+	zmlQuat r;
+	r.elements[0] = w1 * x2 + x1 * w2 + y1 * z2 - z1 * y2;
+	r.elements[1] = w1 * y2 - x1 * z2 + y1 * w2 + z1 * x2;
+	r.elements[2] = w1 * z2 + x1 * y2 - y1 * x2 + z1 * w2;
+	r.elements[3] = w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2;
+	return r;
+}
+
+/**
+ * @brief get the conjugate of a quaternion, which is its inverse if it is normalised.
+ * 
+ * @param q the quaternion to conjugate.
+ */
+zmlQuat zmlConjugateQuat(zmlQuat q) {
+	q.elements[0] = -q.elements[0];
+	q.elements[1] = -q.elements[1];
+	q.elements[2] = -q.elements[2];
+	return q;
+}
+
+/**
+ * @brief get the inverse of a quaternion. For normalised quaternions, zmlConjugateQuat() is cheaper.
+ * 
+ * @param q the quaternion to invert.
+ */
+zmlQuat zmlInverseQuat(zmlQuat q) {
+	const __zml_floating lensq = zmlDotQuat(q, q);
+
+	if (lensq == (__zml_floating) 0.0) {
+		printf("zetaml: zmlInverseQuat(): the given quaternion has no inverse! identity returned!\n");
+		return zmlIdentityQuat();
+	}
+
+	const __zml_floating inv = (__zml_floating) 1.0 / lensq;
+	for (unsigned int i = 0; i < 4; i++) {
+		q.elements[i] *= (i < 3) ? -inv : inv;
+	}
+	return q;
+}
+
+/**
+ * @brief get the dot product of two quaternions.
+ * 
+ * @param v1 the first quaternion to operate on.
+ * @param v2 the second quaternion to operate on.
+ */
+__zml_floating zmlDotQuat(zmlQuat v1, zmlQuat v2) {
+	return v1.elements[0] * v2.elements[0] + v1.elements[1] * v2.elements[1] + v1.elements[2] * v2.elements[2] + v1.elements[3] * v2.elements[3];
+}
+
+/**
+ * @brief get the magnitude (length) of a quaternion.
+ * 
+ * @param q the specified quaternion.
+ */
+__zml_floating zmlMagnitudeQuat(zmlQuat q) {
+	return _zml_sqrt(zmlDotQuat(q, q));
+}
+
+/**
+ * @brief get a quaternion scaled to a magnitude of 1. A quaternion with a magnitude of 0 gives the identity quaternion.
+ * 
+ * @param q the quaternion to normalise.
+ */
+zmlQuat zmlNormalisedQuat(zmlQuat q) {
+	const __zml_floating lensq = zmlDotQuat(q, q);
+
+	if (lensq == (__zml_floating) 0.0) {
+		return zmlIdentityQuat();
+	}
+
+	const __zml_floating inv = (__zml_floating) 1.0 / _zml_sqrt(lensq);
+	for (unsigned int i = 0; i < 4; i++) {
+		q.elements[i] *= inv;
+	}
+	return q;
+}
+
+/**
+ * @brief linearly interpolate between two rotations and normalise the result, taking the shortest path.
+ * Cheaper than zmlSlerpQuat(), but the rotation doesn't move at a constant speed as t changes.
+ * 
+ * @param v1 the rotation at t = 0.
+ * @param v2 the rotation at t = 1.
+ * @param t the interpolation factor.
+ */
+zmlQuat zmlNlerpQuat(zmlQuat v1, zmlQuat v2, __zml_floating t) {
+	// q and -q are the same rotation; interpolate towards whichever one is nearer
+	const __zml_floating t2 = (zmlDotQuat(v1, v2) < (__zml_floating) 0.0) ? -t : t;
+	const __zml_floating t1 = (__zml_floating) 1.0 - t;
+
+	zmlQuat r;
+	for (unsigned int i = 0; i < 4; i++) {
+		r.elements[i] = t1 * v1.elements[i] + t2 * v2.elements[i];
+	}
+	return zmlNormalisedQuat(r);
+}
+
+/**
+ * @brief spherically interpolate between two normalised rotations, taking the shortest path at a constant angular speed.
+ * 
+ * @param v1 the rotation at t = 0.
+ * @param v2 the rotation at t = 1.
+ * @param t the interpolation factor.
+ */
+zmlQuat zmlSlerpQuat(zmlQuat v1, zmlQuat v2, __zml_floating t) {
+	__zml_floating cosangle = zmlDotQuat(v1, v2);
+
+	// q and -q are the same rotation; interpolate towards whichever one is nearer
+	if (cosangle < (__zml_floating) 0.0) {
+		cosangle = -cosangle;
+		v2 = (zmlQuat) { { -v2.elements[0], -v2.elements[1], -v2.elements[2], -v2.elements[3] } };
+	}
+
+	if (cosangle > _ZML_SLERP_THRESHOLD) {
+		return zmlNlerpQuat(v1, v2, t);
+	}
+
+	const __zml_floating angle = (__zml_floating) acos(cosangle);
+	const __zml_floating invsin = (__zml_floating) 1.0 / _zml_sin(angle);
+	const __zml_floating s1 = _zml_sin(((__zml_floating) 1.0 - t) * angle) * invsin;
+	const __zml_floating s2 = _zml_sin(t * angle) * invsin;
+
+	zmlQuat r;
+	for (unsigned int i = 0; i < 4; i++) {
+		r.elements[i] = s1 * v1.elements[i] + s2 * v2.elements[i];
+	}
+	return r;
+}
+
+/**
+ * @brief get the quaternion of a rotation by angle about the given axis (the same rotation as zmlRotateIdentity()).
+ * 
+ * @param angle the angle to rotate the specified axes by.
+ * @param x the multiplier for the X axis of rotation (set to 0 if you don't want X rotation).
+ * @param y the multiplier for the Y axis of rotation (set to 0 if you don't want Y rotation).
+ * @param z the multiplier for the Z axis of rotation (set to 0 if you don't want Z rotation).
+ */
+zmlQuat zmlAxisAngleQuat(__zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z) {
+	const __zml_floating lensq = x * x + y * y + z * z;
+
+	if (angle == (__zml_floating) 0.0 || lensq == (__zml_floating) 0.0) {
+		return zmlIdentityQuat();
+	}
+
+	const __zml_floating half = (__zml_floating) 0.5 * angle;
+	const __zml_floating s = _zml_sin(half) / _zml_sqrt(lensq);
+
+	zmlQuat r = { { x * s, y * s, z * s, _zml_cos(half) } };
+	return r;
+}
+
+/**
+ * @brief get the angle and (normalised) axis of the rotation of a quaternion.
+ * If there is no rotation, the angle is 0 and the axis is the X axis.
+ * 
+ * @param q the quaternion.
+ * @param angle the variable to write the angle into.
+ * @param axis the variable to write the axis into.
+ */
+void zmlQuatToAxisAngle(zmlQuat q, __zml_floating *angle, zmlVec3 *axis) {
+	q = zmlNormalisedQuat(q);
+
+	// the sine of half of the angle
+	const __zml_floating s = _zml_sqrt(q.elements[0] * q.elements[0] + q.elements[1] * q.elements[1] + q.elements[2] * q.elements[2]);
+
+	if (s == (__zml_floating) 0.0) {
+		*angle = (__zml_floating) 0.0;
+		*axis = (zmlVec3) { { 1, 0, 0 } };
+		return;
+	}
+
+	*angle = (__zml_floating) 2.0 * (__zml_floating) atan2(s, q.elements[3]);
+	*axis = (zmlVec3) { { q.elements[0] / s, q.elements[1] / s, q.elements[2] / s } };
+}
+
+/**
+ * @brief get the quaternion of a rotation by the Euler angles x, y and z (the same rotation as zmlRotateIdentityEuler()).
+ * 
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+zmlQuat zmlEulerQuat(zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	const zmlQuat qx = { { _zml_sin((__zml_floating) 0.5 * x), 0, 0, _zml_cos((__zml_floating) 0.5 * x) } };
+	const zmlQuat qy = { { 0, _zml_sin((__zml_floating) 0.5 * y), 0, _zml_cos((__zml_floating) 0.5 * y) } };
+	const zmlQuat qz = { { 0, 0, _zml_sin((__zml_floating) 0.5 * z), _zml_cos((__zml_floating) 0.5 * z) } };
+
+	// the same products as the matrices in _zml_eulerRotation()
+	switch (order) {
+		case ZML_EULER_ZYX:
+			return zmlMultiplyQuats_r(zmlMultiplyQuats_r(qz, qy), qx);
+		case ZML_EULER_YXZ:
+			return zmlMultiplyQuats_r(zmlMultiplyQuats_r(qy, qx), qz);
+		default:
+			return zmlMultiplyQuats_r(zmlMultiplyQuats_r(qx, qy), qz);
+	}
+}
+
+/**
+ * @brief get the Euler angles x, y and z of the rotation of a quaternion, for the given order (so that
+ * zmlEulerQuat(order, x, y, z) is the same rotation as q). The middle rotation's angle is in [-pi/2, pi/2], and the
+ * others are in [-pi, pi]. At gimbal lock (when the middle angle is +-pi/2), the first and last rotations are about the
+ * same axis, so the first angle is taken to be 0 and the last one gives the whole of their rotation.
+ * 
+ * @param q the rotation.
+ * @param order the order that the three rotations are applied in.
+ * @param x the variable to write the angle about the X axis into.
+ * @param y the variable to write the angle about the Y axis into.
+ * @param z the variable to write the angle about the Z axis into.
+ */
+void zmlQuatToEuler(zmlQuat q, zmlEulerOrder order, __zml_floating *x, __zml_floating *y, __zml_floating *z) {
+	__zml_floating r[3][3];
+	_zml_quatRotation(r, zmlNormalisedQuat(q));
+
+	// the first angle is found from the column of r that the last rotation leaves alone, then the other two angles from
+	// that rotation undone (see _zml_eulerRotation() for the elements), so that the result stays accurate near gimbal lock.
+	double a, sa, ca;
+	switch (order) {
+		case ZML_EULER_ZYX: // r = Rz * Ry * Rx, and Rz^T * r = Ry * Rx
+			a = (hypot(r[0][0], r[1][0]) < _ZML_GIMBAL_LOCK_THRESHOLD) ? 0.0 : atan2(r[1][0], r[0][0]);
+			sa = sin(a);
+			ca = cos(a);
+			*z = (__zml_floating) a;
+			*y = (__zml_floating) atan2(-r[2][0], ca * r[0][0] + sa * r[1][0]);
+			*x = (__zml_floating) atan2(sa * r[0][2] - ca * r[1][2], ca * r[1][1] - sa * r[0][1]);
+			break;
+		case ZML_EULER_YXZ: // r = Ry * Rx * Rz, and Ry^T * r = Rx * Rz
+			a = (hypot(r[0][2], r[2][2]) < _ZML_GIMBAL_LOCK_THRESHOLD) ? 0.0 : atan2(r[0][2], r[2][2]);
+			sa = sin(a);
+			ca = cos(a);
+			*y = (__zml_floating) a;
+			*x = (__zml_floating) atan2(-r[1][2], sa * r[0][2] + ca * r[2][2]);
+			*z = (__zml_floating) atan2(sa * r[2][1] - ca * r[0][1], ca * r[0][0] - sa * r[2][0]);
+			break;
+		default: // ZML_EULER_XYZ: r = Rx * Ry * Rz, and Rx^T * r = Ry * Rz
+			a = (hypot(r[1][2], r[2][2]) < _ZML_GIMBAL_LOCK_THRESHOLD) ? 0.0 : atan2(-r[1][2], r[2][2]);
+			sa = sin(a);
+			ca = cos(a);
+			*x = (__zml_floating) a;
+			*y = (__zml_floating) atan2(r[0][2], ca * r[2][2] - sa * r[1][2]);
+			*z = (__zml_floating) atan2(ca * r[1][0] + sa * r[2][0], ca * r[1][1] + sa * r[2][1]);
+			break;
+	}
+}
+
+/**
+ * @brief rotate a 3D vector by a normalised quaternion.
+ * 
+ * @param vec the vector to rotate.
+ * @param q the rotation.
+ */
+zmlVec3 zmlRotatedVec3(zmlVec3 vec, zmlQuat q) {
+	// v + w * t + u x t, where u is the vector part of q and t = 2 (u x v)
+	const zmlVec3 u = { { q.elements[0], q.elements[1], q.elements[2] } };
+	const zmlVec3 t = zmlMultiplyVec3Scalar_r(zmlCrossVec3(u, vec), (__zml_floating) 2.0);
+	const zmlVec3 ut = zmlCrossVec3(u, t);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		vec.elements[i] += q.elements[3] * t.elements[i] + ut.elements[i];
+	}
+	return vec;
+}
+
+/**
+ * @brief get the 3x3 rotation matrix of a normalised quaternion.
+ * 
+ * @param q the rotation.
+ */
+zmlMat3 zmlQuatToMat3(zmlQuat q) {
+	zmlMat3 r;
+	_zml_quatRotation(r.elements, q);
+	return r;
+}
+/**
+ * @brief get the 4x4 rotation matrix of a normalised quaternion.
+ * 
+ * @param q the rotation.
+ */
+zmlMat4 zmlQuatToMat4(zmlQuat q) {
+	__zml_floating rotation[3][3];
+	_zml_quatRotation(rotation, q);
+
+	// the rotation is the upper-left 3x3 block of an identity matrix
+	zmlMat4 r = zmlIdentityMat4();
+	for (unsigned int row = 0; row < 3; row++) {
+		memcpy(r.elements[row], rotation[row], 3 * sizeof(__zml_floating));
+	}
+	return r;
+}
+/**
+ * @brief allocate a 4x4 rotation matrix from a normalised quaternion.
+ * 
+ * @param q the rotation.
+ */
+zmlMatrix zmlQuatToMatrix(zmlQuat q) {
+	zmlMat4 r = zmlQuatToMat4(q);
+	return zmlMat4ToMatrix(r);
+}
+
+/**
+ * @brief get the rotation of a 3x3 rotation matrix as a quaternion.
+ * 
+ * @param mat the rotation matrix.
+ */
+zmlQuat zmlMat3ToQuat(zmlMat3 mat) {
+	return _zml_rotationQuat(&mat.elements[0][0], 3);
+}
+/**
+ * @brief get the rotation in the upper-left 3x3 block of a 4x4 matrix as a quaternion. The block must have no scale or shear.
+ * 
+ * @param mat the rotation matrix.
+ */
+zmlQuat zmlMat4ToQuat(zmlMat4 mat) {
+	return _zml_rotationQuat(&mat.elements[0][0], 4);
+}
+/**
+ * @brief get the rotation in the upper-left 3x3 block of a matrix (at least 3x3) as a quaternion. The block must have no scale or shear.
+ * 
+ * @param mat the rotation matrix.
+ */
+zmlQuat zmlMatrixToQuat(zmlMatrix mat) {
+	if (mat.rows < 3 || mat.cols < 3) {
+		printf("zetaml: zmlMatrixToQuat(): given matrix is smaller than 3x3! identity returned!\n");
+		return zmlIdentityQuat();
+	}
+
+	return _zml_rotationQuat(mat.data, mat.stride);
+}
+
+/**
+ * @brief apply the rotation of a normalised quaternion to mat, as with zmlRotatedMat4().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param q the rotation.
+ */
+zmlMat4 zmlRotatedMat4Quat(zmlMat4 mat, zmlQuat q) {
+	__zml_floating rotation[3][3];
+	_zml_quatRotation(rotation, q);
+	_zml_rotateRows(&mat.elements[0][0], 4, rotation);
+	return mat;
+}
+/**
+ * @brief apply the rotation of a normalised quaternion to a 4x4 matrix, as with zmlRotate().
+ * 
+ * @param mat the matrix to rotate.
+ * @param q the rotation.
+ */
+void zmlRotateQuat(zmlMatrix *mat, zmlQuat q) {
+	if (mat->cols != 4 || mat->rows != 4) {
+		printf("zetaml: zmlRotateQuat(): given matrix is not 4x4, no transformation performed!\n");
+		return;
+	}
+
+	__zml_floating rotation[3][3];
+	_zml_quatRotation(rotation, q);
+	_zml_rotateRows(mat->data, mat->stride, rotation);
+}
+
+typedef struct {
+	const zmlQuat *v1, *v2;
+	zmlQuat *out;
+	__zml_floating t;
+} _zml_slerpArgs;
+
+static void _zml_slerpRange(void *ctx, size_t begin, size_t end) {
+	const _zml_slerpArgs *args = (const _zml_slerpArgs *) ctx;
+	for (size_t i = begin; i < end; i++) {
+		args->out[i] = zmlSlerpQuat(args->v1[i], args->v2[i], args->t);
+	}
+}
+
+/**
+ * @brief spherically interpolate between two arrays of normalised rotations, as with zmlSlerpQuat().
+ * 
+ * @param v1 the rotations at t = 0 (count quaternions).
+ * @param v2 the rotations at t = 1 (count quaternions).
+ * @param t the interpolation factor.
+ * @param out the array to write the interpolated rotations into (count quaternions). May be the same array as v1 or v2.
+ * @param count the number of rotations.
+ */
+void zmlSlerpQuats(const zmlQuat *v1, const zmlQuat *v2, __zml_floating t, zmlQuat *out, size_t count) {
+	_zml_slerpArgs args = { v1, v2, out, t };
+
+	if (count < ZML_PARALLEL_THRESHOLD / 8) {
+		_zml_slerpRange(&args, 0, count);
+		return;
+	}
+
+	_zml_parallelFor(count, ZML_PARALLEL_THRESHOLD / 32, _zml_slerpRange, &args);
+}
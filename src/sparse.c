@@ -0,0 +1,513 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+#include "internal.h"
+
+// ==============================================================================
+// Sparse matrices are stored in compressed form along their 'major' dimension: rows for CSR, columns for CSC. Most
+// of the functions here work on that compressed form directly and only look at the format to decide which of the
+// matrix's dimensions is which, so CSR and CSC share all of their code.
+// ==============================================================================
+
+/**
+ * @brief An undefined sparse matrix; no elements.
+ * 
+ */
+const zmlSparseMatrix ZML_NULL_SPARSE_MATRIX = { 0, 0, ZML_CSR, 0, NULL, NULL, NULL };
+
+// the number of rows (CSR) or columns (CSC) that the nonzeros are grouped by.
+#define _zml_majorSize(s) (((s).format == ZML_CSR) ? (s).rows : (s).cols)
+// the other dimension.
+#define _zml_minorSize(s) (((s).format == ZML_CSR) ? (s).cols : (s).rows)
+
+// allocate a sparse matrix with room for nonzeros elements (offsets are not initialised).
+static zmlSparseMatrix _zml_allocSparse(unsigned int rows, unsigned int cols, zmlSparseFormat format, size_t nonzeros) {
+	zmlSparseMatrix r;
+	r.rows = rows;
+	r.cols = cols;
+	r.format = format;
+	r.nonzeros = nonzeros;
+	r.offsets = (size_t *) _zml_alloc(((size_t) _zml_majorSize(r) + 1) * sizeof(size_t), sizeof(size_t));
+	// (allocations are never empty, so that a sparse matrix with no nonzeros is still distinguishable from ZML_NULL_SPARSE_MATRIX)
+	r.indices = (unsigned int *) _zml_alloc((nonzeros ? nonzeros : 1) * sizeof(unsigned int), ZML_ALIGNMENT);
+	r.values = (__zml_floating *) _zml_alloc((nonzeros ? nonzeros : 1) * sizeof(__zml_floating), ZML_ALIGNMENT);
+	return r;
+}
+
+// rebuild the compressed arrays of s along its minor dimension instead (into dst, which must have room for s.nonzeros
+// elements and 1 + the minor size of s offsets). Within each of the new groups, the indices come out in increasing order.
+static void _zml_swapCompression(zmlSparseMatrix s, size_t *offsets, unsigned int *indices, __zml_floating *values) {
+	const unsigned int nmajor = _zml_majorSize(s);
+	const unsigned int nminor = _zml_minorSize(s);
+
+	// count the elements in each minor group, then turn the counts into starting offsets
+	memset(offsets, 0, ((size_t) nminor + 1) * sizeof(size_t));
+	for (size_t k = 0; k < s.nonzeros; k++) {
+		offsets[s.indices[k] + 1]++;
+	}
+	for (unsigned int i = 0; i < nminor; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	// deal the elements out; going through the major groups in order keeps the new indices sorted. offsets[i] is used
+	// as the next free place in group i, which leaves each one at the start of group i + 1 by the end.
+	for (unsigned int m = 0; m < nmajor; m++) {
+		for (size_t k = s.offsets[m]; k < s.offsets[m + 1]; k++) {
+			const size_t dst = offsets[s.indices[k]]++;
+			indices[dst] = m;
+			values[dst] = s.values[k];
+		}
+	}
+	memmove(offsets + 1, offsets, (size_t) nminor * sizeof(size_t));
+	offsets[0] = 0;
+}
+
+/**
+ * @brief build a sparse matrix from a list of (row, column, value) triplets, in any order.
+ * Values given for the same element more than once are added together. Returns ZML_NULL_SPARSE_MATRIX if any of
+ * the triplets are outside of the matrix.
+ * 
+ * @param rows the number of rows in the matrix.
+ * @param cols the number of columns in the matrix.
+ * @param rowIndices the row of each triplet.
+ * @param colIndices the column of each triplet.
+ * @param values the value of each triplet.
+ * @param count the number of triplets.
+ * @param format the form to store the matrix in.
+ */
+zmlSparseMatrix zmlSparseMatrixFromTriplets(unsigned int rows, unsigned int cols, const unsigned int *rowIndices, const unsigned int *colIndices, const __zml_floating *values, size_t count, zmlSparseFormat format) {
+	for (size_t k = 0; k < count; k++) {
+		if (rowIndices[k] >= rows || colIndices[k] >= cols) {
+			printf("zetaml: zmlSparseMatrixFromTriplets(): triplet %lu, (%u, %u), is outside of the %ux%u matrix!\n", (unsigned long) k, rowIndices[k], colIndices[k], rows, cols);
+			return ZML_NULL_SPARSE_MATRIX;
+		}
+	}
+
+	const unsigned int *major = (format == ZML_CSR) ? rowIndices : colIndices;
+	const unsigned int *minor = (format == ZML_CSR) ? colIndices : rowIndices;
+
+	// the triplets are put into order with two counting sorts: first into the opposite form (grouped by minor index),
+	// which is then compressed the other way round with the indices in order.
+	zmlSparseMatrix t = _zml_allocSparse(rows, cols, (format == ZML_CSR) ? ZML_CSC : ZML_CSR, count);
+	const unsigned int nminor = _zml_majorSize(t);
+	memset(t.offsets, 0, ((size_t) nminor + 1) * sizeof(size_t));
+	for (size_t k = 0; k < count; k++) {
+		t.offsets[minor[k] + 1]++;
+	}
+	for (unsigned int i = 0; i < nminor; i++) {
+		t.offsets[i + 1] += t.offsets[i];
+	}
+	for (size_t k = 0; k < count; k++) {
+		const size_t dst = t.offsets[minor[k]]++;
+		t.indices[dst] = major[k];
+		t.values[dst] = values[k];
+	}
+	memmove(t.offsets + 1, t.offsets, (size_t) nminor * sizeof(size_t));
+	t.offsets[0] = 0;
+
+	zmlSparseMatrix r = _zml_allocSparse(rows, cols, format, count);
+	_zml_swapCompression(t, r.offsets, r.indices, r.values);
+	zmlFreeSparseMatrix(&t);
+
+	// merge duplicates (which are next to each other now) in place
+	const unsigned int nmajor = _zml_majorSize(r);
+	size_t n = 0;
+	for (unsigned int m = 0; m < nmajor; m++) {
+		const size_t begin = r.offsets[m];
+		const size_t end = r.offsets[m + 1];
+		r.offsets[m] = n;
+		for (size_t k = begin; k < end; k++) {
+			if (n > r.offsets[m] && r.indices[n - 1] == r.indices[k]) {
+				r.values[n - 1] += r.values[k];
+			} else {
+				r.indices[n] = r.indices[k];
+				r.values[n] = r.values[k];
+				n++;
+			}
+		}
+	}
+	r.offsets[nmajor] = n;
+	r.nonzeros = n;
+
+	return r;
+}
+
+/**
+ * @brief build a sparse matrix holding the nonzero elements of a (dense) matrix.
+ * 
+ * @param mat the matrix to convert.
+ * @param format the form to store the sparse matrix in.
+ */
+zmlSparseMatrix zmlSparseMatrixFromMatrix(zmlMatrix mat, zmlSparseFormat format) {
+	size_t count = 0;
+	for (unsigned int r = 0; r < mat.rows; r++) {
+		const __zml_floating *row = &_zml_at(mat, r, 0);
+		for (unsigned int c = 0; c < mat.cols; c++) {
+			count += (row[c] != 0);
+		}
+	}
+
+	zmlSparseMatrix s = _zml_allocSparse(mat.rows, mat.cols, format, count);
+
+	if (format == ZML_CSR) {
+		size_t n = 0;
+		for (unsigned int r = 0; r < mat.rows; r++) {
+			const __zml_floating *row = &_zml_at(mat, r, 0);
+			s.offsets[r] = n;
+			for (unsigned int c = 0; c < mat.cols; c++) {
+				if (row[c] != 0) {
+					s.indices[n] = c;
+					s.values[n] = row[c];
+					n++;
+				}
+			}
+		}
+		s.offsets[mat.rows] = n;
+	} else {
+		// count each column first, then fill them in going through the rows in order (so that the indices stay sorted)
+		memset(s.offsets, 0, ((size_t) mat.cols + 1) * sizeof(size_t));
+		for (unsigned int r = 0; r < mat.rows; r++) {
+			const __zml_floating *row = &_zml_at(mat, r, 0);
+			for (unsigned int c = 0; c < mat.cols; c++) {
+				s.offsets[c + 1] += (row[c] != 0);
+			}
+		}
+		for (unsigned int c = 0; c < mat.cols; c++) {
+			s.offsets[c + 1] += s.offsets[c];
+		}
+		for (unsigned int r = 0; r < mat.rows; r++) {
+			const __zml_floating *row = &_zml_at(mat, r, 0);
+			for (unsigned int c = 0; c < mat.cols; c++) {
+				if (row[c] != 0) {
+					const size_t dst = s.offsets[c]++;
+					s.indices[dst] = r;
+					s.values[dst] = row[c];
+				}
+			}
+		}
+		memmove(s.offsets + 1, s.offsets, (size_t) mat.cols * sizeof(size_t));
+		s.offsets[0] = 0;
+	}
+
+	return s;
+}
+
+/**
+ * @brief build a (dense) matrix from a sparse matrix, with zeros everywhere that the sparse matrix has no element.
+ * 
+ * @param s the sparse matrix to convert.
+ */
+zmlMatrix zmlMatrixFromSparse(zmlSparseMatrix s) {
+	zmlMatrix r = zmlZeroMatrix(s.rows, s.cols);
+
+	for (unsigned int m = 0; m < _zml_majorSize(s); m++) {
+		for (size_t k = s.offsets[m]; k < s.offsets[m + 1]; k++) {
+			if (s.format == ZML_CSR) {
+				_zml_at(r, m, s.indices[k]) = s.values[k];
+			} else {
+				_zml_at(r, s.indices[k], m) = s.values[k];
+			}
+		}
+	}
+
+	return r;
+}
+
+/**
+ * @brief copy a sparse matrix, converting it to the given form.
+ * 
+ * @param s the sparse matrix to copy.
+ * @param format the form to store the copy in.
+ */
+zmlSparseMatrix zmlConvertedSparse(zmlSparseMatrix s, zmlSparseFormat format) {
+	zmlSparseMatrix r = _zml_allocSparse(s.rows, s.cols, format, s.nonzeros);
+
+	if (format == s.format) {
+		memcpy(r.offsets, s.offsets, ((size_t) _zml_majorSize(s) + 1) * sizeof(size_t));
+		memcpy(r.indices, s.indices, s.nonzeros * sizeof(unsigned int));
+		memcpy(r.values, s.values, s.nonzeros * sizeof(__zml_floating));
+	} else {
+		_zml_swapCompression(s, r.offsets, r.indices, r.values);
+	}
+
+	return r;
+}
+
+/**
+ * @brief get the transpose of a sparse matrix, stored in the same form.
+ * (The transpose of a CSR matrix has the same arrays as the original in CSC form and vice versa, so zmlConvertedSparse()
+ * does the work.)
+ * 
+ * @param s the sparse matrix to transpose.
+ */
+zmlSparseMatrix zmlTransposedSparse(zmlSparseMatrix s) {
+	zmlSparseMatrix r = zmlConvertedSparse(s, (s.format == ZML_CSR) ? ZML_CSC : ZML_CSR);
+
+	// reinterpret the converted arrays as the transpose in the original form
+	const unsigned int rows = r.rows;
+	r.rows = r.cols;
+	r.cols = rows;
+	r.format = s.format;
+
+	return r;
+}
+
+/**
+ * @brief Free a sparse matrix's memory.
+ * 
+ * @param s the sparse matrix to free.
+ */
+void zmlFreeSparseMatrix(zmlSparseMatrix *s) {
+	_zml_free(s->offsets);
+	_zml_free(s->indices);
+	_zml_free(s->values);
+	*s = ZML_NULL_SPARSE_MATRIX;
+}
+
+// ---- products ----
+
+// the first major group that starts at or after nonzero k.
+static unsigned int _zml_groupStartingFrom(const size_t *offsets, unsigned int count, size_t k) {
+	unsigned int lo = 0, hi = count;
+	while (lo < hi) {
+		const unsigned int mid = lo + (hi - lo) / 2;
+		if (offsets[mid] < k) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+// the major groups that belong to the nonzeros [begin, end): those that start in that range (plus, for the last range,
+// any empty groups at the end). Splitting the work by nonzeros rather than by groups keeps it balanced when some rows
+// are much fuller than others, and every group is still handled by exactly one range.
+static void _zml_groupsOfRange(zmlSparseMatrix s, size_t begin, size_t end, unsigned int *first, unsigned int *last) {
+	const unsigned int nmajor = _zml_majorSize(s);
+	*first = _zml_groupStartingFrom(s.offsets, nmajor, begin);
+	*last = (end >= s.nonzeros) ? nmajor : _zml_groupStartingFrom(s.offsets, nmajor, end);
+}
+
+typedef struct {
+	zmlSparseMatrix a;
+	const __zml_floating *x; // the vector, or the rows of the dense matrix being multiplied
+	__zml_floating *y; // the result
+	unsigned int cols; // columns of the dense matrix (1 for a vector)
+	size_t xstride; // distance between the rows of x
+	size_t ystride; // distance between the rows of y
+	__zml_floating *partials; // CSC vector products: one result per part, rows elements apart
+	unsigned int parts;
+} _zml_sparseProduct;
+
+// CSR: each row of the result is a combination of rows of x, weighted by the nonzeros of that row of a.
+static void _zml_sparseRowsRange(void *ctx, size_t begin, size_t end) {
+	const _zml_sparseProduct *p = (const _zml_sparseProduct *) ctx;
+	const zmlSparseMatrix a = p->a;
+
+	unsigned int first, last;
+	_zml_groupsOfRange(a, begin, end, &first, &last);
+
+	if (p->cols == 1) {
+		for (unsigned int r = first; r < last; r++) {
+			__zml_floating sum = (__zml_floating) 0.0;
+			for (size_t k = a.offsets[r]; k < a.offsets[r + 1]; k++) {
+				sum += a.values[k] * p->x[(size_t) a.indices[k] * p->xstride];
+			}
+			p->y[(size_t) r * p->ystride] = sum;
+		}
+		return;
+	}
+
+	for (unsigned int r = first; r < last; r++) {
+		__zml_floating *y = p->y + (size_t) r * p->ystride;
+		memset(y, 0, p->cols * sizeof(__zml_floating));
+		for (size_t k = a.offsets[r]; k < a.offsets[r + 1]; k++) {
+			const __zml_floating v = a.values[k];
+			const __zml_floating *x = p->x + (size_t) a.indices[k] * p->xstride;
+			for (unsigned int c = 0; c < p->cols; c++) {
+				y[c] += v * x[c];
+			}
+		}
+	}
+}
+
+// CSC vector products: each part scatters its share of the columns of a into a result of its own.
+static void _zml_sparseColumnsPart(void *ctx, size_t begin, size_t end) {
+	const _zml_sparseProduct *p = (const _zml_sparseProduct *) ctx;
+	const zmlSparseMatrix a = p->a;
+
+	for (size_t part = begin; part < end; part++) {
+		__zml_floating *y = (part == 0) ? p->y : p->partials + (part - 1) * a.rows;
+		memset(y, 0, a.rows * sizeof(__zml_floating));
+
+		unsigned int first, last;
+		_zml_groupsOfRange(a, a.nonzeros * part / p->parts, a.nonzeros * (part + 1) / p->parts, &first, &last);
+
+		for (unsigned int c = first; c < last; c++) {
+			const __zml_floating x = p->x[c];
+			for (size_t k = a.offsets[c]; k < a.offsets[c + 1]; k++) {
+				y[a.indices[k]] += a.values[k] * x;
+			}
+		}
+	}
+}
+
+// add the results of the other parts into the first.
+static void _zml_sumPartialsRange(void *ctx, size_t begin, size_t end) {
+	const _zml_sparseProduct *p = (const _zml_sparseProduct *) ctx;
+	for (unsigned int part = 1; part < p->parts; part++) {
+		const __zml_floating *partial = p->partials + (size_t) (part - 1) * p->a.rows;
+		for (size_t i = begin; i < end; i++) {
+			p->y[i] += partial[i];
+		}
+	}
+}
+
+// CSC matrix products: the columns [begin, end) of the result, scattered from every column of a.
+static void _zml_sparseColumnsRange(void *ctx, size_t begin, size_t end) {
+	const _zml_sparseProduct *p = (const _zml_sparseProduct *) ctx;
+	const zmlSparseMatrix a = p->a;
+
+	for (unsigned int r = 0; r < a.rows; r++) {
+		memset(p->y + (size_t) r * p->ystride + begin, 0, (end - begin) * sizeof(__zml_floating));
+	}
+	for (unsigned int c = 0; c < a.cols; c++) {
+		const __zml_floating *x = p->x + (size_t) c * p->xstride;
+		for (size_t k = a.offsets[c]; k < a.offsets[c + 1]; k++) {
+			const __zml_floating v = a.values[k];
+			__zml_floating *y = p->y + (size_t) a.indices[k] * p->ystride;
+			for (size_t j = begin; j < end; j++) {
+				y[j] += v * x[j];
+			}
+		}
+	}
+}
+
+/**
+ * @brief multiply a sparse matrix by a (dense) vector, storing the result in dst.
+ * a must have as many columns as v has elements, and dst as many elements as a has rows; dst may be v.
+ * Large products are split across threads (by rows, for CSR matrices, which are the faster form to multiply).
+ * 
+ * @param dst the vector to store the result in.
+ * @param a the sparse matrix.
+ * @param v the vector.
+ */
+void zmlMultiplySparseVecInto(zmlVector *dst, zmlSparseMatrix a, zmlVector v) {
+	if (a.cols != v.size || dst->size != a.rows) {
+		printf("zetaml: zmlMultiplySparseVec(): a %ux%u sparse matrix needs a vector of %u elements (and gives one of %u)!\n", a.rows, a.cols, a.cols, a.rows);
+		return;
+	}
+
+	// every element of v can be needed for every element of the result, so if dst is v the result is built separately first
+	zmlVector buf = (dst->elements == v.elements) ? zmlAllocVector(a.rows) : *dst;
+
+	_zml_sparseProduct p;
+	p.a = a;
+	p.x = v.elements;
+	p.y = buf.elements;
+	p.cols = 1;
+	p.xstride = 1;
+	p.ystride = 1;
+	p.partials = NULL;
+	p.parts = 1;
+
+	if (a.format == ZML_CSR) {
+		_zml_parallelFor(a.nonzeros ? a.nonzeros : 1, ZML_PARALLEL_THRESHOLD, _zml_sparseRowsRange, &p);
+	} else {
+		// CSC products scatter into the result, so each thread needs a result of its own to add up at the end
+		const size_t maxparts = a.nonzeros / ZML_PARALLEL_THRESHOLD;
+		p.parts = zmlGetThreadCount();
+		if (p.parts > maxparts) {
+			p.parts = maxparts ? (unsigned int) maxparts : 1;
+		}
+		if (p.parts > 1) {
+			p.partials = (__zml_floating *) _zml_alloc((size_t) (p.parts - 1) * a.rows * sizeof(__zml_floating), ZML_ALIGNMENT);
+		}
+
+		_zml_parallelFor(p.parts, 1, _zml_sparseColumnsPart, &p);
+		if (p.parts > 1) {
+			_zml_parallelFor(a.rows, ZML_PARALLEL_THRESHOLD, _zml_sumPartialsRange, &p);
+			_zml_free(p.partials);
+		}
+	}
+
+	if (buf.elements != dst->elements) {
+		memcpy(dst->elements, buf.elements, a.rows * sizeof(__zml_floating));
+		zmlFreeVector(&buf);
+	}
+}
+zmlVector zmlMultiplySparseVec_r(zmlSparseMatrix a, zmlVector v) {
+	if (a.cols != v.size) {
+		printf("zetaml: zmlMultiplySparseVec(): a %ux%u sparse matrix needs a vector of %u elements (and gives one of %u)!\n", a.rows, a.cols, a.cols, a.rows);
+		return ZML_NULL_VECTOR;
+	}
+
+	zmlVector r = zmlAllocVector(a.rows);
+	zmlMultiplySparseVecInto(&r, a, v);
+	return r;
+}
+
+/**
+ * @brief multiply a sparse matrix by a (dense) matrix, storing the result in dst.
+ * a must have as many columns as b has rows, and dst must have a's rows and b's columns; dst may be b.
+ * Large products are split across threads (by rows for CSR matrices, and by the columns of b for CSC matrices).
+ * 
+ * @param dst the matrix to store the result in.
+ * @param a the sparse matrix.
+ * @param b the matrix.
+ */
+void zmlMultiplySparseMatInto(zmlMatrix *dst, zmlSparseMatrix a, zmlMatrix b) {
+	if (a.cols != b.rows || dst->rows != a.rows || dst->cols != b.cols) {
+		printf("zetaml: zmlMultiplySparseMat(): a %ux%u sparse matrix needs a matrix with %u rows (and gives one of %ux%u)!\n", a.rows, a.cols, a.cols, a.rows, b.cols);
+		return;
+	}
+
+	zmlMatrix buf = (dst->data == b.data) ? zmlAllocMatrix(a.rows, b.cols) : *dst;
+
+	_zml_sparseProduct p;
+	p.a = a;
+	p.x = b.data;
+	p.y = buf.data;
+	p.cols = b.cols;
+	p.xstride = b.stride;
+	p.ystride = buf.stride;
+	p.partials = NULL;
+	p.parts = 1;
+
+	if (a.format == ZML_CSR) {
+		const size_t grain = ZML_PARALLEL_THRESHOLD / (b.cols ? b.cols : 1);
+		_zml_parallelFor(a.nonzeros ? a.nonzeros : 1, grain, _zml_sparseRowsRange, &p);
+	} else {
+		const size_t grain = ZML_PARALLEL_THRESHOLD / (a.nonzeros + a.rows + 1);
+		_zml_parallelFor(b.cols, grain, _zml_sparseColumnsRange, &p);
+	}
+
+	if (buf.data != dst->data) {
+		for (unsigned int r = 0; r < a.rows; r++) {
+			memcpy(&_zml_at(*dst, r, 0), &_zml_at(buf, r, 0), b.cols * sizeof(__zml_floating));
+		}
+		zmlFreeMatrix(&buf);
+	}
+}
+zmlMatrix zmlMultiplySparseMat_r(zmlSparseMatrix a, zmlMatrix b) {
+	if (a.cols != b.rows) {
+		printf("zetaml: zmlMultiplySparseMat(): a %ux%u sparse matrix needs a matrix with %u rows (and gives one of %ux%u)!\n", a.rows, a.cols, a.cols, a.rows, b.cols);
+		return ZML_NULL_MATRIX;
+	}
+
+	zmlMatrix r = zmlAllocMatrix(a.rows, b.cols);
+	zmlMultiplySparseMatInto(&r, a, b);
+	return r;
+}
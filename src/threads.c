@@ -0,0 +1,424 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+#include "internal.h"
+
+// ==============================================================================
+// The thread pool is owned by the library and created on first use. Every worker has its own deque of tasks:
+// a worker takes tasks from the back of its own deque, and when that is empty it steals from the front of
+// another worker's deque. The thread that called _zml_parallelFor() steals tasks too while it waits, so it
+// never sits idle. Loops started from inside a task (on a worker, or on the calling thread while it helps out) run
+// serially, so nested parallel calls cannot deadlock.
+// ==============================================================================
+
+#ifndef ZML_NO_THREADS
+
+#include <pthread.h>
+#include <unistd.h>
+
+// one parallel loop; tasks from it count down 'remaining' and the last one wakes up the caller.
+typedef struct {
+	_zml_parallelFunc func;
+	void *ctx;
+	size_t remaining;
+	pthread_mutex_t mutex;
+	pthread_cond_t done;
+} _zml_job;
+
+// a contiguous chunk of one job.
+typedef struct {
+	_zml_job *job;
+	size_t begin;
+	size_t end;
+} _zml_task;
+
+// a double-ended queue of tasks, stored as a growable ring buffer.
+typedef struct {
+	pthread_mutex_t mutex;
+	_zml_task *tasks;
+	size_t capacity;
+	size_t head;
+	size_t count;
+} _zml_deque;
+
+typedef struct {
+	unsigned int nworkers;
+	pthread_t *threads;
+	_zml_deque *deques;
+
+	// workers sleep on 'wake' when there are no tasks left anywhere ('pending' counts queued tasks)
+	pthread_mutex_t mutex;
+	pthread_cond_t wake;
+	long pending;
+	unsigned char shutdown;
+	unsigned int started; // workers that have started (each takes the next deque)
+} _zml_pool;
+
+static _zml_pool *_zml_threadPool = NULL;
+static pthread_mutex_t _zml_poolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// requested thread count (0 = use the number of processors).
+static unsigned int _zml_requestedThreads = 0;
+
+// index (+ 1) of the worker running on this thread; 0 on threads that aren't part of the pool.
+static _zml_threadLocal unsigned int _zml_workerIndex = 0;
+
+// whether this thread is running a task of a parallel loop (so any loop it starts must run serially).
+static _zml_threadLocal unsigned char _zml_inTask = 0;
+
+// add a task to the back of a deque. Returns 0 (leaving the deque unchanged) if it couldn't grow to fit the task.
+static unsigned char _zml_dequePushBack(_zml_deque *dq, _zml_task task) {
+	pthread_mutex_lock(&dq->mutex);
+
+	if (dq->count == dq->capacity) {
+		// grow, unwrapping the ring buffer into the new storage
+		size_t newcap = dq->capacity ? dq->capacity * 2 : 64;
+		_zml_task *tasks = (_zml_task *) malloc(newcap * sizeof(_zml_task));
+		if (!tasks) {
+			pthread_mutex_unlock(&dq->mutex);
+			return 0;
+		}
+		for (size_t i = 0; i < dq->count; i++) {
+			tasks[i] = dq->tasks[(dq->head + i) % dq->capacity];
+		}
+		free(dq->tasks);
+		dq->tasks = tasks;
+		dq->capacity = newcap;
+		dq->head = 0;
+	}
+
+	dq->tasks[(dq->head + dq->count) % dq->capacity] = task;
+	dq->count++;
+
+	pthread_mutex_unlock(&dq->mutex);
+	return 1;
+}
+
+// take a task from the back (the owner's end) or the front (thieves' end) of a deque.
+static unsigned char _zml_dequeTake(_zml_deque *dq, unsigned char back, _zml_task *task) {
+	unsigned char r = 0;
+	pthread_mutex_lock(&dq->mutex);
+
+	if (dq->count) {
+		if (back) {
+			*task = dq->tasks[(dq->head + dq->count - 1) % dq->capacity];
+		} else {
+			*task = dq->tasks[dq->head];
+			dq->head = (dq->head + 1) % dq->capacity;
+		}
+		dq->count--;
+		r = 1;
+	}
+
+	pthread_mutex_unlock(&dq->mutex);
+	return r;
+}
+
+// find a task: first from the worker's own deque (if it has one), then from everybody else's.
+static unsigned char _zml_findTask(_zml_pool *pool, unsigned int self, _zml_task *task) {
+	if (self && _zml_dequeTake(&pool->deques[self - 1], 1, task)) {
+		return 1;
+	}
+	for (unsigned int i = 0; i < pool->nworkers; i++) {
+		unsigned int victim = (self + i) % pool->nworkers;
+		if (victim + 1 != self && _zml_dequeTake(&pool->deques[victim], 0, task)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// run one chunk of a job on this thread, and count it as finished.
+static void _zml_runChunk(_zml_job *job, size_t begin, size_t end) {
+	const unsigned char wasInTask = _zml_inTask;
+	_zml_inTask = 1;
+	job->func(job->ctx, begin, end);
+	_zml_inTask = wasInTask;
+
+	// the last task of a job wakes up whoever is waiting for it
+	pthread_mutex_lock(&job->mutex);
+	if (__atomic_sub_fetch(&job->remaining, 1, __ATOMIC_RELEASE) == 0) {
+		pthread_cond_signal(&job->done);
+	}
+	pthread_mutex_unlock(&job->mutex);
+}
+
+static void _zml_runTask(_zml_pool *pool, _zml_task *task) {
+	__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_RELAXED);
+	_zml_runChunk(task->job, task->begin, task->end);
+}
+
+static void *_zml_workerMain(void *arg) {
+	_zml_pool *pool = (_zml_pool *) arg;
+
+	// (the pool's mutex is held until every worker has been created, so this also waits for the pool to be finished)
+	pthread_mutex_lock(&pool->mutex);
+	_zml_workerIndex = ++pool->started;
+	pthread_mutex_unlock(&pool->mutex);
+
+	// workers can run tasks for any thread, so they always allocate with malloc() rather than a (possibly
+	// thread-unsafe) global allocator
+	zmlSetThreadAllocator(&ZML_DEFAULT_ALLOCATOR);
+
+	for (;;) {
+		_zml_task task;
+		if (_zml_findTask(pool, _zml_workerIndex, &task)) {
+			_zml_runTask(pool, &task);
+			continue;
+		}
+
+		// nothing to do: sleep until more tasks are queued
+		pthread_mutex_lock(&pool->mutex);
+		while (__atomic_load_n(&pool->pending, __ATOMIC_RELAXED) <= 0 && !pool->shutdown) {
+			pthread_cond_wait(&pool->wake, &pool->mutex);
+		}
+		unsigned char shutdown = pool->shutdown;
+		pthread_mutex_unlock(&pool->mutex);
+
+		if (shutdown) {
+			return NULL;
+		}
+	}
+}
+
+static unsigned int _zml_defaultThreadCount(void) {
+	const char *env = getenv("ZML_NUM_THREADS");
+	if (env && atoi(env) > 0) {
+		return (unsigned int) atoi(env);
+	}
+
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (unsigned int) n : 1;
+}
+
+// free a pool whose worker threads have all been joined (or were never started).
+static void _zml_freePool(_zml_pool *pool) {
+	for (unsigned int i = 0; i < pool->nworkers; i++) {
+		pthread_mutex_destroy(&pool->deques[i].mutex);
+		free(pool->deques[i].tasks);
+	}
+	pthread_mutex_destroy(&pool->mutex);
+	pthread_cond_destroy(&pool->wake);
+
+	free(pool->threads);
+	free(pool->deques);
+	free(pool);
+}
+
+// create a pool of up to nworkers worker threads. If some of the threads can't be created, the pool makes do with the
+// ones that could be; returns NULL if there's no memory for the pool or no threads could be created at all.
+static _zml_pool *_zml_createPool(unsigned int nworkers) {
+	_zml_pool *pool = (_zml_pool *) calloc(1, sizeof(_zml_pool));
+	if (!pool) {
+		return NULL;
+	}
+	pool->threads = (pthread_t *) malloc(nworkers * sizeof(pthread_t));
+	pool->deques = (_zml_deque *) calloc(nworkers, sizeof(_zml_deque));
+	if (!pool->threads || !pool->deques) {
+		free(pool->threads);
+		free(pool->deques);
+		free(pool);
+		return NULL;
+	}
+
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+	for (unsigned int i = 0; i < nworkers; i++) {
+		pthread_mutex_init(&pool->deques[i].mutex, NULL);
+	}
+
+	// the workers wait for the pool's mutex before they start, so nworkers can be settled first
+	pthread_mutex_lock(&pool->mutex);
+	unsigned int created = 0;
+	while (created < nworkers && pthread_create(&pool->threads[created], NULL, _zml_workerMain, pool) == 0) {
+		created++;
+	}
+	for (unsigned int i = created; i < nworkers; i++) {
+		pthread_mutex_destroy(&pool->deques[i].mutex);
+	}
+	pool->nworkers = created;
+	pthread_mutex_unlock(&pool->mutex);
+
+	if (!created) {
+		_zml_freePool(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+static void _zml_destroyPool(void) {
+	pthread_mutex_lock(&_zml_poolMutex);
+	_zml_pool *pool = _zml_threadPool;
+
+	if (pool) {
+		pthread_mutex_lock(&pool->mutex);
+		pool->shutdown = 1;
+		pthread_cond_broadcast(&pool->wake);
+		pthread_mutex_unlock(&pool->mutex);
+
+		for (unsigned int i = 0; i < pool->nworkers; i++) {
+			pthread_join(pool->threads[i], NULL);
+		}
+		_zml_freePool(pool);
+		_zml_threadPool = NULL;
+	}
+
+	pthread_mutex_unlock(&_zml_poolMutex);
+}
+
+// get the pool, creating it if necessary. Returns NULL if only one thread is to be used.
+static _zml_pool *_zml_getPool(void) {
+	_zml_pool *pool = __atomic_load_n(&_zml_threadPool, __ATOMIC_ACQUIRE);
+	if (pool) {
+		return pool;
+	}
+
+	pthread_mutex_lock(&_zml_poolMutex);
+
+	if (!_zml_threadPool) {
+		unsigned int nthreads = _zml_requestedThreads ? _zml_requestedThreads : _zml_defaultThreadCount();
+
+		// the calling thread does work too, so the pool only needs nthreads - 1 workers
+		if (nthreads > 1) {
+			static unsigned char registered = 0;
+			if (!registered) {
+				atexit(_zml_destroyPool);
+				registered = 1;
+			}
+
+			pool = _zml_createPool(nthreads - 1);
+			if (pool) {
+				__atomic_store_n(&_zml_threadPool, pool, __ATOMIC_RELEASE);
+			} else {
+				// (don't try again for every loop; zmlSetThreadCount() starts afresh)
+				_zml_requestedThreads = 1;
+			}
+		}
+	}
+
+	pool = _zml_threadPool;
+	pthread_mutex_unlock(&_zml_poolMutex);
+
+	return pool;
+}
+
+/**
+ * @brief set the number of threads that zetaml splits large operations across (including the calling thread).
+ * Must not be called while other zetaml functions are running.
+ * 
+ * @param count the number of threads to use. 0 uses the number of processors (or the ZML_NUM_THREADS environment variable if set); 1 disables multithreading.
+ */
+void zmlSetThreadCount(unsigned int count) {
+	_zml_destroyPool();
+	_zml_requestedThreads = count;
+}
+
+/**
+ * @brief get the number of threads that zetaml splits large operations across (including the calling thread).
+ * 
+ */
+unsigned int zmlGetThreadCount(void) {
+	_zml_pool *pool = _zml_getPool();
+	return pool ? pool->nworkers + 1 : 1;
+}
+
+/**
+ * @brief run func over the range [0, count), split into chunks of at least grain items that are spread across the thread pool.
+ * Returns once every chunk has finished.
+ * 
+ */
+void _zml_parallelFor(size_t count, size_t grain, _zml_parallelFunc func, void *ctx) {
+	if (count == 0) {
+		return;
+	}
+	if (grain == 0) {
+		grain = 1;
+	}
+
+	// (workers only ever run tasks, so this also keeps loops started on a worker serial)
+	_zml_pool *pool = (count > grain && !_zml_inTask) ? _zml_getPool() : NULL;
+	if (!pool) {
+		func(ctx, 0, count);
+		return;
+	}
+
+	// aim for a few chunks per thread so that stealing can even out the load
+	const size_t nthreads = pool->nworkers + 1;
+	size_t chunk = (count + nthreads * 4 - 1) / (nthreads * 4);
+	if (chunk < grain) {
+		chunk = grain;
+	}
+	const size_t ntasks = (count + chunk - 1) / chunk;
+
+	_zml_job job;
+	job.func = func;
+	job.ctx = ctx;
+	job.remaining = ntasks;
+	pthread_mutex_init(&job.mutex, NULL);
+	pthread_cond_init(&job.done, NULL);
+
+	// deal the chunks out across the workers' deques (running any that don't fit on this thread)
+	size_t queued = 0;
+	for (size_t t = 0; t < ntasks; t++) {
+		_zml_task task;
+		task.job = &job;
+		task.begin = t * chunk;
+		task.end = (task.begin + chunk < count) ? task.begin + chunk : count;
+		if (_zml_dequePushBack(&pool->deques[t % pool->nworkers], task)) {
+			queued++;
+		} else {
+			_zml_runChunk(&job, task.begin, task.end);
+		}
+	}
+
+	pthread_mutex_lock(&pool->mutex);
+	__atomic_add_fetch(&pool->pending, (long) queued, __ATOMIC_RELAXED);
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->mutex);
+
+	// help out until there is nothing left to steal, then wait for the rest of the job to finish
+	_zml_task task;
+	while (__atomic_load_n(&job.remaining, __ATOMIC_RELAXED) && _zml_findTask(pool, 0, &task)) {
+		_zml_runTask(pool, &task);
+	}
+
+	pthread_mutex_lock(&job.mutex);
+	while (job.remaining) {
+		pthread_cond_wait(&job.done, &job.mutex);
+	}
+	pthread_mutex_unlock(&job.mutex);
+
+	pthread_mutex_destroy(&job.mutex);
+	pthread_cond_destroy(&job.done);
+}
+
+#else
+
+// built without thread support: everything runs on the calling thread.
+
+void zmlSetThreadCount(unsigned int count) {
+	(void) count;
+}
+
+unsigned int zmlGetThreadCount(void) {
+	return 1;
+}
+
+void _zml_parallelFor(size_t count, size_t grain, _zml_parallelFunc func, void *ctx) {
+	(void) grain;
+	if (count) {
+		func(ctx, 0, count);
+	}
+}
+
+#endif
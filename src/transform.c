@@ -13,6 +13,33 @@
 
 #include "internal.h"
 
+// write a fixed-size 4x4 matrix into mat, reallocating mat if it is not already 4x4.
+static void _zml_storeMat4(zmlMatrix *mat, const zmlMat4 *val) {
+	if (mat->rows != 4 || mat->cols != 4) {
+		zmlFreeMatrix(mat);
+		*mat = zmlAllocMatrix(4, 4);
+	}
+
+	for (unsigned int r = 0; r < 4; r++) {
+		memcpy(&_zml_at(*mat, r, 0), val->elements[r], 4 * sizeof(__zml_floating));
+	}
+}
+
+// copy the elements of a vector of size 3 into a fixed-size 3D vector.
+static zmlVec3 _zml_toVec3(zmlVector vec) {
+	zmlVec3 r = { { vec.elements[0], vec.elements[1], vec.elements[2] } };
+	return r;
+}
+
+// check that the vectors given to a look-at function are all of size 3, printing the problem on behalf of func if not.
+static unsigned char _zml_checkLookAtVectors(zmlVector pos, zmlVector focus, zmlVector up, const char *func) {
+	if (pos.size != 3 || focus.size != 3 || up.size != 3) {
+		printf("zetaml: %s(): given vectors are not all of size 3, no transformation performed!\n", func);
+		return 0;
+	}
+	return 1;
+}
+
 /**
  * @brief produces a translation matrix from a given matrix (mat) and the desired 3D vector vec. 
  * 
@@ -45,22 +72,11 @@ void zmlTranslate(zmlMatrix *mat, zmlVector vec) {
 		return;
 	}
 
-	zmlVector r = zmlConstructVectorDefault(4, (__zml_floating) 0.0); // allocate and initialise vector r as a zero vector
-	// loop through the columns in the matrix (this is asserted to be 4)
-	for (unsigned int i = 0; i < 4; i++) {
-		zmlVector col = zmlGetMatrixCol(*mat, i);
-		// multiply by the appropriate vector element except on the last column
-		if (i < 3) zmlMultiplyVecScalar(&col, vec.elements[i]);
-		
-		// add this to the result vector
-		zmlAddVecs(&r, col);
-
-		zmlFreeVector(&col);
+	// the fourth column becomes the sum of the first three columns (each multiplied by the appropriate vector element) and itself.
+	for (unsigned int r = 0; r < 4; r++) {
+		__zml_floating *row = &_zml_at(*mat, r, 0);
+		row[3] += row[0] * vec.elements[0] + row[1] * vec.elements[1] + row[2] * vec.elements[2];
 	}
-	
-	zmlSetMatrixCol(mat, 3, r);
-
-	zmlFreeVector(&r);
 }
 
 /**
@@ -100,78 +116,14 @@ zmlMatrix zmlRotated(zmlMatrix mat, __zml_floating angle, __zml_floating x, __zm
 void zmlRotate(zmlMatrix *mat, __zml_floating angle, __zml_floating x, __zml_floating y, __zml_floating z) {
 	if (mat->cols != 4 || mat->rows != 4) {
 		printf("zetaml: zmlRotate(): given matrix is not 4x4, no transformation performed!\n");
-	}
-	// if there is no rotation then skip the rest of the function
-	if (angle == (__zml_floating) 0.0 || (
-		x == (__zml_floating) 0.0 &&
-		y == (__zml_floating) 0.0 &&
-		z == (__zml_floating) 0.0
-	)) {
 		return;
 	}
 
-	const __zml_floating cos_angle = (__zml_floating) cos(angle);
-	const __zml_floating sin_angle = (__zml_floating) sin(angle);
-	zmlMatrix rotated = zmlZeroMatrix(4, 4);
-
-	// create a unit vector with axes
-	zmlVector axes = zmlAllocVector(3);
-	axes.elements[0] = x;
-	axes.elements[1] = y;
-	axes.elements[2] = z;
-	zmlNormalise(&axes);
-	
-	// i have not got a clue:
-
-	zmlVector temp = zmlMultiplyVecScalar_r(axes, (__zml_floating) 1.0 - cos_angle);
-
-	rotated.elements[0][0] = cos_angle + temp.elements[0] * axes.elements[0];
-	rotated.elements[1][0] = temp.elements[0] * axes.elements[1] + sin_angle * axes.elements[2];
-	rotated.elements[2][0] = temp.elements[0] * axes.elements[2] - sin_angle * axes.elements[1];
-
-	rotated.elements[0][1] = temp.elements[1] * axes.elements[0] - sin_angle * axes.elements[2];
-	rotated.elements[1][1] = cos_angle + temp.elements[1] * axes.elements[1];
-	rotated.elements[2][1] = temp.elements[1] * axes.elements[2] + sin_angle * axes.elements[0];
-
-	rotated.elements[0][2] = temp.elements[2] * axes.elements[0] + sin_angle * axes.elements[1];
-	rotated.elements[1][2] = temp.elements[2] * axes.elements[1] - sin_angle * axes.elements[0];
-	rotated.elements[2][2] = cos_angle + temp.elements[2] * axes.elements[2];
-
-	zmlMatrix result = zmlCopyMatrix(mat);
-
-	// apply this rotated matrix onto mat
-	for (unsigned int i = 0; i < 3; i++) {
-		// get columns from mat + store them as vectors in a buffer array
-		zmlVector matcols[3];
-		for (unsigned int ii = 0; ii < 3; ii++) matcols[ii] = zmlGetMatrixCol(*mat, ii);
-
-		// col is the resulting column that will replace the current column in the result matrix
-		zmlVector col = zmlConstructVectorDefault(4, (__zml_floating) 0.0);
-
-		for (unsigned int j = 0; j < 3; j++) {
-			// multiply each matcol by the appropriate element in rotated
-			zmlVector m = zmlMultiplyVecScalar_r(matcols[j], rotated.elements[j][i]);
-			// add the product of this to col
-			zmlAddVecs(&col, m);
-
-			zmlFreeVector(&m);
-		}
-
-		// update the columns in result
-		zmlSetMatrixCol(&result, i, col);
-
-		for (unsigned int ii = 0; ii < 3; ii++) zmlFreeVector(&matcols[ii]);
-		zmlFreeVector(&col);
+	// rotate the matrix where it is (if there is no rotation then it is left unchanged)
+	__zml_floating rotation[3][3];
+	if (_zml_axisAngleRotation(rotation, angle, x, y, z)) {
+		_zml_rotateRows(mat->data, mat->stride, rotation);
 	}
-
-	// return r into mat
-	zmlFreeMatrix(mat);
-	*mat = zmlCopyMatrix(&result);
-	
-	zmlFreeVector(&axes);
-	zmlFreeVector(&temp);
-	zmlFreeMatrix(&result);
-	zmlFreeMatrix(&rotated);
 }
 /**
  * @brief produces a rotation matrix by rotating a new identity matrix by angle on the given axes.
@@ -187,6 +139,54 @@ zmlMatrix zmlRotateIdentity(__zml_floating angle, __zml_floating x, __zml_floati
 	return r;
 }
 
+/**
+ * @brief produces a rotation matrix by rotating mat by the Euler angles x, y and z, in one step.
+ * ZML_EULER_XYZ gives the same result as rotating by x about the X axis, then y about the Y axis, then z about the Z axis with zmlRotated().
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+zmlMatrix zmlRotatedEuler(zmlMatrix mat, zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	zmlMatrix r = zmlCopyMatrix(&mat);
+	zmlRotateEuler(&r, order, x, y, z);
+	return r;
+}
+/**
+ * @brief alternative to zmlRotatedEuler() that modifies mat instead of allocating and returning a new matrix.
+ * 
+ * @param mat the matrix to base the rotation matrix on.
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+void zmlRotateEuler(zmlMatrix *mat, zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	if (mat->cols != 4 || mat->rows != 4) {
+		printf("zetaml: zmlRotateEuler(): given matrix is not 4x4, no transformation performed!\n");
+		return;
+	}
+
+	__zml_floating rotation[3][3];
+	_zml_eulerRotation(rotation, order, x, y, z);
+	_zml_rotateRows(mat->data, mat->stride, rotation);
+}
+/**
+ * @brief produces a rotation matrix by rotating a new identity matrix by the Euler angles x, y and z.
+ * 
+ * @param order the order that the three rotations are applied in.
+ * @param x the angle to rotate about the X axis by.
+ * @param y the angle to rotate about the Y axis by.
+ * @param z the angle to rotate about the Z axis by.
+ */
+zmlMatrix zmlRotateIdentityEuler(zmlEulerOrder order, __zml_floating x, __zml_floating y, __zml_floating z) {
+	zmlMatrix r = zmlIdentityMatrix(4, 4);
+	zmlRotateEuler(&r, order, x, y, z);
+	return r;
+}
+
 /**
  * @brief produces a scale matrix from a given matrix (mat) and the desired 3D vector vec. 
  * 
@@ -208,6 +208,7 @@ zmlMatrix zmlScaled(zmlMatrix *mat, zmlVector vec) {
 void zmlScale(zmlMatrix *mat, zmlVector vec) {
 	if (mat->cols != 4 || mat->rows != 4) {
 		printf("zetaml: zmlScale(): given matrix is not 4x4, no transformation performed!\n");
+		return;
 	}
 	if (vec.size != 3) {
 		printf("zetaml: zmlScale(): given vector is not of size 3, no transformation performed!\n");
@@ -218,24 +219,13 @@ void zmlScale(zmlMatrix *mat, zmlVector vec) {
 		return;
 	}
 
-	zmlMatrix r = zmlCopyMatrix(mat);
-
 	// the fourth column, similarly to in zmlRotate(), is not modified.
-	for (unsigned int i = 0; i < 3; i++) {
-		zmlVector col = zmlGetMatrixCol(*mat, i);
-		zmlMultiplyVecScalar(&col, vec.elements[i]);
-
-		// update column in r
-		zmlSetMatrixCol(&r, i, col);
-
-		zmlFreeVector(&col);
+	for (unsigned int r = 0; r < 4; r++) {
+		__zml_floating *row = &_zml_at(*mat, r, 0);
+		for (unsigned int i = 0; i < 3; i++) {
+			row[i] *= vec.elements[i];
+		}
 	}
-
-	// return r
-	zmlFreeMatrix(mat);
-	*mat = zmlCopyMatrix(&r);
-
-	zmlFreeMatrix(&r);
 }
 
 /**
@@ -298,14 +288,14 @@ void zmlUpdateOrthoMatrixLH(zmlMatrix *mat, __zml_floating lm, __zml_floating rm
 	}
 	
 	// set the scale of the matrix to the given values
-	mat->elements[0][0] = 2 / (rm - lm);
-	mat->elements[1][1] = 2 / (tm - bm);
-	mat->elements[2][2] = 2 / (zf - zn);
+	_zml_at(*mat, 0, 0) = 2 / (rm - lm);
+	_zml_at(*mat, 1, 1) = 2 / (tm - bm);
+	_zml_at(*mat, 2, 2) = 2 / (zf - zn);
 
 	// set the translation of the matrix to the given values.
-	mat->elements[0][3] = -(rm + lm) / (rm - lm);
-	mat->elements[1][3] = -(tm + bm) / (tm - bm);
-	mat->elements[2][3] = -(zf + zn) / (zf - zn);
+	_zml_at(*mat, 0, 3) = -(rm + lm) / (rm - lm);
+	_zml_at(*mat, 1, 3) = -(tm + bm) / (tm - bm);
+	_zml_at(*mat, 2, 3) = -(zf + zn) / (zf - zn);
 }
 /**
  * @brief  modifies a matrix to be an orthographic projection matrix based on the given values. Uses right-handed coordinates!
@@ -325,14 +315,14 @@ void zmlUpdateOrthoMatrixRH(zmlMatrix *mat, __zml_floating lm, __zml_floating rm
 	}
 	
 	// set the scale of the matrix to the given values
-	mat->elements[0][0] = 2 / (rm - lm);
-	mat->elements[1][1] = 2 / (tm - bm);
-	mat->elements[2][2] = -2 / (zf - zn);
+	_zml_at(*mat, 0, 0) = 2 / (rm - lm);
+	_zml_at(*mat, 1, 1) = 2 / (tm - bm);
+	_zml_at(*mat, 2, 2) = -2 / (zf - zn);
 
 	// set the translation of the matrix to the given values.
-	mat->elements[0][3] = -(rm + lm) / (rm - lm);
-	mat->elements[1][3] = -(tm + bm) / (tm - bm);
-	mat->elements[2][3] = -(zf + zn) / (zf - zn);
+	_zml_at(*mat, 0, 3) = -(rm + lm) / (rm - lm);
+	_zml_at(*mat, 1, 3) = -(tm + bm) / (tm - bm);
+	_zml_at(*mat, 2, 3) = -(zf + zn) / (zf - zn);
 }
 
 
@@ -379,13 +369,14 @@ void zmlUpdatePerspectiveMatrixLH(zmlMatrix *mat, __zml_floating near, __zml_flo
 	
 	const __zml_floating tfovy_half = tan(fovy / 2);
 
-	mat->elements[0][0] = 1 / (aspect_ratio * tfovy_half);
-	mat->elements[1][1] = 1 / tfovy_half;
+	_zml_at(*mat, 0, 0) = 1 / (aspect_ratio * tfovy_half);
+	_zml_at(*mat, 1, 1) = 1 / tfovy_half;
 
-	mat->elements[2][2] = (near + far) / (far - near);
-	mat->elements[3][2] = 1;
+	_zml_at(*mat, 2, 2) = (near + far) / (far - near);
+	_zml_at(*mat, 3, 2) = 1;
+	_zml_at(*mat, 3, 3) = 0; // (w is the depth alone)
 
-	mat->elements[2][3] = -(2 * far * near) / (far - near);
+	_zml_at(*mat, 2, 3) = -(2 * far * near) / (far - near);
 }
 /**
  * @brief modifies a matrix to be a perspective projection matrix based on the given values. Uses right-handed coordinates!
@@ -403,13 +394,14 @@ void zmlUpdatePerspectiveMatrixRH(zmlMatrix *mat, __zml_floating near, __zml_flo
 	
 	const __zml_floating tfovy_half = tan(fovy / 2);
 
-	mat->elements[0][0] = 1 / (aspect_ratio * tfovy_half);
-	mat->elements[1][1] = 1 / tfovy_half;
+	_zml_at(*mat, 0, 0) = 1 / (aspect_ratio * tfovy_half);
+	_zml_at(*mat, 1, 1) = 1 / tfovy_half;
 
-	mat->elements[2][2] = -(near + far) / (far - near);
-	mat->elements[3][2] = -1;
+	_zml_at(*mat, 2, 2) = -(near + far) / (far - near);
+	_zml_at(*mat, 3, 2) = -1;
+	_zml_at(*mat, 3, 3) = 0; // (w is the depth alone)
 
-	mat->elements[2][3] = -(2 * far * near) / (far - near);
+	_zml_at(*mat, 2, 3) = -(2 * far * near) / (far - near);
 }
 
 /**
@@ -421,7 +413,9 @@ void zmlUpdatePerspectiveMatrixRH(zmlMatrix *mat, __zml_floating near, __zml_flo
  */
 zmlMatrix zmlConstructLookAtMatrixLH(zmlVector pos, zmlVector focus, zmlVector up) {
 	zmlMatrix r = zmlIdentityMatrix(4, 4);
-	zmlUpdateLookAtMatrixLH(&r, pos, focus, up);
+	if (_zml_checkLookAtVectors(pos, focus, up, "zmlConstructLookAtMatrixLH")) {
+		zmlUpdateLookAtMatrixLH(&r, pos, focus, up);
+	}
 	return r;
 }
 /**
@@ -433,7 +427,9 @@ zmlMatrix zmlConstructLookAtMatrixLH(zmlVector pos, zmlVector focus, zmlVector u
  */
 zmlMatrix zmlConstructLookAtMatrixRH(zmlVector pos, zmlVector focus, zmlVector up) {
 	zmlMatrix r = zmlIdentityMatrix(4, 4);
-	zmlUpdateLookAtMatrixRH(&r, pos, focus, up);
+	if (_zml_checkLookAtVectors(pos, focus, up, "zmlConstructLookAtMatrixRH")) {
+		zmlUpdateLookAtMatrixRH(&r, pos, focus, up);
+	}
 	return r;
 }
 
@@ -446,41 +442,12 @@ zmlMatrix zmlConstructLookAtMatrixRH(zmlVector pos, zmlVector focus, zmlVector u
  * @param up an absolute unit vector indicating the up direction. If Y is the 'up' axis, set this to be ( 0, 1, 0 ), for example.
  */
 void zmlUpdateLookAtMatrixLH(zmlMatrix *mat, zmlVector pos, zmlVector focus, zmlVector up) {
-	// the direction the camera is facing in (reverse to the actual direction, must be negated when used)
-	zmlVector dir = zmlSubtractVecs_r(focus, pos); zmlNormalise(&dir);
-	// right direction relative to the camera's direction
-	zmlVector right = zmlCross(dir, up); zmlNormalise(&right);
-	// up direction relative to the camera's direction
-	zmlVector rup = zmlCross(right, dir);
-
-	zmlMatrix r = zmlIdentityMatrix(4, 4);
+	if (!_zml_checkLookAtVectors(pos, focus, up, "zmlUpdateLookAtMatrixLH")) {
+		return;
+	}
 
-	// first row = relative right direction
-	zmlSetMatrixRow(&r, 0, right);
-	// second row = relative up direction
-	zmlSetMatrixRow(&r, 1, rup);
-	// third row = relative forward direction
-	zmlSetMatrixRow(&r, 2, dir);
-
-	// fourth column = dot product of the vector on each row and the position of the camera
-	// the fourth element in this column is left unchanged (identity matrix, so 1)
-	zmlVector fcol = zmlAllocVector(3);
-	fcol.elements[0] = -zmlDot(right, pos);
-	fcol.elements[1] = -zmlDot(rup, pos);
-	fcol.elements[2] = -zmlDot(dir, pos);
-	zmlSetMatrixCol(&r, 3, fcol);
-
-	// (the fourth row is therefore kept as [ 0, 0, 0, 1 ].)
-
-	// return r into mat
-	zmlFreeMatrix(mat);
-	*mat = zmlCopyMatrix(&r);
-
-	zmlFreeVector(&dir);
-	zmlFreeVector(&right);
-	zmlFreeVector(&rup);
-	zmlFreeVector(&fcol);
-	zmlFreeMatrix(&r);
+	zmlMat4 r = zmlConstructLookAtMat4LH(_zml_toVec3(pos), _zml_toVec3(focus), _zml_toVec3(up));
+	_zml_storeMat4(mat, &r);
 }
 /**
  * @brief modifies a matrix to be a look-at matrix based on the given values. Uses right-handed coordinates!
@@ -491,43 +458,10 @@ void zmlUpdateLookAtMatrixLH(zmlMatrix *mat, zmlVector pos, zmlVector focus, zml
  * @param up an absolute unit vector indicating the up direction. If Y is the 'up' axis, set this to be ( 0, 1, 0 ), for example.
  */
 void zmlUpdateLookAtMatrixRH(zmlMatrix *mat, zmlVector pos, zmlVector focus, zmlVector up) {
-	// the direction the camera is facing in (reverse to the actual direction, must be negated when used)
-	zmlVector dir = zmlSubtractVecs_r(focus, pos); zmlNormalise(&dir);
-	// right direction relative to the camera's direction
-	zmlVector right = zmlCross(dir, up); zmlNormalise(&right);
-	// up direction relative to the camera's direction
-	zmlVector rup = zmlCross(right, dir);
-
-	zmlMatrix r = zmlIdentityMatrix(4, 4);
+	if (!_zml_checkLookAtVectors(pos, focus, up, "zmlUpdateLookAtMatrixRH")) {
+		return;
+	}
 
-	// negative version of dir (for right handed coords)
-	zmlVector ndir = zmlMultiplyVecScalar_r(dir, -1);
-
-	// first row = relative right direction
-	zmlSetMatrixRow(&r, 0, right);
-	// second row = relative up direction
-	zmlSetMatrixRow(&r, 1, rup);
-	// third row = relative forward direction (reverse)
-	zmlSetMatrixRow(&r, 2, ndir);
-
-	// fourth column = dot product of the vector on each row and the position of the camera
-	// the fourth element in this column is left unchanged (identity matrix, so 1)
-	zmlVector fcol = zmlAllocVector(3);
-	fcol.elements[0] = -zmlDot(right, pos);
-	fcol.elements[1] = -zmlDot(rup, pos);
-	fcol.elements[2] = zmlDot(dir, pos);
-	zmlSetMatrixCol(&r, 3, fcol);
-
-	// (the fourth row is therefore kept as [ 0, 0, 0, 1 ].)
-
-	// return r into mat
-	zmlFreeMatrix(mat);
-	*mat = zmlCopyMatrix(&r);
-
-	zmlFreeVector(&dir);
-	zmlFreeVector(&ndir);
-	zmlFreeVector(&right);
-	zmlFreeVector(&rup);
-	zmlFreeVector(&fcol);
-	zmlFreeMatrix(&r);
+	zmlMat4 r = zmlConstructLookAtMat4RH(_zml_toVec3(pos), _zml_toVec3(focus), _zml_toVec3(up));
+	_zml_storeMat4(mat, &r);
 }
@@ -30,129 +30,263 @@ __zml_floating zmlToRadians(__zml_floating deg) {
 	return deg * (PI / (__zml_floating) 180.0);
 }
 
-/**
- * @brief Takes a vector value, val, and converts it to a formatted string.
- * 
- * @param val the vector to format and express as a string.
- * @param str the string to return the value into.
- */
-void zmlToStringV(zmlVector val, char *str) {
-	// TODO: this function can probably be optimised!
+// ---- formatting ----
+
+// the longest %.5f representation of a floating value (the largest double has 309 integer digits, plus a sign, point, 5 decimals and null terminator).
+#define _ZML_MAX_FLOATING_CHARS 320
+
+// values whose magnitude (times 10^5) can be held exactly as an integer in a double are formatted directly; anything larger goes through snprintf().
+#define _ZML_FAST_FORMAT_LIMIT 9.0e10
+
+// the decimal digits of every number from 00 to 99, so that two digits are written at a time.
+static const char _zml_digitPairs[201] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+// an output that formatted text is written to in a single pass: either a string (which is never written beyond its size, like snprintf()) or a stream.
+typedef struct {
+	char *str; // destination string (NULL when writing to a stream)
+	size_t size; // space available in str, including the null terminator
+	FILE *file; // destination stream (NULL when writing to a string)
+	size_t len; // characters produced so far (including any that didn't fit in str)
+	size_t written; // characters successfully written to the stream so far
+	size_t buffered; // characters waiting in chunk to be written to the stream
+	char chunk[4096];
+} _zml_formatter;
+
+static void _zml_flushFormatter(_zml_formatter *f) {
+	if (f->buffered) {
+		f->written += fwrite(f->chunk, 1, f->buffered, f->file);
+		f->buffered = 0;
+	}
+}
+
+static void _zml_emit(_zml_formatter *f, const char *s, size_t n) {
+	if (f->file) {
+		// gather small pieces into whole chunks so the stream isn't called once per element.
+		if (f->buffered + n > sizeof(f->chunk)) {
+			_zml_flushFormatter(f);
+		}
+		if (n > sizeof(f->chunk)) {
+			f->written += fwrite(s, 1, n, f->file);
+		} else {
+			memcpy(f->chunk + f->buffered, s, n);
+			f->buffered += n;
+		}
+	} else if (f->len + 1 < f->size) {
+		size_t room = f->size - 1 - f->len;
+		memcpy(f->str + f->len, s, (n < room) ? n : room);
+	}
+
+	f->len += n;
+}
 
-	// getting the total maximum length of the string
-	// start off with 1 for null terminator.
-	unsigned int maxlen = 1;
+// write val as printf("%.5f") would into out (which must have space for _ZML_MAX_FLOATING_CHARS characters), returning its length.
+static size_t _zml_formatFloating(__zml_floating val, char *out) {
+	double x = (double) val;
+	double ax = fabs(x);
 
-	// each number (floating-point so digits + 5 decimal places + decimal point + potential minus sign) + ", " on every one (except the last)
-	for (unsigned int i = 0; i < val.size - 1; i++) {
-		maxlen += _zml_getDigitsi(val.elements[i]) + 9;
+	// infinity, NaN and very large values are rare enough to leave to the C library.
+	if (!(ax < _ZML_FAST_FORMAT_LIMIT)) {
+		int n = snprintf(out, _ZML_MAX_FLOATING_CHARS, "%.5f", x);
+		return (n < 0) ? 0 : (size_t) n;
 	}
-	maxlen += _zml_getDigitsi(val.elements[val.size - 1]) + 7;
 
-	// (this is a good time to allocate memory for the list of comma-separated values)
-	char elementsbuffer[maxlen];
-	memset(elementsbuffer, 0, maxlen);
+	// round |x| * 10^5 to the nearest integer (ties to even, as printf does). the product isn't always exact in a double,
+	// so its rounding error (lo) is recovered with fma() and used to decide which way to round.
+	double hi = ax * 100000.0;
+	double lo = fma(ax, 100000.0, -hi);
+	double whole = floor(hi);
+	double half = (hi - whole - 0.5) + lo; // sign of (the exact fraction - 0.5)
+	uint64_t fixed = (uint64_t) whole;
+	if (half > 0 || (half == 0 && (fixed & 1))) {
+		fixed++;
+	}
 
-	// there is also "( " and " )" on either side (4) AND the type descriptor (+ ()). This is "vec[size]" so it is 9 + however-many-digits characters long + null term.
-	maxlen += 10 + _zml_getDigitsi(val.size);
-	
-	// the list of elements is in the format 3, 6, 8, 2, ...
-	for (unsigned int i = 0; i < val.size; i++) {
-		// the amount of digits in the number
-		unsigned int numdigits = _zml_getDigitsi(val.elements[i]) + 6; // digits + 5 decimals + decimal point.
+	uint64_t ipart = fixed / 100000;
+	unsigned int fpart = (unsigned int) (fixed % 100000);
 
-		char e[numdigits + 3]; // 3 because of ", \0"
-		snprintf(e, numdigits + 3, "%.5f", val.elements[i]);
+	// build the number backwards from the last decimal place.
+	char tmp[24];
+	char *p = tmp + sizeof(tmp);
 
-		if (i < val.size - 1) {
-			strncat(e, ", ", 3);
-		}
+	*--p = (char) ('0' + fpart % 10);
+	fpart /= 10;
+	for (int i = 0; i < 2; i++) {
+		p -= 2;
+		memcpy(p, _zml_digitPairs + (fpart % 100) * 2, 2);
+		fpart /= 100;
+	}
+	*--p = '.';
 
-		strncat(elementsbuffer, e, numdigits + 3);
+	while (ipart >= 100) {
+		p -= 2;
+		memcpy(p, _zml_digitPairs + (ipart % 100) * 2, 2);
+		ipart /= 100;
+	}
+	if (ipart >= 10) {
+		p -= 2;
+		memcpy(p, _zml_digitPairs + ipart * 2, 2);
+	} else {
+		*--p = (char) ('0' + ipart);
 	}
 
-	// combine all of this into the resulting string 'r'
-	char r[maxlen];
-	memset(r, 0, maxlen);
-	snprintf(r, maxlen, "(vec%d) ( %s )", val.size, elementsbuffer);
+	// printf keeps the sign of negative values that round to zero ("-0.00000"), so check the sign bit rather than the rounded value.
+	if (signbit(x)) {
+		*--p = '-';
+	}
 
-	strncpy(str, r, maxlen);
+	size_t n = (size_t) (tmp + sizeof(tmp) - p);
+	memcpy(out, p, n);
+	return n;
 }
 
-/**
- * @brief Takes a matrix value, val, and converts it to a formatted string.
- * 
- * @param val the matrix to format and express as a string.
- * @param str the string to return the value into.
- */
-void zmlToStringM(zmlMatrix val, char *str) {
-	// TODO: this function can probably be optimised!
-
-	// getting the amount of characters in the type descriptor to indent each line if necessary
-	// 'mat' plus cols + 'x' + rows e.g. mat2x2 (also a space) + brackets
-	unsigned int typedescramt = 7 + _zml_getDigitsi(val.cols) + _zml_getDigitsi(val.rows);
+static void _zml_emitFloating(_zml_formatter *f, __zml_floating val) {
+	char num[_ZML_MAX_FLOATING_CHARS];
+	_zml_emit(f, num, _zml_formatFloating(val, num));
+}
 
-	// getting the total maximum length of the string
-	// start off with 1 for null terminator.
-	unsigned int maxlen = 1;
+// format a vector as "(vecN) ( a, b, ... )".
+static void _zml_formatVector(_zml_formatter *f, zmlVector val) {
+	char head[32];
+	int n = snprintf(head, sizeof(head), "(vec%u) ( ", val.size);
+	_zml_emit(f, head, (size_t) n);
 
-	// get the total amount of space for just the elements + commas
-	for (unsigned int r = 0; r < val.rows; r++) {
-		// each number in the row (floating-point so digits + 5 decimal places + decimal point + potential minus sign) + ", " on every one (except the last in the row)
-		for (unsigned int c = 0; c < val.cols - 1; c++) {
-			maxlen += _zml_getDigitsi(val.elements[r][c]) + 9;
+	for (unsigned int i = 0; i < val.size; i++) {
+		if (i > 0) {
+			_zml_emit(f, ", ", 2);
 		}
-		maxlen += _zml_getDigitsi(val.elements[r][val.cols - 1]) + 7;
+		_zml_emitFloating(f, val.elements[i]);
 	}
 
-	// loop through each row
-	for (unsigned int r = 0; r < val.rows; r++) {
-		// each row has the indentation of the type descriptor + '[ ' + ' ]' + a comma on each row except the last + newline
-		maxlen += typedescramt + 6;
-	}
+	_zml_emit(f, " )", 2);
+}
 
-	// start appending to the final string
-	char res[maxlen];
-	memset(res, 0, maxlen);
+// format a matrix as "(matCxR) [ a, b, ... ]," with each further row on its own line, indented to line up with the first.
+static void _zml_formatMatrix(_zml_formatter *f, zmlMatrix val) {
+	static const char spaces[] = "                                ";
 
-	// add the type descriptor first
-	snprintf(res, maxlen, "(mat%dx%d) ", val.cols, val.rows);
+	char head[32];
+	int n = snprintf(head, sizeof(head), "(mat%ux%u) ", val.cols, val.rows);
+	_zml_emit(f, head, (size_t) n);
 
-	// the list of elements is in the format 3, 6, 8, 2, ...
 	for (unsigned int r = 0; r < val.rows; r++) {
-		// indent every row after the first one (first one has the type descriptor before it anyway)
-		for (unsigned int i = 0; i < typedescramt && r > 0; i++) {
-			strncat(res, " ", 2);
+		if (r > 0) {
+			_zml_emit(f, ",\n", 2);
+			_zml_emit(f, spaces, (size_t) n); // (the type descriptor is never longer than spaces)
 		}
-		
-		strncat(res, "[ ", 3);
-		for (unsigned int c = 0; c < val.cols; c++) {
-			// the amount of digits in the number
-			unsigned int numdigits = _zml_getDigitsi(val.elements[r][c]) + 6; // digits + 5 decimals + decimal point.
 
-			// get current element as a string
-			// this is like this because it needs to be formatted as %.5f. otherwise I would just concatenate it directly onto res.
-			char e[numdigits + 3]; // 3 because of ", \0"
-			snprintf(e, numdigits + 3, "%.5f", val.elements[r][c]);
-
-			// append a comma to each element in the row
-			if (c < val.cols - 1) {
-				strncat(e, ", ", 3);
+		_zml_emit(f, "[ ", 2);
+		for (unsigned int c = 0; c < val.cols; c++) {
+			if (c > 0) {
+				_zml_emit(f, ", ", 2);
 			}
-
-			// add the element to the elementsbuffer string.
-			strncat(res, e, numdigits + 3);
+			_zml_emitFloating(f, _zml_at(val, r, c));
 		}
-		strncat(res, " ]", 3);
+		_zml_emit(f, " ]", 2);
+	}
+}
 
-		// add a newline and a comma to every row except the last.
-		if (r < val.rows - 1) {
-			strncat(res, ",\n", 3);
-		}
+static void _zml_initFormatter(_zml_formatter *f, char *str, size_t size, FILE *file) {
+	f->str = str;
+	f->size = (str) ? size : 0;
+	f->file = file;
+	f->len = 0;
+	f->written = 0;
+	f->buffered = 0;
+}
+
+// null-terminate a string formatter's output (truncated if necessary) and return the length of the full output.
+static size_t _zml_finishString(_zml_formatter *f) {
+	if (f->size > 0) {
+		f->str[(f->len < f->size) ? f->len : f->size - 1] = '\0';
 	}
+	return f->len;
+}
+
+/**
+ * @brief Formats a vector value, val, into the string str, writing at most size characters (including the null terminator).
+ * Like snprintf(), the output is truncated if it doesn't fit but is always null-terminated (as long as size is not 0), and
+ * the length of the full output is returned - so zmlFormatV(val, NULL, 0) + 1 is the size needed to hold it.
+ * 
+ * @param val the vector to format.
+ * @param str the string to write the output into (may be NULL if size is 0).
+ * @param size the amount of space available in str.
+ */
+size_t zmlFormatV(zmlVector val, char *str, size_t size) {
+	_zml_formatter f;
+	_zml_initFormatter(&f, str, size, NULL);
+	_zml_formatVector(&f, val);
+	return _zml_finishString(&f);
+}
+
+/**
+ * @brief Formats a matrix value, val, into the string str, writing at most size characters (including the null terminator).
+ * Like snprintf(), the output is truncated if it doesn't fit but is always null-terminated (as long as size is not 0), and
+ * the length of the full output is returned - so zmlFormatM(val, NULL, 0) + 1 is the size needed to hold it.
+ * 
+ * @param val the matrix to format.
+ * @param str the string to write the output into (may be NULL if size is 0).
+ * @param size the amount of space available in str.
+ */
+size_t zmlFormatM(zmlMatrix val, char *str, size_t size) {
+	_zml_formatter f;
+	_zml_initFormatter(&f, str, size, NULL);
+	_zml_formatMatrix(&f, val);
+	return _zml_finishString(&f);
+}
 
-	// return res
-	strncpy(str, res, maxlen);
+/**
+ * @brief Writes the formatted vector value, val, straight to the stream file (without building the string in memory first).
+ * The output is the same as zmlFormatV()'s, with no new line added. Returns the number of characters written.
+ * 
+ * @param val the vector to format and write.
+ * @param file the stream to write to.
+ */
+size_t zmlFPrintV(zmlVector val, FILE *file) {
+	_zml_formatter f;
+	_zml_initFormatter(&f, NULL, 0, file);
+	_zml_formatVector(&f, val);
+	_zml_flushFormatter(&f);
+	return f.written;
+}
+
+/**
+ * @brief Writes the formatted matrix value, val, straight to the stream file (without building the string in memory first).
+ * The output is the same as zmlFormatM()'s, with no new line added. Returns the number of characters written.
+ * 
+ * @param val the matrix to format and write.
+ * @param file the stream to write to.
+ */
+size_t zmlFPrintM(zmlMatrix val, FILE *file) {
+	_zml_formatter f;
+	_zml_initFormatter(&f, NULL, 0, file);
+	_zml_formatMatrix(&f, val);
+	_zml_flushFormatter(&f);
+	return f.written;
+}
+
+/**
+ * @brief Takes a vector value, val, and converts it to a formatted string.
+ * str must be large enough to hold the result: use zmlFormatV() to find the size needed, or to format into a buffer of limited size.
+ * 
+ * @param val the vector to format and express as a string.
+ * @param str the string to return the value into.
+ */
+void zmlToStringV(zmlVector val, char *str) {
+	zmlFormatV(val, str, SIZE_MAX);
+}
+
+/**
+ * @brief Takes a matrix value, val, and converts it to a formatted string.
+ * str must be large enough to hold the result: use zmlFormatM() to find the size needed, or to format into a buffer of limited size.
+ * 
+ * @param val the matrix to format and express as a string.
+ * @param str the string to return the value into.
+ */
+void zmlToStringM(zmlMatrix val, char *str) {
+	zmlFormatM(val, str, SIZE_MAX);
 }
 
 /**
@@ -161,16 +295,8 @@ void zmlToStringM(zmlMatrix val, char *str) {
  * @param val the vector to format and print.
  */
 void zmlPrintV(zmlVector val) {
-	// get the length of the string
-	// yes, this is a mess - it is also done in zmlToStringV() but in a more readable format (and it's commented).
-	unsigned int maxlen = 18 + _zml_getDigitsi(val.elements[val.size - 1]) + _zml_getDigitsi(val.size);
-	for (unsigned int i = 0; i < val.size - 1; i++) maxlen += _zml_getDigitsi(val.elements[i]) + 9;
-
-	char r[maxlen];
-	memset(r, 0, maxlen);
-	zmlToStringV(val, r);
-
-	printf("%s\n", r);
+	zmlFPrintV(val, stdout);
+	putchar('\n');
 }
 
 /**
@@ -179,19 +305,8 @@ void zmlPrintV(zmlVector val) {
  * @param val the matrix to format and print.
  */
 void zmlPrintM(zmlMatrix val) {
-	// get the length of the string
-	// NEVER touch this code. it works fine
-	unsigned int maxlen = 1 + (val.rows * ((7 + _zml_getDigitsi(val.cols) + _zml_getDigitsi(val.rows)) + 6));
-	for (unsigned int r = 0; r < val.rows; r++) {
-		for (unsigned int c = 0; c < val.cols - 1; c++) maxlen += _zml_getDigitsi(val.elements[r][c]) + 9;
-		maxlen += _zml_getDigitsi(val.elements[r][val.cols - 1]) + 7;
-	}
-
-	char r[maxlen];
-	memset(r, 0, maxlen);
-	zmlToStringM(val, r);
-
-	printf("%s\n", r);
+	zmlFPrintM(val, stdout);
+	putchar('\n');
 }
 
 /**
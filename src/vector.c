@@ -17,19 +17,36 @@
  * @brief An undefined vector; no dimension.
  * 
  */
-const zmlVector ZML_NULL_VECTOR = { 0, NULL };
+const zmlVector ZML_NULL_VECTOR = { 0, NULL, 0 };
+
+// vectors at least this long have their elements aligned to ZML_ALIGNMENT; shorter ones only get the alignment
+// malloc() would give them, so that small vectors don't waste most of their memory on padding.
+#define _ZML_ALIGNED_VECTOR_SIZE 32
+
+static size_t _zml_vectorAlignment(unsigned int capacity) {
+	return (capacity >= _ZML_ALIGNED_VECTOR_SIZE) ? ZML_ALIGNMENT : 2 * sizeof(void *);
+}
 
 /**
  * @brief Allocate memory for a vector struct, and return the empty vector. Elements are NOT initialised!
  * 
  * @param size the size of the vector.
  */
-
 zmlVector zmlAllocVector(unsigned int size) {
+	return zmlAllocVectorAligned(size, _zml_vectorAlignment(size));
+}
+/**
+ * @brief Allocate memory for a vector whose elements start at a multiple of the given alignment (e.g. 32 or 64 bytes). Elements are NOT initialised!
+ * 
+ * @param size the size of the vector.
+ * @param alignment the alignment, in bytes, of the elements. Must be a power of 2.
+ */
+zmlVector zmlAllocVectorAligned(unsigned int size, size_t alignment) {
 	zmlVector r;
 	r.size = size;
-	r.elements = (__zml_floating *) malloc(3 * size * sizeof(__zml_floating));
-	
+	r.capacity = size;
+	r.elements = (__zml_floating *) _zml_alloc((size_t) size * sizeof(__zml_floating), alignment);
+
 	return r;
 }
 /**
@@ -38,10 +55,80 @@ zmlVector zmlAllocVector(unsigned int size) {
  * @param vec the vector to free.
  */
 void zmlFreeVector(zmlVector *vec) {
-	free(vec->elements);
+	_zml_free(vec->elements);
 
 	vec->elements = NULL;
 	vec->size = 0;
+	vec->capacity = 0;
+}
+
+/**
+ * @brief make sure a vector has room for at least capacity elements without reallocating. Its size and elements are not changed.
+ * 
+ * @param vec the vector to modify.
+ * @param capacity the number of elements to make room for.
+ */
+void zmlReserveVector(zmlVector *vec, unsigned int capacity) {
+	if (capacity <= vec->capacity) {
+		return;
+	}
+
+	// keep any stronger alignment the elements were allocated with
+	size_t alignment = _zml_vectorAlignment(capacity);
+	uintptr_t addr = (uintptr_t) vec->elements;
+	if (addr && (addr & (ZML_ALIGNMENT - 1)) == 0) {
+		alignment = ZML_ALIGNMENT;
+	}
+
+	__zml_floating *elements = (__zml_floating *) _zml_alloc((size_t) capacity * sizeof(__zml_floating), alignment);
+	if (!elements) {
+		return;
+	}
+	if (vec->size) {
+		memcpy(elements, vec->elements, vec->size * sizeof(__zml_floating));
+	}
+
+	_zml_free(vec->elements);
+	vec->elements = elements;
+	vec->capacity = capacity;
+}
+
+/**
+ * @brief change the size of a vector, keeping its existing elements. New elements are set to 0.
+ * Growing the vector reallocates it at most logarithmically often, as its capacity is at least doubled each time.
+ * 
+ * @param vec the vector to modify.
+ * @param size the new size of the vector.
+ */
+void zmlResizeVector(zmlVector *vec, unsigned int size) {
+	if (size > vec->capacity) {
+		zmlReserveVector(vec, (size > vec->capacity * 2) ? size : vec->capacity * 2);
+		if (size > vec->capacity) {
+			return;
+		}
+	}
+
+	for (unsigned int i = vec->size; i < size; i++) {
+		vec->elements[i] = (__zml_floating) 0.0;
+	}
+	vec->size = size;
+}
+
+/**
+ * @brief add an element onto the end of a vector (reallocating it, with room to spare, if it is full).
+ * 
+ * @param vec the vector to modify.
+ * @param val the value of the new element.
+ */
+void zmlAppendVector(zmlVector *vec, __zml_floating val) {
+	if (vec->size == vec->capacity) {
+		zmlReserveVector(vec, vec->capacity ? vec->capacity * 2 : 4);
+		if (vec->size == vec->capacity) {
+			return;
+		}
+	}
+
+	vec->elements[vec->size++] = val;
 }
 
 /**
@@ -68,23 +155,15 @@ zmlVector zmlConstructVectorDefault(unsigned int size, __zml_floating val) {
 zmlVector zmlConstructVector(unsigned int size, ...) {
 	zmlVector r = zmlAllocVector(size);
 
-	#ifdef ZML_USING_FLOATS
-		for (unsigned int i = 0; i < size; i++) {
-			r.elements[i] = 0;
-		}
-		
-		printf("zetaml: zmlConstructVector(): variadic arguments do not support floats; you could manually set elements instead. (zero vector returned)\n");
-	#else
-		va_list vl;
-		va_start(vl, size);
-
-		for (unsigned int i = 0; i < size; i++) {
-			r.elements[i] = va_arg(vl, __zml_floating);
-		}
-		va_end(vl);
+	// floating-point variadic arguments are always passed as doubles (floats are promoted), whatever __zml_floating is
+	va_list vl;
+	va_start(vl, size);
+
+	for (unsigned int i = 0; i < size; i++) {
+		r.elements[i] = (__zml_floating) va_arg(vl, double);
+	}
+	va_end(vl);
 
-	#endif
-	
 	return r;
 }
 
@@ -95,10 +174,7 @@ zmlVector zmlConstructVector(unsigned int size, ...) {
  */
 zmlVector zmlCopyVector(zmlVector *val) {
 	zmlVector r = zmlAllocVector(val->size);
-
-	for (unsigned int i = 0; i < val->size; i++) {
-		r.elements[i] = val->elements[i];
-	}
+	memcpy(r.elements, val->elements, val->size * sizeof(__zml_floating));
 
 	return r;
 }
@@ -116,12 +192,30 @@ zmlVector zmlCross(zmlVector v1, zmlVector v2) {
 	}
 
 	zmlVector r = zmlAllocVector(3);
+	zmlCrossInto(&r, v1, v2);
+	return r;
+}
+/**
+ * @brief write the cross product of v1 and v2 into dst, which must already be a 3-dimensional vector (and may be v1 or v2).
+ * 
+ * @param dst the vector to write the result into.
+ * @param v1 the first vector to operate on.
+ * @param v2 the second vector to operate on.
+ */
+void zmlCrossInto(zmlVector *dst, zmlVector v1, zmlVector v2) {
+	if (v1.size != 3 || v2.size != 3 || dst->size != 3) {
+		printf("zetaml: zmlCrossInto(): one or more given vectors are not 3-dimensional!\n");
+		return;
+	}
 
-	r.elements[0] = v1.elements[1] * v2.elements[2] - v1.elements[2] * v2.elements[1];
-	r.elements[1] = v1.elements[2] * v2.elements[0] - v1.elements[0] * v2.elements[2];
-	r.elements[2] = v1.elements[0] * v2.elements[1] - v1.elements[1] * v2.elements[0];
+	// (computed before anything is written, in case dst is v1 or v2)
+	__zml_floating x = v1.elements[1] * v2.elements[2] - v1.elements[2] * v2.elements[1];
+	__zml_floating y = v1.elements[2] * v2.elements[0] - v1.elements[0] * v2.elements[2];
+	__zml_floating z = v1.elements[0] * v2.elements[1] - v1.elements[1] * v2.elements[0];
 
-	return r;
+	dst->elements[0] = x;
+	dst->elements[1] = y;
+	dst->elements[2] = z;
 }
 
 /**
@@ -131,19 +225,13 @@ zmlVector zmlCross(zmlVector v1, zmlVector v2) {
  * @param v2 the second vector to operate on.
  */
 __zml_floating zmlDot(zmlVector v1, zmlVector v2) {
-	__zml_floating r = (__zml_floating) 0.0;
-
-	// add each vector element to the result, multiplied by the other equivalent element.
-	if (v1.size == v2.size) {
-		for (unsigned int i = 0; i < v1.size; i++) {
-			r += (__zml_floating) (v1.elements[i] * v2.elements[i]);
-		}
-	} else {
+	if (v1.size != v2.size) {
 		// 0 is returned if arguments are different dimensions
 		printf("zetaml: zmlDot(): the given vectors are of different sizes! 0 returned!\n");
+		return (__zml_floating) 0.0;
 	}
 
-	return r;
+	return _zml_kernels()->dot(v1.elements, v2.elements, v1.size);
 }
 
 /**
@@ -152,13 +240,7 @@ __zml_floating zmlDot(zmlVector v1, zmlVector v2) {
  * @param vec the specified vector.
  */
 __zml_floating zmlMagnitude(zmlVector vec) {
-	__zml_floating r = (__zml_floating) 0.0;
-
-	for (unsigned int i = 0; i < vec.size; i++) {
-		r += (__zml_floating) pow(vec.elements[i], 2); // add square of each element to r
-	}
-
-	return (__zml_floating) sqrt(r);
+	return (__zml_floating) sqrt(_zml_kernels()->sumSquares(vec.elements, vec.size));
 }
 
 /**
@@ -167,10 +249,19 @@ __zml_floating zmlMagnitude(zmlVector vec) {
  * @param vec the specified vector.
  */
 zmlVector zmlNormalised(zmlVector vec) {
-	zmlVector r = zmlCopyVector(&vec);
-	zmlNormalise(&r);
+	zmlVector r = zmlAllocVector(vec.size);
+	zmlNormalisedInto(&r, vec);
 	return r;
 }
+/**
+ * @brief write the given vector in its normalised state into dst, which must already be the same size (and may be vec).
+ * 
+ * @param dst the vector to write the result into.
+ * @param vec the specified vector.
+ */
+void zmlNormalisedInto(zmlVector *dst, zmlVector vec) {
+	zmlDivideVecScalarInto(dst, vec, zmlMagnitude(vec));
+}
 
 /**
  * @brief normalises (modifies) the specified vector.
@@ -188,96 +279,70 @@ void zmlNormalise(zmlVector *vec) {
 	}\
 }
 
-zmlVector zmlAddVecs_r(zmlVector v1, zmlVector v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_VECTOR);
-	zmlVector r = zmlCopyVector(&v1);
-	zmlAddVecs(&r, v2);
-	return r;
-}
-void zmlAddVecs(zmlVector *v1, zmlVector v2) {
-	_zml_assertSameSize((*v1), v2,);
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] += v2.elements[i];
-	}
-}
-zmlVector zmlSubtractVecs_r(zmlVector v1, zmlVector v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_VECTOR);
-	zmlVector r = zmlCopyVector(&v1);
-	zmlSubtractVecs(&r, v2);
-	return r;
-}
-void zmlSubtractVecs(zmlVector *v1, zmlVector v2) {
-	_zml_assertSameSize((*v1), v2,);
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] -= v2.elements[i];
-	}
-}
-zmlVector zmlMultiplyVecs_r(zmlVector v1, zmlVector v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_VECTOR);
-	zmlVector r = zmlCopyVector(&v1);
-	zmlMultiplyVecs(&r, v2);
-	return r;
-}
-void zmlMultiplyVecs(zmlVector *v1, zmlVector v2) {
-	_zml_assertSameSize((*v1), v2,);
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] *= v2.elements[i];
-	}
-}
-zmlVector zmlDivideVecs_r(zmlVector v1, zmlVector v2) {
-	_zml_assertSameSize(v1, v2, ZML_NULL_VECTOR);
-	zmlVector r = zmlCopyVector(&v1);
-	zmlDivideVecs(&r, v2);
-	return r;
-}
-void zmlDivideVecs(zmlVector *v1, zmlVector v2) {
-	_zml_assertSameSize((*v1), v2,);
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] /= v2.elements[i];
+// define the Into, _r and in-place versions of an element-wise operator, for two vectors and for a vector and a scalar.
+// the Into versions do all of the work; dst may be the same vector as either operand.
+#define _zml_defineVecOperators(name, op, scalarop) \
+	void zml##name##VecsInto(zmlVector *dst, zmlVector v1, zmlVector v2) {\
+		_zml_assertSameSize(v1, v2,);\
+		_zml_assertSameSize((*dst), v1,);\
+		_zml_applyElementwise(op, dst->elements, v1.elements, v2.elements, 0, v1.size);\
+	}\
+	zmlVector zml##name##Vecs_r(zmlVector v1, zmlVector v2) {\
+		_zml_assertSameSize(v1, v2, ZML_NULL_VECTOR);\
+		zmlVector r = zmlAllocVector(v1.size);\
+		zml##name##VecsInto(&r, v1, v2);\
+		return r;\
+	}\
+	void zml##name##Vecs(zmlVector *v1, zmlVector v2) {\
+		zml##name##VecsInto(v1, *v1, v2);\
+	}\
+	void zml##name##VecScalarInto(zmlVector *dst, zmlVector v1, __zml_floating v2) {\
+		_zml_assertSameSize((*dst), v1,);\
+		_zml_applyElementwise(scalarop, dst->elements, v1.elements, NULL, v2, v1.size);\
+	}\
+	zmlVector zml##name##VecScalar_r(zmlVector v1, __zml_floating v2) {\
+		zmlVector r = zmlAllocVector(v1.size);\
+		zml##name##VecScalarInto(&r, v1, v2);\
+		return r;\
+	}\
+	void zml##name##VecScalar(zmlVector *v1, __zml_floating v2) {\
+		zml##name##VecScalarInto(v1, *v1, v2);\
 	}
-}
 
-zmlVector zmlAddVecScalar_r(zmlVector v1, __zml_floating v2) {
-	zmlVector r = zmlCopyVector(&v1);
-	zmlAddVecScalar(&r, v2);
-	return r;
-}
-void zmlAddVecScalar(zmlVector *v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] += v2;
+_zml_defineVecOperators(Add, _ZML_OP_ADD, _ZML_OP_ADD_SCALAR)
+_zml_defineVecOperators(Subtract, _ZML_OP_SUBTRACT, _ZML_OP_SUBTRACT_SCALAR)
+_zml_defineVecOperators(Multiply, _ZML_OP_MULTIPLY, _ZML_OP_MULTIPLY_SCALAR)
+_zml_defineVecOperators(Divide, _ZML_OP_DIVIDE, _ZML_OP_DIVIDE_SCALAR)
+
+void zmlMultiplyVecMatInto(zmlVector *dst, zmlVector v1, zmlMatrix v2) {
+	if (v2.rows != v2.cols) {
+		printf("zetaml: zmlMultiplyVecMat(): given matrix must be square!\n");
+		return;
 	}
-}
-zmlVector zmlSubtractVecScalar_r(zmlVector v1, __zml_floating v2) {
-	zmlVector r = zmlCopyVector(&v1);
-	zmlSubtractVecScalar(&r, v2);
-	return r;
-}
-void zmlSubtractVecScalar(zmlVector *v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] -= v2;
+	if (v1.size != v2.rows) {
+		printf("zetaml: zmlMultiplyVecMat(): given vector and matrix must be the same size! (e.g. 4x4 matrix -> 4d vector)\n");
+		return;
 	}
-}
-zmlVector zmlMultiplyVecScalar_r(zmlVector v1, __zml_floating v2) {
-	zmlVector r = zmlCopyVector(&v1);
-	zmlMultiplyVecScalar(&r, v2);
-	return r;
-}
-void zmlMultiplyVecScalar(zmlVector *v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] *= v2;
+	_zml_assertSameSize((*dst), v1,);
+
+	// every element of v1 is needed for every element of the result, so if dst is v1 the result is built separately first
+	zmlVector buf = (dst->elements == v1.elements) ? zmlAllocVector(v1.size) : *dst;
+
+	// each element of the result is the dot product of a row of v2 (read straight from its contiguous storage) and v1
+	for (unsigned int i = 0; i < v1.size; i++) {
+		const __zml_floating *row = &_zml_at(v2, i, 0);
+		__zml_floating sum = (__zml_floating) 0.0;
+		for (unsigned int j = 0; j < v1.size; j++) {
+			sum += row[j] * v1.elements[j];
+		}
+		buf.elements[i] = sum;
 	}
-}
-zmlVector zmlDivideVecScalar_r(zmlVector v1, __zml_floating v2) {
-	zmlVector r = zmlCopyVector(&v1);
-	zmlDivideVecScalar(&r, v2);
-	return r;
-}
-void zmlDivideVecScalar(zmlVector *v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1->size; i++) {
-		v1->elements[i] /= v2;
+
+	if (buf.elements != dst->elements) {
+		memcpy(dst->elements, buf.elements, v1.size * sizeof(__zml_floating));
+		zmlFreeVector(&buf);
 	}
 }
-
 zmlVector zmlMultiplyVecMat_r(zmlVector v1, zmlMatrix v2) {
 	if (v2.rows != v2.cols) {
 		printf("zetaml: zmlMultiplyVecMat(): given matrix must be square!\n");
@@ -288,35 +353,12 @@ zmlVector zmlMultiplyVecMat_r(zmlVector v1, zmlMatrix v2) {
 		return ZML_NULL_VECTOR;
 	}
 
-	zmlVector r = zmlCopyVector(&v1);
-	zmlMultiplyVecMat(&r, v2);
+	zmlVector r = zmlAllocVector(v1.size);
+	zmlMultiplyVecMatInto(&r, v1, v2);
 	return r;
 }
 void zmlMultiplyVecMat(zmlVector *v1, zmlMatrix v2) {
-	if (v2.rows != v2.cols) {
-		printf("zetaml: zmlMultiplyVecMat(): given matrix must be square!\n");
-		return;
-	}
-	if (v1->size != v2.rows) {
-		printf("zetaml: zmlMultiplyVecMat(): given vector and matrix must be the same size! (e.g. 4x4 matrix -> 4d vector)\n");
-		return;
-	}
-
-	zmlVector buf = zmlCopyVector(v1);
-
-	for (unsigned int i = 0; i < v1->size; i++) {
-		zmlVector rowvec = zmlGetMatrixRow(v2, i);
-		buf.elements[i] = zmlDot(*v1, rowvec);
-
-		zmlFreeVector(&rowvec);
-	}
-
-	// set v1 to buf
-	zmlFreeVector(v1);
-	*v1 = zmlCopyVector(&buf);
-
-	// free buffer
-	zmlFreeVector(&buf);
+	zmlMultiplyVecMatInto(v1, *v1, v2);
 }
 
 /**
@@ -333,76 +375,36 @@ void zmlCopyVectorElements(zmlVector vec, __zml_floating arr[vec.size]) {
 
 unsigned char zmlVecEquals(zmlVector v1, zmlVector v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] != v2.elements[i])
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_EQ, v1.elements, v2.elements, 0, v1.size);
 }
 unsigned char zmlVecGT(zmlVector v1, zmlVector v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] <= v2.elements[i])
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_GT, v1.elements, v2.elements, 0, v1.size);
 }
 unsigned char zmlVecGTE(zmlVector v1, zmlVector v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] < v2.elements[i])
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_GTE, v1.elements, v2.elements, 0, v1.size);
 }
 unsigned char zmlVecLT(zmlVector v1, zmlVector v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] >= v2.elements[i])
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_LT, v1.elements, v2.elements, 0, v1.size);
 }
 unsigned char zmlVecLTE(zmlVector v1, zmlVector v2) {
 	_zml_assertSameSize(v1, v2, 0);
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] > v2.elements[i])
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_LTE, v1.elements, v2.elements, 0, v1.size);
 }
 unsigned char zmlVecEqualsScalar(zmlVector v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] != v2)
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_EQ, v1.elements, NULL, v2, v1.size);
 }
 unsigned char zmlVecGTScalar(zmlVector v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] <= v2)
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_GT, v1.elements, NULL, v2, v1.size);
 }
 unsigned char zmlVecGTEScalar(zmlVector v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] < v2)
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_GTE, v1.elements, NULL, v2, v1.size);
 }
 unsigned char zmlVecLTScalar(zmlVector v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] >= v2)
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_LT, v1.elements, NULL, v2, v1.size);
 }
 unsigned char zmlVecLTEScalar(zmlVector v1, __zml_floating v2) {
-	for (unsigned int i = 0; i < v1.size; i++) {
-		if (v1.elements[i] > v2)
-			return 0;
-	}
-	return 1;
+	return _zml_kernels()->compare(_ZML_CMP_LTE, v1.elements, NULL, v2, v1.size);
 }
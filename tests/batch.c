@@ -0,0 +1,126 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks batches of 4x4 products against zmlMultiplyMat4s_r(): counts that don't fill a whole group of products in
+// flight, a stride of 0 on either input, matrices inside larger structures, the output overwriting either input, and
+// batches big enough to be split across threads.
+
+#include "test.h"
+#include <string.h>
+
+static const size_t counts[] = { 1, 2, 3, 4, 5, 7, 8, 9, 13, 16, 17, 31, 33, 1001, 5003 };
+
+// a matrix inside a larger structure, as with the nodes of a scene graph
+typedef struct {
+	unsigned int id;
+	zmlMat4 m;
+	__zml_floating weight;
+} node;
+
+static zmlMat4 randomMat4(void) {
+	zmlMat4 m;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int c = 0; c < 4; c++) {
+			m.elements[r][c] = zmlTestRandom();
+		}
+	}
+	return m;
+}
+
+static double mat4Difference(const zmlMat4 *a, const zmlMat4 *b) {
+	double diff = 0;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int c = 0; c < 4; c++) {
+			diff = fmax(diff, fabs((double) a->elements[r][c] - (double) b->elements[r][c]));
+		}
+	}
+	return diff;
+}
+
+// out[i] against a[i] * b[i], where a and b advance by their strides
+static void checkProducts(const zmlMat4 *out, size_t outstride, const zmlMat4 *a, size_t astride, const zmlMat4 *b, size_t bstride,
+	size_t count, const char *what) {
+	double worst = 0;
+	for (size_t i = 0; i < count; i++) {
+		const zmlMat4 *am = (const zmlMat4 *) ((const unsigned char *) a + i * astride);
+		const zmlMat4 *bm = (const zmlMat4 *) ((const unsigned char *) b + i * bstride);
+		const zmlMat4 *om = (const zmlMat4 *) ((const unsigned char *) out + i * outstride);
+		const zmlMat4 expected = zmlMultiplyMat4s_r(*am, *bm);
+		worst = fmax(worst, mat4Difference(om, &expected));
+	}
+	ZML_CHECK(worst < ZML_TEST_TOLERANCE * 10, "%s, %zu products: differs from zmlMultiplyMat4s_r() by %g", what, count, worst);
+}
+
+static void checkCount(size_t count) {
+	zmlMat4 *a = malloc(count * sizeof(zmlMat4)), *b = malloc(count * sizeof(zmlMat4));
+	zmlMat4 *out = malloc(count * sizeof(zmlMat4)), *saved = malloc(count * sizeof(zmlMat4));
+	for (size_t i = 0; i < count; i++) {
+		a[i] = randomMat4();
+		b[i] = randomMat4();
+	}
+
+	zmlMultiplyMat4Batch(a, b, out, count);
+	checkProducts(out, sizeof(zmlMat4), a, sizeof(zmlMat4), b, sizeof(zmlMat4), count, "contiguous");
+
+	// one matrix for every product
+	zmlMultiplyMat4BatchStrided(a, 0, b, sizeof(zmlMat4), out, sizeof(zmlMat4), count);
+	checkProducts(out, sizeof(zmlMat4), a, 0, b, sizeof(zmlMat4), count, "stride 0 on a");
+	zmlMultiplyMat4BatchStrided(a, sizeof(zmlMat4), b, 0, out, sizeof(zmlMat4), count);
+	checkProducts(out, sizeof(zmlMat4), a, sizeof(zmlMat4), b, 0, count, "stride 0 on b");
+
+	// matrices inside structures, with the results written back into them
+	node *nodes = malloc(count * sizeof(node));
+	for (size_t i = 0; i < count; i++) {
+		nodes[i].id = (unsigned int) i;
+		nodes[i].m = b[i];
+		nodes[i].weight = 1;
+	}
+	zmlMultiplyMat4BatchStrided(a, sizeof(zmlMat4), &nodes[0].m, sizeof(node), &nodes[0].m, sizeof(node), count);
+	checkProducts(&nodes[0].m, sizeof(node), a, sizeof(zmlMat4), b, sizeof(zmlMat4), count, "inside structures");
+	unsigned char intact = 1;
+	for (size_t i = 0; i < count; i++) {
+		intact &= (nodes[i].id == i && nodes[i].weight == 1);
+	}
+	ZML_CHECK(intact, "%zu products: the rest of the structures were overwritten", count);
+	free(nodes);
+
+	// the output overwriting a, then b
+	memcpy(saved, a, count * sizeof(zmlMat4));
+	zmlMultiplyMat4Batch(a, b, a, count);
+	checkProducts(a, sizeof(zmlMat4), saved, sizeof(zmlMat4), b, sizeof(zmlMat4), count, "out = a");
+	memcpy(saved, b, count * sizeof(zmlMat4));
+	zmlMultiplyMat4Batch(a, b, b, count);
+	checkProducts(b, sizeof(zmlMat4), a, sizeof(zmlMat4), saved, sizeof(zmlMat4), count, "out = b");
+
+	// and with the other input shared by every product
+	memcpy(saved, a, count * sizeof(zmlMat4));
+	zmlMultiplyMat4BatchStrided(a, sizeof(zmlMat4), b, 0, a, sizeof(zmlMat4), count);
+	checkProducts(a, sizeof(zmlMat4), saved, sizeof(zmlMat4), b, 0, count, "out = a, stride 0 on b");
+
+	free(a);
+	free(b);
+	free(out);
+	free(saved);
+}
+
+int main() {
+	// (so that the biggest batches are split across threads)
+	zmlSetThreadCount(4);
+
+	for (unsigned int i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+		checkCount(counts[i]);
+	}
+
+	return zmlTestResult("batch");
+}
@@ -0,0 +1,224 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks the batched camera matrices: look-at, perspective and orthographic matrices (left- and right-handed) against
+// the single-matrix constructors, their inverses against the identity, and the combined view-projection matrices and
+// inverses against zmlInvertedMat4(), with a projection shared by every view and a view shared by every projection.
+// also checks that the look-at functions for allocated matrices reject vectors that aren't of size 3.
+
+#include "test.h"
+
+#define COUNT 37
+
+// the largest difference between the elements of a and b, relative to the largest element of b (or 1, if that is smaller)
+static double mat4Difference(const zmlMat4 *a, const zmlMat4 *b) {
+	double diff = 0, scale = 1;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int c = 0; c < 4; c++) {
+			diff = fmax(diff, fabs((double) a->elements[r][c] - (double) b->elements[r][c]));
+			scale = fmax(scale, fabs((double) b->elements[r][c]));
+		}
+	}
+	return diff / scale;
+}
+
+// check that out[i] matches expected[i] and that out[i] * inverse[i] is the identity
+static void checkBatch(const zmlMat4 *out, const zmlMat4 *inverse, const zmlMat4 *expected, const char *what) {
+	const zmlMat4 identity = zmlIdentityMat4();
+	for (unsigned int i = 0; i < COUNT; i++) {
+		double diff = mat4Difference(&out[i], &expected[i]);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE, "%s %u: differs from the single-matrix constructor by %g", what, i, diff);
+
+		const zmlMat4 product = zmlMultiplyMat4s_r(out[i], inverse[i]);
+		diff = mat4Difference(&product, &identity);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 100, "%s %u: matrix * inverse differs from the identity by %g", what, i, diff);
+	}
+}
+
+static void checkLookAt(unsigned char rightHanded) {
+	__zml_floating p[9][COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		for (unsigned int a = 0; a < 3; a++) {
+			p[a][i] = 20 * zmlTestRandom();
+			p[3 + a][i] = p[a][i] + 10 * zmlTestRandom();
+		}
+		// (looking roughly horizontally, so the up direction is never close to the direction the camera is facing)
+		p[4][i] = p[1][i] + zmlTestRandom();
+		p[3][i] += (p[3][i] < p[0][i]) ? -2 : 2;
+		p[6][i] = zmlTestRandom() / 4;
+		p[7][i] = 1;
+		p[8][i] = zmlTestRandom() / 4;
+	}
+
+	zmlMat4 out[COUNT], inverse[COUNT], expected[COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		const zmlVec3 pos = { { p[0][i], p[1][i], p[2][i] } };
+		const zmlVec3 focus = { { p[3][i], p[4][i], p[5][i] } };
+		const zmlVec3 up = { { p[6][i], p[7][i], p[8][i] } };
+		expected[i] = rightHanded ? zmlConstructLookAtMat4RH(pos, focus, up) : zmlConstructLookAtMat4LH(pos, focus, up);
+	}
+	if (rightHanded) {
+		zmlConstructLookAtMat4sRH(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], out, inverse, COUNT);
+	} else {
+		zmlConstructLookAtMat4sLH(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], out, inverse, COUNT);
+	}
+	checkBatch(out, inverse, expected, rightHanded ? "RH look-at" : "LH look-at");
+}
+
+static void checkPerspective(unsigned char rightHanded) {
+	__zml_floating near[COUNT], far[COUNT], fovy[COUNT], aspect[COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		near[i] = (__zml_floating) 0.1 + (zmlTestRandom() + 1) / 2;
+		far[i] = 50 + 40 * zmlTestRandom();
+		// (runs of cameras sharing a field of view, as with the faces of a cubemap)
+		fovy[i] = (i % 6 == 0 || i < 6) ? 1 + zmlTestRandom() / 2 : fovy[i - 1];
+		aspect[i] = (__zml_floating) 1.25 + zmlTestRandom() / 2;
+	}
+
+	zmlMat4 out[COUNT], inverse[COUNT], expected[COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		expected[i] = rightHanded ? zmlConstructPerspectiveMat4RH(near[i], far[i], fovy[i], aspect[i]) :
+			zmlConstructPerspectiveMat4LH(near[i], far[i], fovy[i], aspect[i]);
+	}
+	if (rightHanded) {
+		zmlConstructPerspectiveMat4sRH(near, far, fovy, aspect, out, inverse, COUNT);
+	} else {
+		zmlConstructPerspectiveMat4sLH(near, far, fovy, aspect, out, inverse, COUNT);
+	}
+	checkBatch(out, inverse, expected, rightHanded ? "RH perspective" : "LH perspective");
+}
+
+static void checkOrtho(unsigned char rightHanded) {
+	__zml_floating b[6][COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		for (unsigned int a = 0; a < 3; a++) {
+			b[2 * a][i] = 10 * zmlTestRandom();
+			b[2 * a + 1][i] = b[2 * a][i] + 1 + 10 * (zmlTestRandom() + 1);
+		}
+	}
+
+	zmlMat4 out[COUNT], inverse[COUNT], expected[COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		expected[i] = rightHanded ? zmlConstructOrthoMat4RH(b[0][i], b[1][i], b[2][i], b[3][i], b[4][i], b[5][i]) :
+			zmlConstructOrthoMat4LH(b[0][i], b[1][i], b[2][i], b[3][i], b[4][i], b[5][i]);
+	}
+	if (rightHanded) {
+		zmlConstructOrthoMat4sRH(b[0], b[1], b[2], b[3], b[4], b[5], out, inverse, COUNT);
+	} else {
+		zmlConstructOrthoMat4sLH(b[0], b[1], b[2], b[3], b[4], b[5], out, inverse, COUNT);
+	}
+	checkBatch(out, inverse, expected, rightHanded ? "RH ortho" : "LH ortho");
+}
+
+// the look-at functions for allocated matrices give the same matrices, and leave mat alone if a vector isn't of size 3
+static void checkDynamicLookAt(void) {
+	zmlVector pos = zmlConstructVector(3, 1.0, 2.0, 3.0), focus = zmlConstructVector(3, -4.0, 5.0, 7.0);
+	zmlVector up = zmlConstructVector(3, 0.0, 1.0, 0.0), flat = zmlConstructVector(2, 0.0, 1.0);
+	const zmlVec3 pos3 = { { 1, 2, 3 } }, focus3 = { { -4, 5, 7 } }, up3 = { { 0, 1, 0 } };
+	const zmlMat4 identity = zmlIdentityMat4();
+
+	for (unsigned int rh = 0; rh < 2; rh++) {
+		const zmlMat4 expected = rh ? zmlConstructLookAtMat4RH(pos3, focus3, up3) : zmlConstructLookAtMat4LH(pos3, focus3, up3);
+		zmlMatrix m = rh ? zmlConstructLookAtMatrixRH(pos, focus, up) : zmlConstructLookAtMatrixLH(pos, focus, up);
+		zmlMat4 got = zmlMatrixToMat4(m);
+		ZML_CHECK(mat4Difference(&got, &expected) < ZML_TEST_TOLERANCE, "%s: the allocated look-at matrix differs", rh ? "RH" : "LH");
+
+		// (the constructors give the identity instead)
+		zmlMatrix bad = rh ? zmlConstructLookAtMatrixRH(pos, focus, flat) : zmlConstructLookAtMatrixLH(flat, focus, up);
+		got = zmlMatrixToMat4(bad);
+		ZML_CHECK(mat4Difference(&got, &identity) == 0, "%s: a look-at matrix was built from a vector of size 2", rh ? "RH" : "LH");
+		zmlFreeMatrix(&bad);
+
+		if (rh) {
+			zmlUpdateLookAtMatrixRH(&m, pos, flat, up);
+		} else {
+			zmlUpdateLookAtMatrixLH(&m, pos, focus, flat);
+		}
+		got = zmlMatrixToMat4(m);
+		ZML_CHECK(mat4Difference(&got, &expected) == 0, "%s: a look-at matrix was updated from a vector of size 2", rh ? "RH" : "LH");
+		zmlFreeMatrix(&m);
+	}
+
+	zmlFreeVector(&pos);
+	zmlFreeVector(&focus);
+	zmlFreeVector(&up);
+	zmlFreeVector(&flat);
+}
+
+// combine projections and views (either of which may be a single matrix, with a stride of 0), with and without their inverses
+static void checkCombine(const zmlMat4 *proj, const zmlMat4 *projinverse, size_t projstride, const zmlMat4 *view,
+	const zmlMat4 *viewinverse, size_t viewstride, const char *what) {
+	zmlMat4 viewproj[COUNT], inverse[COUNT], general[COUNT];
+	zmlCombineViewProjectionMat4s(proj, projinverse, projstride, view, viewinverse, viewstride, viewproj, inverse, COUNT);
+	zmlCombineViewProjectionMat4s(proj, NULL, projstride, view, viewinverse, viewstride, general, general, COUNT);
+
+	for (unsigned int i = 0; i < COUNT; i++) {
+		const zmlMat4 *p = (const zmlMat4 *) ((const unsigned char *) proj + i * projstride);
+		const zmlMat4 *v = (const zmlMat4 *) ((const unsigned char *) view + i * viewstride);
+		const zmlMat4 expected = zmlMultiplyMat4s_r(*p, *v);
+		const zmlMat4 expectedInverse = zmlInvertedMat4(viewproj[i]);
+
+		double diff = mat4Difference(&viewproj[i], &expected);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE, "%s %u: view-projection differs from projection * view by %g", what, i, diff);
+		diff = mat4Difference(&inverse[i], &expectedInverse);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 100, "%s %u: the combined inverse differs from zmlInvertedMat4() by %g", what, i, diff);
+		diff = mat4Difference(&general[i], &expectedInverse);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 100, "%s %u: the inverse found without projinverse differs by %g", what, i, diff);
+	}
+}
+
+int main() {
+	for (unsigned int rh = 0; rh < 2; rh++) {
+		checkLookAt((unsigned char) rh);
+		checkPerspective((unsigned char) rh);
+		checkOrtho((unsigned char) rh);
+	}
+	checkDynamicLookAt();
+
+	// a view and a projection for every camera, from the batched constructors
+	__zml_floating p[9][COUNT], near[COUNT], far[COUNT], fovy[COUNT], aspect[COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		for (unsigned int a = 0; a < 3; a++) {
+			p[a][i] = 20 * zmlTestRandom();
+			p[3 + a][i] = p[a][i] + 10 * zmlTestRandom();
+			p[6 + a][i] = (a == 1) ? 1 : 0;
+		}
+		p[4][i] = p[1][i] + zmlTestRandom();
+		p[3][i] += (p[3][i] < p[0][i]) ? -2 : 2;
+		near[i] = (__zml_floating) 0.5;
+		far[i] = 100;
+		fovy[i] = 1 + zmlTestRandom() / 2;
+		aspect[i] = (__zml_floating) 1.5;
+	}
+	zmlMat4 view[COUNT], viewinverse[COUNT], proj[COUNT], projinverse[COUNT];
+	zmlConstructLookAtMat4sRH(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], view, viewinverse, COUNT);
+	zmlConstructPerspectiveMat4sRH(near, far, fovy, aspect, proj, projinverse, COUNT);
+
+	checkCombine(proj, projinverse, sizeof(zmlMat4), view, viewinverse, sizeof(zmlMat4), "separate cameras");
+	checkCombine(proj, projinverse, 0, view, viewinverse, sizeof(zmlMat4), "one projection");
+	checkCombine(proj, projinverse, sizeof(zmlMat4), view, viewinverse, 0, "one view");
+	checkCombine(proj, projinverse, 0, view, viewinverse, 0, "one projection and view");
+
+	__zml_floating lm[COUNT], rm[COUNT], bm[COUNT], tm[COUNT];
+	for (unsigned int i = 0; i < COUNT; i++) {
+		lm[i] = -10 + zmlTestRandom();
+		rm[i] = 10 + zmlTestRandom();
+		bm[i] = -5 + zmlTestRandom();
+		tm[i] = 5 + zmlTestRandom();
+	}
+	zmlConstructOrthoMat4sLH(lm, rm, bm, tm, near, far, proj, projinverse, COUNT);
+	checkCombine(proj, projinverse, 0, view, viewinverse, sizeof(zmlMat4), "one ortho projection");
+
+	return zmlTestResult("camera");
+}
@@ -0,0 +1,253 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks frustum culling: frustums built from left- and right-handed perspective and orthographic cameras against points
+// known to be inside or outside them and against clip-space coordinates, the batched sphere and box culling against
+// zmlSphereInFrustum() and zmlAABBInFrustum() volume by volume (for counts that don't fill whole SIMD registers, with NaN
+// centres, and big enough to be split across threads), and zmlTransformAABBs() against transforming each box's corners.
+
+#include "test.h"
+#include <string.h>
+
+static const size_t counts[] = { 1, 2, 3, 5, 7, 9, 13, 17, 31, 33, 1001, (1 << 15) + 13 };
+
+static zmlVec3 vec3(__zml_floating x, __zml_floating y, __zml_floating z) {
+	zmlVec3 v = { { x, y, z } };
+	return v;
+}
+
+// m * (x, y, z, 1)
+static void transformPoint(const zmlMat4 *m, const double p[3], double out[4]) {
+	for (unsigned int r = 0; r < 4; r++) {
+		out[r] = (double) m->elements[r][0] * p[0] + (double) m->elements[r][1] * p[1] + (double) m->elements[r][2] * p[2] + (double) m->elements[r][3];
+	}
+}
+
+// a camera at (1, 2, 3) looking at focus, with a 60 degree field of view, an aspect ratio of 1.5 and clipping planes at 0.5 and 50
+static zmlMat4 perspectiveCamera(zmlVec3 focus, unsigned char rightHanded) {
+	const zmlVec3 pos = vec3(1, 2, 3), up = vec3(0, 1, 0);
+	const __zml_floating fovy = (__zml_floating) (PI / 3);
+	if (rightHanded) {
+		return zmlMultiplyMat4s_r(zmlConstructPerspectiveMat4RH((__zml_floating) 0.5, 50, fovy, (__zml_floating) 1.5), zmlConstructLookAtMat4RH(pos, focus, up));
+	}
+	return zmlMultiplyMat4s_r(zmlConstructPerspectiveMat4LH((__zml_floating) 0.5, 50, fovy, (__zml_floating) 1.5), zmlConstructLookAtMat4LH(pos, focus, up));
+}
+
+// the same camera with an orthographic projection 20 wide, 10 high and 40 deep
+static zmlMat4 orthoCamera(zmlVec3 focus, unsigned char rightHanded) {
+	const zmlVec3 pos = vec3(1, 2, 3), up = vec3(0, 1, 0);
+	if (rightHanded) {
+		return zmlMultiplyMat4s_r(zmlConstructOrthoMat4RH(-10, 10, -5, 5, 1, 41), zmlConstructLookAtMat4RH(pos, focus, up));
+	}
+	return zmlMultiplyMat4s_r(zmlConstructOrthoMat4LH(-10, 10, -5, 5, 1, 41), zmlConstructLookAtMat4LH(pos, focus, up));
+}
+
+// points in front of the camera, which looks along +z from (1, 2, 3): at a depth of 10, the view is 5.77 high and 8.66 wide either side
+static void checkKnownPoints(void) {
+	static const struct {
+		double x, y, z;
+		unsigned char inside;
+	} points[] = {
+		{ 1, 2, 13, 1 }, { 1, 2, 3.6, 1 }, { 1, 2, 52.9, 1 }, { 9, 2, 13, 1 }, { -7, 2, 13, 1 }, { 1, 7.5, 13, 1 }, { 1, -3.5, 13, 1 },
+		{ 1, 2, -7, 0 }, { 1, 2, 3.4, 0 }, { 1, 2, 53.1, 0 }, { 10, 2, 13, 0 }, { -8, 2, 13, 0 }, { 1, 8, 13, 0 }, { 1, -4, 13, 0 },
+		{ 1, 2, 3, 0 }, { 101, 2, 13, 0 },
+	};
+
+	for (unsigned int rh = 0; rh < 2; rh++) {
+		const zmlFrustum f = zmlConstructFrustum(perspectiveCamera(vec3(1, 2, 13), (unsigned char) rh));
+		for (unsigned int i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+			const zmlVec3 p = vec3((__zml_floating) points[i].x, (__zml_floating) points[i].y, (__zml_floating) points[i].z);
+			ZML_CHECK(zmlSphereInFrustum(&f, p, 0) == points[i].inside, "%s perspective: (%g, %g, %g) should be %s",
+				rh ? "RH" : "LH", points[i].x, points[i].y, points[i].z, points[i].inside ? "inside" : "outside");
+			ZML_CHECK(zmlAABBInFrustum(&f, p, vec3(0, 0, 0)) == points[i].inside, "%s perspective: box at (%g, %g, %g) should be %s",
+				rh ? "RH" : "LH", points[i].x, points[i].y, points[i].z, points[i].inside ? "inside" : "outside");
+		}
+
+		// volumes outside, but big enough to reach inside
+		ZML_CHECK(zmlSphereInFrustum(&f, vec3(1, 2, -7), 11), "%s perspective: a sphere reaching in from behind the camera was culled", rh ? "RH" : "LH");
+		ZML_CHECK(zmlAABBInFrustum(&f, vec3(12, 2, 13), vec3(3, 1, 1)), "%s perspective: a box reaching in from the side was culled", rh ? "RH" : "LH");
+		ZML_CHECK(!zmlAABBInFrustum(&f, vec3(12, 2, 13), vec3(1, 1, 1)), "%s perspective: a box to the side wasn't culled", rh ? "RH" : "LH");
+	}
+}
+
+// a point is inside a frustum exactly when -w <= x, y, z <= w in clip space
+static void checkClipSpace(zmlMat4 viewproj, const char *what) {
+	const zmlFrustum f = zmlConstructFrustum(viewproj);
+	unsigned int tested = 0;
+
+	for (unsigned int i = 0; i < 20000; i++) {
+		const double p[3] = { 1 + 60 * zmlTestRandom(), 2 + 60 * zmlTestRandom(), 3 + 60 * zmlTestRandom() };
+		double clip[4];
+		transformPoint(&viewproj, p, clip);
+
+		// (skip points too close to a plane for rounding not to matter)
+		double margin = INFINITY;
+		for (unsigned int c = 0; c < 3; c++) {
+			margin = fmin(margin, clip[3] - fabs(clip[c]));
+		}
+		if (fabs(margin) < 1e-3) {
+			continue;
+		}
+
+		const unsigned char inside = zmlSphereInFrustum(&f, vec3((__zml_floating) p[0], (__zml_floating) p[1], (__zml_floating) p[2]), 0);
+		ZML_CHECK(inside == (margin > 0), "%s: (%g, %g, %g) is %s in clip space", what, p[0], p[1], p[2], (margin > 0) ? "inside" : "outside");
+		tested += inside;
+	}
+
+	ZML_CHECK(tested > 0, "%s: no random points were inside", what);
+}
+
+// how far inside (positive) or outside (negative) the least-inside plane a volume is; the batched and single tests may
+// disagree when this is within rounding of 0
+static double planeMargin(const zmlFrustum *f, double x, double y, double z, double radius, double ex, double ey, double ez) {
+	double margin = INFINITY;
+	for (unsigned int p = 0; p < 6; p++) {
+		const __zml_floating *plane = f->planes[p].elements;
+		const double d = plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+		margin = fmin(margin, d + radius + fabs(plane[0]) * ex + fabs(plane[1]) * ey + fabs(plane[2]) * ez);
+	}
+	return margin;
+}
+
+static void checkBatched(const zmlFrustum *f, size_t count) {
+	__zml_floating *x = malloc(count * sizeof(__zml_floating)), *y = malloc(count * sizeof(__zml_floating));
+	__zml_floating *z = malloc(count * sizeof(__zml_floating)), *radius = malloc(count * sizeof(__zml_floating));
+	__zml_floating *ex = malloc(count * sizeof(__zml_floating)), *ey = malloc(count * sizeof(__zml_floating));
+	__zml_floating *ez = malloc(count * sizeof(__zml_floating));
+	unsigned char *visible = malloc(count);
+
+	for (size_t i = 0; i < count; i++) {
+		x[i] = 1 + 40 * zmlTestRandom();
+		y[i] = 2 + 40 * zmlTestRandom();
+		z[i] = 3 + 40 * zmlTestRandom();
+		radius[i] = 2 * (zmlTestRandom() + 1);
+		ex[i] = zmlTestRandom() + 1;
+		ey[i] = zmlTestRandom() + 1;
+		ez[i] = zmlTestRandom() + 1;
+	}
+	// NaN centres (which are always culled) at the start, in the middle and in the leftover volumes at the end
+	x[0] = (__zml_floating) NAN;
+	y[count / 2] = (__zml_floating) NAN;
+	z[count - 1] = (__zml_floating) NAN;
+
+	const double tolerance = ZML_TEST_TOLERANCE * 100;
+
+	memset(visible, 2, count);
+	size_t visibleCount = zmlCullSpheres(f, x, y, z, radius, visible, count), sum = 0;
+	for (size_t i = 0; i < count; i++) {
+		const unsigned char expected = zmlSphereInFrustum(f, vec3(x[i], y[i], z[i]), radius[i]);
+		if (fabs(planeMargin(f, x[i], y[i], z[i], radius[i], 0, 0, 0)) > tolerance) {
+			ZML_CHECK(visible[i] == expected, "%zu spheres: sphere %zu is %u, expected %u", count, i, visible[i], expected);
+		}
+		ZML_CHECK(visible[i] <= 1, "%zu spheres: visible[%zu] wasn't set", count, i);
+		sum += visible[i];
+	}
+	ZML_CHECK(!visible[0] && !visible[count / 2] && !visible[count - 1], "%zu spheres: a sphere with a NaN centre wasn't culled", count);
+	ZML_CHECK(visibleCount == sum, "%zu spheres: returned %zu, but %zu are marked visible", count, visibleCount, sum);
+
+	memset(visible, 2, count);
+	visibleCount = zmlCullAABBs(f, x, y, z, ex, ey, ez, visible, count);
+	sum = 0;
+	for (size_t i = 0; i < count; i++) {
+		const unsigned char expected = zmlAABBInFrustum(f, vec3(x[i], y[i], z[i]), vec3(ex[i], ey[i], ez[i]));
+		if (fabs(planeMargin(f, x[i], y[i], z[i], 0, ex[i], ey[i], ez[i])) > tolerance) {
+			ZML_CHECK(visible[i] == expected, "%zu boxes: box %zu is %u, expected %u", count, i, visible[i], expected);
+		}
+		ZML_CHECK(visible[i] <= 1, "%zu boxes: visible[%zu] wasn't set", count, i);
+		sum += visible[i];
+	}
+	ZML_CHECK(!visible[0] && !visible[count / 2] && !visible[count - 1], "%zu boxes: a box with a NaN centre wasn't culled", count);
+	ZML_CHECK(visibleCount == sum, "%zu boxes: returned %zu, but %zu are marked visible", count, visibleCount, sum);
+
+	free(x);
+	free(y);
+	free(z);
+	free(radius);
+	free(ex);
+	free(ey);
+	free(ez);
+	free(visible);
+}
+
+// the boxes' 8 transformed corners are bounded by (and touch) the transformed boxes
+static void checkTransformAABBs(size_t count, unsigned char inPlace) {
+	zmlMat4 m = zmlMultiplyMat4s_r(zmlTranslateIdentityMat4(vec3(3, -2, 5)), zmlRotateIdentityMat4((__zml_floating) 0.7, 1, 2, 3));
+	m = zmlMultiplyMat4s_r(m, zmlScaleIdentityMat4(vec3(2, (__zml_floating) 0.5, 3)));
+
+	__zml_floating *in = malloc(6 * count * sizeof(__zml_floating));
+	__zml_floating *out = inPlace ? in : malloc(6 * count * sizeof(__zml_floating));
+	for (size_t i = 0; i < 6 * count; i++) {
+		in[i] = (i < 3 * count) ? 10 * zmlTestRandom() : zmlTestRandom() + 1;
+	}
+	__zml_floating *saved = malloc(6 * count * sizeof(__zml_floating));
+	memcpy(saved, in, 6 * count * sizeof(__zml_floating));
+
+	zmlTransformAABBs(&m, in, in + count, in + 2 * count, in + 3 * count, in + 4 * count, in + 5 * count,
+		out, out + count, out + 2 * count, out + 3 * count, out + 4 * count, out + 5 * count, count);
+
+	double worst = 0;
+	for (size_t i = 0; i < count; i++) {
+		double lo[3] = { INFINITY, INFINITY, INFINITY }, hi[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (unsigned int corner = 0; corner < 8; corner++) {
+			double p[3], q[4];
+			for (unsigned int a = 0; a < 3; a++) {
+				const double e = saved[(3 + a) * count + i];
+				p[a] = saved[a * count + i] + ((corner >> a) & 1 ? e : -e);
+			}
+			transformPoint(&m, p, q);
+			for (unsigned int a = 0; a < 3; a++) {
+				lo[a] = fmin(lo[a], q[a]);
+				hi[a] = fmax(hi[a], q[a]);
+			}
+		}
+		for (unsigned int a = 0; a < 3; a++) {
+			worst = fmax(worst, fabs(out[a * count + i] - (lo[a] + hi[a]) / 2));
+			worst = fmax(worst, fabs(out[(3 + a) * count + i] - (hi[a] - lo[a]) / 2));
+		}
+	}
+	ZML_CHECK(worst < ZML_TEST_TOLERANCE * 100, "%zu boxes%s: transformed boxes differ from their corners' bounds by %g", count, inPlace ? " (in place)" : "", worst);
+
+	free(saved);
+	if (!inPlace) {
+		free(out);
+	}
+	free(in);
+}
+
+int main() {
+	// (so that the biggest counts are split across threads)
+	zmlSetThreadCount(4);
+
+	checkKnownPoints();
+
+	const zmlVec3 focuses[] = { vec3(1, 2, 13), vec3(-5, 4, -1), vec3(7, -3, 20) };
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int rh = 0; rh < 2; rh++) {
+			char what[64];
+			snprintf(what, sizeof(what), "%s perspective camera %u", rh ? "RH" : "LH", i);
+			checkClipSpace(perspectiveCamera(focuses[i], (unsigned char) rh), what);
+			snprintf(what, sizeof(what), "%s ortho camera %u", rh ? "RH" : "LH", i);
+			checkClipSpace(orthoCamera(focuses[i], (unsigned char) rh), what);
+		}
+	}
+
+	const zmlFrustum f = zmlConstructFrustum(perspectiveCamera(vec3(-5, 4, -1), 1));
+	for (unsigned int i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+		checkBatched(&f, counts[i]);
+		checkTransformAABBs(counts[i], 0);
+		checkTransformAABBs(counts[i], 1);
+	}
+
+	return zmlTestResult("culling");
+}
@@ -0,0 +1,233 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks the LU, Cholesky and QR decompositions by their residuals |PA - LU|, |A - LL^T| and |A - QR|, at sizes around the
+// 64-column panel width of the blocked factorisations, checks their solvers, and checks that singular, non positive-definite
+// and wide input is rejected.
+
+#include "test.h"
+
+// r = a * b, naively, with a and b optionally transposed
+static zmlMatrix naiveProduct(zmlMatrix a, unsigned char transposeA, zmlMatrix b, unsigned char transposeB) {
+	const unsigned int m = transposeA ? a.cols : a.rows, k = transposeA ? a.rows : a.cols, n = transposeB ? b.rows : b.cols;
+	zmlMatrix r = zmlAllocMatrix(m, n);
+	for (unsigned int i = 0; i < m; i++) {
+		for (unsigned int j = 0; j < n; j++) {
+			double sum = 0;
+			for (unsigned int p = 0; p < k; p++) {
+				sum += (double) (transposeA ? a.elements[p][i] : a.elements[i][p]) * (double) (transposeB ? b.elements[j][p] : b.elements[p][j]);
+			}
+			r.elements[i][j] = (__zml_floating) sum;
+		}
+	}
+	return r;
+}
+
+// |a x - b| relative to b
+static double solveError(zmlMatrix a, zmlMatrix x, zmlMatrix b) {
+	zmlMatrix ax = naiveProduct(a, 0, x, 0);
+	const double diff = zmlTestDifference(ax, b);
+	zmlFreeMatrix(&ax);
+	return diff;
+}
+
+static void checkLU(unsigned int n) {
+	zmlMatrix a = zmlTestRandomMatrix(n, n);
+	zmlMatrix lu = zmlCopyMatrix(&a);
+	unsigned int *pivots = malloc(n * sizeof(unsigned int));
+	ZML_CHECK(zmlLUDecompose(&lu, pivots), "LU %u: decomposition failed", n);
+
+	zmlMatrix l = zmlZeroMatrix(n, n), u = zmlZeroMatrix(n, n);
+	for (unsigned int r = 0; r < n; r++) {
+		for (unsigned int c = 0; c < n; c++) {
+			if (c < r) {
+				l.elements[r][c] = lu.elements[r][c];
+			} else {
+				u.elements[r][c] = lu.elements[r][c];
+			}
+		}
+		l.elements[r][r] = 1;
+	}
+
+	// apply the row swaps to a copy of A, in order
+	zmlMatrix pa = zmlCopyMatrix(&a);
+	for (unsigned int i = 0; i < n; i++) {
+		ZML_CHECK(pivots[i] >= i && pivots[i] < n, "LU %u: pivot %u out of range", n, pivots[i]);
+		for (unsigned int c = 0; c < n && pivots[i] < n; c++) {
+			const __zml_floating t = pa.elements[i][c];
+			pa.elements[i][c] = pa.elements[pivots[i]][c];
+			pa.elements[pivots[i]][c] = t;
+		}
+	}
+
+	zmlMatrix product = naiveProduct(l, 0, u, 0);
+	const double diff = zmlTestDifference(product, pa);
+	ZML_CHECK(diff < ZML_TEST_TOLERANCE * n, "LU %u: |PA - LU| = %g", n, diff);
+
+	zmlMatrix b = zmlTestRandomMatrix(n, 3);
+	zmlMatrix x = zmlCopyMatrix(&b);
+	zmlLUSolve(lu, pivots, &x);
+	const double solve = solveError(a, x, b);
+	ZML_CHECK(solve < ZML_TEST_TOLERANCE * n * 10, "LU %u: |AX - B| = %g", n, solve);
+
+	// a zero row stays exactly singular through the elimination
+	zmlMatrix singular = zmlCopyMatrix(&a);
+	for (unsigned int c = 0; c < n; c++) {
+		singular.elements[n / 2][c] = 0;
+	}
+	ZML_CHECK(!zmlLUDecompose(&singular, pivots), "LU %u: singular matrix decomposed", n);
+
+	free(pivots);
+	zmlFreeMatrix(&a);
+	zmlFreeMatrix(&lu);
+	zmlFreeMatrix(&l);
+	zmlFreeMatrix(&u);
+	zmlFreeMatrix(&pa);
+	zmlFreeMatrix(&product);
+	zmlFreeMatrix(&b);
+	zmlFreeMatrix(&x);
+	zmlFreeMatrix(&singular);
+}
+
+static void checkCholesky(unsigned int n) {
+	// B B^T + n I is symmetric positive definite
+	zmlMatrix random = zmlTestRandomMatrix(n, n);
+	zmlMatrix a = naiveProduct(random, 0, random, 1);
+	for (unsigned int i = 0; i < n; i++) {
+		a.elements[i][i] += (__zml_floating) n;
+	}
+
+	// only the lower triangle should be read
+	zmlMatrix l = zmlCopyMatrix(&a);
+	for (unsigned int r = 0; r < n; r++) {
+		for (unsigned int c = r + 1; c < n; c++) {
+			l.elements[r][c] = (__zml_floating) NAN;
+		}
+	}
+	ZML_CHECK(zmlCholeskyDecompose(&l), "Cholesky %u: decomposition failed", n);
+
+	unsigned char lower = 1;
+	for (unsigned int r = 0; r < n; r++) {
+		for (unsigned int c = r + 1; c < n; c++) {
+			lower &= l.elements[r][c] == 0;
+		}
+	}
+	ZML_CHECK(lower, "Cholesky %u: L isn't lower triangular", n);
+
+	zmlMatrix product = naiveProduct(l, 0, l, 1);
+	const double diff = zmlTestDifference(product, a);
+	ZML_CHECK(diff < ZML_TEST_TOLERANCE * n, "Cholesky %u: |A - LL^T| = %g", n, diff);
+
+	zmlMatrix b = zmlTestRandomMatrix(n, 2);
+	zmlMatrix x = zmlCopyMatrix(&b);
+	zmlCholeskySolve(l, &x);
+	const double solve = solveError(a, x, b);
+	ZML_CHECK(solve < ZML_TEST_TOLERANCE * n, "Cholesky %u: |AX - B| = %g", n, solve);
+
+	// flipping the sign of the last diagonal element makes it indefinite (the Schur complement of the rest is negative)
+	zmlMatrix indefinite = zmlCopyMatrix(&a);
+	indefinite.elements[n - 1][n - 1] = -indefinite.elements[n - 1][n - 1];
+	ZML_CHECK(!zmlCholeskyDecompose(&indefinite), "Cholesky %u: indefinite matrix decomposed", n);
+
+	zmlFreeMatrix(&random);
+	zmlFreeMatrix(&a);
+	zmlFreeMatrix(&l);
+	zmlFreeMatrix(&product);
+	zmlFreeMatrix(&b);
+	zmlFreeMatrix(&x);
+	zmlFreeMatrix(&indefinite);
+}
+
+static void checkQR(unsigned int m, unsigned int n) {
+	zmlMatrix a = zmlTestRandomMatrix(m, n);
+	zmlMatrix qr = zmlCopyMatrix(&a);
+	zmlVector tau = zmlQRDecompose(&qr);
+	ZML_CHECK(tau.size == n, "QR %ux%u: decomposition failed", m, n);
+
+	// Q R = H(0) H(1) ... H(n - 1) R, where H(j) = I - tau[j] v v^T and v is column j below the diagonal, with an implicit 1 at j
+	zmlMatrix x = zmlZeroMatrix(m, n);
+	for (unsigned int r = 0; r < n; r++) {
+		for (unsigned int c = r; c < n; c++) {
+			x.elements[r][c] = qr.elements[r][c];
+		}
+	}
+	for (unsigned int j = n; j-- > 0;) {
+		for (unsigned int c = 0; c < n; c++) {
+			double dot = x.elements[j][c];
+			for (unsigned int i = j + 1; i < m; i++) {
+				dot += (double) qr.elements[i][j] * (double) x.elements[i][c];
+			}
+			dot *= (double) tau.elements[j];
+			x.elements[j][c] -= (__zml_floating) dot;
+			for (unsigned int i = j + 1; i < m; i++) {
+				x.elements[i][c] -= (__zml_floating) (dot * (double) qr.elements[i][j]);
+			}
+		}
+	}
+	const double diff = zmlTestDifference(x, a);
+	ZML_CHECK(diff < ZML_TEST_TOLERANCE * m, "QR %ux%u: |A - QR| = %g", m, n, diff);
+
+	// the least-squares residual A X - B is orthogonal to the columns of A
+	zmlMatrix b = zmlTestRandomMatrix(m, 2);
+	zmlMatrix solution = zmlCopyMatrix(&b);
+	zmlQRSolve(qr, tau, &solution);
+	ZML_CHECK(solution.rows == n && solution.cols == 2, "QR %ux%u: solution is %ux%u", m, n, solution.rows, solution.cols);
+	zmlMatrix residual = naiveProduct(a, 0, solution, 0);
+	for (unsigned int r = 0; r < m; r++) {
+		for (unsigned int c = 0; c < 2; c++) {
+			residual.elements[r][c] -= b.elements[r][c];
+		}
+	}
+	zmlMatrix normal = naiveProduct(a, 1, residual, 0);
+	zmlMatrix zero = zmlZeroMatrix(n, 2);
+	const double orthogonal = zmlTestDifference(normal, zero);
+	ZML_CHECK(orthogonal < ZML_TEST_TOLERANCE * m * 10, "QR %ux%u: |A^T (AX - B)| = %g", m, n, orthogonal);
+
+	zmlFreeMatrix(&a);
+	zmlFreeMatrix(&qr);
+	zmlFreeVector(&tau);
+	zmlFreeMatrix(&x);
+	zmlFreeMatrix(&b);
+	zmlFreeMatrix(&solution);
+	zmlFreeMatrix(&residual);
+	zmlFreeMatrix(&normal);
+	zmlFreeMatrix(&zero);
+}
+
+int main() {
+	// one panel less than, at, and more than the 64-column panel width, and more than two panels
+	static const unsigned int sizes[] = { 1, 2, 63, 64, 65, 129 };
+
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		checkLU(sizes[s]);
+		checkCholesky(sizes[s]);
+		checkQR(sizes[s], sizes[s]);
+	}
+
+	// tall matrices
+	checkQR(150, 70);
+	checkQR(300, 129);
+	checkQR(40, 1);
+
+	// wide and non-square input is rejected
+	zmlMatrix wide = zmlTestRandomMatrix(3, 5);
+	zmlVector tau = zmlQRDecompose(&wide);
+	ZML_CHECK(tau.elements == NULL && tau.size == 0, "QR of a wide matrix didn't return a null vector");
+	ZML_CHECK(!zmlCholeskyDecompose(&wide), "Cholesky of a non-square matrix succeeded");
+	unsigned int pivots[3];
+	ZML_CHECK(!zmlLUDecompose(&wide, pivots), "LU of a non-square matrix succeeded");
+	zmlFreeMatrix(&wide);
+
+	return zmlTestResult("decompose");
+}
@@ -0,0 +1,217 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+
+// checks the expression layer in zetaml.hpp against the chain of _r functions it replaces: x + v * dt + 0.5 * a * dt * dt
+// evaluated into new, existing and resized vectors and matrices, with +=, and into existing zmlVectors and zmlMatrices
+// (including a strided view of a larger matrix) through zml::ref(), where the destination is often one of the operands.
+
+#include "test.h"
+#include <zetaml.hpp>
+
+static const zml::scalar dt = (zml::scalar) 0.01;
+
+// x + v * dt + 0.5 * a * dt * dt, one _r function per operator.
+static zmlVector chain(zmlVector x, zmlVector v, zmlVector a) {
+	zmlVector vdt = zmlMultiplyVecScalar_r(v, dt);
+	zmlVector sum = zmlAddVecs_r(x, vdt);
+	zmlVector ahalf = zmlMultiplyVecScalar_r(a, (zml::scalar) 0.5);
+	zmlVector adt = zmlMultiplyVecScalar_r(ahalf, dt);
+	zmlVector adt2 = zmlMultiplyVecScalar_r(adt, dt);
+	zmlVector r = zmlAddVecs_r(sum, adt2);
+
+	zmlFreeVector(&vdt);
+	zmlFreeVector(&sum);
+	zmlFreeVector(&ahalf);
+	zmlFreeVector(&adt);
+	zmlFreeVector(&adt2);
+	return r;
+}
+static zmlMatrix chain(zmlMatrix x, zmlMatrix v, zmlMatrix a) {
+	zmlMatrix vdt = zmlMultiplyMatScalar_r(v, dt);
+	zmlMatrix sum = zmlAddMats_r(x, vdt);
+	zmlMatrix ahalf = zmlMultiplyMatScalar_r(a, (zml::scalar) 0.5);
+	zmlMatrix adt = zmlMultiplyMatScalar_r(ahalf, dt);
+	zmlMatrix adt2 = zmlMultiplyMatScalar_r(adt, dt);
+	zmlMatrix r = zmlAddMats_r(sum, adt2);
+
+	zmlFreeMatrix(&vdt);
+	zmlFreeMatrix(&sum);
+	zmlFreeMatrix(&ahalf);
+	zmlFreeMatrix(&adt);
+	zmlFreeMatrix(&adt2);
+	return r;
+}
+
+static zml::vector randomVector(unsigned int size) {
+	zml::vector r(size);
+	for (unsigned int i = 0; i < size; i++) {
+		r[i] = zmlTestRandom() * 10;
+	}
+	return r;
+}
+
+// the largest difference between the elements of a and b, relative to the largest element of b (or 1, if that is smaller).
+// Vectors of different sizes differ infinitely.
+static double difference(const zmlVector &a, const zmlVector &b) {
+	if (a.size != b.size) {
+		return HUGE_VAL;
+	}
+	double diff = 0, scale = 1;
+	for (unsigned int i = 0; i < b.size; i++) {
+		diff = fmax(diff, fabs((double) a.elements[i] - (double) b.elements[i]));
+		scale = fmax(scale, fabs((double) b.elements[i]));
+	}
+	return diff / scale;
+}
+// (as zmlTestDifference(), through data and stride, so that views can be compared too)
+static double difference(const zmlMatrix &a, const zmlMatrix &b) {
+	if (a.rows != b.rows || a.cols != b.cols) {
+		return HUGE_VAL;
+	}
+	double diff = 0, scale = 1;
+	for (unsigned int r = 0; r < b.rows; r++) {
+		for (unsigned int c = 0; c < b.cols; c++) {
+			diff = fmax(diff, fabs((double) a.data[r * a.stride + c] - (double) b.data[r * b.stride + c]));
+			scale = fmax(scale, fabs((double) b.data[r * b.stride + c]));
+		}
+	}
+	return diff / scale;
+}
+
+static void checkVectors(unsigned int size) {
+	const zml::vector x = randomVector(size), v = randomVector(size), a = randomVector(size);
+	zmlVector expected = chain(x.get(), v.get(), a.get());
+
+	// into a new vector
+	const zml::vector next = x + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(next.get(), expected) < ZML_TEST_TOLERANCE, "size %u: new vector differs by %g", size, difference(next.get(), expected));
+
+	// into the vector being read
+	zml::vector y = x;
+	y = y + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(y.get(), expected) < ZML_TEST_TOLERANCE, "size %u: x = x + ... differs by %g", size, difference(y.get(), expected));
+
+	// into a vector of another size, which is reallocated
+	zml::vector resized(size + 3);
+	resized = x + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(resized.get(), expected) < ZML_TEST_TOLERANCE, "size %u: reallocated vector differs by %g", size,
+		difference(resized.get(), expected));
+
+	// with +=
+	zml::vector compound = x;
+	compound += v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(compound.get(), expected) < ZML_TEST_TOLERANCE, "size %u: x += ... differs by %g", size,
+		difference(compound.get(), expected));
+
+	// into an existing zmlVector, reading others through zml::ref()
+	zmlVector zx = zmlCopyVector(const_cast<zmlVector *>(&x.get()));
+	const zmlVector &zv = v.get();
+	zmlVector za = zmlCopyVector(const_cast<zmlVector *>(&a.get()));
+	zml::ref(zx) = zml::ref(zx) + zml::ref(zv) * dt + (zml::scalar) 0.5 * zml::ref(za) * dt * dt;
+	ZML_CHECK(difference(zx, expected) < ZML_TEST_TOLERANCE, "size %u: zml::ref(x) = ... differs by %g", size, difference(zx, expected));
+
+	// and with +=, mixing references with owned vectors
+	for (unsigned int i = 0; i < size; i++) {
+		zx.elements[i] = x[i];
+	}
+	zml::ref(zx) += v * dt + (zml::scalar) 0.5 * zml::ref(za) * dt * dt;
+	ZML_CHECK(difference(zx, expected) < ZML_TEST_TOLERANCE, "size %u: zml::ref(x) += ... differs by %g", size, difference(zx, expected));
+
+	// the other compound assignments, which read their destination too
+	zml::ref(zx) -= zml::ref(zx) * (zml::scalar) 0.5;
+	zml::ref(zx) *= (zml::scalar) 4;
+	zml::ref(zx) /= zml::ref(expected);
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < size; i++) {
+		wrong += (expected.elements[i] != 0 && fabs((double) zx.elements[i] - 2.0) > ZML_TEST_TOLERANCE * 10);
+	}
+	ZML_CHECK(wrong == 0, "size %u: -=, *= and /= through zml::ref() gave %u wrong elements", size, wrong);
+
+	zmlFreeVector(&zx);
+	zmlFreeVector(&za);
+	zmlFreeVector(&expected);
+}
+
+static zml::matrix randomMatrix(unsigned int rows, unsigned int cols) {
+	zml::matrix r = zml::matrix::adopt(zmlTestRandomMatrix(rows, cols));
+	r *= (zml::scalar) 10;
+	return r;
+}
+
+static void checkMatrices(unsigned int rows, unsigned int cols) {
+	const zml::matrix x = randomMatrix(rows, cols), v = randomMatrix(rows, cols), a = randomMatrix(rows, cols);
+	zmlMatrix expected = chain(x.get(), v.get(), a.get());
+
+	const zml::matrix next = x + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(next.get(), expected) < ZML_TEST_TOLERANCE, "%ux%u: new matrix differs by %g", rows, cols,
+		difference(next.get(), expected));
+
+	zml::matrix y = x;
+	y = y + v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(y.get(), expected) < ZML_TEST_TOLERANCE, "%ux%u: x = x + ... differs by %g", rows, cols, difference(y.get(), expected));
+
+	zml::matrix compound = x;
+	compound += v * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(compound.get(), expected) < ZML_TEST_TOLERANCE, "%ux%u: x += ... differs by %g", rows, cols,
+		difference(compound.get(), expected));
+
+	zmlMatrix zx = zmlCopyMatrix(const_cast<zmlMatrix *>(&x.get()));
+	zml::ref(zx) = zml::ref(zx) + zml::ref(v.get()) * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(zx, expected) < ZML_TEST_TOLERANCE, "%ux%u: zml::ref(x) = ... differs by %g", rows, cols, difference(zx, expected));
+	zmlFreeMatrix(&zx);
+
+	// a view of part of a larger matrix (whose rows are further apart than the view is wide), updated with +=
+	const unsigned int pad = 3;
+	zmlMatrix outer = zmlAllocMatrix(rows + 1, cols + pad);
+	for (unsigned int r = 0; r < outer.rows; r++) {
+		for (unsigned int c = 0; c < outer.cols; c++) {
+			outer.data[r * outer.stride + c] = (r >= 1 && c >= 1 && c <= cols) ? x(r - 1, c - 1) : (zml::scalar) -7;
+		}
+	}
+	zmlMatrix view = outer;
+	view.rows = rows;
+	view.cols = cols;
+	view.data = outer.data + outer.stride + 1;
+	view.elements = NULL;
+
+	zml::ref(view) += zml::ref(v.get()) * dt + (zml::scalar) 0.5 * a * dt * dt;
+	ZML_CHECK(difference(view, expected) < ZML_TEST_TOLERANCE, "%ux%u: zml::ref(view) += ... differs by %g", rows, cols,
+		difference(view, expected));
+
+	unsigned int touched = 0;
+	for (unsigned int r = 0; r < outer.rows; r++) {
+		for (unsigned int c = 0; c < outer.cols; c++) {
+			touched += !(r >= 1 && c >= 1 && c <= cols) && outer.data[r * outer.stride + c] != (zml::scalar) -7;
+		}
+	}
+	ZML_CHECK(touched == 0, "%ux%u: %u elements outside the view were changed", rows, cols, touched);
+
+	zmlFreeMatrix(&outer);
+	zmlFreeMatrix(&expected);
+}
+
+int main() {
+	static const unsigned int sizes[] = { 1, 3, 17, 1000, 4099 };
+	for (unsigned int size : sizes) {
+		checkVectors(size);
+	}
+
+	static const unsigned int shapes[][2] = { { 1, 1 }, { 3, 5 }, { 64, 33 }, { 100, 1 } };
+	for (const auto &shape : shapes) {
+		checkMatrices(shape[0], shape[1]);
+	}
+
+	return zmlTestResult("expressions");
+}
@@ -0,0 +1,224 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+
+// checks the compile-time-sized types in zetaml.hpp: zml::half against every 16-bit pattern and the rounding of known values
+// (ties to even, subnormals, overflow and NaN), and zml::mat4f and zml::mat4d against the zmlMat4 functions.
+
+#include "test.h"
+#include <zetaml.hpp>
+
+#include <cmath>
+#include <limits>
+
+static bool isNaNBits(std::uint16_t bits) {
+	return (bits & 0x7c00) == 0x7c00 && (bits & 0x3ff);
+}
+
+// every bit pattern converts to a float and back unchanged (NaNs stay NaNs with the same sign, though not the same payload).
+static void checkRoundTrips() {
+	unsigned int wrong = 0;
+	for (std::uint32_t bits = 0; bits <= 0xffff; bits++) {
+		const float f = zml::half::fromBits((std::uint16_t) bits);
+		const zml::half back = f;
+		if (isNaNBits((std::uint16_t) bits)) {
+			wrong += !(isNaNBits(back.bits) && (back.bits & 0x8000) == (bits & 0x8000));
+		} else {
+			wrong += (back.bits != bits);
+		}
+	}
+	ZML_CHECK(wrong == 0, "%u bit patterns didn't survive a round trip through float", wrong);
+}
+
+// a value exactly halfway between two neighbouring halves rounds to the even one, and anything either side of it to the
+// nearer one. The midpoints (each needing a bit more than a half's mantissa) are all exact in float.
+static void checkTies() {
+	unsigned int wrong = 0;
+	for (std::uint32_t bits = 0; bits < 0x7c00; bits++) {
+		const float lo = zml::half::fromBits((std::uint16_t) bits);
+		// (the value after the largest finite half is infinity, but 65520 is still its midpoint)
+		const float hi = (bits == 0x7bff) ? 65536.0f : (float) zml::half::fromBits((std::uint16_t) (bits + 1));
+		const float mid = (float) (((double) lo + (double) hi) / 2);
+
+		const std::uint16_t even = (std::uint16_t) ((bits & 1) ? bits + 1 : bits);
+		for (int sign = 0; sign < 2; sign++) {
+			const float s = sign ? -1.0f : 1.0f;
+			const std::uint16_t signBit = (std::uint16_t) (sign ? 0x8000 : 0);
+			wrong += (zml::half(s * mid).bits != (signBit | even));
+			wrong += (zml::half(s * std::nextafter(mid, 0.0f)).bits != (signBit | bits));
+			wrong += (zml::half(s * std::nextafter(mid, std::numeric_limits<float>::infinity())).bits != (signBit | (bits + 1)));
+		}
+	}
+	ZML_CHECK(wrong == 0, "%u values around the midpoints between halves were rounded the wrong way", wrong);
+}
+
+static void checkKnown(float f, std::uint16_t expected) {
+	const zml::half h = f;
+	ZML_CHECK(h.bits == expected, "%.9g became 0x%04x rather than 0x%04x", (double) f, (unsigned int) h.bits, (unsigned int) expected);
+}
+
+static void checkEncodings() {
+	checkKnown(0.0f, 0x0000);
+	checkKnown(-0.0f, 0x8000);
+	checkKnown(1.0f, 0x3c00);
+	checkKnown(-2.0f, 0xc000);
+	checkKnown(0.333333343f, 0x3555);
+	checkKnown(65504.0f, 0x7bff);
+
+	// ties to even between normals
+	checkKnown(1.0f + std::ldexp(1.0f, -11), 0x3c00);
+	checkKnown(1.0f + 3 * std::ldexp(1.0f, -11), 0x3c02);
+	checkKnown(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20), 0x3c01);
+	checkKnown(2049.0f, 0x6800);
+	checkKnown(2051.0f, 0x6802);
+
+	// subnormals, including ties at the bottom of the range and between the largest subnormal and the smallest normal
+	checkKnown(std::ldexp(1.0f, -24), 0x0001);
+	checkKnown(-std::ldexp(1.0f, -24), 0x8001);
+	checkKnown(std::ldexp(1.0f, -25), 0x0000);
+	checkKnown(-std::ldexp(1.0f, -25), 0x8000);
+	checkKnown(std::ldexp(1.0f, -25) * 1.001f, 0x0001);
+	checkKnown(std::ldexp(3.0f, -25), 0x0002);
+	checkKnown(std::ldexp(1023.0f, -24), 0x03ff);
+	checkKnown(std::ldexp(2047.0f, -25), 0x0400);
+	checkKnown(std::ldexp(1.0f, -14), 0x0400);
+	checkKnown(std::ldexp(1.0f, -30), 0x0000);
+	checkKnown(std::numeric_limits<float>::denorm_min(), 0x0000);
+
+	// overflow: 65520 is halfway between 65504 and 65536, which is out of range
+	checkKnown(std::nextafter(65520.0f, 0.0f), 0x7bff);
+	checkKnown(65520.0f, 0x7c00);
+	checkKnown(-65520.0f, 0xfc00);
+	checkKnown(1e10f, 0x7c00);
+	checkKnown(std::numeric_limits<float>::max(), 0x7c00);
+	checkKnown(std::numeric_limits<float>::infinity(), 0x7c00);
+	checkKnown(-std::numeric_limits<float>::infinity(), 0xfc00);
+
+	// NaNs stay NaNs, even when their payload is only in bits a half doesn't have
+	const float nans[] = { std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN(),
+		std::numeric_limits<float>::signaling_NaN() };
+	for (float nan : nans) {
+		const zml::half h = nan;
+		ZML_CHECK(isNaNBits(h.bits), "a NaN became 0x%04x", (unsigned int) h.bits);
+		ZML_CHECK(std::isnan((float) h), "a NaN didn't convert back to a NaN");
+	}
+	std::uint32_t lowPayload = 0x7f800001;
+	float nan;
+	std::memcpy(&nan, &lowPayload, sizeof(nan));
+	ZML_CHECK(isNaNBits(zml::half(nan).bits), "a NaN with only the lowest bit of its payload set became 0x%04x", (unsigned int) zml::half(nan).bits);
+}
+
+// -------------------------------------------
+// zml::mat4f and zml::mat4d against the zmlMat4 functions
+// -------------------------------------------
+
+static zmlMat4 randomMat4() {
+	zmlMat4 m;
+	for (int r = 0; r < 4; r++) {
+		for (int c = 0; c < 4; c++) {
+			// (kept well away from singular, so inverses can be compared)
+			m.elements[r][c] = zmlTestRandom() + ((r == c) ? 4 : 0);
+		}
+	}
+	return m;
+}
+
+// convert the C types (which hold the library's precision) to fixed-size types holding T.
+template <typename T>
+static zml::mat<4, 4, T> toMat4(const zmlMat4 &m) {
+	return zml::mat<4, 4, T>(zml::mat<4, 4>(m));
+}
+template <typename T>
+static zml::vec<3, T> toVec3(const zmlVec3 &v) {
+	return zml::vec<3, T>(zml::vec<3>(v));
+}
+template <typename T>
+static zml::vec<4, T> toVec4(const zmlVec4 &v) {
+	return zml::vec<4, T>(zml::vec<4>(v));
+}
+
+// the largest difference between the elements of a and b, relative to the largest element of b (or 1, if that is smaller).
+template <typename T>
+static double difference(const zml::mat<4, 4, T> &a, const zmlMat4 &b) {
+	double diff = 0, scale = 1;
+	for (int r = 0; r < 4; r++) {
+		for (int c = 0; c < 4; c++) {
+			diff = std::fmax(diff, std::fabs((double) a.elements[r][c] - (double) b.elements[r][c]));
+			scale = std::fmax(scale, std::fabs((double) b.elements[r][c]));
+		}
+	}
+	return diff / scale;
+}
+
+// T's results are compared at the lower of its precision and the library's.
+template <typename T>
+static void checkMatrices(const char *name, double tolerance) {
+	tolerance = std::fmax(tolerance, ZML_TEST_TOLERANCE);
+
+	for (int i = 0; i < 200; i++) {
+		const zmlMat4 a = randomMat4(), b = randomMat4();
+		const zml::mat<4, 4, T> fa = toMat4<T>(a), fb = toMat4<T>(b);
+
+		const double product = difference(fa * fb, zmlMultiplyMat4s_r(a, b));
+		ZML_CHECK(product < tolerance, "%s: product differs by %g", name, product);
+
+		zml::mat<4, 4, T> inplace = fa;
+		inplace *= fb;
+		const double compound = difference(inplace, zmlMultiplyMat4s_r(a, b));
+		ZML_CHECK(compound < tolerance, "%s: *= differs by %g", name, compound);
+
+		const zmlVec4 v = { { zmlTestRandom(), zmlTestRandom(), zmlTestRandom(), 1 } };
+		const zml::vec<4, T> fv = fa * toVec4<T>(v);
+		const zmlVec4 cv = zmlMultiplyVec4Mat4_r(v, a);
+		for (int k = 0; k < 4; k++) {
+			ZML_CHECK(std::fabs((double) fv[k] - (double) cv.elements[k]) < tolerance * 8, "%s: matrix-vector product element %d is %g rather than %g",
+				name, k, (double) fv[k], (double) cv.elements[k]);
+		}
+
+		const double inverse = difference(zml::inverted(fa), zmlInvertedMat4(a));
+		ZML_CHECK(inverse < tolerance, "%s: inverse differs by %g", name, inverse);
+		zml::mat<4, 4, T> invertedInPlace = fa;
+		ZML_CHECK(zml::invert(invertedInPlace), "%s: invert() found a non-singular matrix singular", name);
+		ZML_CHECK(difference(invertedInPlace, zmlInvertedMat4(a)) < tolerance, "%s: invert() differs from zmlInvertedMat4()", name);
+
+		const zmlVec3 pos = { { zmlTestRandom() * 10, zmlTestRandom() * 10, zmlTestRandom() * 10 } };
+		const zmlVec3 focus = { { pos.elements[0] + 1 + zmlTestRandom(), pos.elements[1] + zmlTestRandom(), pos.elements[2] + 1 } };
+		const zmlVec3 up = { { zmlTestRandom() * 0.1f, 1, zmlTestRandom() * 0.1f } };
+		const zml::vec<3, T> fpos = toVec3<T>(pos), ffocus = toVec3<T>(focus), fup = toVec3<T>(up);
+
+		// (the translations scale with the position, so they're compared relative to that)
+		const double lh = difference(zml::lookAtLH(fpos, ffocus, fup), zmlConstructLookAtMat4LH(pos, focus, up));
+		ZML_CHECK(lh < tolerance * 20, "%s: lookAtLH() differs by %g", name, lh);
+		const double rh = difference(zml::lookAtRH(fpos, ffocus, fup), zmlConstructLookAtMat4RH(pos, focus, up));
+		ZML_CHECK(rh < tolerance * 20, "%s: lookAtRH() differs by %g", name, rh);
+	}
+
+	// a singular matrix is reported, and left alone by invert()
+	zml::mat<4, 4, T> singular = zml::mat<4, 4, T>::zero();
+	singular.elements[0][0] = T(1.0f);
+	const zml::mat<4, 4, T> before = singular;
+	ZML_CHECK(!zml::invert(singular), "%s: invert() didn't report a singular matrix", name);
+	ZML_CHECK(singular == before, "%s: invert() changed a singular matrix", name);
+}
+
+int main() {
+	checkRoundTrips();
+	checkTies();
+	checkEncodings();
+
+	checkMatrices<float>("mat4f", 1e-5);
+	checkMatrices<double>("mat4d", 1e-12);
+
+	return zmlTestResult("fixed");
+}
@@ -0,0 +1,181 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks that vectors and matrices are formatted with exactly the digits snprintf("%.5f") gives for each element: ties,
+// negatives that round to zero, values either side of the point where the C library takes over, infinities and NaN. also
+// checks that output truncated to a small buffer is still null-terminated, and that zmlFPrintM() writes the same text.
+
+#include "test.h"
+#include <string.h>
+
+static const double specials[] = {
+	0.0, -0.0, 1.0, -1.0, 0.5, 0.000005, 0.000015, 0.000025, 2.5e-6, 7.5e-6, 0.0000049, 0.0000051, 1.000005, 2.675,
+	-0.000004, -0.0000001, -0.000005, -1e-300, 123456.789015, 99999.999995, 8.99999e10, 8.9999999999e10, 9.0e10,
+	9.0000001e10, -9.0e10, -8.99999e10, 1.8e11, 1e20, 1e300, -1e300,
+};
+
+// append text to the string at *p (which has room for it), moving *p along
+static void append(char **p, const char *text) {
+	size_t n = strlen(text);
+	memcpy(*p, text, n + 1);
+	*p += n;
+}
+
+static void appendFloating(char **p, __zml_floating val) {
+	char num[400];
+	snprintf(num, sizeof(num), "%.5f", (double) val);
+	append(p, num);
+}
+
+// the expected output of zmlFormatV(v)
+static void expectVector(zmlVector v, char *out) {
+	char head[32];
+	snprintf(head, sizeof(head), "(vec%u) ( ", v.size);
+	append(&out, head);
+	for (unsigned int i = 0; i < v.size; i++) {
+		if (i > 0) {
+			append(&out, ", ");
+		}
+		appendFloating(&out, v.elements[i]);
+	}
+	append(&out, " )");
+}
+
+// the expected output of zmlFormatM(m)
+static void expectMatrix(zmlMatrix m, char *out) {
+	char head[32];
+	int n = snprintf(head, sizeof(head), "(mat%ux%u) ", m.cols, m.rows);
+	append(&out, head);
+	for (unsigned int r = 0; r < m.rows; r++) {
+		if (r > 0) {
+			append(&out, ",\n");
+			for (int i = 0; i < n; i++) {
+				append(&out, " ");
+			}
+		}
+		append(&out, "[ ");
+		for (unsigned int c = 0; c < m.cols; c++) {
+			if (c > 0) {
+				append(&out, ", ");
+			}
+			appendFloating(&out, m.elements[r][c]);
+		}
+		append(&out, " ]");
+	}
+}
+
+static void checkVector(zmlVector v) {
+	char *expected = malloc((size_t) v.size * 400 + 64);
+	char *got = malloc((size_t) v.size * 400 + 64);
+	expectVector(v, expected);
+
+	size_t len = zmlFormatV(v, got, (size_t) v.size * 400 + 64);
+	ZML_CHECK(len == strlen(expected), "vec%u: length %zu, expected %zu", v.size, len, strlen(expected));
+	ZML_CHECK(strcmp(got, expected) == 0, "vec%u:\n%s\nexpected:\n%s", v.size, got, expected);
+	ZML_CHECK(zmlFormatV(v, NULL, 0) == len, "vec%u: zmlFormatV(v, NULL, 0) != %zu", v.size, len);
+
+	free(expected);
+	free(got);
+}
+
+static void checkMatrix(zmlMatrix m) {
+	const size_t cap = (size_t) m.rows * m.cols * 400 + (size_t) m.rows * 64 + 64;
+	char *expected = malloc(cap);
+	char *got = malloc(cap + 16);
+	expectMatrix(m, expected);
+	const size_t full = strlen(expected);
+
+	size_t len = zmlFormatM(m, got, cap);
+	ZML_CHECK(len == full, "mat%ux%u: length %zu, expected %zu", m.cols, m.rows, len, full);
+	ZML_CHECK(strcmp(got, expected) == 0, "mat%ux%u:\n%s\nexpected:\n%s", m.cols, m.rows, got, expected);
+	ZML_CHECK(zmlFormatM(m, NULL, 0) == full, "mat%ux%u: zmlFormatM(m, NULL, 0) != %zu", m.cols, m.rows, full);
+
+	// truncated output is a null-terminated prefix of the full output, and nothing past size is touched
+	for (size_t size = 1; size <= full + 2 && size < 300; size++) {
+		memset(got, 'x', size + 16);
+		len = zmlFormatM(m, got, size);
+		const size_t kept = (full < size) ? full : size - 1;
+		ZML_CHECK(len == full, "mat%ux%u, size %zu: returned %zu, expected %zu", m.cols, m.rows, size, len, full);
+		ZML_CHECK(got[kept] == '\0' && strncmp(got, expected, kept) == 0, "mat%ux%u, size %zu: bad truncated output", m.cols, m.rows, size);
+		ZML_CHECK(got[size] == 'x', "mat%ux%u, size %zu: wrote past the end of the buffer", m.cols, m.rows, size);
+	}
+	got[0] = 'x';
+	ZML_CHECK(zmlFormatM(m, got, 0) == full && got[0] == 'x', "mat%ux%u: size 0 wrote to the buffer", m.cols, m.rows);
+
+	// printing to a stream gives the same text
+	FILE *file = tmpfile();
+	if (file) {
+		size_t written = zmlFPrintM(m, file);
+		rewind(file);
+		size_t read = fread(got, 1, cap, file);
+		got[read] = '\0';
+		fclose(file);
+		ZML_CHECK(written == full && read == full, "mat%ux%u: zmlFPrintM() wrote %zu, read back %zu, expected %zu", m.cols, m.rows, written, read, full);
+		ZML_CHECK(strcmp(got, expected) == 0, "mat%ux%u: zmlFPrintM() output differs", m.cols, m.rows);
+	}
+
+	free(expected);
+	free(got);
+}
+
+int main() {
+	const unsigned int nspecials = sizeof(specials) / sizeof(specials[0]);
+
+	// the special values, plus infinity and NaN
+	zmlVector v = zmlAllocVector(nspecials + 3);
+	for (unsigned int i = 0; i < nspecials; i++) {
+		v.elements[i] = (__zml_floating) specials[i];
+	}
+	v.elements[nspecials] = (__zml_floating) INFINITY;
+	v.elements[nspecials + 1] = (__zml_floating) -INFINITY;
+	v.elements[nspecials + 2] = (__zml_floating) NAN;
+	checkVector(v);
+	zmlFreeVector(&v);
+
+	// values at and close to ties (k + 1/2) / 10^5, and random values over a wide range of magnitudes
+	v = zmlAllocVector(4000);
+	for (unsigned int i = 0; i < 4000; i += 4) {
+		double k = floor((zmlTestRandom() + 1) * 1e6);
+		double scale = pow(10.0, (double) ((i / 4) % 16) - 5);
+		v.elements[i] = (__zml_floating) ((k + 0.5) / 1e5);
+		v.elements[i + 1] = (__zml_floating) -((k + 0.5) / 1e5);
+		v.elements[i + 2] = (__zml_floating) nextafter((k + 0.5) / 1e5, 0);
+		v.elements[i + 3] = (__zml_floating) (zmlTestRandom() * scale);
+	}
+	checkVector(v);
+	zmlFreeVector(&v);
+
+	v = zmlAllocVector(0);
+	checkVector(v);
+	zmlFreeVector(&v);
+
+	// matrices of a few shapes, using the special values
+	static const unsigned int shapes[][2] = { { 1, 1 }, { 1, 5 }, { 5, 1 }, { 4, 4 }, { 3, 10 }, { 0, 0 } };
+	for (unsigned int s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+		zmlMatrix m = zmlAllocMatrix(shapes[s][0], shapes[s][1]);
+		for (unsigned int r = 0; r < m.rows; r++) {
+			for (unsigned int c = 0; c < m.cols; c++) {
+				m.elements[r][c] = (__zml_floating) specials[(r * m.cols + c) % nspecials];
+			}
+		}
+		if (m.rows * m.cols > 2) {
+			m.elements[0][1] = (__zml_floating) NAN;
+			m.elements[m.rows - 1][m.cols - 1] = (__zml_floating) -INFINITY;
+		}
+		checkMatrix(m);
+		zmlFreeMatrix(&m);
+	}
+
+	return zmlTestResult("format");
+}
@@ -0,0 +1,97 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks zmlGemm() against a naive triple loop, for every combination of transpose flags and for sizes that
+// exercise the small-matrix path, partial register tiles and more than one cache block in each dimension.
+
+#include "test.h"
+
+// the naive product alpha * op(a) * op(b) + beta * c, accumulated in double.
+static zmlMatrix naiveGemm(unsigned char transa, unsigned char transb, double alpha, zmlMatrix a, zmlMatrix b, double beta, zmlMatrix c) {
+	zmlMatrix r = zmlAllocMatrix(c.rows, c.cols);
+	const unsigned int k = transa ? a.rows : a.cols;
+
+	for (unsigned int i = 0; i < c.rows; i++) {
+		for (unsigned int j = 0; j < c.cols; j++) {
+			double sum = 0;
+			for (unsigned int p = 0; p < k; p++) {
+				const double x = transa ? a.elements[p][i] : a.elements[i][p];
+				const double y = transb ? b.elements[j][p] : b.elements[p][j];
+				sum += x * y;
+			}
+			r.elements[i][j] = (__zml_floating) (alpha * sum + ((beta == 0) ? 0 : beta * c.elements[i][j]));
+		}
+	}
+	return r;
+}
+
+int main() {
+	// m, n, k
+	static const unsigned int sizes[][3] = {
+		{ 1, 1, 1 }, { 3, 5, 7 }, { 13, 1, 9 }, { 1, 17, 4 }, { 31, 33, 29 },
+		{ 64, 64, 64 }, { 150, 70, 300 }, { 97, 130, 257 }, { 260, 300, 40 }
+	};
+
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		const unsigned int m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+
+		for (unsigned int flags = 0; flags < 4; flags++) {
+			const unsigned char transa = (flags & 1) ? ZML_TRANSPOSE : ZML_NO_TRANSPOSE;
+			const unsigned char transb = (flags & 2) ? ZML_TRANSPOSE : ZML_NO_TRANSPOSE;
+
+			zmlMatrix a = transa ? zmlTestRandomMatrix(k, m) : zmlTestRandomMatrix(m, k);
+			zmlMatrix b = transb ? zmlTestRandomMatrix(n, k) : zmlTestRandomMatrix(k, n);
+			zmlMatrix c = zmlTestRandomMatrix(m, n);
+
+			zmlMatrix expected = naiveGemm(transa, transb, 1.5, a, b, -0.5, c);
+			zmlGemm(transa, transb, (__zml_floating) 1.5, a, b, (__zml_floating) -0.5, &c);
+			const double diff = zmlTestDifference(c, expected);
+			ZML_CHECK(diff < ZML_TEST_TOLERANCE * k, "%ux%ux%u, transa %u, transb %u: difference %g", m, n, k, transa, transb, diff);
+
+			// beta = 0 must ignore whatever is in c, even NaNs
+			for (unsigned int i = 0; i < m; i++) {
+				for (unsigned int j = 0; j < n; j++) {
+					c.elements[i][j] = (__zml_floating) NAN;
+				}
+			}
+			zmlFreeMatrix(&expected);
+			expected = naiveGemm(transa, transb, 1.0, a, b, 0.0, c);
+			zmlGemm(transa, transb, (__zml_floating) 1.0, a, b, (__zml_floating) 0.0, &c);
+			const double diff0 = zmlTestDifference(c, expected);
+			ZML_CHECK(diff0 < ZML_TEST_TOLERANCE * k, "%ux%ux%u, transa %u, transb %u, beta 0: difference %g", m, n, k, transa, transb, diff0);
+
+			zmlFreeMatrix(&a);
+			zmlFreeMatrix(&b);
+			zmlFreeMatrix(&c);
+			zmlFreeMatrix(&expected);
+		}
+	}
+
+	// zmlMultiplyMats_r() goes through zmlGemm() too
+	{
+		zmlMatrix a = zmlTestRandomMatrix(40, 23), b = zmlTestRandomMatrix(23, 57), c = zmlZeroMatrix(40, 57);
+		zmlMatrix expected = naiveGemm(0, 0, 1.0, a, b, 0.0, c);
+		zmlMatrix product = zmlMultiplyMats_r(a, b);
+		const double diff = zmlTestDifference(product, expected);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 23, "zmlMultiplyMats_r(): difference %g", diff);
+
+		zmlFreeMatrix(&a);
+		zmlFreeMatrix(&b);
+		zmlFreeMatrix(&c);
+		zmlFreeMatrix(&expected);
+		zmlFreeMatrix(&product);
+	}
+
+	return zmlTestResult("gemm");
+}
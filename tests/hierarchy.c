@@ -0,0 +1,149 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks transform hierarchies against a brute-force pass over the nodes (world = parent's world * local), after nodes
+// have been added and after local transforms have been changed, and checks that all of a hierarchy's memory comes from
+// the zetaml allocator.
+
+#include "test.h"
+
+// counts the allocations made through it, passing them on to the default allocator
+typedef struct {
+	unsigned int allocs;
+	unsigned int frees;
+} allocationCounts;
+
+static void *countingAlloc(void *context, size_t size, size_t alignment) {
+	((allocationCounts *) context)->allocs++;
+	return ZML_DEFAULT_ALLOCATOR.alloc(ZML_DEFAULT_ALLOCATOR.context, size, alignment);
+}
+static void countingFree(void *context, void *ptr) {
+	((allocationCounts *) context)->frees++;
+	ZML_DEFAULT_ALLOCATOR.free(ZML_DEFAULT_ALLOCATOR.context, ptr);
+}
+
+// a random transform, close enough to the identity that long chains of them stay a sensible size
+static zmlMat4 randomTransform(void) {
+	zmlMat4 m;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int c = 0; c < 4; c++) {
+			m.elements[r][c] = zmlTestRandom() / 2 + (__zml_floating) (r == c);
+		}
+	}
+	return m;
+}
+
+static double difference(zmlMat4 a, zmlMat4 b) {
+	double diff = 0, scale = 1;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int c = 0; c < 4; c++) {
+			diff = fmax(diff, fabs((double) a.elements[r][c] - (double) b.elements[r][c]));
+			scale = fmax(scale, fabs((double) b.elements[r][c]));
+		}
+	}
+	return diff / scale;
+}
+
+// a pseudo-random index in [0, n)
+static unsigned int randomIndex(unsigned int n) {
+	return (unsigned int) ((zmlTestRandom() + 1) * 32768) % n;
+}
+
+int main() {
+	// (use several threads even on a machine with one core, so that the work at each depth really is split)
+	zmlSetThreadCount(4);
+
+	allocationCounts counts = { 0, 0 };
+	const zmlAllocator counting = { countingAlloc, countingFree, &counts };
+	zmlSetThreadAllocator(&counting);
+
+	const unsigned int n = 30000;
+	unsigned int *parents = malloc(n * sizeof(unsigned int));
+	zmlMat4 *locals = malloc(n * sizeof(zmlMat4)), *expected = malloc(n * sizeof(zmlMat4)), *worlds = malloc(n * sizeof(zmlMat4));
+
+	// a small capacity, so that the hierarchy has to grow
+	zmlHierarchy *h = zmlCreateHierarchy(4);
+	ZML_CHECK(h != NULL, "zmlCreateHierarchy() failed");
+	ZML_CHECK(counts.allocs > 0, "the hierarchy wasn't allocated through the zetaml allocator");
+
+	for (unsigned int round = 0; round < 3; round++) {
+		// add nodes, mostly as deep chains and wide fans of recent nodes, with the odd new root
+		const unsigned int start = zmlGetHierarchySize(h), end = start + n / 3;
+		for (unsigned int i = start; i < end; i++) {
+			if (i < 3 || randomIndex(50) == 0) {
+				parents[i] = ZML_NO_PARENT;
+			} else if (randomIndex(8) != 0) {
+				parents[i] = i - 1 - randomIndex(i < 20 ? i : 20);
+			} else {
+				parents[i] = randomIndex(i);
+			}
+			locals[i] = randomTransform();
+
+			const unsigned int handle = zmlAddHierarchyNode(h, parents[i], locals[i]);
+			ZML_CHECK(handle == i, "node %u was given handle %u", i, handle);
+		}
+
+		for (unsigned int frame = 0; frame < 4; frame++) {
+			// after the first frame, change some of the local transforms
+			const unsigned int count = zmlGetHierarchySize(h);
+			for (unsigned int k = 0; frame > 0 && k < count / 50; k++) {
+				const unsigned int i = randomIndex(count);
+				locals[i] = randomTransform();
+				zmlSetHierarchyLocal(h, i, locals[i]);
+			}
+
+			const unsigned int updated = zmlUpdateHierarchy(h);
+			ZML_CHECK(updated > 0 && updated <= count, "round %u frame %u: %u of %u nodes updated", round, frame, updated, count);
+
+			// parents always come before their children, so one pass in handle order is enough
+			for (unsigned int i = 0; i < count; i++) {
+				expected[i] = (parents[i] == ZML_NO_PARENT) ? locals[i] : zmlMultiplyMat4s_r(expected[parents[i]], locals[i]);
+			}
+			zmlCopyHierarchyWorlds(h, worlds);
+
+			double worst = 0;
+			for (unsigned int i = 0; i < count; i++) {
+				worst = fmax(worst, difference(worlds[i], expected[i]));
+			}
+			ZML_CHECK(worst < ZML_TEST_TOLERANCE * 10, "round %u frame %u: world transforms differ by %g", round, frame, worst);
+
+			const unsigned int last = count - 1;
+			ZML_CHECK(difference(zmlGetHierarchyWorld(h, last), expected[last]) < ZML_TEST_TOLERANCE * 10, "round %u frame %u: zmlGetHierarchyWorld() is wrong", round, frame);
+			ZML_CHECK(zmlGetHierarchyParent(h, last) == parents[last], "round %u frame %u: zmlGetHierarchyParent() is wrong", round, frame);
+			ZML_CHECK(difference(zmlGetHierarchyLocal(h, 7), locals[7]) == 0, "round %u frame %u: zmlGetHierarchyLocal() is wrong", round, frame);
+
+			// nothing has changed since
+			ZML_CHECK(zmlUpdateHierarchy(h) == 0, "round %u frame %u: an update with nothing changed did some work", round, frame);
+		}
+	}
+
+	// nodes that don't exist are rejected
+	ZML_CHECK(zmlAddHierarchyNode(h, n * 2, locals[0]) == ZML_NO_PARENT, "a node was added under a parent that doesn't exist");
+
+	zmlDestroyHierarchy(h);
+
+	zmlHierarchy *empty = zmlCreateHierarchy(0);
+	ZML_CHECK(zmlUpdateHierarchy(empty) == 0, "an empty hierarchy updated some nodes");
+	zmlDestroyHierarchy(empty);
+
+	ZML_CHECK(counts.allocs == counts.frees, "%u allocations but %u frees", counts.allocs, counts.frees);
+	zmlSetThreadAllocator(NULL);
+
+	free(parents);
+	free(locals);
+	free(expected);
+	free(worlds);
+
+	return zmlTestResult("hierarchy");
+}
@@ -0,0 +1,175 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks that the general, affine and rigid inverses satisfy A * inverse(A) = I, that singular matrices are rejected
+// and left unchanged, and that determinants match the product of a triangular matrix's diagonal.
+
+#include "test.h"
+
+// a random n x n matrix with a heavy diagonal, so that it is well conditioned.
+static zmlMatrix wellConditioned(unsigned int n) {
+	zmlMatrix m = zmlTestRandomMatrix(n, n);
+	for (unsigned int i = 0; i < n; i++) {
+		m.elements[i][i] += (__zml_floating) n;
+	}
+	return m;
+}
+
+static double identityError(zmlMatrix a, zmlMatrix inverse) {
+	zmlMatrix product = zmlMultiplyMats_r(a, inverse);
+	zmlMatrix identity = zmlIdentityMatrix(a.rows, a.cols);
+	const double diff = zmlTestDifference(product, identity);
+	zmlFreeMatrix(&product);
+	zmlFreeMatrix(&identity);
+	return diff;
+}
+
+static double identityErrorMat4(zmlMat4 a, zmlMat4 inverse) {
+	const zmlMat4 product = zmlMultiplyMat4s_r(a, inverse);
+	double diff = 0;
+	for (unsigned int r = 0; r < 4; r++) {
+		for (unsigned int c = 0; c < 4; c++) {
+			diff = fmax(diff, fabs((double) product.elements[r][c] - (r == c)));
+		}
+	}
+	return diff;
+}
+
+int main() {
+	// the 1-4 sizes have closed forms (and 4x4 affine matrices a faster one); larger sizes go through LU
+	static const unsigned int sizes[] = { 1, 2, 3, 4, 5, 8, 17, 70, 131 };
+
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		const unsigned int n = sizes[s];
+		zmlMatrix a = wellConditioned(n);
+
+		zmlMatrix inverse = zmlInverted(a);
+		ZML_CHECK(inverse.rows == n && inverse.cols == n, "%u: zmlInverted() failed", n);
+		const double diff = identityError(a, inverse);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * n, "%u: |A inverse(A) - I| = %g", n, diff);
+
+		// in place gives the same result
+		zmlMatrix copy = zmlCopyMatrix(&a);
+		ZML_CHECK(zmlInvert(&copy), "%u: zmlInvert() failed", n);
+		const double inPlace = zmlTestDifference(copy, inverse);
+		ZML_CHECK(inPlace < ZML_TEST_TOLERANCE, "%u: zmlInvert() differs from zmlInverted() by %g", n, inPlace);
+
+		// det(A) det(inverse(A)) = 1 (det(A) is around n^n, so only while that fits in a float)
+		if (n <= 17) {
+			const double det = (double) zmlDeterminant(a) * (double) zmlDeterminant(inverse);
+			ZML_CHECK(fabs(det - 1) < ZML_TEST_TOLERANCE * n * 10, "%u: det(A) det(inverse(A)) = %g", n, det);
+		}
+
+		// a singular matrix (with a zero row, so that it stays exactly singular after rounding) is rejected and left alone
+		if (n > 1) {
+			zmlMatrix singular = zmlCopyMatrix(&a);
+			for (unsigned int c = 0; c < n; c++) {
+				singular.elements[n - 1][c] = 0;
+			}
+			zmlMatrix before = zmlCopyMatrix(&singular);
+			ZML_CHECK(!zmlInvert(&singular), "%u: singular matrix inverted", n);
+			ZML_CHECK(zmlTestDifference(singular, before) == 0, "%u: singular matrix was changed", n);
+			ZML_CHECK(zmlDeterminant(before) == 0, "%u: singular determinant %g", n, (double) zmlDeterminant(before));
+			zmlFreeMatrix(&singular);
+			zmlFreeMatrix(&before);
+		}
+
+		// the determinant of a triangular matrix, with two rows swapped, is minus the product of its diagonal
+		zmlMatrix upper = zmlZeroMatrix(n, n);
+		double product = 1;
+		for (unsigned int r = 0; r < n; r++) {
+			for (unsigned int c = r; c < n; c++) {
+				upper.elements[r][c] = zmlTestRandom();
+			}
+			upper.elements[r][r] = (__zml_floating) (1.0 + 0.25 * (r % 3));
+			product *= (double) upper.elements[r][r];
+		}
+		if (n > 1) {
+			for (unsigned int c = 0; c < n; c++) {
+				const __zml_floating t = upper.elements[0][c];
+				upper.elements[0][c] = upper.elements[1][c];
+				upper.elements[1][c] = t;
+			}
+			product = -product;
+		}
+		const double triangular = (double) zmlDeterminant(upper);
+		ZML_CHECK(fabs(triangular - product) < ZML_TEST_TOLERANCE * fabs(product) * n, "%u: determinant %g, expected %g", n, triangular, product);
+
+		zmlFreeMatrix(&a);
+		zmlFreeMatrix(&inverse);
+		zmlFreeMatrix(&copy);
+		zmlFreeMatrix(&upper);
+	}
+
+	// fixed-size inverses
+	{
+		zmlMat4 general;
+		for (unsigned int r = 0; r < 4; r++) {
+			for (unsigned int c = 0; c < 4; c++) {
+				general.elements[r][c] = zmlTestRandom() + (__zml_floating) (r == c ? 4 : 0);
+			}
+		}
+		double diff = identityErrorMat4(general, zmlInvertedMat4(general));
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "zmlInvertedMat4(): |A inverse(A) - I| = %g", diff);
+
+		zmlMat3 m3;
+		for (unsigned int r = 0; r < 3; r++) {
+			for (unsigned int c = 0; c < 3; c++) {
+				m3.elements[r][c] = general.elements[r][c];
+			}
+		}
+		const zmlMat3 i3 = zmlInvertedMat3(m3);
+		diff = 0;
+		for (unsigned int r = 0; r < 3; r++) {
+			for (unsigned int c = 0; c < 3; c++) {
+				double sum = 0;
+				for (unsigned int k = 0; k < 3; k++) {
+					sum += (double) m3.elements[r][k] * (double) i3.elements[k][c];
+				}
+				diff = fmax(diff, fabs(sum - (r == c)));
+			}
+		}
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "zmlInvertedMat3(): |A inverse(A) - I| = %g", diff);
+
+		// translate * rotate * scale is affine
+		const zmlVec3 translation = { { 1, -2, 3 } }, scale = { { 2, (__zml_floating) 0.5, 3 } };
+		const zmlMat4 affine = zmlScaledMat4(zmlRotatedMat4(zmlTranslateIdentityMat4(translation), (__zml_floating) 0.7, 1, 2, 3), scale);
+		diff = identityErrorMat4(affine, zmlInvertedAffineMat4(affine));
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "zmlInvertedAffineMat4(): |A inverse(A) - I| = %g", diff);
+		diff = identityErrorMat4(affine, zmlInvertedMat4(affine));
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "zmlInvertedMat4() of an affine matrix: |A inverse(A) - I| = %g", diff);
+
+		// a view matrix is rigid
+		const zmlVec3 pos = { { 3, 4, -10 } }, focus = { { 0, 1, 0 } }, up = { { 0, 1, 0 } };
+		const zmlMat4 view = zmlConstructLookAtMat4RH(pos, focus, up);
+		diff = identityErrorMat4(view, zmlInvertedRigidMat4(view));
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "zmlInvertedRigidMat4(): |A inverse(A) - I| = %g", diff);
+
+		// singular fixed-size matrices give zero matrices
+		zmlMat4 singular = general;
+		for (unsigned int c = 0; c < 4; c++) {
+			singular.elements[3][c] = 0;
+		}
+		const zmlMat4 zero = zmlInvertedMat4(singular);
+		unsigned char allZero = 1;
+		for (unsigned int r = 0; r < 4; r++) {
+			for (unsigned int c = 0; c < 4; c++) {
+				allZero &= zero.elements[r][c] == 0;
+			}
+		}
+		ZML_CHECK(allZero, "zmlInvertedMat4() of a singular matrix isn't zero");
+	}
+
+	return zmlTestResult("inverse");
+}
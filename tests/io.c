@@ -0,0 +1,256 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks saving matrices to files and reading them back with zmlLoadMatrix() and zmlMapMatrix(), including strided
+// matrices, files of the other floating type (with padded rows), files written a few rows at a time, and rejecting
+// files that are damaged: a bad magic number or version, a truncated payload, or elements beyond the end of the file.
+
+#include "test.h"
+#include <string.h>
+#include <stdint.h>
+
+// the file the tests write (named after the ZML_CPU setting, so that variants of the test can run at the same time)
+static char path[64] = "zmltest_io.zml";
+
+// the layout of a matrix file's header (see src/io.c), so that files can be written by hand
+typedef struct {
+	char magic[4];
+	uint32_t byteOrder;
+	uint32_t version;
+	uint32_t elementSize;
+	uint32_t rows;
+	uint32_t cols;
+	uint32_t stride;
+	uint32_t alignment;
+	uint64_t offset;
+	uint64_t size;
+	unsigned char reserved[16];
+} fileHeader;
+
+static fileHeader makeHeader(unsigned int rows, unsigned int cols, unsigned int stride, uint32_t elementSize) {
+	fileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, "ZMLM", 4);
+	h.byteOrder = 0x01020304u;
+	h.version = 1;
+	h.elementSize = elementSize;
+	h.rows = rows;
+	h.cols = cols;
+	h.stride = stride;
+	h.alignment = 64;
+	h.offset = 64;
+	h.size = (uint64_t) rows * stride * elementSize;
+	return h;
+}
+
+// write a header followed by length bytes of payload to path
+static void writeFile(const fileHeader *h, const void *payload, size_t length) {
+	FILE *file = fopen(path, "wb");
+	if (!file) {
+		ZML_CHECK(0, "couldn't write '%s'", path);
+		return;
+	}
+	fwrite(h, sizeof(*h), 1, file);
+	fwrite(payload, 1, length, file);
+	fclose(file);
+}
+
+// the elements of a match those of b exactly
+static unsigned char same(zmlMatrix a, zmlMatrix b) {
+	if (!a.elements || a.rows != b.rows || a.cols != b.cols) {
+		return 0;
+	}
+	for (unsigned int r = 0; r < b.rows; r++) {
+		for (unsigned int c = 0; c < b.cols; c++) {
+			if (a.elements[r][c] != b.elements[r][c]) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+// save m, then check that loading and mapping the file give it back
+static void checkRoundTrip(zmlMatrix m, const char *what) {
+	ZML_CHECK(zmlSaveMatrix(m, path), "%s: zmlSaveMatrix() failed", what);
+
+	zmlMatrix loaded = zmlLoadMatrix(path);
+	ZML_CHECK(same(loaded, m), "%s: the loaded matrix differs", what);
+	zmlFreeMatrix(&loaded);
+
+	zmlMatrix mapped = zmlMapMatrix(path);
+	ZML_CHECK(same(mapped, m), "%s: the mapped matrix differs", what);
+	zmlUnmapMatrix(&mapped);
+}
+
+// check that both ways of reading path reject it
+static void checkRejected(const char *what) {
+	zmlMatrix loaded = zmlLoadMatrix(path);
+	ZML_CHECK(loaded.elements == NULL, "%s: zmlLoadMatrix() accepted the file", what);
+	zmlFreeMatrix(&loaded);
+
+	zmlMatrix mapped = zmlMapMatrix(path);
+	ZML_CHECK(mapped.elements == NULL, "%s: zmlMapMatrix() accepted the file", what);
+	zmlUnmapMatrix(&mapped);
+}
+
+// a file of floats or doubles (whichever zetaml wasn't built with), with two elements of padding after each row
+static void checkOtherType(void) {
+	const unsigned int rows = 13, cols = 7, stride = cols + 2;
+	const uint32_t elementSize = (sizeof(__zml_floating) == sizeof(float)) ? sizeof(double) : sizeof(float);
+
+	zmlMatrix expected = zmlAllocMatrix(rows, cols);
+	unsigned char *payload = malloc((size_t) rows * stride * elementSize);
+	for (unsigned int r = 0; r < rows; r++) {
+		for (unsigned int c = 0; c < stride; c++) {
+			// (values that convert exactly both ways, so the result can be compared exactly)
+			const float val = (float) zmlTestRandom();
+			if (elementSize == sizeof(float)) {
+				((float *) payload)[r * stride + c] = val;
+			} else {
+				((double *) payload)[r * stride + c] = val;
+			}
+			if (c < cols) {
+				expected.elements[r][c] = (__zml_floating) val;
+			}
+		}
+	}
+
+	fileHeader h = makeHeader(rows, cols, stride, elementSize);
+	writeFile(&h, payload, (size_t) h.size);
+
+	zmlMatrix loaded = zmlLoadMatrix(path);
+	ZML_CHECK(same(loaded, expected), "the matrix loaded from a file of %s differs", (elementSize == sizeof(float)) ? "floats" : "doubles");
+	zmlFreeMatrix(&loaded);
+
+	// (mapping can't convert the elements)
+	zmlMatrix mapped = zmlMapMatrix(path);
+	ZML_CHECK(mapped.elements == NULL, "zmlMapMatrix() accepted a file of the other floating type");
+	zmlUnmapMatrix(&mapped);
+
+	free(payload);
+	zmlFreeMatrix(&expected);
+}
+
+static void checkDamaged(void) {
+	const unsigned int rows = 5, cols = 4;
+	__zml_floating payload[5 * 4] = { 0 };
+	const fileHeader good = makeHeader(rows, cols, cols, sizeof(__zml_floating));
+
+	writeFile(&good, payload, sizeof(payload));
+	zmlMatrix loaded = zmlLoadMatrix(path);
+	ZML_CHECK(loaded.elements != NULL, "an undamaged file was rejected");
+	zmlFreeMatrix(&loaded);
+
+	fileHeader h = good;
+	memcpy(h.magic, "ZMLX", 4);
+	writeFile(&h, payload, sizeof(payload));
+	checkRejected("bad magic");
+
+	h = good;
+	h.version = 2;
+	writeFile(&h, payload, sizeof(payload));
+	checkRejected("bad version");
+
+	h = good;
+	writeFile(&h, payload, sizeof(payload) - sizeof(__zml_floating));
+	checkRejected("truncated payload");
+
+	writeFile(&h, payload, 0);
+	checkRejected("no payload");
+
+	h = good;
+	h.offset = (uint64_t) 1 << 40;
+	writeFile(&h, payload, sizeof(payload));
+	checkRejected("offset beyond the file");
+
+	h = good;
+	h.size = UINT64_MAX - 8;
+	writeFile(&h, payload, sizeof(payload));
+	checkRejected("size beyond the file");
+
+	h = good;
+	h.rows = rows + 1;
+	writeFile(&h, payload, sizeof(payload));
+	checkRejected("more rows than the size holds");
+
+	FILE *file = fopen(path, "wb");
+	if (file) {
+		fwrite("ZMLM", 1, 4, file);
+		fclose(file);
+	}
+	checkRejected("truncated header");
+}
+
+static void checkWriter(void) {
+	const unsigned int rows = 10, cols = 6;
+	zmlMatrix m = zmlTestRandomMatrix(rows, cols);
+
+	// a few rows at a time
+	zmlMatrixWriter *writer = zmlOpenMatrixWriter(path, rows, cols);
+	ZML_CHECK(writer != NULL, "zmlOpenMatrixWriter() failed");
+	if (!writer) {
+		zmlFreeMatrix(&m);
+		return;
+	}
+	ZML_CHECK(zmlWriteMatrixRows(writer, m.elements[0], 3), "writing rows 0-2 failed");
+	ZML_CHECK(zmlWriteMatrixRows(writer, m.elements[3], 0), "writing no rows failed");
+	ZML_CHECK(zmlWriteMatrixRows(writer, m.elements[3], 7), "writing rows 3-9 failed");
+	ZML_CHECK(!zmlWriteMatrixRows(writer, m.elements[0], 1), "writing past the last row succeeded");
+	ZML_CHECK(zmlCloseMatrixWriter(writer), "closing a complete writer failed");
+
+	zmlMatrix loaded = zmlLoadMatrix(path);
+	ZML_CHECK(same(loaded, m), "the matrix written a few rows at a time differs");
+	zmlFreeMatrix(&loaded);
+
+	// fewer rows than declared
+	writer = zmlOpenMatrixWriter(path, rows, cols);
+	if (writer) {
+		zmlWriteMatrixRows(writer, m.elements[0], 4);
+		ZML_CHECK(!zmlCloseMatrixWriter(writer), "closing a writer with only 4 of its 10 rows written succeeded");
+	}
+	checkRejected("fewer rows than declared");
+
+	zmlFreeMatrix(&m);
+}
+
+int main() {
+	const char *cpu = getenv("ZML_CPU");
+	if (cpu && strlen(cpu) < 32) {
+		snprintf(path, sizeof(path), "zmltest_io_%s.zml", cpu);
+	}
+
+	static const unsigned int shapes[][2] = { { 1, 1 }, { 1, 17 }, { 17, 1 }, { 8, 8 }, { 37, 23 }, { 300, 129 } };
+	for (unsigned int s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+		char what[64];
+		snprintf(what, sizeof(what), "%ux%u", shapes[s][0], shapes[s][1]);
+		zmlMatrix m = zmlTestRandomMatrix(shapes[s][0], shapes[s][1]);
+		checkRoundTrip(m, what);
+		zmlFreeMatrix(&m);
+	}
+
+	// the left 23 columns of a 37 x 30 matrix (so each row is followed by 7 elements that aren't part of it)
+	zmlMatrix whole = zmlTestRandomMatrix(37, 30);
+	zmlMatrix view = whole;
+	view.cols = 23;
+	checkRoundTrip(view, "strided 37x23");
+	zmlFreeMatrix(&whole);
+
+	checkOtherType();
+	checkDamaged();
+	checkWriter();
+
+	remove(path);
+	return zmlTestResult("io");
+}
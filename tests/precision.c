@@ -0,0 +1,228 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks the float and double entry points, which are built into the library whatever __zml_floating is: zmlGemmf() and
+// zmlGemmd() against a naive product, the typed matrix-vector product and conversions, and the array functions on arrays big
+// enough to be split across threads.
+
+#include "test.h"
+#include <string.h>
+
+// 1 + a small pseudo-random difference, so that sums of many values don't cancel out
+static double positive(void) {
+	return 1.0 + 0.5 * (double) zmlTestRandom();
+}
+
+// the largest difference between a[i] and b[i], relative to the largest b[i] (or 1)
+static double arrayDifference(const double *a, const double *b, size_t n) {
+	double diff = 0, scale = 1;
+	for (size_t i = 0; i < n; i++) {
+		diff = fmax(diff, fabs(a[i] - b[i]));
+		scale = fmax(scale, fabs(b[i]));
+	}
+	return diff / scale;
+}
+
+// c = alpha * op(a) * op(b) + beta * c, in double, for row-major m x k, k x n and m x n arrays (before op() is applied)
+static void naiveGemm(unsigned char transa, unsigned char transb, double alpha, const double *a, const double *b, double beta, double *c,
+	size_t m, size_t n, size_t k) {
+	for (size_t i = 0; i < m; i++) {
+		for (size_t j = 0; j < n; j++) {
+			double sum = 0;
+			for (size_t p = 0; p < k; p++) {
+				sum += (transa ? a[p * m + i] : a[i * k + p]) * (transb ? b[j * k + p] : b[p * n + j]);
+			}
+			c[i * n + j] = alpha * sum + beta * c[i * n + j];
+		}
+	}
+}
+
+static void checkGemm(unsigned int m, unsigned int n, unsigned int k) {
+	double *a = malloc((size_t) m * k * sizeof(double)), *b = malloc((size_t) k * n * sizeof(double));
+	double *c = malloc((size_t) m * n * sizeof(double)), *expected = malloc((size_t) m * n * sizeof(double));
+	double *result = malloc((size_t) m * n * sizeof(double));
+	for (size_t i = 0; i < (size_t) m * k; i++) a[i] = zmlTestRandom();
+	for (size_t i = 0; i < (size_t) k * n; i++) b[i] = zmlTestRandom();
+	for (size_t i = 0; i < (size_t) m * n; i++) c[i] = zmlTestRandom();
+
+	for (unsigned int trans = 0; trans < 4; trans++) {
+		const unsigned char ta = trans & 1, tb = (trans >> 1) & 1;
+		memcpy(expected, c, (size_t) m * n * sizeof(double));
+		naiveGemm(ta, tb, 1.5, a, b, -0.5, expected, m, n, k);
+
+		// op(a) is m x k, so a itself is k x m if it's transposed
+		zmlMatrixd ad = zmlAllocMatrixd(ta ? k : m, ta ? m : k), bd = zmlAllocMatrixd(tb ? n : k, tb ? k : n), cd = zmlAllocMatrixd(m, n);
+		memcpy(ad.data, a, (size_t) m * k * sizeof(double));
+		memcpy(bd.data, b, (size_t) k * n * sizeof(double));
+		memcpy(cd.data, c, (size_t) m * n * sizeof(double));
+		zmlGemmd(ta, tb, 1.5, ad, bd, -0.5, &cd);
+		double diff = arrayDifference(cd.data, expected, (size_t) m * n);
+		ZML_CHECK(diff < 1e-10 * k, "zmlGemmd() %ux%ux%u (trans %u): relative error %g", m, n, k, trans, diff);
+
+		zmlMatrixf af = zmlAllocMatrixf(ad.rows, ad.cols), bf = zmlAllocMatrixf(bd.rows, bd.cols), cf = zmlAllocMatrixf(m, n);
+		zmlDoublesToFloats(af.data, a, (size_t) m * k);
+		zmlDoublesToFloats(bf.data, b, (size_t) k * n);
+		zmlDoublesToFloats(cf.data, c, (size_t) m * n);
+		zmlGemmf(ta, tb, 1.5f, af, bf, -0.5f, &cf);
+		zmlFloatsToDoubles(result, cf.data, (size_t) m * n);
+		diff = arrayDifference(result, expected, (size_t) m * n);
+		ZML_CHECK(diff < 1e-5 * k, "zmlGemmf() %ux%ux%u (trans %u): relative error %g", m, n, k, trans, diff);
+
+		zmlFreeMatrixd(&ad);
+		zmlFreeMatrixd(&bd);
+		zmlFreeMatrixd(&cd);
+		zmlFreeMatrixf(&af);
+		zmlFreeMatrixf(&bf);
+		zmlFreeMatrixf(&cf);
+	}
+
+	free(a);
+	free(b);
+	free(c);
+	free(expected);
+	free(result);
+}
+
+static void checkMatVec(unsigned int rows, unsigned int cols) {
+	zmlMatrix mat = zmlTestRandomMatrix(rows, cols);
+	zmlMatrixf matf = zmlMatrixToFloats(mat);
+	zmlMatrixd matd = zmlMatrixToDoubles(mat);
+
+	zmlVector vec = zmlAllocVector(cols);
+	for (unsigned int i = 0; i < cols; i++) {
+		vec.elements[i] = zmlTestRandom();
+	}
+	zmlVectorf vecf = zmlVectorToFloats(vec);
+	zmlVectord vecd = zmlVectorToDoubles(vec);
+
+	zmlVectorf dstf = zmlAllocVectorf(rows);
+	zmlVectord dstd = zmlAllocVectord(rows);
+	zmlMultiplyMatVecIntof(&dstf, matf, vecf);
+	zmlMultiplyMatVecIntod(&dstd, matd, vecd);
+
+	double errorf = 0, errord = 0;
+	for (unsigned int r = 0; r < rows; r++) {
+		double expected = 0;
+		for (unsigned int c = 0; c < cols; c++) {
+			expected += (double) mat.elements[r][c] * (double) vec.elements[c];
+		}
+		errorf = fmax(errorf, fabs(dstf.elements[r] - expected));
+		errord = fmax(errord, fabs(dstd.elements[r] - expected));
+	}
+	// (the inputs may already have been rounded to floats if __zml_floating is float, so they're the same in every type)
+	ZML_CHECK(errorf < 1e-5 * cols, "zmlMultiplyMatVecIntof() %ux%u: error %g", rows, cols, errorf);
+	ZML_CHECK(errord < 1e-12 * cols, "zmlMultiplyMatVecIntod() %ux%u: error %g", rows, cols, errord);
+
+	// the conversions back give the original values
+	zmlMatrix back = zmlMatrixFromDoubles(matd);
+	ZML_CHECK(zmlTestDifference(back, mat) == 0, "%ux%u: zmlMatrixFromDoubles() of zmlMatrixToDoubles() isn't the original", rows, cols);
+	zmlFreeMatrix(&back);
+	back = zmlMatrixFromFloats(matf);
+	ZML_CHECK(zmlTestDifference(back, mat) < 1e-7, "%ux%u: zmlMatrixFromFloats() of zmlMatrixToFloats() isn't the original", rows, cols);
+	zmlFreeMatrix(&back);
+
+	zmlVector vecBack = zmlVectorFromDoubles(vecd);
+	ZML_CHECK(memcmp(vecBack.elements, vec.elements, cols * sizeof(__zml_floating)) == 0, "%u: zmlVectorFromDoubles() of zmlVectorToDoubles() isn't the original", cols);
+	zmlFreeVector(&vecBack);
+
+	// the dot product of the vector with the first row is the first element
+	ZML_CHECK(fabs(zmlDotVecsd(vecd, (zmlVectord) { cols, matd.data }) - dstd.elements[0]) < 1e-12 * cols, "%u: zmlDotVecsd() is wrong", cols);
+
+	zmlFreeMatrix(&mat);
+	zmlFreeMatrixf(&matf);
+	zmlFreeMatrixd(&matd);
+	zmlFreeVector(&vec);
+	zmlFreeVectorf(&vecf);
+	zmlFreeVectord(&vecd);
+	zmlFreeVectorf(&dstf);
+	zmlFreeVectord(&dstd);
+}
+
+// arrays of n values: dot products, sums, axpy and the element-wise operators
+static void checkArrays(size_t n) {
+	float *af = malloc(n * sizeof(float)), *bf = malloc(n * sizeof(float)), *yf = malloc(n * sizeof(float));
+	double *ad = malloc(n * sizeof(double)), *bd = malloc(n * sizeof(double)), *yd = malloc(n * sizeof(double));
+	for (size_t i = 0; i < n; i++) {
+		ad[i] = positive();
+		bd[i] = positive();
+	}
+	zmlDoublesToFloats(af, ad, n);
+	zmlDoublesToFloats(bf, bd, n);
+	zmlFloatsToDoubles(yd, af, n);
+
+	double dotf = 0, dotd = 0, sumf = 0, sumd = 0;
+	unsigned char converted = 1;
+	for (size_t i = 0; i < n; i++) {
+		dotf += (double) af[i] * (double) bf[i];
+		dotd += ad[i] * bd[i];
+		sumf += (double) af[i];
+		sumd += ad[i];
+		converted &= af[i] == (float) ad[i] && yd[i] == (double) af[i];
+	}
+	ZML_CHECK(converted, "%zu: conversions between floats and doubles are wrong", n);
+
+	// everything is accumulated in double, so the sums are close to exact whatever the type of the arrays
+	ZML_CHECK(fabs(zmlDotf(af, bf, n) - dotf) < 1e-12 * dotf, "%zu: zmlDotf() = %.17g, expected %.17g", n, zmlDotf(af, bf, n), dotf);
+	ZML_CHECK(fabs(zmlDotd(ad, bd, n) - dotd) < 1e-12 * dotd, "%zu: zmlDotd() = %.17g, expected %.17g", n, zmlDotd(ad, bd, n), dotd);
+	ZML_CHECK(fabs(zmlSumf(af, n) - sumf) < 1e-12 * sumf, "%zu: zmlSumf() = %.17g, expected %.17g", n, zmlSumf(af, n), sumf);
+	ZML_CHECK(fabs(zmlSumd(ad, n) - sumd) < 1e-12 * sumd, "%zu: zmlSumd() = %.17g, expected %.17g", n, zmlSumd(ad, n), sumd);
+
+	// axpy and the element-wise operators are exact in their own type
+	memcpy(yf, bf, n * sizeof(float));
+	memcpy(yd, bd, n * sizeof(double));
+	zmlAxpyf(yf, 2.0f, af, n);
+	zmlAxpyd(yd, 2.0, ad, n);
+	unsigned char axpy = 1;
+	for (size_t i = 0; i < n; i++) {
+		axpy &= fabsf(yf[i] - (bf[i] + 2.0f * af[i])) <= 1e-6f * fabsf(yf[i]) && fabs(yd[i] - (bd[i] + 2.0 * ad[i])) <= 1e-15 * fabs(yd[i]);
+	}
+	ZML_CHECK(axpy, "%zu: zmlAxpyf() or zmlAxpyd() is wrong", n);
+
+	zmlMultiplyArraysf(yf, af, bf, n);
+	zmlSubtractArrayScalard(yd, ad, 0.25, n);
+	unsigned char elementwise = 1;
+	for (size_t i = 0; i < n; i++) {
+		elementwise &= yf[i] == af[i] * bf[i] && yd[i] == ad[i] - 0.25;
+	}
+	ZML_CHECK(elementwise, "%zu: element-wise operators are wrong", n);
+
+	free(af);
+	free(bf);
+	free(yf);
+	free(ad);
+	free(bd);
+	free(yd);
+}
+
+int main() {
+	// (use several threads even on a machine with one core, so that the work really is split)
+	zmlSetThreadCount(4);
+
+	// small (unpacked), packed, and big enough to be split across threads
+	checkGemm(1, 1, 1);
+	checkGemm(7, 13, 5);
+	checkGemm(97, 130, 257);
+	checkGemm(300, 200, 150);
+
+	checkMatVec(1, 1);
+	checkMatVec(17, 33);
+	checkMatVec(700, 300);
+
+	// one block, and several blocks (with a partial one at the end) of the reductions that are split across threads
+	checkArrays(1);
+	checkArrays(1000);
+	checkArrays((1 << 19) * 3 + 17);
+
+	return zmlTestResult("precision");
+}
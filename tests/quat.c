@@ -0,0 +1,206 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks converting rotations between quaternions and Euler angles (for every order, including at and near gimbal
+// lock), axes and angles, and rotation matrices, in both directions, and slerp's endpoints and midpoints.
+
+#include "test.h"
+
+static const zmlEulerOrder orders[] = { ZML_EULER_XYZ, ZML_EULER_ZYX, ZML_EULER_YXZ };
+static const char *orderNames[] = { "XYZ", "ZYX", "YXZ" };
+
+// (rotations are compared through their matrices, which don't depend on the sign of the quaternion)
+static double rotationDifference(zmlQuat a, zmlQuat b) {
+	const zmlMat3 ma = zmlQuatToMat3(zmlNormalisedQuat(a)), mb = zmlQuatToMat3(zmlNormalisedQuat(b));
+	double diff = 0;
+	for (unsigned int r = 0; r < 3; r++) {
+		for (unsigned int c = 0; c < 3; c++) {
+			diff = fmax(diff, fabs((double) ma.elements[r][c] - (double) mb.elements[r][c]));
+		}
+	}
+	return diff;
+}
+
+static zmlQuat randomQuat(void) {
+	zmlQuat q = { { zmlTestRandom(), zmlTestRandom(), zmlTestRandom(), zmlTestRandom() } };
+	return zmlNormalisedQuat(q);
+}
+
+// the angle of an order's middle rotation
+static __zml_floating *middleAngle(zmlEulerOrder order, __zml_floating angles[3]) {
+	return (order == ZML_EULER_YXZ) ? &angles[0] : &angles[1];
+}
+
+static void checkEuler(void) {
+	const double tolerance = ZML_TEST_TOLERANCE * 100;
+
+	for (unsigned int o = 0; o < 3; o++) {
+		const zmlEulerOrder order = orders[o];
+		for (unsigned int i = 0; i < 2000; i++) {
+			// angles in range (so they come back unchanged), then at and around gimbal lock
+			__zml_floating angles[3] = { (__zml_floating) (PI * zmlTestRandom()), (__zml_floating) (PI * zmlTestRandom()), (__zml_floating) (PI * zmlTestRandom()) };
+			__zml_floating *middle = middleAngle(order, angles);
+			*middle /= 2;
+			const unsigned int kind = i % 4;
+			if (kind == 1) {
+				*middle = (__zml_floating) ((i % 8 < 4) ? PI / 2 : -PI / 2);
+			} else if (kind == 2) {
+				*middle = (__zml_floating) ((i % 8 < 4) ? PI / 2 - 1e-3 : -PI / 2 + 1e-5);
+			}
+
+			const zmlQuat q = zmlEulerQuat(order, angles[0], angles[1], angles[2]);
+			__zml_floating back[3];
+			zmlQuatToEuler(q, order, &back[0], &back[1], &back[2]);
+			const zmlQuat again = zmlEulerQuat(order, back[0], back[1], back[2]);
+
+			double diff = rotationDifference(again, q);
+			ZML_CHECK(diff < tolerance, "%s (%g, %g, %g): the angles found, (%g, %g, %g), give a rotation that differs by %g", orderNames[o],
+				(double) angles[0], (double) angles[1], (double) angles[2], (double) back[0], (double) back[1], (double) back[2], diff);
+
+			if (kind == 0 || kind == 3) {
+				double worst = 0;
+				for (unsigned int a = 0; a < 3; a++) {
+					worst = fmax(worst, fabs((double) back[a] - (double) angles[a]));
+				}
+				ZML_CHECK(worst < tolerance, "%s (%g, %g, %g): came back as (%g, %g, %g)", orderNames[o],
+					(double) angles[0], (double) angles[1], (double) angles[2], (double) back[0], (double) back[1], (double) back[2]);
+			} else if (kind == 1) {
+				// (the first rotation is folded into the last)
+				const __zml_floating first = (order == ZML_EULER_XYZ) ? back[0] : (order == ZML_EULER_ZYX) ? back[2] : back[1];
+				ZML_CHECK(first == 0, "%s at gimbal lock: the first angle is %g, not 0", orderNames[o], (double) first);
+			}
+			ZML_CHECK(fabs((double) *middleAngle(order, back)) <= PI / 2 + tolerance, "%s: the middle angle %g is out of range", orderNames[o], (double) *middleAngle(order, back));
+
+			// the quaternion and the Euler rotation matrix agree
+			const zmlMat4 expected = zmlRotateIdentityEulerMat4(order, angles[0], angles[1], angles[2]);
+			const zmlQuat fromMat = zmlMat4ToQuat(expected);
+			diff = rotationDifference(fromMat, q);
+			ZML_CHECK(diff < tolerance, "%s (%g, %g, %g): differs from zmlRotateIdentityEulerMat4() by %g", orderNames[o],
+				(double) angles[0], (double) angles[1], (double) angles[2], diff);
+		}
+
+		// no rotation at all
+		__zml_floating x, y, z;
+		zmlQuatToEuler(zmlIdentityQuat(), order, &x, &y, &z);
+		ZML_CHECK(x == 0 && y == 0 && z == 0, "%s: the identity gave (%g, %g, %g)", orderNames[o], (double) x, (double) y, (double) z);
+	}
+}
+
+static void checkAxisAngle(void) {
+	const double tolerance = ZML_TEST_TOLERANCE * 100;
+
+	for (unsigned int i = 0; i < 1000; i++) {
+		zmlVec3 axis = { { zmlTestRandom(), zmlTestRandom(), zmlTestRandom() } };
+		axis = zmlNormalisedVec3(axis);
+		// (angles in (0, pi), where the axis and angle are unique, including close to a half turn)
+		const __zml_floating angle = (i % 10 == 0) ? (__zml_floating) (PI - 1e-3) : (__zml_floating) (PI * (zmlTestRandom() + 1) / 2 + 1e-3);
+
+		const zmlQuat q = zmlAxisAngleQuat(angle, axis.elements[0], axis.elements[1], axis.elements[2]);
+		__zml_floating backAngle;
+		zmlVec3 backAxis;
+		zmlQuatToAxisAngle(q, &backAngle, &backAxis);
+
+		double worst = fabs((double) backAngle - (double) angle);
+		for (unsigned int a = 0; a < 3; a++) {
+			worst = fmax(worst, fabs((double) backAxis.elements[a] - (double) axis.elements[a]));
+		}
+		ZML_CHECK(worst < tolerance, "rotation by %g about (%g, %g, %g) came back as %g about (%g, %g, %g)", (double) angle,
+			(double) axis.elements[0], (double) axis.elements[1], (double) axis.elements[2], (double) backAngle,
+			(double) backAxis.elements[0], (double) backAxis.elements[1], (double) backAxis.elements[2]);
+
+		const zmlQuat fromMat = zmlMat4ToQuat(zmlRotateIdentityMat4(angle, axis.elements[0], axis.elements[1], axis.elements[2]));
+		const double diff = rotationDifference(fromMat, q);
+		ZML_CHECK(diff < tolerance, "rotation by %g: differs from zmlRotateIdentityMat4() by %g", (double) angle, diff);
+	}
+
+	__zml_floating angle;
+	zmlVec3 axis;
+	zmlQuatToAxisAngle(zmlIdentityQuat(), &angle, &axis);
+	ZML_CHECK(angle == 0 && axis.elements[0] == 1, "the identity gave a rotation by %g", (double) angle);
+}
+
+static void checkMat4(void) {
+	const double tolerance = ZML_TEST_TOLERANCE * 100;
+
+	for (unsigned int i = 0; i < 1000; i++) {
+		zmlQuat q = randomQuat();
+		// (including half turns about each axis, where each branch of the conversion is taken)
+		if (i < 3) {
+			q = (zmlQuat) { { i == 0, i == 1, i == 2, 0 } };
+		}
+
+		const zmlMat4 m = zmlQuatToMat4(q);
+		const zmlQuat back = zmlMat4ToQuat(m);
+		const double diff = fmin(
+			fmax(fmax(fabs((double) back.elements[0] - q.elements[0]), fabs((double) back.elements[1] - q.elements[1])),
+				fmax(fabs((double) back.elements[2] - q.elements[2]), fabs((double) back.elements[3] - q.elements[3]))),
+			fmax(fmax(fabs((double) back.elements[0] + q.elements[0]), fabs((double) back.elements[1] + q.elements[1])),
+				fmax(fabs((double) back.elements[2] + q.elements[2]), fabs((double) back.elements[3] + q.elements[3]))));
+		ZML_CHECK(diff < tolerance, "(%g, %g, %g, %g) came back from its matrix as (%g, %g, %g, %g)", (double) q.elements[0],
+			(double) q.elements[1], (double) q.elements[2], (double) q.elements[3], (double) back.elements[0],
+			(double) back.elements[1], (double) back.elements[2], (double) back.elements[3]);
+
+		// rotating a vector with the quaternion and with its matrix
+		const zmlVec3 v = { { zmlTestRandom(), zmlTestRandom(), zmlTestRandom() } };
+		const zmlVec3 rotated = zmlRotatedVec3(v, q);
+		double worst = 0;
+		for (unsigned int r = 0; r < 3; r++) {
+			const double expected = m.elements[r][0] * v.elements[0] + m.elements[r][1] * v.elements[1] + m.elements[r][2] * v.elements[2];
+			worst = fmax(worst, fabs((double) rotated.elements[r] - expected));
+		}
+		ZML_CHECK(worst < tolerance, "zmlRotatedVec3() differs from the rotation matrix by %g", worst);
+	}
+}
+
+static void checkSlerp(void) {
+	const double tolerance = ZML_TEST_TOLERANCE * 100;
+
+	for (unsigned int i = 0; i < 1000; i++) {
+		const zmlQuat a = randomQuat();
+		zmlQuat b = randomQuat();
+		// (including rotations too close together for sin() to be accurate)
+		if (i % 10 == 0) {
+			b = zmlNormalisedQuat(zmlMultiplyQuats_r(a, zmlAxisAngleQuat((__zml_floating) 1e-3, 1, 2, 3)));
+		}
+
+		ZML_CHECK(rotationDifference(zmlSlerpQuat(a, b, 0), a) < tolerance, "slerp at t = 0 isn't the first rotation");
+		ZML_CHECK(rotationDifference(zmlSlerpQuat(a, b, 1), b) < tolerance, "slerp at t = 1 isn't the second rotation");
+
+		// the midpoint is the same angle from each end, half of the angle between them (taking the shorter way around)
+		const zmlQuat mid = zmlSlerpQuat(a, b, (__zml_floating) 0.5);
+		const double total = acos(fmin(1.0, fabs((double) zmlDotQuat(a, b))));
+		const double toA = acos(fmin(1.0, fabs((double) zmlDotQuat(mid, a))));
+		const double toB = acos(fmin(1.0, fabs((double) zmlDotQuat(mid, b))));
+		ZML_CHECK(fabs(toA - total / 2) < sqrt(tolerance) && fabs(toB - total / 2) < sqrt(tolerance),
+			"the slerp midpoint is %g and %g from the ends, which are %g apart", toA, toB, total);
+		ZML_CHECK(fabs((double) zmlMagnitudeQuat(mid) - 1) < tolerance, "the slerp midpoint isn't normalised");
+
+		// and the rotation halfway between them, as a rotation
+		zmlQuat half = b;
+		if (zmlDotQuat(a, b) < 0) {
+			for (unsigned int c = 0; c < 4; c++) half.elements[c] = -half.elements[c];
+		}
+		for (unsigned int c = 0; c < 4; c++) half.elements[c] += a.elements[c];
+		ZML_CHECK(rotationDifference(mid, half) < tolerance, "the slerp midpoint isn't the normalised sum of the ends");
+	}
+}
+
+int main() {
+	checkEuler();
+	checkAxisAngle();
+	checkMat4();
+	checkSlerp();
+
+	return zmlTestResult("quat");
+}
@@ -0,0 +1,275 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks sparse matrices against the dense matrices they represent: building them from triplets (with duplicates, and
+// rejecting triplets outside of the matrix), converting between CSR and CSC, transposing, and multiplying them by vectors
+// and matrices (including in place, and big enough for the products to be split across threads).
+
+#include "test.h"
+#include <string.h>
+
+static const zmlSparseFormat formats[] = { ZML_CSR, ZML_CSC };
+static const char *formatNames[] = { "CSR", "CSC" };
+
+// a rows x cols matrix with about one element in density nonzero
+static zmlMatrix randomSparseDense(unsigned int rows, unsigned int cols, unsigned int density) {
+	zmlMatrix m = zmlZeroMatrix(rows, cols);
+	for (unsigned int r = 0; r < rows; r++) {
+		for (unsigned int c = 0; c < cols; c++) {
+			if ((unsigned int) ((zmlTestRandom() + 1) * 1000) % density == 0) {
+				m.elements[r][c] = zmlTestRandom();
+			}
+		}
+	}
+	return m;
+}
+
+// the indices of every group are in increasing order, and the offsets add up
+static unsigned char wellFormed(zmlSparseMatrix s) {
+	const unsigned int nmajor = (s.format == ZML_CSR) ? s.rows : s.cols;
+	const unsigned int nminor = (s.format == ZML_CSR) ? s.cols : s.rows;
+	if (s.offsets[0] != 0 || s.offsets[nmajor] != s.nonzeros) {
+		return 0;
+	}
+	for (unsigned int m = 0; m < nmajor; m++) {
+		for (size_t k = s.offsets[m]; k < s.offsets[m + 1]; k++) {
+			if (s.indices[k] >= nminor || (k > s.offsets[m] && s.indices[k] <= s.indices[k - 1])) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+// a * b, naively, in double
+static zmlMatrix naiveProduct(zmlMatrix a, zmlMatrix b) {
+	zmlMatrix r = zmlAllocMatrix(a.rows, b.cols);
+	for (unsigned int i = 0; i < a.rows; i++) {
+		for (unsigned int j = 0; j < b.cols; j++) {
+			double sum = 0;
+			for (unsigned int p = 0; p < a.cols; p++) {
+				sum += (double) a.elements[i][p] * (double) b.elements[p][j];
+			}
+			r.elements[i][j] = (__zml_floating) sum;
+		}
+	}
+	return r;
+}
+
+// a copy of v as a column matrix, to compare with zmlTestDifference()
+static zmlMatrix columnOf(zmlVector v) {
+	zmlMatrix r = zmlAllocMatrix(v.size, 1);
+	memcpy(r.data, v.elements, v.size * sizeof(__zml_floating));
+	return r;
+}
+
+static void checkShape(unsigned int rows, unsigned int cols) {
+	zmlMatrix dense = randomSparseDense(rows, cols, 5);
+
+	// each element is given as two halves (which add up exactly), in a scrambled order, with some explicit zeros
+	size_t count = 0;
+	unsigned int *rowIndices = malloc(((size_t) rows * cols * 2 + 1) * sizeof(unsigned int));
+	unsigned int *colIndices = malloc(((size_t) rows * cols * 2 + 1) * sizeof(unsigned int));
+	__zml_floating *values = malloc(((size_t) rows * cols * 2 + 1) * sizeof(__zml_floating));
+	for (unsigned int half = 0; half < 2; half++) {
+		for (unsigned int i = 0; i < rows * cols; i++) {
+			// (visit the elements in a different order each time)
+			const unsigned int e = (unsigned int) (((size_t) i * 7919 + half * 31) % ((size_t) rows * cols));
+			const unsigned int r = e / cols, c = e % cols;
+			if (dense.elements[r][c] != 0 || (half == 0 && e % 11 == 0)) {
+				rowIndices[count] = r;
+				colIndices[count] = c;
+				values[count] = dense.elements[r][c] / 2;
+				count++;
+			}
+		}
+	}
+
+	for (unsigned int f = 0; f < 2; f++) {
+		const char *name = formatNames[f];
+
+		zmlSparseMatrix s = zmlSparseMatrixFromTriplets(rows, cols, rowIndices, colIndices, values, count, formats[f]);
+		ZML_CHECK(s.rows == rows && s.cols == cols && s.format == formats[f] && wellFormed(s), "%s %ux%u: bad matrix from triplets", name, rows, cols);
+		zmlMatrix back = zmlMatrixFromSparse(s);
+		ZML_CHECK(zmlTestDifference(back, dense) == 0, "%s %ux%u: triplets (with duplicates) don't give the dense matrix", name, rows, cols);
+		zmlFreeMatrix(&back);
+
+		// from and to dense, and converted to the other form
+		zmlSparseMatrix fromDense = zmlSparseMatrixFromMatrix(dense, formats[f]);
+		ZML_CHECK(wellFormed(fromDense), "%s %ux%u: bad matrix from a dense matrix", name, rows, cols);
+		back = zmlMatrixFromSparse(fromDense);
+		ZML_CHECK(zmlTestDifference(back, dense) == 0, "%s %ux%u: zmlSparseMatrixFromMatrix() doesn't give the dense matrix", name, rows, cols);
+		zmlFreeMatrix(&back);
+
+		zmlSparseMatrix converted = zmlConvertedSparse(s, formats[1 - f]);
+		ZML_CHECK(converted.format == formats[1 - f] && wellFormed(converted), "%s %ux%u: bad converted matrix", name, rows, cols);
+		back = zmlMatrixFromSparse(converted);
+		ZML_CHECK(zmlTestDifference(back, dense) == 0, "%s %ux%u: zmlConvertedSparse() changed the matrix", name, rows, cols);
+		zmlFreeMatrix(&back);
+
+		zmlSparseMatrix transposed = zmlTransposedSparse(s);
+		zmlMatrix denseTransposed = zmlTransposed(dense);
+		ZML_CHECK(transposed.format == formats[f] && transposed.rows == cols && wellFormed(transposed), "%s %ux%u: bad transposed matrix", name, rows, cols);
+		back = zmlMatrixFromSparse(transposed);
+		ZML_CHECK(zmlTestDifference(back, denseTransposed) == 0, "%s %ux%u: zmlTransposedSparse() isn't the transpose", name, rows, cols);
+		zmlFreeMatrix(&back);
+
+		// products with a vector
+		zmlMatrix x = zmlTestRandomMatrix(cols, 1);
+		zmlVector v = zmlAllocVector(cols);
+		memcpy(v.elements, x.data, cols * sizeof(__zml_floating));
+		zmlMatrix expected = naiveProduct(dense, x);
+		zmlVector y = zmlMultiplySparseVec_r(s, v);
+		zmlMatrix ym = columnOf(y);
+		double diff = zmlTestDifference(ym, expected);
+		zmlFreeMatrix(&ym);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "%s %ux%u: |Av - expected| = %g", name, rows, cols, diff);
+
+		if (rows == cols) {
+			// in place: every element of v is still needed after the first element of the result is known
+			zmlMultiplySparseVecInto(&v, s, v);
+			zmlMatrix vm = columnOf(v);
+			diff = zmlTestDifference(vm, expected);
+			zmlFreeMatrix(&vm);
+			ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "%s %ux%u: |Av - expected| = %g with dst == v", name, rows, cols, diff);
+		}
+
+		// and with a matrix
+		zmlMatrix b = zmlTestRandomMatrix(cols, 5);
+		zmlMatrix expectedMat = naiveProduct(dense, b);
+		zmlMatrix product = zmlMultiplySparseMat_r(s, b);
+		diff = zmlTestDifference(product, expectedMat);
+		ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "%s %ux%u: |AB - expected| = %g", name, rows, cols, diff);
+		if (rows == cols) {
+			zmlMultiplySparseMatInto(&b, s, b);
+			diff = zmlTestDifference(b, expectedMat);
+			ZML_CHECK(diff < ZML_TEST_TOLERANCE * 10, "%s %ux%u: |AB - expected| = %g with dst == b", name, rows, cols, diff);
+		}
+
+		zmlFreeSparseMatrix(&s);
+		zmlFreeSparseMatrix(&fromDense);
+		zmlFreeSparseMatrix(&converted);
+		zmlFreeSparseMatrix(&transposed);
+		zmlFreeMatrix(&denseTransposed);
+		zmlFreeMatrix(&x);
+		zmlFreeVector(&v);
+		zmlFreeMatrix(&expected);
+		zmlFreeVector(&y);
+		zmlFreeMatrix(&b);
+		zmlFreeMatrix(&expectedMat);
+		zmlFreeMatrix(&product);
+	}
+
+	// a triplet outside of the matrix is rejected
+	if (count) {
+		rowIndices[count] = rows;
+		colIndices[count] = 0;
+		values[count] = 1;
+		zmlSparseMatrix outside = zmlSparseMatrixFromTriplets(rows, cols, rowIndices, colIndices, values, count + 1, ZML_CSR);
+		ZML_CHECK(outside.offsets == NULL && outside.nonzeros == 0, "%ux%u: a triplet outside of the matrix wasn't rejected", rows, cols);
+		rowIndices[count] = 0;
+		colIndices[count] = cols;
+		outside = zmlSparseMatrixFromTriplets(rows, cols, rowIndices, colIndices, values, count + 1, ZML_CSC);
+		ZML_CHECK(outside.offsets == NULL && outside.nonzeros == 0, "%ux%u: a triplet outside of the matrix wasn't rejected", rows, cols);
+	}
+
+	free(rowIndices);
+	free(colIndices);
+	free(values);
+	zmlFreeMatrix(&dense);
+}
+
+// a matrix with more nonzeros than ZML_PARALLEL_THRESHOLD, some rows much fuller than others, so that the CSR products are
+// split by nonzeros and the CSC vector product adds up the results of several threads. Checked against the triplets directly.
+static void checkLarge(unsigned int n) {
+	const size_t count = (size_t) n * 4;
+	unsigned int *rowIndices = malloc(count * sizeof(unsigned int)), *colIndices = malloc(count * sizeof(unsigned int));
+	__zml_floating *values = malloc(count * sizeof(__zml_floating));
+	for (size_t k = 0; k < count; k++) {
+		// a quarter of the elements are in the first 16 rows
+		rowIndices[k] = (k % 4 == 0) ? (unsigned int) (k % 16) : (unsigned int) ((k * 2654435761u) % n);
+		colIndices[k] = (unsigned int) ((k * 40503u + 7) % n);
+		values[k] = zmlTestRandom();
+	}
+
+	zmlVector v = zmlAllocVector(n);
+	zmlMatrix b = zmlTestRandomMatrix(n, 3);
+	for (unsigned int i = 0; i < n; i++) {
+		v.elements[i] = zmlTestRandom();
+	}
+
+	double *expected = calloc(n, sizeof(double)), *expectedMat = calloc((size_t) n * 3, sizeof(double));
+	double scale = 1;
+	for (size_t k = 0; k < count; k++) {
+		expected[rowIndices[k]] += (double) values[k] * (double) v.elements[colIndices[k]];
+		for (unsigned int c = 0; c < 3; c++) {
+			expectedMat[(size_t) rowIndices[k] * 3 + c] += (double) values[k] * (double) b.elements[colIndices[k]][c];
+		}
+	}
+	for (unsigned int i = 0; i < n; i++) {
+		scale = fmax(scale, fabs(expected[i]));
+	}
+
+	for (unsigned int f = 0; f < 2; f++) {
+		zmlSparseMatrix s = zmlSparseMatrixFromTriplets(n, n, rowIndices, colIndices, values, count, formats[f]);
+		ZML_CHECK(wellFormed(s), "%s %u: bad matrix from triplets", formatNames[f], n);
+
+		zmlVector y = zmlMultiplySparseVec_r(s, v);
+		double diff = 0;
+		for (unsigned int i = 0; i < n; i++) {
+			diff = fmax(diff, fabs((double) y.elements[i] - expected[i]));
+		}
+		ZML_CHECK(diff / scale < ZML_TEST_TOLERANCE * 100, "%s %u: |Av - expected| = %g", formatNames[f], n, diff / scale);
+
+		zmlVector inPlace = zmlCopyVector(&v);
+		zmlMultiplySparseVecInto(&inPlace, s, inPlace);
+		ZML_CHECK(memcmp(inPlace.elements, y.elements, n * sizeof(__zml_floating)) == 0, "%s %u: dst == v gives a different result", formatNames[f], n);
+
+		zmlMatrix product = zmlMultiplySparseMat_r(s, b);
+		diff = 0;
+		for (unsigned int i = 0; i < n; i++) {
+			for (unsigned int c = 0; c < 3; c++) {
+				diff = fmax(diff, fabs((double) product.elements[i][c] - expectedMat[(size_t) i * 3 + c]));
+			}
+		}
+		ZML_CHECK(diff / scale < ZML_TEST_TOLERANCE * 100, "%s %u: |AB - expected| = %g", formatNames[f], n, diff / scale);
+
+		zmlFreeSparseMatrix(&s);
+		zmlFreeVector(&y);
+		zmlFreeVector(&inPlace);
+		zmlFreeMatrix(&product);
+	}
+
+	free(rowIndices);
+	free(colIndices);
+	free(values);
+	free(expected);
+	free(expectedMat);
+	zmlFreeVector(&v);
+	zmlFreeMatrix(&b);
+}
+
+int main() {
+	// (use several threads even on a machine with one core, so that the work really is split)
+	zmlSetThreadCount(4);
+
+	static const unsigned int shapes[][2] = { { 1, 1 }, { 1, 7 }, { 7, 1 }, { 6, 6 }, { 13, 29 }, { 40, 17 }, { 64, 64 } };
+	for (unsigned int i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+		checkShape(shapes[i][0], shapes[i][1]);
+	}
+
+	checkLarge(50000);
+
+	return zmlTestResult("sparse");
+}
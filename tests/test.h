@@ -0,0 +1,85 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// Helpers shared by the self-checking test programs. Each program records failed checks with ZML_CHECK() and returns
+// zmlTestResult() from main(), so that CTest sees a nonzero exit status if anything failed.
+
+#ifndef ZML_TEST_H
+#define ZML_TEST_H
+
+#include <zetaml.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// the relative error allowed when comparing results with a reference computed a different way.
+#ifdef ZML_USING_FLOATS
+#	define ZML_TEST_TOLERANCE 1e-4
+#else
+#	define ZML_TEST_TOLERANCE 1e-10
+#endif
+
+static unsigned int zmlTestFailures = 0;
+
+// check a condition, printing the failure (described by the printf()-style arguments after it) if it is false.
+#define ZML_CHECK(cond, ...) do {\
+	if (!(cond)) {\
+		printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond);\
+		printf(__VA_ARGS__);\
+		printf("\n");\
+		zmlTestFailures++;\
+	}\
+} while (0)
+
+// a repeatable pseudo-random value in [-1, 1).
+static inline __zml_floating zmlTestRandom(void) {
+	static unsigned int seed = 12345;
+	seed = seed * 1103515245u + 12345u;
+	return (__zml_floating) (((seed >> 8) & 0xffff) / 32768.0 - 1.0);
+}
+
+// a rows x cols matrix of zmlTestRandom() values.
+static inline zmlMatrix zmlTestRandomMatrix(unsigned int rows, unsigned int cols) {
+	zmlMatrix m = zmlAllocMatrix(rows, cols);
+	for (unsigned int r = 0; r < rows; r++) {
+		for (unsigned int c = 0; c < cols; c++) {
+			m.elements[r][c] = zmlTestRandom();
+		}
+	}
+	return m;
+}
+
+// the largest difference between the elements of a and b, relative to the largest element of b (or 1, if that is smaller).
+static inline double zmlTestDifference(zmlMatrix a, zmlMatrix b) {
+	double diff = 0, scale = 1;
+	for (unsigned int r = 0; r < b.rows; r++) {
+		for (unsigned int c = 0; c < b.cols; c++) {
+			diff = fmax(diff, fabs((double) a.elements[r][c] - (double) b.elements[r][c]));
+			scale = fmax(scale, fabs((double) b.elements[r][c]));
+		}
+	}
+	return diff / scale;
+}
+
+// report the number of failed checks and return the program's exit status.
+static inline int zmlTestResult(const char *name) {
+	if (zmlTestFailures) {
+		printf("%s: %u check(s) failed\n", name, zmlTestFailures);
+		return 1;
+	}
+	printf("%s: all checks passed\n", name);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,125 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks the library's parallel loops: every item is visited exactly once, loops started from inside a loop's tasks
+// (whichever thread runs them, including the one that started the outer loop) run serially on that thread, and loops
+// split across threads again once the outer loop has finished.
+
+#include "test.h"
+#include "../src/internal.h"
+
+#define OUTER 64
+#define INNER 5000
+
+// (the address of a thread-local variable identifies the thread)
+static _zml_threadLocal unsigned char threadMarker;
+
+typedef struct {
+	unsigned int visits[OUTER * INNER];
+	unsigned int calls; // calls made to the function of the loop being checked
+	unsigned int wrongThread; // inner loop items not run on the thread that ran their outer item
+	unsigned int depth; // how deep the loops are nested
+} loops;
+
+typedef struct {
+	loops *l;
+	size_t first; // index of the first item visited by this loop
+	const unsigned char *thread;
+	unsigned int depth;
+} innerArgs;
+
+static void innerLoop(void *ctx, size_t begin, size_t end) {
+	innerArgs *args = (innerArgs *) ctx;
+	if (&threadMarker != args->thread) {
+		__atomic_add_fetch(&args->l->wrongThread, (unsigned int) (end - begin), __ATOMIC_RELAXED);
+	}
+
+	for (size_t i = begin; i < end; i++) {
+		if (args->depth > 1) {
+			// (a third level, over this item alone)
+			innerArgs deeper = *args;
+			deeper.first += i;
+			deeper.depth = 1;
+			_zml_parallelFor(1, 1, innerLoop, &deeper);
+		}
+		__atomic_add_fetch(&args->l->visits[args->first + i], 1, __ATOMIC_RELAXED);
+	}
+}
+
+static void outerLoop(void *ctx, size_t begin, size_t end) {
+	loops *l = (loops *) ctx;
+	__atomic_add_fetch(&l->calls, 1, __ATOMIC_RELAXED);
+
+	for (size_t o = begin; o < end; o++) {
+		innerArgs args = { l, o * INNER, &threadMarker, l->depth };
+		// (small grains, so that the inner loops would be split if they were allowed to be)
+		_zml_parallelFor(INNER, 1, innerLoop, &args);
+	}
+}
+
+static void countCalls(void *ctx, size_t begin, size_t end) {
+	loops *l = (loops *) ctx;
+	__atomic_add_fetch(&l->calls, 1, __ATOMIC_RELAXED);
+	for (size_t i = begin; i < end; i++) {
+		__atomic_add_fetch(&l->visits[i], 1, __ATOMIC_RELAXED);
+	}
+}
+
+static void checkNested(loops *l, unsigned int depth) {
+	memset(l, 0, sizeof(*l));
+	l->depth = depth;
+	_zml_parallelFor(OUTER, 1, outerLoop, l);
+
+	unsigned int wrong = 0;
+	for (size_t i = 0; i < OUTER * INNER; i++) {
+		wrong += (l->visits[i] != depth);
+	}
+	ZML_CHECK(wrong == 0, "nested %u deep: %u items weren't visited exactly %u times", depth, wrong, depth);
+	ZML_CHECK(l->wrongThread == 0, "nested %u deep: %u inner items ran on another thread", depth, l->wrongThread);
+}
+
+// a loop on its own, which should be split into calls unless there's only one thread
+static void checkFlat(loops *l, unsigned int threads) {
+	memset(l, 0, sizeof(*l));
+	_zml_parallelFor(OUTER * INNER, 1000, countCalls, l);
+
+	unsigned int wrong = 0;
+	for (size_t i = 0; i < OUTER * INNER; i++) {
+		wrong += (l->visits[i] != 1);
+	}
+	ZML_CHECK(wrong == 0, "%u threads: %u items weren't visited exactly once", threads, wrong);
+	if (threads == 1 || zmlGetThreadCount() == 1) {
+		ZML_CHECK(l->calls == 1, "%u threads: the loop was split into %u calls", threads, l->calls);
+	} else {
+		ZML_CHECK(l->calls > 1, "%u threads: the loop wasn't split", threads);
+	}
+}
+
+int main() {
+	loops *l = malloc(sizeof(loops));
+
+	static const unsigned int threadCounts[] = { 4, 2, 1, 8 };
+	for (unsigned int t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); t++) {
+		zmlSetThreadCount(threadCounts[t]);
+		checkFlat(l, threadCounts[t]);
+		checkNested(l, 1);
+		checkNested(l, 2);
+
+		// (the calling thread has finished helping with the nested loops, so loops can be split again)
+		checkFlat(l, threadCounts[t]);
+	}
+
+	free(l);
+	return zmlTestResult("threads");
+}
@@ -0,0 +1,78 @@
+/* *************************************************************************************** */
+/* 						THE ZETA MATHS LIBRARY LICENSE INFORMATION						   */
+/* *************************************************************************************** */
+/* Copyright (c) 2022 Jack Bennett														   */
+/* --------------------------------------------------------------------------------------- */
+/* THE  SOFTWARE IS  PROVIDED "AS IS",  WITHOUT WARRANTY OF ANY KIND, EXPRESS  OR IMPLIED, */
+/* INCLUDING  BUT  NOT  LIMITED  TO  THE  WARRANTIES  OF  MERCHANTABILITY,  FITNESS FOR  A */
+/* PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN  NO EVENT SHALL  THE  AUTHORS  OR COPYRIGHT */
+/* HOLDERS  BE  LIABLE  FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF */
+/* CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR */
+/* THE USE OR OTHER DEALINGS IN THE SOFTWARE.											   */
+/* *************************************************************************************** */
+
+
+// checks zmlTransposed(), zmlTransposedInto() and the in-place zmlTranspose() against the definition of the transpose, for square
+// and non-square shapes, either side of the tile size and of the threshold for splitting the work across threads.
+
+#include "test.h"
+
+static void checkShape(unsigned int rows, unsigned int cols) {
+	zmlMatrix a = zmlTestRandomMatrix(rows, cols);
+
+	zmlMatrix t = zmlTransposed(a);
+	unsigned char ok = t.rows == cols && t.cols == rows;
+	for (unsigned int r = 0; r < rows && ok; r++) {
+		for (unsigned int c = 0; c < cols; c++) {
+			ok &= t.elements[c][r] == a.elements[r][c];
+		}
+	}
+	ZML_CHECK(ok, "%ux%u: zmlTransposed() is wrong", rows, cols);
+
+	zmlMatrix into = zmlAllocMatrix(cols, rows);
+	zmlTransposedInto(&into, a);
+	ZML_CHECK(zmlTestDifference(into, t) == 0, "%ux%u: zmlTransposedInto() differs from zmlTransposed()", rows, cols);
+
+	// in place, the shape changes along with the elements, and each row is found through elements and stride alike
+	zmlMatrix inPlace = zmlCopyMatrix(&a);
+	zmlTranspose(&inPlace);
+	ZML_CHECK(inPlace.rows == cols && inPlace.cols == rows, "%ux%u: zmlTranspose() gave a %ux%u matrix", rows, cols, inPlace.rows, inPlace.cols);
+	if (inPlace.rows == cols && inPlace.cols == rows) {
+		ZML_CHECK(zmlTestDifference(inPlace, t) == 0, "%ux%u: zmlTranspose() differs from zmlTransposed()", rows, cols);
+		unsigned char rowsOk = 1;
+		for (unsigned int r = 0; r < inPlace.rows; r++) {
+			rowsOk &= inPlace.elements[r] == inPlace.data + (size_t) r * inPlace.stride;
+		}
+		ZML_CHECK(rowsOk, "%ux%u: zmlTranspose() left stale row pointers", rows, cols);
+
+		// and back again
+		zmlTranspose(&inPlace);
+		ZML_CHECK(inPlace.rows == rows && zmlTestDifference(inPlace, a) == 0, "%ux%u: transposing twice didn't give the original", rows, cols);
+	}
+
+	// a square matrix can be transposed into itself
+	if (rows == cols) {
+		zmlMatrix self = zmlCopyMatrix(&a);
+		zmlTransposedInto(&self, self);
+		ZML_CHECK(zmlTestDifference(self, t) == 0, "%ux%u: zmlTransposedInto() with dst == mat is wrong", rows, cols);
+		zmlFreeMatrix(&self);
+	}
+
+	zmlFreeMatrix(&a);
+	zmlFreeMatrix(&t);
+	zmlFreeMatrix(&into);
+	zmlFreeMatrix(&inPlace);
+}
+
+int main() {
+	static const unsigned int shapes[][2] = {
+		{ 0, 5 }, { 5, 0 }, { 0, 0 }, { 1, 1 }, { 1, 9 }, { 9, 1 }, { 2, 3 }, { 3, 7 }, { 7, 3 },
+		{ 16, 16 }, { 33, 33 }, { 64, 65 }, { 65, 64 }, { 1, 1000 }, { 1000, 1 }, { 130, 257 }, { 300, 257 }, { 200, 200 },
+	};
+
+	for (unsigned int s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+		checkShape(shapes[s][0], shapes[s][1]);
+	}
+
+	return zmlTestResult("transpose");
+}